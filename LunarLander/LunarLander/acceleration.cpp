@@ -9,6 +9,7 @@
 
 #include "acceleration.h"
 #include "angle.h"
+#include "fastMath.h"
 #include <math.h>
 
 /****************************************
@@ -17,8 +18,10 @@
  ****************************************/
 void Acceleration::set(const Angle& angle, double magnitude)
 {
-   ddx = magnitude * sin(angle.radians);
-   ddy = magnitude * cos(angle.radians);
+   double s, c;
+   simSincos(angle.radians, s, c);
+   ddx = magnitude * s;
+   ddy = magnitude * c;
 }
 
 /****************************************
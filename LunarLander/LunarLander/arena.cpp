@@ -0,0 +1,113 @@
+/***********************************************************************
+ * Source File:
+ *    ARENA
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Monotonic per-frame and per-thread allocation
+ ************************************************************************/
+
+#include "arena.h"
+#include <cstdint>  // for uintptr_t
+#include <new>      // for operator new
+
+/*************************************************************************
+ * ALIGN UP
+ * Offset of the first address at or after base + offset with alignment
+ *************************************************************************/
+static size_t alignUp(const char* base, size_t offset, size_t alignment)
+{
+   uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+   uintptr_t aligned = (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+   return offset + (aligned - address);
+}
+
+/*************************************************************************
+ * ARENA : CONSTRUCTOR
+ *************************************************************************/
+Arena::Arena(size_t capacity) :
+   block(static_cast<char*>(::operator new(capacity > 0 ? capacity : 1))),
+   capacity(capacity > 0 ? capacity : 1),
+   used(0),
+   retiredBytes(0)
+{
+}
+
+/*************************************************************************
+ * ARENA : DESTRUCTOR
+ *************************************************************************/
+Arena::~Arena()
+{
+   for (char* old : retired)
+      ::operator delete(old);
+   ::operator delete(block);
+}
+
+/*************************************************************************
+ * ARENA : ALLOCATE
+ * Bump the pointer. When the block is full, retire it and carry on in
+ * a bigger one; nothing already handed out moves.
+ *************************************************************************/
+void* Arena::allocate(size_t bytes, size_t alignment)
+{
+   size_t offset = alignUp(block, used, alignment);
+   if (offset + bytes > capacity)
+   {
+      size_t grown = capacity * 2;
+      if (grown < bytes + alignment)
+         grown = bytes + alignment;
+
+      retired.push_back(block);
+      retiredBytes += used;
+      block = static_cast<char*>(::operator new(grown));
+      capacity = grown;
+      used = 0;
+      offset = alignUp(block, 0, alignment);
+   }
+
+   used = offset + bytes;
+   return block + offset;
+}
+
+/*************************************************************************
+ * ARENA : RESET
+ * Normally just a rewind. After an overflow, trade every block for one
+ * that holds all of this frame at once, so the next frame fits again.
+ *************************************************************************/
+void Arena::reset()
+{
+   if (!retired.empty())
+   {
+      size_t needed = retiredBytes + used;
+      for (char* old : retired)
+         ::operator delete(old);
+      retired.clear();
+      retiredBytes = 0;
+
+      if (needed > capacity)
+      {
+         ::operator delete(block);
+         block = static_cast<char*>(::operator new(needed));
+         capacity = needed;
+      }
+   }
+   used = 0;
+}
+
+/*************************************************************************
+ * FRAME ARENA
+ *************************************************************************/
+Arena& frameArena()
+{
+   static Arena arena;
+   return arena;
+}
+
+/*************************************************************************
+ * THREAD ARENA
+ *************************************************************************/
+Arena& threadArena()
+{
+   thread_local Arena arena;
+   return arena;
+}
@@ -0,0 +1,85 @@
+/***********************************************************************
+ * Header File:
+ *    ARENA
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A monotonic bump allocator for data that lives for one frame (or
+ *    one request). Allocation is a pointer bump, free is a no-op, and
+ *    reset() rewinds the whole arena at once. If a frame ever needs more
+ *    than the arena holds, the extra comes from the heap and the next
+ *    reset() grows the arena so the following frames fit again.
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>  // for size_t, max_align_t
+#include <vector>
+
+// Forward declaration for unit tests
+class TestArena;
+
+/*****************************************************
+ * ARENA
+ *****************************************************/
+class Arena
+{
+   friend TestArena;
+
+public:
+   explicit Arena(size_t capacity = 64 * 1024);
+   ~Arena();
+   Arena(const Arena&) = delete;
+   Arena& operator=(const Arena&) = delete;
+
+   void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+   void reset();
+
+   size_t getUsed() const { return used + retiredBytes; }
+   size_t getCapacity() const { return capacity; }
+
+private:
+   char* block;                  // where allocations come from
+   size_t capacity;              // size of block
+   size_t used;                  // bytes handed out of block
+   std::vector<char*> retired;   // blocks we outgrew since the last reset
+   size_t retiredBytes;          // bytes handed out of those
+};
+
+/*****************************************************
+ * ARENA ALLOCATOR
+ * Lets standard containers live in an arena
+ *****************************************************/
+template <class T>
+class ArenaAllocator
+{
+public:
+   typedef T value_type;
+
+   ArenaAllocator(Arena& arena) : arena(&arena) {}
+   template <class U>
+   ArenaAllocator(const ArenaAllocator<U>& rhs) : arena(rhs.arena) {}
+
+   T* allocate(size_t n)
+   {
+      return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+   }
+   void deallocate(T*, size_t) {}
+
+   template <class U>
+   bool operator==(const ArenaAllocator<U>& rhs) const { return arena == rhs.arena; }
+   template <class U>
+   bool operator!=(const ArenaAllocator<U>& rhs) const { return arena != rhs.arena; }
+
+   Arena* arena;
+};
+
+// A vector that lives until its arena is reset
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// The user interface thread's arena, reset after every frame is drawn
+Arena& frameArena();
+
+// One per thread for workers, reset by whoever owns the thread's loop
+Arena& threadArena();
@@ -0,0 +1,483 @@
+/***********************************************************************
+ * Source File:
+ *    BATCH RUNNER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Fly a range of seeded missions in this process or across workers
+ ************************************************************************/
+
+#include "batchRunner.h"
+#include "controller.h"
+#include "resultStore.h"
+#include "trajectoryArchive.h"
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>     // for open
+#include <signal.h>  // for kill
+#include <cstdio>    // for rename
+#include <map>
+#include <deque>
+
+#ifdef __linux__
+#include <sched.h>   // for sched_setaffinity
+#endif // __linux__
+
+// What a worker sends back after every chunk, followed by `rows`
+// MissionResults when the results are being kept and then
+// `trajectoryBytes` of encoded trajectories when those are
+struct ChunkRecord
+{
+   uint32_t chunk;
+   uint32_t rows;
+   MissionStats stats;
+   uint64_t trajectoryBytes;
+};
+
+/*************************************************************************
+ * READ FULLY
+ * False on end of file or error before everything arrived
+ *************************************************************************/
+static bool readFully(int fd, void* buffer, size_t size)
+{
+   char* p = static_cast<char*>(buffer);
+   while (size > 0)
+   {
+      ssize_t n = read(fd, p, size);
+      if (n <= 0)
+         return false;
+      p += n;
+      size -= n;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * WRITE FULLY
+ *************************************************************************/
+static bool writeFully(int fd, const void* buffer, size_t size)
+{
+   const char* p = static_cast<const char*>(buffer);
+   while (size > 0)
+   {
+      ssize_t n = write(fd, p, size);
+      if (n <= 0)
+         return false;
+      p += n;
+      size -= n;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * BATCH RUNNER : CONSTRUCTOR
+ *************************************************************************/
+BatchRunner::BatchRunner(uint32_t firstSeed, uint32_t count, int controllerId) :
+   firstSeed(firstSeed),
+   count(count),
+   controllerId(controllerId),
+   chunkSize(256),
+   pinWorkers(true),
+   maxAttempts(3),
+   retries(0),
+   failChunk(-1),
+   store(nullptr),
+   archive(nullptr),
+   sobol(false),
+   scramble(0),
+   checkpointInterval(BATCH_CHECKPOINT_INTERVAL),
+   resumed(0)
+{
+}
+
+/*************************************************************************
+ * BATCH RUNNER : RESUME
+ * A checkpoint counts only if it is this run's, every range is whole
+ * chunks, no chunk is in two ranges and the totals cover exactly the
+ * missions in them
+ *************************************************************************/
+void BatchRunner::resume(std::vector<bool>& done, MissionStats& stats)
+{
+   done.assign(numChunks(), false);
+   stats = MissionStats();
+   resumed = 0;
+   lastCheckpoint = std::chrono::steady_clock::now();
+   if (checkpointPath.empty())
+      return;
+   FILE* file = fopen(checkpointPath.c_str(), "rb");
+   if (!file)
+      return;
+
+   BatchCheckpointHeader header;
+   std::vector<BatchCheckpointRange> ranges;
+   bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+             header.magic == BATCH_CHECKPOINT_MAGIC &&
+             header.version == BATCH_CHECKPOINT_VERSION &&
+             header.firstSeed == firstSeed && header.count == count &&
+             header.controllerId == controllerId && header.chunkSize == chunkSize &&
+             header.sobol == (sobol ? 1u : 0u) && header.scramble == (sobol ? scramble : 0u) &&
+             header.numRanges <= numChunks();
+   if (ok)
+   {
+      ranges.resize(header.numRanges);
+      ok = fread(ranges.data(), sizeof(BatchCheckpointRange), ranges.size(), file) ==
+              ranges.size() &&
+           fgetc(file) == EOF;
+   }
+   fclose(file);
+
+   std::vector<bool> loaded(numChunks(), false);
+   uint64_t missions = 0;
+   for (size_t r = 0; ok && r < ranges.size(); r++)
+   {
+      uint32_t begin = ranges[r].firstSeed - firstSeed;
+      uint32_t size = ranges[r].count;
+      ok = begin < count && size > 0 && size <= count - begin && begin % chunkSize == 0 &&
+           (size % chunkSize == 0 || begin + size == count);
+      for (uint32_t chunk = begin / chunkSize; ok && chunk * chunkSize < begin + size; chunk++)
+      {
+         ok = !loaded[chunk];
+         loaded[chunk] = true;
+      }
+      missions += size;
+   }
+   if (!ok || missions != header.stats.missions)
+      return;
+
+   done = loaded;
+   stats = header.stats;
+   resumed = static_cast<uint32_t>(missions);
+}
+
+/*************************************************************************
+ * BATCH RUNNER : CHECKPOINT
+ * One that cannot be written is skipped and the run goes on
+ *************************************************************************/
+void BatchRunner::checkpoint(const std::vector<bool>& done, const MissionStats& stats,
+                             bool force)
+{
+   if (checkpointPath.empty())
+      return;
+   std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+   if (!force && std::chrono::duration<double>(now - lastCheckpoint).count() < checkpointInterval)
+      return;
+   lastCheckpoint = now;
+   writeCheckpoint(done, stats);
+}
+
+/*************************************************************************
+ * BATCH RUNNER : WRITE CHECKPOINT
+ * Runs of finished chunks as seed ranges, written beside the checkpoint
+ * and on the disk before it takes the old one's place
+ *************************************************************************/
+bool BatchRunner::writeCheckpoint(const std::vector<bool>& done, const MissionStats& stats) const
+{
+   std::vector<BatchCheckpointRange> ranges;
+   for (uint32_t chunk = 0; chunk < numChunks(); chunk++)
+   {
+      if (!done[chunk])
+         continue;
+      uint32_t seed = firstSeed + chunk * chunkSize;
+      if (!ranges.empty() && ranges.back().firstSeed + ranges.back().count == seed)
+         ranges.back().count += chunkMissions(chunk);
+      else
+         ranges.push_back(BatchCheckpointRange{ seed, chunkMissions(chunk) });
+   }
+
+   BatchCheckpointHeader header;
+   header.magic = BATCH_CHECKPOINT_MAGIC;
+   header.version = BATCH_CHECKPOINT_VERSION;
+   header.firstSeed = firstSeed;
+   header.count = count;
+   header.controllerId = controllerId;
+   header.chunkSize = chunkSize;
+   header.sobol = sobol ? 1u : 0u;
+   header.scramble = sobol ? scramble : 0u;
+   header.numRanges = static_cast<uint32_t>(ranges.size());
+   header.reserved = 0;
+   header.stats = stats;
+
+   std::string temporary = checkpointPath + ".tmp";
+   FILE* file = fopen(temporary.c_str(), "wb");
+   if (!file)
+      return false;
+   bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(ranges.data(), sizeof(BatchCheckpointRange), ranges.size(), file) ==
+                ranges.size() &&
+             fflush(file) == 0 && fsync(fileno(file)) == 0;
+   ok = fclose(file) == 0 && ok;
+   if (!ok || rename(temporary.c_str(), checkpointPath.c_str()) != 0)
+   {
+      remove(temporary.c_str());
+      return false;
+   }
+
+   // Make the rename itself durable
+   size_t slash = checkpointPath.rfind('/');
+   std::string directory = slash == std::string::npos ? "." :
+                           slash == 0 ? "/" : checkpointPath.substr(0, slash);
+   int dir = ::open(directory.c_str(), O_RDONLY);
+   if (dir >= 0)
+   {
+      fsync(dir);
+      ::close(dir);
+   }
+   return true;
+}
+
+/*************************************************************************
+ * BATCH RUNNER : RUN CHUNK
+ *************************************************************************/
+MissionStats BatchRunner::runChunk(uint32_t chunk,
+                                   std::vector<MissionResult>* results,
+                                   std::vector<uint8_t>* trajectories) const
+{
+   MissionStats stats;
+   std::unique_ptr<Controller> controller = createController(controllerId);
+   if (!controller)
+      return stats;
+
+   uint32_t begin = chunk * chunkSize;
+   uint32_t end = (begin + chunkSize < count) ? begin + chunkSize : count;
+   std::vector<TrajectoryFrame> trajectory;
+   for (uint32_t i = begin; i < end; i++)
+   {
+      uint32_t seed = firstSeed + i;
+      MissionResult result = sobol ?
+         runMission(seed, sobolConditions(seed, scramble), *controller,
+                    trajectories ? &trajectory : nullptr) :
+         runMission(seed, *controller, trajectories ? &trajectory : nullptr);
+      stats.add(result);
+      if (results)
+         results->push_back(result);
+      if (trajectories)
+         TrajectoryArchiveWriter::encode(result.seed, result.controller, trajectory,
+                                         *trajectories);
+   }
+   return stats;
+}
+
+/*************************************************************************
+ * BATCH RUNNER : RUN LOCAL
+ *************************************************************************/
+MissionStats BatchRunner::runLocal()
+{
+   MissionStats stats;
+   std::vector<bool> done;
+   std::vector<MissionResult> results;
+   std::vector<uint8_t> trajectories;
+   resume(done, stats);
+   if (store)
+      store->setSampling(sobol ? SAMPLING_SOBOL : SAMPLING_RANDOM, scramble);
+   for (uint32_t chunk = 0; chunk < numChunks(); chunk++)
+   {
+      if (done[chunk])
+         continue;
+      results.clear();
+      trajectories.clear();
+      stats.merge(runChunk(chunk, store ? &results : nullptr,
+                           archive ? &trajectories : nullptr));
+      for (const MissionResult& result : results)
+         store->append(result);
+      if (archive)
+         archive->appendEncoded(trajectories.data(), trajectories.size());
+      done[chunk] = true;
+      checkpoint(done, stats, false);
+   }
+   checkpoint(done, stats, true);
+   return stats;
+}
+
+/*************************************************************************
+ * BATCH RUNNER : WORKER MAIN
+ * Runs in the child. Never returns.
+ *************************************************************************/
+void BatchRunner::workerMain(int writeFd, const std::vector<uint32_t>& chunks,
+                             bool mayFail) const
+{
+   std::vector<MissionResult> results;
+   std::vector<uint8_t> trajectories;
+   for (uint32_t chunk : chunks)
+   {
+      if (mayFail && static_cast<int>(chunk) == failChunk)
+         _exit(3);
+
+      ChunkRecord record;
+      record.chunk = chunk;
+      results.clear();
+      trajectories.clear();
+      record.stats = runChunk(chunk, store ? &results : nullptr,
+                              archive ? &trajectories : nullptr);
+      record.rows = static_cast<uint32_t>(results.size());
+      record.trajectoryBytes = trajectories.size();
+
+      // the coordinator is this pipe's only reader, so a record split
+      // across several writes still arrives in one piece
+      if (!writeFully(writeFd, &record, sizeof(record)) ||
+          !writeFully(writeFd, results.data(), results.size() * sizeof(MissionResult)) ||
+          !writeFully(writeFd, trajectories.data(), trajectories.size()))
+         _exit(2);
+   }
+   _exit(0);
+}
+
+/*************************************************************************
+ * BATCH RUNNER : RUN SHARDED
+ *************************************************************************/
+bool BatchRunner::runSharded(int numWorkers, MissionStats& stats)
+{
+   struct Shard
+   {
+      pid_t pid;
+      std::vector<uint32_t> chunks;   // handed to this worker
+   };
+
+   if (numWorkers < 1)
+      numWorkers = 1;
+
+   std::vector<bool> done;
+   resume(done, stats);
+   if (store)
+      store->setSampling(sobol ? SAMPLING_SOBOL : SAMPLING_RANDOM, scramble);
+   retries = 0;
+
+   // Deal what is left out round-robin, one shard per worker
+   std::deque<std::vector<uint32_t>> waiting(numWorkers);
+   uint32_t dealt = 0;
+   for (uint32_t chunk = 0; chunk < numChunks(); chunk++)
+      if (!done[chunk])
+         waiting[dealt++ % numWorkers].push_back(chunk);
+
+   std::vector<int> attempts(numChunks(), 0);
+   std::map<int, Shard> live;   // by read end of the worker's pipe
+   long numCores = sysconf(_SC_NPROCESSORS_ONLN);
+   int nextCore = 0;
+   std::vector<MissionResult> results;
+   std::vector<uint8_t> trajectories;
+   bool failed = false;
+   bool firstWave = true;
+
+   while (!failed && (!waiting.empty() || !live.empty()))
+   {
+      // Keep every worker slot busy
+      while (!waiting.empty() && static_cast<int>(live.size()) < numWorkers)
+      {
+         std::vector<uint32_t> chunks = waiting.front();
+         waiting.pop_front();
+         if (chunks.empty())
+            continue;
+
+         for (uint32_t chunk : chunks)
+            if (++attempts[chunk] > maxAttempts)
+               failed = true;
+         if (failed)
+            break;
+
+         int fds[2];
+         if (pipe(fds) != 0)
+         {
+            failed = true;
+            break;
+         }
+
+         int core = nextCore++;
+         pid_t pid = fork();
+         if (pid == 0)
+         {
+            close(fds[0]);
+#ifdef __linux__
+            if (pinWorkers && numCores > 0)
+            {
+               cpu_set_t set;
+               CPU_ZERO(&set);
+               CPU_SET(core % numCores, &set);
+               sched_setaffinity(0, sizeof(set), &set);
+            }
+#else
+            (void)core;
+#endif // __linux__
+            workerMain(fds[1], chunks, firstWave);
+         }
+
+         close(fds[1]);
+         if (pid < 0)
+         {
+            close(fds[0]);
+            failed = true;
+            break;
+         }
+         live[fds[0]] = Shard{ pid, chunks };
+      }
+      firstWave = false;
+      if (failed || live.empty())
+         break;
+
+      // Wait for any worker to report
+      std::vector<pollfd> pfds;
+      for (auto& shard : live)
+         pfds.push_back(pollfd{ shard.first, POLLIN, 0 });
+      if (poll(pfds.data(), pfds.size(), -1) < 0)
+         continue;
+
+      for (const pollfd& pfd : pfds)
+      {
+         if (pfd.revents == 0)
+            continue;
+
+         ChunkRecord record;
+         if (readFully(pfd.fd, &record, sizeof(record)) && record.chunk < numChunks())
+         {
+            results.resize(record.rows);
+            trajectories.resize(record.trajectoryBytes);
+            if (readFully(pfd.fd, results.data(), record.rows * sizeof(MissionResult)) &&
+                readFully(pfd.fd, trajectories.data(), trajectories.size()))
+            {
+               if (!done[record.chunk])
+               {
+                  done[record.chunk] = true;
+                  stats.merge(record.stats);
+                  if (store)
+                     for (const MissionResult& result : results)
+                        store->append(result);
+                  if (archive)
+                     archive->appendEncoded(trajectories.data(), trajectories.size());
+                  checkpoint(done, stats, false);
+               }
+               continue;
+            }
+         }
+
+         // End of file: the worker finished or died. Anything it did
+         // not report goes back in line for a new worker.
+         Shard shard = live[pfd.fd];
+         live.erase(pfd.fd);
+         close(pfd.fd);
+         int status = 0;
+         waitpid(shard.pid, &status, 0);
+
+         std::vector<uint32_t> unfinished;
+         for (uint32_t chunk : shard.chunks)
+            if (!done[chunk])
+               unfinished.push_back(chunk);
+         if (!unfinished.empty())
+         {
+            retries += static_cast<int>(unfinished.size());
+            waiting.push_back(unfinished);
+         }
+      }
+   }
+
+   // Don't leave anybody behind if we gave up
+   for (auto& shard : live)
+   {
+      kill(shard.second.pid, SIGKILL);
+      waitpid(shard.second.pid, nullptr, 0);
+      close(shard.first);
+   }
+
+   if (!failed)
+      checkpoint(done, stats, true);
+   return !failed;
+}
@@ -0,0 +1,156 @@
+/***********************************************************************
+ * Header File:
+ *    BATCH RUNNER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Fly a range of seeded missions, either in this process or sharded
+ *    across forked worker processes. Workers stream per-chunk totals
+ *    back through pipes; the coordinator merges them and re-runs any
+ *    chunk whose worker died. Because every mission depends only on its
+ *    seed and the totals are exact, any number of workers gives the
+ *    same answer as one process.
+ *
+ *    A long run can keep a checkpoint: the seed ranges finished so far
+ *    and their totals, rewritten at most every few seconds by writing a
+ *    new file and renaming it over the old, so a crash at any moment
+ *    leaves the last whole one. The same run started again with the
+ *    same checkpoint flies only what is left and still gives the same
+ *    answer.
+ *
+ *    A checkpoint file:
+ *       BatchCheckpointHeader
+ *       BatchCheckpointRange[numRanges]
+ ************************************************************************/
+
+#pragma once
+
+#include "mission.h"
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Forward declaration for unit tests
+class TestBatchRunner;
+class ResultStoreWriter;
+class TrajectoryArchiveWriter;
+
+#define BATCH_CHECKPOINT_MAGIC     0x50434c4cu   // "LLCP"
+#define BATCH_CHECKPOINT_VERSION   1u
+#define BATCH_CHECKPOINT_INTERVAL  5.0           // seconds between writes
+
+// Start of a checkpoint: which run it belongs to and its totals so far
+struct BatchCheckpointHeader
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t firstSeed;
+   uint32_t count;
+   int32_t  controllerId;
+   uint32_t chunkSize;
+   uint32_t sobol;
+   uint32_t scramble;
+   uint32_t numRanges;
+   uint32_t reserved;
+   MissionStats stats;
+};
+
+// Seeds firstSeed to firstSeed + count - 1 are done
+struct BatchCheckpointRange
+{
+   uint32_t firstSeed;
+   uint32_t count;
+};
+
+/*****************************************************
+ * BATCH RUNNER
+ *****************************************************/
+class BatchRunner
+{
+   friend TestBatchRunner;
+
+public:
+   BatchRunner(uint32_t firstSeed, uint32_t count, int controllerId);
+
+   // Missions per unit of work handed to a worker
+   void setChunkSize(uint32_t size) { chunkSize = size > 0 ? size : 1; }
+
+   // Pin worker k to core k (modulo the number of cores) where supported
+   void setPinning(bool pin) { pinWorkers = pin; }
+
+   // Attempts per chunk before the whole run gives up
+   void setMaxAttempts(int attempts) { maxAttempts = attempts > 0 ? attempts : 1; }
+
+   // Also keep every mission's result, not just the totals, and how the
+   // missions were sampled
+   void setResultStore(ResultStoreWriter* store) { this->store = store; }
+
+   // And every frame of every mission. Workers compress their own
+   // trajectories, so the coordinator only copies bytes.
+   void setTrajectoryArchive(TrajectoryArchiveWriter* archive) { this->archive = archive; }
+
+   // Start mission `seed` from point `seed` of a scrambled Sobol sequence
+   // (see sobolConditions()) instead of from rand(). A first seed and
+   // count that are multiples of a power of two take whole nets of it.
+   void setSobol(uint32_t scramble) { sobol = true; this->scramble = scramble; }
+
+   // Keep a checkpoint at path, rewritten at most every interval seconds
+   // and once more at the end. A checkpoint already there from this same
+   // run (same seeds, controller, chunks and sampling) is resumed; any
+   // other is replaced. Results and trajectories are not checkpointed:
+   // a resumed run keeps only those of the missions it flies itself.
+   void setCheckpoint(const std::string& path, double interval = BATCH_CHECKPOINT_INTERVAL)
+   {
+      checkpointPath = path;
+      checkpointInterval = interval;
+   }
+
+   // Missions taken from the checkpoint by the last run
+   uint32_t getResumed() const { return resumed; }
+
+   // Everything in this process
+   MissionStats runLocal();
+
+   // Sharded across numWorkers forked processes. False if some chunk
+   // could not be completed in maxAttempts tries.
+   bool runSharded(int numWorkers, MissionStats& stats);
+
+   // Chunks re-run because their worker died, from the last runSharded()
+   int getRetries() const { return retries; }
+
+private:
+   uint32_t firstSeed;
+   uint32_t count;
+   int controllerId;
+   uint32_t chunkSize;
+   bool pinWorkers;
+   int maxAttempts;
+   int retries;
+   int failChunk;          // unit tests: the first worker to run this chunk dies
+   ResultStoreWriter* store;
+   TrajectoryArchiveWriter* archive;
+   bool sobol;             // missions from Sobol points rather than seeds
+   uint32_t scramble;
+   std::string checkpointPath;   // none if empty
+   double checkpointInterval;
+   std::chrono::steady_clock::time_point lastCheckpoint;
+   uint32_t resumed;
+
+   uint32_t numChunks() const { return (count + chunkSize - 1) / chunkSize; }
+   uint32_t chunkMissions(uint32_t chunk) const
+   {
+      return chunk + 1 < numChunks() ? chunkSize : count - chunk * chunkSize;
+   }
+
+   // Chunks done and their totals from this run's checkpoint, or none
+   void resume(std::vector<bool>& done, MissionStats& stats);
+
+   // Written if the interval has passed since the last, or if forced
+   void checkpoint(const std::vector<bool>& done, const MissionStats& stats, bool force);
+   bool writeCheckpoint(const std::vector<bool>& done, const MissionStats& stats) const;
+
+   MissionStats runChunk(uint32_t chunk, std::vector<MissionResult>* results,
+                         std::vector<uint8_t>* trajectories) const;
+   void workerMain(int writeFd, const std::vector<uint32_t>& chunks, bool mayFail) const;
+};
@@ -0,0 +1,101 @@
+/***********************************************************************
+ * Source File:
+ *    CONTROLLER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Something that flies a lander
+ ************************************************************************/
+
+#include "controller.h"
+#include "thrust.h"
+#include "guidance.h"
+#include <cmath>      // for atan2, sin, cos
+#include <algorithm>  // for std::max, std::min
+
+/*************************************************************************
+ * HIGHEST GROUND
+ * The tallest terrain between two x coordinates
+ *************************************************************************/
+static double highestGround(const Ground& ground, double x1, double x2)
+{
+   if (x1 > x2)
+      std::swap(x1, x2);
+
+   double highest = ground.getElevationMeters(Position(x2, 0.0));
+   for (double x = x1; x < x2; x += 2.0)
+      highest = std::max(highest, ground.getElevationMeters(Position(x, 0.0)));
+   return highest;
+}
+
+/*************************************************************************
+ * CONTROLLER : DECIDE ALL
+ *************************************************************************/
+void Controller::decideAll(const Lander* const* landers, int count,
+                           const Ground& ground, unsigned char* bits)
+{
+   for (int i = 0; i < count; i++)
+      bits[i] = decide(*landers[i], ground);
+}
+
+/*************************************************************************
+ * SIMPLE AUTOPILOT : DECIDE
+ *************************************************************************/
+unsigned char SimpleAutopilot::decide(const Lander& lander, const Ground& ground)
+{
+   Position pos = lander.getPosition();
+   Velocity v = lander.getVelocity();
+   double offset = ground.getPlatformPosition().getX() - pos.getX();
+   bool overPlatform = std::fabs(offset) < ground.getPlatformWidth() / 2.0 - lander.getWidth() / 2.0;
+
+   // Over the platform only the platform matters; otherwise we must
+   // clear every peak between here and there
+   double clearance = overPlatform ?
+      pos.getY() - ground.getPlatformPosition().getY() :
+      pos.getY() - highestGround(ground, pos.getX() - lander.getWidth() / 2.0,
+                                 ground.getPlatformPosition().getX());
+
+   // The angle is never normalized, so bring it to (-PI, PI]
+   double radians = lander.getAngle().getRadians();
+   double angle = atan2(sin(radians), cos(radians));
+
+   // Horizontal: drift toward the platform, slowing down as we arrive.
+   // A main-engine burn pushes toward -sin(angle), so tilt the other way.
+   double dxWanted = std::max(-6.0, std::min(6.0, offset * 0.05));
+   double tilt = std::max(-0.4, std::min(0.4, (dxWanted - v.getDX()) * 0.15));
+   double angleWanted = (overPlatform && clearance < 15.0) ? 0.0 : -tilt;
+
+   // Vertical: the closer to the ground, the slower we may fall. Stay
+   // above the peaks until we are over the platform.
+   double dyWanted = -std::min(12.0, 1.0 + clearance * 0.05);
+   if (!overPlatform && clearance < 40.0)
+      dyWanted = (clearance < 20.0) ? 2.0 : 0.0;
+
+   unsigned char bits = 0;
+   if (angle > angleWanted + 0.05)
+      bits |= THRUST_BIT_CLOCK;
+   else if (angle < angleWanted - 0.05)
+      bits |= THRUST_BIT_COUNTER;
+
+   if (v.getDY() < dyWanted && std::fabs(angle) < M_PI_2)
+      bits |= THRUST_BIT_MAIN;
+
+   return bits;
+}
+
+/*************************************************************************
+ * CREATE CONTROLLER
+ *************************************************************************/
+std::unique_ptr<Controller> createController(int id)
+{
+   switch (id)
+   {
+      case CONTROLLER_NONE:
+         return std::unique_ptr<Controller>(new FreeFall);
+      case CONTROLLER_SIMPLE:
+         return std::unique_ptr<Controller>(new SimpleAutopilot);
+      case CONTROLLER_GUIDANCE:
+         return std::unique_ptr<Controller>(new GuidanceAutopilot);
+   }
+   return nullptr;
+}
@@ -0,0 +1,91 @@
+/***********************************************************************
+ * Header File:
+ *    CONTROLLER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Something that flies a lander: every frame it looks at the lander
+ *    and the ground and decides which thrusters to fire
+ ************************************************************************/
+
+#pragma once
+
+#include "lander.h"
+#include "ground.h"
+#include <functional>
+#include <memory>
+#include <stdint.h>
+
+// Controllers the batch tools know by number
+enum ControllerId
+{
+   CONTROLLER_NONE   = 0,   // never fires anything
+   CONTROLLER_SIMPLE = 1,   // SimpleAutopilot
+   CONTROLLER_PLUGIN = 2,   // PluginController, loaded at run time
+   CONTROLLER_SCRIPT = 3,   // ScriptController
+   CONTROLLER_POLICY = 4,   // PolicyController, weights from a file
+   CONTROLLER_GUIDANCE = 5  // GuidanceAutopilot
+};
+
+/*****************************************************
+ * CONTROLLER
+ * Decide which thrusters to fire this frame
+ *****************************************************/
+class Controller
+{
+public:
+   virtual ~Controller() {}
+
+   // Which ControllerId this is, recorded with every result
+   virtual int getId() const = 0;
+
+   // A new mission is about to start
+   virtual void start(uint32_t /*seed*/) {}
+
+   // ThrustBits to fire this frame
+   virtual unsigned char decide(const Lander& lander, const Ground& ground) = 0;
+
+   // ThrustBits for many landers over one ground. One at a time unless
+   // the controller can do better with the whole batch.
+   virtual void decideAll(const Lander* const* landers, int count,
+                          const Ground& ground, unsigned char* bits);
+
+   // A copy, mid-mission, that flies on just as this one would (see
+   // splitting.h). NULL if this controller cannot be copied.
+   virtual std::unique_ptr<Controller> clone() const { return nullptr; }
+};
+
+/*****************************************************
+ * FREE FALL
+ * The baseline: hands off the controls
+ *****************************************************/
+class FreeFall : public Controller
+{
+public:
+   int getId() const { return CONTROLLER_NONE; }
+   unsigned char decide(const Lander& /*lander*/, const Ground& /*ground*/) { return 0; }
+   std::unique_ptr<Controller> clone() const { return std::unique_ptr<Controller>(new FreeFall); }
+};
+
+/*****************************************************
+ * SIMPLE AUTOPILOT
+ * Tilt toward the platform, stand up when low, and
+ * burn whenever falling faster than the altitude allows
+ *****************************************************/
+class SimpleAutopilot : public Controller
+{
+public:
+   int getId() const { return CONTROLLER_SIMPLE; }
+   unsigned char decide(const Lander& lander, const Ground& ground);
+   std::unique_ptr<Controller> clone() const
+   {
+      return std::unique_ptr<Controller>(new SimpleAutopilot(*this));
+   }
+};
+
+// A new controller for a ControllerId, or NULL if there is no such controller
+std::unique_ptr<Controller> createController(int id);
+
+// A fresh controller whenever one is wanted, say one for each thread.
+// NULL if there is none.
+typedef std::function<std::unique_ptr<Controller>()> ControllerFactory;
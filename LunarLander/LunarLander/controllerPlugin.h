@@ -0,0 +1,72 @@
+/***********************************************************************
+ * Header File:
+ *    CONTROLLER PLUGIN
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The C interface an autopilot implements to be loaded into the
+ *    simulator at run time. A plugin is a shared object that exports
+ *    one function, lander_plugin(), returning a table of entry points.
+ *    Nothing here depends on the simulator's C++ classes, so a plugin
+ *    can be written in anything that produces a C-callable library.
+ *
+ *    A minimal plugin:
+ *       #include "controllerPlugin.h"
+ *       static uint8_t decide(void* context, const lander_plugin_state* s)
+ *       {
+ *          return s->lander.dy < -3.0 ? LANDER_THRUST_MAIN : 0;
+ *       }
+ *       static const lander_plugin_api api =
+ *          { LANDER_PLUGIN_ABI, "hover", NULL, decide, NULL };
+ *       extern "C" const lander_plugin_api* lander_plugin(void) { return &api; }
+ *
+ *    Build it as a shared object against this header alone:
+ *       c++ -std=c++17 -O2 -shared -fPIC -o hover.so hover.cpp
+ ************************************************************************/
+
+#pragma once
+
+#include "landerApi.h"   // for lander_observation and LANDER_THRUST_*
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped whenever a struct below changes shape
+#define LANDER_PLUGIN_ABI  1
+
+// Everything a plugin sees each frame
+typedef struct lander_plugin_state
+{
+   lander_observation lander;
+   double  padX;        // meters, center of the platform
+   double  padY;        // meters, its elevation
+   double  padWidth;    // meters
+   int32_t frame;       // frames since the mission started
+   int32_t reserved;
+} lander_plugin_state;
+
+// The entry points. create and destroy may be NULL.
+typedef struct lander_plugin_api
+{
+   int32_t abi;                 // LANDER_PLUGIN_ABI
+   const char* name;            // for the leaderboard
+
+   // Per-mission state, created before the first decision of each
+   // mission and destroyed after its last one
+   void* (*create)(uint32_t seed);
+
+   // LANDER_THRUST_* bits for this frame
+   uint8_t (*decide)(void* context, const lander_plugin_state* state);
+
+   void (*destroy)(void* context);
+} lander_plugin_api;
+
+// The one symbol a plugin exports
+typedef const lander_plugin_api* (*lander_plugin_entry)(void);
+#define LANDER_PLUGIN_ENTRY  "lander_plugin"
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,149 @@
+/***********************************************************************
+ * Source File:
+ *    CONVERGENCE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Random against Sobol sampling, replicate by replicate
+ ************************************************************************/
+
+#include "convergence.h"
+#include "controller.h"
+#include "mission.h"
+#include "world.h"    // for World::FRAME_TIME
+#include <cmath>
+#include <atomic>
+#include <thread>
+
+/*************************************************************************
+ * CONVERGENCE ROW : GAIN
+ *************************************************************************/
+double ConvergenceRow::gain(int metric) const
+{
+   double random = error[SAMPLING_RANDOM][metric];
+   double sobol = error[SAMPLING_SOBOL][metric];
+   return random > 0.0 && sobol > 0.0 ? (random * random) / (sobol * sobol) : 0.0;
+}
+
+/*************************************************************************
+ * CONVERGENCE STUDY : CONSTRUCTOR
+ *************************************************************************/
+ConvergenceStudy::ConvergenceStudy(const ControllerFactory& factory, uint32_t missions,
+                                   int replicates) :
+   factory(factory),
+   missions(1),
+   replicates(replicates > 1 ? replicates : 2)
+{
+   while (this->missions * 2 <= missions && this->missions < (1u << 30))
+      this->missions *= 2;
+}
+
+ConvergenceStudy::ConvergenceStudy(int controllerId, uint32_t missions, int replicates) :
+   ConvergenceStudy([controllerId]() { return createController(controllerId); },
+                    missions, replicates)
+{
+}
+
+/*************************************************************************
+ * CONVERGENCE STUDY : REPLICATE
+ * Random replicate r takes seeds after those of replicate r - 1 (never
+ * 0, which rand() treats as 1). Sobol replicate r is the sequence
+ * scrambled with key r.
+ *************************************************************************/
+void ConvergenceStudy::replicate(int sampling, int r, std::vector<double>& totals) const
+{
+   std::unique_ptr<Controller> controller = factory();
+   double sums[NUM_CONVERGENCE_METRICS] = { 0.0, 0.0, 0.0 };
+   uint32_t next = 1;
+   totals.clear();
+   for (uint32_t i = 0; i < missions; i++)
+   {
+      MissionResult result = sampling == SAMPLING_SOBOL ?
+         runMission(i, sobolConditions(i, static_cast<uint32_t>(r)), *controller) :
+         runMission(1 + static_cast<uint32_t>(r) * missions + i, *controller);
+      sums[METRIC_LANDED] += result.outcome == MISSION_LANDED ? 1.0 : 0.0;
+      sums[METRIC_FUEL] += result.fuel;
+      sums[METRIC_FLIGHT_TIME] += result.frames * World::FRAME_TIME;
+      if (i + 1 == next)
+      {
+         totals.insert(totals.end(), sums, sums + NUM_CONVERGENCE_METRICS);
+         next *= 2;
+      }
+   }
+}
+
+/*************************************************************************
+ * CONVERGENCE STUDY : RUN
+ *************************************************************************/
+bool ConvergenceStudy::run(int numThreads)
+{
+   if (!factory())
+      return false;
+
+   // totals[sampling * replicates + r]: the replicate's running totals
+   int jobs = NUM_SAMPLINGS * replicates;
+   std::vector<std::vector<double>> totals(jobs);
+   std::atomic<int> nextJob(0);
+   auto work = [&]()
+   {
+      for (int job = nextJob++; job < jobs; job = nextJob++)
+         replicate(job / replicates, job % replicates, totals[job]);
+   };
+   std::vector<std::thread> threads;
+   for (int t = 1; t < numThreads && t < jobs; t++)
+      threads.emplace_back(work);
+   work();
+   for (std::thread& thread : threads)
+      thread.join();
+
+   rows.clear();
+   for (uint32_t n = 1, k = 0; n <= missions; n *= 2, k++)
+   {
+      ConvergenceRow row;
+      row.missions = n;
+      for (int sampling = 0; sampling < NUM_SAMPLINGS; sampling++)
+         for (int metric = 0; metric < NUM_CONVERGENCE_METRICS; metric++)
+         {
+            auto estimate = [&](int r)
+            {
+               return totals[sampling * replicates + r][k * NUM_CONVERGENCE_METRICS + metric] / n;
+            };
+            double mean = 0.0;
+            for (int r = 0; r < replicates; r++)
+               mean += estimate(r);
+            mean /= replicates;
+            double variance = 0.0;
+            for (int r = 0; r < replicates; r++)
+               variance += (estimate(r) - mean) * (estimate(r) - mean) / (replicates - 1);
+            row.mean[sampling][metric] = mean;
+            row.error[sampling][metric] = sqrt(variance);
+         }
+      rows.push_back(row);
+   }
+   return true;
+}
+
+/*************************************************************************
+ * CONVERGENCE STUDY : ORDER
+ * Least squares through (log n, -log error)
+ *************************************************************************/
+double ConvergenceStudy::order(int sampling, int metric) const
+{
+   double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+   int points = 0;
+   for (const ConvergenceRow& row : rows)
+   {
+      double error = row.error[sampling][metric];
+      if (error <= 0.0)
+         continue;
+      double x = log(static_cast<double>(row.missions));
+      double y = -log(error);
+      sx += x;
+      sy += y;
+      sxx += x * x;
+      sxy += x * y;
+      points++;
+   }
+   double denominator = points * sxx - sx * sx;
+   return points > 1 && denominator > 0.0 ? (points * sxy - sx * sy) / denominator : 0.0;
+}
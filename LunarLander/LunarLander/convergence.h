@@ -0,0 +1,86 @@
+/***********************************************************************
+ * Header File:
+ *    CONVERGENCE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    How fast batch estimates settle down, plain random missions against
+ *    missions whose starting conditions come from a scrambled Sobol
+ *    sequence. Each sampling is run as several independent replicates:
+ *    different seeds for the random missions, different scrambles for
+ *    the Sobol ones. The spread of the replicates' estimates after the
+ *    first 1, 2, 4, ... missions gives each sampling's standard error at
+ *    every size, and so its order of convergence and how many random
+ *    missions one Sobol mission is worth.
+ ************************************************************************/
+
+#pragma once
+
+#include "controller.h"   // for ControllerFactory
+#include "mission.h"      // for Sampling
+#include <stdint.h>
+#include <vector>
+
+// Forward declaration for unit tests
+class TestConvergence;
+
+// What is estimated
+enum ConvergenceMetric
+{
+   METRIC_LANDED,        // landing rate
+   METRIC_FUEL,          // kg left
+   METRIC_FLIGHT_TIME,   // seconds
+   NUM_CONVERGENCE_METRICS
+};
+
+/*****************************************************
+ * CONVERGENCE ROW
+ * Every estimate after the same number of missions
+ *****************************************************/
+struct ConvergenceRow
+{
+   uint32_t missions;                                        // per replicate
+   double mean[NUM_SAMPLINGS][NUM_CONVERGENCE_METRICS];      // over the replicates
+   double error[NUM_SAMPLINGS][NUM_CONVERGENCE_METRICS];     // standard error of one replicate
+
+   // Random missions needed for the error of one Sobol mission: the
+   // ratio of the variances. 0 if either is 0.
+   double gain(int metric) const;
+};
+
+/*****************************************************
+ * CONVERGENCE STUDY
+ *****************************************************/
+class ConvergenceStudy
+{
+   friend TestConvergence;
+
+public:
+   // missions per replicate, rounded down to a power of two so the
+   // Sobol points are whole nets
+   ConvergenceStudy(const ControllerFactory& factory, uint32_t missions, int replicates);
+   ConvergenceStudy(int controllerId, uint32_t missions, int replicates);
+
+   // Every replicate of both samplings, spread over numThreads. False if
+   // the factory makes no controller.
+   bool run(int numThreads);
+
+   uint32_t getMissions() const { return missions; }
+   int getReplicates() const { return replicates; }
+
+   // One row per power of two up to the missions per replicate
+   const std::vector<ConvergenceRow>& getRows() const { return rows; }
+
+   // The slope of log error against log missions, from rows with a
+   // non-zero error: 0.5 for random sampling, more is better
+   double order(int sampling, int metric) const;
+
+private:
+   ControllerFactory factory;
+   uint32_t missions;
+   int replicates;
+   std::vector<ConvergenceRow> rows;
+
+   // Running totals of every metric after each power of two
+   void replicate(int sampling, int r, std::vector<double>& totals) const;
+};
@@ -0,0 +1,231 @@
+/***********************************************************************
+ * Source File:
+ *    DEBRIS
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Pooled crash fragments
+ ************************************************************************/
+
+#include "debris.h"
+#include "ground.h"
+#include "uiDraw.h"
+#include "fastMath.h"  // for simSincos, simSin
+#include <cstdlib>     // for rand()
+#include <cmath>
+
+// A fragment keeps this much of its speed when it bounces...
+static const double DEBRIS_RESTITUTION = 0.35;
+// ...and this much of its sliding speed every time it touches down
+static const double DEBRIS_FRICTION = 0.6;
+// Slower than this, m/s, and it stays down
+static const double DEBRIS_REST_SPEED = 0.5;
+
+/*****************************************************
+ * LANDER SEGMENTS
+ * The lines of ogstream::drawLander(), in the same
+ * coordinates: x across, y up from the feet, turning
+ * about (0, 8)
+ *****************************************************/
+struct Segment
+{
+   double x1, y1, x2, y2;
+   uint8_t color;
+};
+
+static const double PALETTE[5][3] =
+{
+   { 1.0, 1.0, 1.0 },      // legs
+   { 0.8, 0.8, 0.0 },      // gold engine unit
+   { 0.4, 0.4, 0.4 },      // engine and thrusters
+   { 0.7, 0.7, 0.7 },      // habitat
+   { 0.92, 0.92, 0.92 }    // storage units
+};
+
+static const Segment SEGMENTS[] =
+{
+   // landing legs, one line strip
+   { -10, 0, -6, 0, 0 }, { -6, 0, -9, 1, 0 }, { -9, 1, -9, 8, 0 }, { -9, 8, -5, 3, 0 },
+   { -5, 3, -9, 8, 0 }, { -9, 8, -5, 6, 0 }, { -5, 6, 5, 6, 0 }, { 5, 6, 9, 8, 0 },
+   { 9, 8, 5, 3, 0 }, { 5, 3, 9, 8, 0 }, { 9, 8, 9, 1, 0 }, { 9, 1, 6, 0, 0 },
+   { 6, 0, 10, 0, 0 },
+
+   // gold engine unit
+   { -5, 3, -5, 7, 1 }, { -5, 7, 5, 7, 1 }, { 5, 7, 5, 3, 1 }, { 5, 3, -5, 3, 1 },
+
+   // engine
+   { -4, 1, -2, 3, 2 }, { -2, 3, 2, 3, 2 }, { 2, 3, 4, 1, 2 }, { 4, 1, -4, 1, 2 },
+
+   // horizontal thrusters
+   { -8, 12, -8, 11, 2 }, { -8, 11, 8, 11, 2 }, { 8, 11, 9, 12, 2 }, { 9, 12, -8, 12, 2 },
+
+   // main habitat, around the fan
+   { 3, 7, -3, 7, 3 }, { -3, 7, -5, 9, 3 }, { -5, 9, -5, 12, 3 }, { -5, 12, -3, 16, 3 },
+   { -3, 16, 3, 16, 3 }, { 3, 16, 5, 12, 3 }, { 5, 12, 5, 9, 3 }, { 5, 9, 3, 7, 3 },
+
+   // window
+   { 3, 15, 4, 11, 2 }, { 4, 11, 0, 12, 2 }, { 0, 12, 3, 15, 2 },
+
+   // storage units
+   { -1, 7, -5, 10, 4 }, { -5, 10, -5, 12, 4 }, { -5, 12, -1, 12, 4 }, { -1, 12, -1, 7, 4 }
+};
+
+static const int NUM_SEGMENTS = sizeof(SEGMENTS) / sizeof(SEGMENTS[0]);
+
+int DebrisPool::fragmentsPerCrash()
+{
+   return NUM_SEGMENTS;
+}
+
+/*************************************************************************
+ * DEBRIS POOL : CONSTRUCTOR
+ * The only allocation the pool ever makes
+ *************************************************************************/
+DebrisPool::DebrisPool(int capacity) :
+   capacity(capacity > 0 ? capacity : 1),
+   count(0),
+   next(0),
+   x(this->capacity), y(this->capacity),
+   dx(this->capacity), dy(this->capacity),
+   angle(this->capacity), spin(this->capacity),
+   half(this->capacity), awake(this->capacity),
+   color(this->capacity)
+{
+}
+
+/*************************************************************************
+ * DEBRIS POOL : SPAWN
+ * Every segment of the drawing, placed where the drawing would put it,
+ * then thrown outward from the middle of the lander. A full pool gives
+ * up its oldest fragments.
+ *************************************************************************/
+int DebrisPool::spawn(const Position& pos, double landerAngle, const Velocity& v)
+{
+   double sinA, cosA;
+   simSincos(landerAngle, sinA, cosA);
+   double centerX = pos.getX();
+   double centerY = pos.getY() + 8.0;
+
+   for (const Segment& s : SEGMENTS)
+   {
+      // the same rotation as ogstream::rotate()
+      double mx = 0.5 * (s.x1 + s.x2);
+      double my = 0.5 * (s.y1 + s.y2) - 8.0;
+      double ex = s.x2 - s.x1;
+      double ey = s.y2 - s.y1;
+      double wx = mx * cosA - my * sinA;
+      double wy = my * cosA + mx * sinA;
+
+      int i = next;
+      next = (next + 1) % capacity;
+      if (count < capacity)
+         count++;
+
+      x[i] = centerX + wx;
+      y[i] = centerY + wy;
+      angle[i] = atan2(ey * cosA + ex * sinA, ex * cosA - ey * sinA);
+      half[i] = 0.5 * sqrt(ex * ex + ey * ey);
+      color[i] = s.color;
+
+      // outward from the middle, plus some of the lander's own motion
+      double out = sqrt(wx * wx + wy * wy);
+      double speed = 4.0 + rand() % 9;
+      double ox = out > 0.0 ? wx / out : 0.0;
+      double oy = out > 0.0 ? wy / out : 1.0;
+      dx[i] = v.getDX() * 0.4 + ox * speed;
+      dy[i] = -v.getDY() * 0.2 + oy * speed + 3.0;
+      spin[i] = (rand() % 2 ? 1.0 : -1.0) * (1.0 + rand() % 6);
+      awake[i] = 1.0;
+   }
+   return NUM_SEGMENTS;
+}
+
+/*************************************************************************
+ * FLY
+ * One pass over the arrays. No branches: at rest, dx, dy and spin are 0
+ * and awake turns gravity off. The arrays never overlap, which is what
+ * lets the compiler vectorize it.
+ *************************************************************************/
+static void fly(int n, double* __restrict x, double* __restrict y,
+                const double* __restrict dx, double* __restrict dy,
+                double* __restrict angle, const double* __restrict spin,
+                const double* __restrict awake, double gravity, double time)
+{
+   const double drop = 0.5 * gravity * time * time;
+   const double fall = gravity * time;
+   for (int i = 0; i < n; i++)
+   {
+      x[i] += dx[i] * time;
+      y[i] += dy[i] * time + drop * awake[i];
+      dy[i] += fall * awake[i];
+      angle[i] += spin[i] * time;
+   }
+}
+
+/*************************************************************************
+ * DEBRIS POOL : MOVE
+ *************************************************************************/
+void DebrisPool::move(double gravity, double time)
+{
+   fly(count, x.data(), y.data(), dx.data(), dy.data(),
+       angle.data(), spin.data(), awake.data(), gravity, time);
+}
+
+/*************************************************************************
+ * DEBRIS POOL : COLLIDE
+ * The low end of a fragment below the ground bounces it back up,
+ * slower, sliding less and tumbling less each time
+ *************************************************************************/
+void DebrisPool::collide(const Ground& ground)
+{
+   for (int i = 0; i < count; i++)
+   {
+      if (awake[i] == 0.0)
+         continue;
+
+      double reach = fabs(half[i] * simSin(angle[i]));
+      double elevation = ground.getElevationMeters(Position(x[i], y[i]));
+      if (y[i] - reach > elevation)
+         continue;
+
+      y[i] = elevation + reach;
+      if (dy[i] < 0.0)
+         dy[i] = -dy[i] * DEBRIS_RESTITUTION;
+      dx[i] *= DEBRIS_FRICTION;
+      spin[i] *= DEBRIS_FRICTION;
+
+      if (dy[i] < DEBRIS_REST_SPEED && fabs(dx[i]) < DEBRIS_REST_SPEED)
+      {
+         dx[i] = dy[i] = spin[i] = 0.0;
+         awake[i] = 0.0;
+      }
+   }
+}
+
+/*************************************************************************
+ * DEBRIS POOL : NUM MOVING
+ *************************************************************************/
+int DebrisPool::numMoving() const
+{
+   int moving = 0;
+   for (int i = 0; i < count; i++)
+      moving += awake[i] != 0.0 ? 1 : 0;
+   return moving;
+}
+
+/*************************************************************************
+ * DEBRIS POOL : DRAW
+ *************************************************************************/
+void DebrisPool::draw(ogstream& gout) const
+{
+   for (int i = 0; i < count; i++)
+   {
+      double s, c;
+      simSincos(angle[i], s, c);
+      s *= half[i];
+      c *= half[i];
+      const double* rgb = PALETTE[color[i]];
+      gout.drawLine(Position(x[i] - c, y[i] - s), Position(x[i] + c, y[i] + s),
+                    rgb[0], rgb[1], rgb[2]);
+   }
+}
@@ -0,0 +1,74 @@
+/***********************************************************************
+ * Header File:
+ *    DEBRIS
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    What is left of a lander after a crash: one fragment for every
+ *    line of the lander drawing, flung out from where it hit, bouncing
+ *    along the terrain until friction stops it.
+ *
+ *    Fragments live in a pool with a fixed capacity, one array per
+ *    field, all allocated up front. A crash writes a few dozen rows and
+ *    never allocates; when the pool is full the oldest fragments are
+ *    reused. Flight is one straight loop over the arrays that the
+ *    compiler can vectorize; resting fragments ride along as no-ops.
+ ************************************************************************/
+
+#pragma once
+
+#include "position.h"
+#include "velocity.h"
+#include <vector>
+#include <stdint.h>
+
+// Forward declarations
+class Ground;
+class ogstream;
+class TestDebris;
+
+#define DEBRIS_POOL_CAPACITY   4096   // fragments, about a hundred crashes
+
+/*****************************************************
+ * DEBRIS POOL
+ * Every fragment from every crash
+ *****************************************************/
+class DebrisPool
+{
+   friend TestDebris;
+
+public:
+   DebrisPool(int capacity = DEBRIS_POOL_CAPACITY);
+
+   // Break a lander at pos (tilted angle radians, moving at v) into
+   // fragments. Returns how many.
+   int spawn(const Position& pos, double angle, const Velocity& v);
+
+   // Ballistic flight for everything still moving
+   void move(double gravity, double time);
+
+   // Bounce off the terrain, slide, and come to rest
+   void collide(const Ground& ground);
+
+   void draw(ogstream& gout) const;
+   void clear() { count = 0; next = 0; }
+
+   int size() const { return count; }
+   int getCapacity() const { return capacity; }
+   int numMoving() const;
+
+   // Fragments in one crash
+   static int fragmentsPerCrash();
+
+private:
+   int capacity;
+   int count;                       // rows in use, [0, count)
+   int next;                        // the row the next fragment takes
+   std::vector<double> x, y;        // center
+   std::vector<double> dx, dy;
+   std::vector<double> angle;       // of the fragment, radians
+   std::vector<double> spin;        // radians/s
+   std::vector<double> half;        // half the length
+   std::vector<double> awake;       // 1.0 moving, 0.0 at rest
+   std::vector<uint8_t> color;      // into the lander palette
+};
@@ -0,0 +1,379 @@
+/***********************************************************************
+ * Source File:
+ *    DESCENT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    From lunar orbit to touchdown: round-moon RK4 up high, the lab's
+ *    flat-ground physics near the surface
+ ************************************************************************/
+
+#include "descent.h"
+#include "world.h"    // for FRAME_TIME, GRAVITY
+#include "thrust.h"   // for THRUST_BIT_*
+#include <cmath>
+#include <algorithm>  // for std::min, std::max
+
+// The lab's fuel load buys about 300 m/s, and orbit is 1670 m/s. The
+// descent flies the Apollo 11 descent stage instead: the lab engine
+// and starting mass, the real propellant load and specific impulse,
+// and the lander gets lighter (and livelier) as it burns.
+static const double DESCENT_FUEL     = 8248.0;    // kg of propellant
+static const double DESCENT_DRY_MASS = 15103.0 - DESCENT_FUEL;
+static const double DESCENT_THRUST   = 45000.0;   // N, as in Lander
+static const double DESCENT_FLOW     = 45000.0 / (311.0 * 9.80665); // kg/s
+
+/*************************************************************************
+ * DESCENT : CONSTRUCTOR
+ *************************************************************************/
+Descent::Descent(uint32_t seed) :
+   x(0.0), y(0.0), dx(0.0), dy(0.0),
+   angle(0.0),
+   fuel(DESCENT_FUEL),
+   status(PLAYING),
+   phase(DESCENT_ORBIT),
+   time(0.0),
+   frames(0),
+   coastSteps(0),
+   coastStep(10.0),
+   touchdownSpeed(0.0),
+   terrain(seed, 800000.0 + (seed * 2654435761u) % 300000u, 30.0)
+{
+   double r = MOON_RADIUS + DESCENT_ORBIT_ALTITUDE;
+   px = 0.0;
+   py = r;
+   vx = sqrt(MOON_MU / r);
+   vy = 0.0;
+   trackAngle = 0.0;
+}
+
+/*************************************************************************
+ * DESCENT : GET DOWNRANGE / HEIGHT / SPEEDS
+ *************************************************************************/
+double Descent::getDownrange() const
+{
+   return phase == DESCENT_FLAT ? x : MOON_RADIUS * trackAngle;
+}
+
+double Descent::getHeight() const
+{
+   return phase == DESCENT_FLAT ? y : sqrt(px * px + py * py) - MOON_RADIUS;
+}
+
+double Descent::getHorizontalSpeed() const
+{
+   if (phase == DESCENT_FLAT)
+      return dx;
+   double r = sqrt(px * px + py * py);
+   return (vx * py - vy * px) / r;
+}
+
+double Descent::getVerticalSpeed() const
+{
+   if (phase == DESCENT_FLAT)
+      return dy;
+   double r = sqrt(px * px + py * py);
+   return (vx * px + vy * py) / r;
+}
+
+/*************************************************************************
+ * ORBIT ACCELERATION
+ * Central gravity plus thrust held at a fixed angle from local vertical
+ *************************************************************************/
+static void orbitAcceleration(double px, double py, double sinA, double cosA,
+                              double thrust, double& ax, double& ay)
+{
+   double r2 = px * px + py * py;
+   double r = sqrt(r2);
+   double g = -MOON_MU / (r2 * r);
+   double ux = px / r, uy = py / r;      // up
+   double ex = uy, ey = -ux;             // prograde
+   ax = g * px + thrust * (-sinA * ex + cosA * ux);
+   ay = g * py + thrust * (-sinA * ey + cosA * uy);
+}
+
+/*************************************************************************
+ * DESCENT : ORBIT STEP
+ * Classic RK4 over dt seconds
+ *************************************************************************/
+void Descent::orbitStep(double dt, double thrust)
+{
+   double sinA = sin(angle), cosA = cos(angle);
+   double k1x, k1y, k2x, k2y, k3x, k3y, k4x, k4y;
+
+   orbitAcceleration(px, py, sinA, cosA, thrust, k1x, k1y);
+   double p2x = px + 0.5 * dt * vx, p2y = py + 0.5 * dt * vy;
+   double v2x = vx + 0.5 * dt * k1x, v2y = vy + 0.5 * dt * k1y;
+   orbitAcceleration(p2x, p2y, sinA, cosA, thrust, k2x, k2y);
+   double p3x = px + 0.5 * dt * v2x, p3y = py + 0.5 * dt * v2y;
+   double v3x = vx + 0.5 * dt * k2x, v3y = vy + 0.5 * dt * k2y;
+   orbitAcceleration(p3x, p3y, sinA, cosA, thrust, k3x, k3y);
+   double p4x = px + dt * v3x, p4y = py + dt * v3y;
+   double v4x = vx + dt * k3x, v4y = vy + dt * k3y;
+   orbitAcceleration(p4x, p4y, sinA, cosA, thrust, k4x, k4y);
+
+   px += dt / 6.0 * (vx + 2.0 * v2x + 2.0 * v3x + v4x);
+   py += dt / 6.0 * (vy + 2.0 * v2y + 2.0 * v3y + v4y);
+   vx += dt / 6.0 * (k1x + 2.0 * k2x + 2.0 * k3x + k4x);
+   vy += dt / 6.0 * (k1y + 2.0 * k2y + 2.0 * k3y + k4y);
+   updateTrackAngle();
+}
+
+/*************************************************************************
+ * DESCENT : UPDATE TRACK ANGLE
+ * Follow the lander around the moon without ever wrapping
+ *************************************************************************/
+void Descent::updateTrackAngle()
+{
+   trackAngle += remainder(atan2(px, py) - trackAngle, 2.0 * M_PI);
+}
+
+/*************************************************************************
+ * DESCENT : STEP
+ * Thrust at this frame's attitude, then turn, as in Lander::input()
+ *************************************************************************/
+void Descent::step(unsigned char thrustBits)
+{
+   if (status != PLAYING)
+      return;
+
+   const double t = World::FRAME_TIME;
+   double thrust = 0.0;
+   if (fuel > 0.0 && (thrustBits & THRUST_BIT_MAIN))
+   {
+      thrust = DESCENT_THRUST / (DESCENT_DRY_MASS + fuel);
+      fuel = std::max(0.0, fuel - DESCENT_FLOW * t);
+   }
+
+   if (phase == DESCENT_ORBIT)
+      orbitStep(t, thrust);
+   else
+   {
+      double ddx = -sin(angle) * thrust;
+      double ddy = cos(angle) * thrust + World::GRAVITY;
+      x = x + (dx * t) + (0.5 * ddx * t * t);
+      y = y + (dy * t) + (0.5 * ddy * t * t);
+      dx = dx + ddx * t;
+      dy = dy + ddy * t;
+   }
+
+   if (fuel > 0.0 && (thrustBits & THRUST_BIT_CLOCK))
+   {
+      angle += -Lander::THRUST_ATTITUDE.value();
+      fuel = std::max(0.0, fuel - (Lander::FUEL_CONSUMPTION_ATTITUDE * Seconds(t)).value());
+   }
+   if (fuel > 0.0 && (thrustBits & THRUST_BIT_COUNTER))
+   {
+      angle += Lander::THRUST_ATTITUDE.value();
+      fuel = std::max(0.0, fuel - (Lander::FUEL_CONSUMPTION_ATTITUDE * Seconds(t)).value());
+   }
+
+   time += t;
+   frames++;
+   checkTouchdown();
+   checkHandoff();
+}
+
+/*************************************************************************
+ * DESCENT : COAST
+ * Engine off. In orbit: RK4 with step doubling, each step as long as
+ * the position error allows and short enough not to fall through
+ * floorAltitude. On flat ground: plain frames.
+ *************************************************************************/
+double Descent::coast(double seconds, double floorAltitude)
+{
+   double flown = 0.0;
+   while (status == PLAYING && flown < seconds)
+   {
+      double altitude = getAltitude();
+      if (altitude <= floorAltitude)
+         break;
+
+      if (phase == DESCENT_FLAT)
+      {
+         step(0);
+         flown += World::FRAME_TIME;
+         continue;
+      }
+
+      // No further than half way to the floor, falling at least 1 m/s
+      double sink = std::max(1.0, -getVerticalSpeed());
+      double limit = std::max(World::FRAME_TIME, 0.5 * (altitude - floorAltitude) / sink);
+      double dt = std::min(std::min(coastStep, limit), seconds - flown);
+
+      double sx = px, sy = py, svx = vx, svy = vy, sTrack = trackAngle;
+      orbitStep(dt, 0.0);
+      double bx = px, by = py;
+      px = sx; py = sy; vx = svx; vy = svy; trackAngle = sTrack;
+      orbitStep(0.5 * dt, 0.0);
+      orbitStep(0.5 * dt, 0.0);
+      coastSteps++;
+
+      double error = sqrt((px - bx) * (px - bx) + (py - by) * (py - by)) / 15.0;
+      double scale = error > 0.0 ? 0.9 * pow(DESCENT_COAST_TOLERANCE / error, 0.2) : 2.0;
+      if (error > DESCENT_COAST_TOLERANCE && dt > World::FRAME_TIME)
+      {
+         px = sx; py = sy; vx = svx; vy = svy; trackAngle = sTrack;
+         coastStep = std::max(World::FRAME_TIME, dt * std::max(0.2, scale));
+         continue;
+      }
+      if (dt == coastStep)
+         coastStep = std::min(600.0, dt * std::min(2.0, scale));
+
+      flown += dt;
+      time += dt;
+      checkTouchdown();
+   }
+   return flown;
+}
+
+/*************************************************************************
+ * DESCENT : CHECK HANDOFF
+ * Low and slow enough that the ground might as well be flat: the
+ * curvature is worth less than 1% of gravity below 100 m/s
+ *************************************************************************/
+void Descent::checkHandoff()
+{
+   if (phase != DESCENT_ORBIT || status != PLAYING)
+      return;
+   double vh = getHorizontalSpeed();
+   if (getAltitude() >= DESCENT_HANDOFF_ALTITUDE || fabs(vh) >= DESCENT_HANDOFF_SPEED)
+      return;
+
+   double r = sqrt(px * px + py * py);
+   x = MOON_RADIUS * trackAngle;
+   y = r - MOON_RADIUS;
+   dx = vh * MOON_RADIUS / r;     // speed along the ground below
+   dy = getVerticalSpeed();
+   phase = DESCENT_FLAT;
+}
+
+/*************************************************************************
+ * DESCENT : CHECK TOUCHDOWN
+ * The lab spec, as in Lander::checkSafetyLanding(). The attitude is
+ * steered freely, so it may have turned any number of times.
+ *************************************************************************/
+void Descent::checkTouchdown()
+{
+   if (status != PLAYING || getAltitude() > 0.0)
+      return;
+
+   double vh = getHorizontalSpeed(), vr = getVerticalSpeed();
+   touchdownSpeed = sqrt(vh * vh + vr * vr);
+   bool slow = touchdownSpeed < Lander::SAFE_SPEED;
+   bool upright = fabs(remainder(angle, 2.0 * M_PI)) < Lander::SAFE_TILT;
+   if (slow && upright && phase == DESCENT_FLAT && terrain.onPad(x, Lander::WIDTH))
+   {
+      angle = 0.0;
+      status = SAFE;
+   }
+   else
+   {
+      angle = M_PI;
+      status = DEAD;
+   }
+}
+
+/*************************************************************************
+ * DESCENT AUTOPILOT : STEER
+ * Turn toward the attitude that points the engine along (ax, ay) and
+ * burn once roughly there
+ *************************************************************************/
+unsigned char DescentAutopilot::steer(double angle, double ax, double ay, bool burn) const
+{
+   double target = atan2(-ax, ay);
+   double error = remainder(target - angle, 2.0 * M_PI);
+   unsigned char bits = 0;
+   if (error > 0.05)
+      bits |= THRUST_BIT_COUNTER;
+   else if (error < -0.05)
+      bits |= THRUST_BIT_CLOCK;
+   if (burn && fabs(error) < 0.3)
+      bits |= THRUST_BIT_MAIN;
+   return bits;
+}
+
+/*************************************************************************
+ * DESCENT AUTOPILOT : COASTABLE
+ * Braking starts once stopping at the pad takes 70% of the engine.
+ * Until then, coast to 90% of the way to that point.
+ *************************************************************************/
+double DescentAutopilot::coastable(Descent& descent) const
+{
+   if (descent.getPhase() != DESCENT_ORBIT)
+      return 0.0;
+   double thrust = DESCENT_THRUST / (DESCENT_DRY_MASS + descent.getFuel());
+   double vh = descent.getHorizontalSpeed();
+   double toGo = descent.getTerrain().getPadX() - descent.getDownrange();
+   double brakeAt = vh * vh / (2.0 * 0.7 * thrust);
+   if (vh <= 0.0 || toGo <= brakeAt)
+      return 0.0;
+   double seconds = 0.9 * (toGo - brakeAt) / vh;
+   return seconds > 2.0 ? seconds : 0.0;
+}
+
+/*************************************************************************
+ * DESCENT AUTOPILOT : DECIDE
+ *************************************************************************/
+unsigned char DescentAutopilot::decide(Descent& descent)
+{
+   double thrust = DESCENT_THRUST / (DESCENT_DRY_MASS + descent.getFuel());
+   double vh = descent.getHorizontalSpeed();
+   double vr = descent.getVerticalSpeed();
+   double toGo = descent.getTerrain().getPadX() - descent.getDownrange();
+   double altitude = descent.getAltitude();
+
+   if (descent.getPhase() == DESCENT_ORBIT)
+   {
+      double r = MOON_RADIUS + descent.getHeight();
+      double gravity = MOON_MU / (r * r) - vh * vh / r;   // less what the orbit holds up
+      double needed = vh > 0.0 ? vh * vh / (2.0 * std::max(toGo, 1.0)) : 0.0;
+      if (needed < 0.6 * thrust)
+         return steer(descent.getAngle(), -1.0, 0.0, false);
+
+      // Come down to 2 km over the ground by the time the braking is done
+      double left = std::max(10.0, vh / needed);
+      double sink = std::max(-150.0, std::min(0.0, -(altitude - 2000.0) / left));
+      double ay = std::max(0.0, std::min(thrust, gravity + 0.3 * (sink - vr)));
+      double ax = -std::min(needed, sqrt(thrust * thrust - ay * ay));
+      return steer(descent.getAngle(), ax, ay, true);
+   }
+
+   // Flat: hold 200 m over the ground ahead while walking over to the
+   // pad, then settle straight down onto it
+   double x = descent.getDownrange();
+   TerrainStream& terrain = descent.getTerrain();
+   double ground = std::max(terrain.getElevation(x),
+                   std::max(terrain.getElevation(x + vh * 10.0),
+                            terrain.getElevation(x + vh * 20.0)));
+   double clearance = descent.getHeight() - ground;
+   bool overPad = fabs(toGo) < 5.0 && fabs(vh) < 1.0;
+
+   double targetDX = std::max(-40.0, std::min(40.0, 0.05 * toGo));
+   double targetDY = std::max(-15.0, std::min(10.0, 0.1 * (200.0 - clearance)));
+   if (overPad)
+   {
+      targetDX = 0.3 * toGo;
+      targetDY = -std::max(1.0, std::min(40.0, 0.08 * altitude));
+   }
+
+   double ax = std::max(-2.0, std::min(2.0, 0.5 * (targetDX - vh)));
+   if (altitude < 40.0)
+      ax = 0.0;            // upright for touchdown
+   bool burn = vr < targetDY || (fabs(targetDX - vh) > 2.0 && altitude > 40.0);
+   return steer(descent.getAngle(), ax, -World::GRAVITY, burn);
+}
+
+/*************************************************************************
+ * DESCENT AUTOPILOT : FLY
+ *************************************************************************/
+void DescentAutopilot::fly(Descent& descent, long maxFrames)
+{
+   while (descent.isFlying() && descent.getFrames() < maxFrames)
+   {
+      double seconds = coastable(descent);
+      if (seconds > 0.0 && descent.coast(seconds, DESCENT_HANDOFF_ALTITUDE) > 0.0)
+         continue;
+      descent.step(decide(descent));
+   }
+}
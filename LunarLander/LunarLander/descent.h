@@ -0,0 +1,131 @@
+/***********************************************************************
+ * Header File:
+ *    DESCENT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The whole landing, from a 15 km circular lunar orbit to touchdown
+ *    on a pad hundreds of kilometers downrange.
+ *
+ *    Up high the lander falls around a round moon: central gravity in
+ *    moon-centered coordinates, integrated with RK4. Once it is low and
+ *    slow it hands off, for good, to the flat-ground lab physics the
+ *    game uses, with x downrange and y above the datum. Frames without
+ *    thrust can be skipped with coast(), which takes steps as large as
+ *    the error allows; the terrain is a TerrainStream that only makes
+ *    the stretch of ground somebody has looked at.
+ *
+ *    The engine and attitude thrusters are the lab spec, but on a real
+ *    descent stage's propellant load that lightens as it burns (the
+ *    lab's 2268 kg would not slow down from orbit). The attitude is
+ *    measured from the local vertical, as in Lander. The moon does not
+ *    turn underneath.
+ ************************************************************************/
+
+#pragma once
+
+#include "terrainStream.h"
+#include "lander.h"     // for Status and the engine constants
+#include <stdint.h>
+
+// Forward declaration for unit tests
+class TestDescent;
+
+#define MOON_RADIUS              1737400.0      // m, the terrain datum
+#define MOON_MU                  4.9048695e12   // m^3/s^2, surface gravity 1.625
+#define DESCENT_ORBIT_ALTITUDE   15000.0        // m above the datum
+#define DESCENT_HANDOFF_ALTITUDE 3000.0         // m above the ground
+#define DESCENT_HANDOFF_SPEED    100.0          // m/s across the ground
+#define DESCENT_COAST_TOLERANCE  0.01           // m of position error per coast step
+
+enum DescentPhase
+{
+   DESCENT_ORBIT,   // round moon, moon-centered coordinates
+   DESCENT_FLAT     // flat ground, lab physics
+};
+
+/*****************************************************
+ * DESCENT
+ * One lander from orbit to the ground
+ *****************************************************/
+class Descent
+{
+   friend TestDescent;
+
+public:
+   // Circular orbit over downrange 0, the pad somewhere 800-1100 km on
+   Descent(uint32_t seed);
+
+   // One frame (World::FRAME_TIME) with these THRUST_BIT_* bits
+   void step(unsigned char thrustBits);
+
+   // Up to seconds with the engine off, stopping early once the lander
+   // is within floorAltitude of the ground. Returns the seconds flown.
+   double coast(double seconds, double floorAltitude);
+
+   // Where and how fast, in the local frame: downrange along the ground
+   // track, up from the ground or the datum, prograde and upward speeds
+   double getDownrange() const;
+   double getHeight() const;
+   double getAltitude() { return getHeight() - terrain.getElevation(getDownrange()); }
+   double getHorizontalSpeed() const;
+   double getVerticalSpeed() const;
+
+   double getAngle() const { return angle; }
+   double getFuel() const { return fuel; }
+   Status getStatus() const { return status; }
+   bool isFlying() const { return status == PLAYING; }
+   bool isLanded() const { return status == SAFE; }
+   DescentPhase getPhase() const { return phase; }
+   double getTime() const { return time; }
+   long getFrames() const { return frames; }        // step() calls
+   long getCoastSteps() const { return coastSteps; } // integrator steps in coast()
+   double getTouchdownSpeed() const { return touchdownSpeed; }
+   TerrainStream& getTerrain() { return terrain; }
+
+private:
+   // DESCENT_ORBIT: moon-centered, +y through downrange 0, moving +x
+   double px, py, vx, vy;
+   double trackAngle;          // radians around the moon, never wrapped
+
+   // DESCENT_FLAT: x downrange, y above the datum
+   double x, y, dx, dy;
+
+   double angle;               // radians from local vertical, as in Lander
+   double fuel;                // kg
+   Status status;
+   DescentPhase phase;
+   double time;                // seconds since the start
+   long frames;
+   long coastSteps;
+   double coastStep;           // last good coast step, seconds
+   double touchdownSpeed;
+   TerrainStream terrain;
+
+   void orbitStep(double dt, double thrust);
+   void updateTrackAngle();
+   void checkHandoff();
+   void checkTouchdown();
+};
+
+/*****************************************************
+ * DESCENT AUTOPILOT
+ * Coast until it is time to brake, brake with the
+ * engine wide open down to the handoff, then walk
+ * over to the pad and settle onto it
+ *****************************************************/
+class DescentAutopilot
+{
+public:
+   // THRUST_BIT_* bits for this frame
+   unsigned char decide(Descent& descent);
+
+   // Seconds that could be coasted from here, 0 to fly frame by frame
+   double coastable(Descent& descent) const;
+
+   // Fly until down or out of frames, coasting wherever possible
+   void fly(Descent& descent, long maxFrames);
+
+private:
+   unsigned char steer(double angle, double ax, double ay, bool burn) const;
+};
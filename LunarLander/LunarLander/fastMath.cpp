@@ -0,0 +1,164 @@
+/***********************************************************************
+ * Source File:
+ *    FAST MATH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Array versions of the polynomial sin and cos. Every lane does
+ *    exactly what fastSincos() does, without branches: the quadrant
+ *    comes out of the low bits of the rounded multiple of PI/2 and
+ *    picks the polynomial and the signs with masks.
+ ************************************************************************/
+
+#include "fastMath.h"
+
+// Adding 1.5 * 2^52 rounds to the nearest integer and leaves it in the
+// low bits of the mantissa, which is where the quadrant comes from
+static const double TRIG_ROUND = 6755399441055744.0;
+
+#if defined(__AVX2__)
+
+/*************************************************************************
+ * SINCOS 4
+ * Four lanes with AVX2
+ *************************************************************************/
+static inline void sincos4(__m256d x, __m256d& s, __m256d& c)
+{
+   __m256d shifted = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(TRIG_TWO_OVER_PI)),
+                                   _mm256_set1_pd(TRIG_ROUND));
+   __m256d k = _mm256_sub_pd(shifted, _mm256_set1_pd(TRIG_ROUND));
+   __m256i q = _mm256_and_si256(_mm256_castpd_si256(shifted), _mm256_set1_epi64x(3));
+
+   __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(TRIG_PIO2_1)));
+   r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(TRIG_PIO2_2)));
+   r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(TRIG_PIO2_2T)));
+   __m256d z = _mm256_mul_pd(r, r);
+
+   __m256d ps = _mm256_set1_pd(TRIG_S6);
+   ps = _mm256_add_pd(_mm256_mul_pd(ps, z), _mm256_set1_pd(TRIG_S5));
+   ps = _mm256_add_pd(_mm256_mul_pd(ps, z), _mm256_set1_pd(TRIG_S4));
+   ps = _mm256_add_pd(_mm256_mul_pd(ps, z), _mm256_set1_pd(TRIG_S3));
+   ps = _mm256_add_pd(_mm256_mul_pd(ps, z), _mm256_set1_pd(TRIG_S2));
+   ps = _mm256_add_pd(_mm256_mul_pd(ps, z), _mm256_set1_pd(TRIG_S1));
+   ps = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, z), ps));
+
+   __m256d pc = _mm256_set1_pd(TRIG_C6);
+   pc = _mm256_add_pd(_mm256_mul_pd(pc, z), _mm256_set1_pd(TRIG_C5));
+   pc = _mm256_add_pd(_mm256_mul_pd(pc, z), _mm256_set1_pd(TRIG_C4));
+   pc = _mm256_add_pd(_mm256_mul_pd(pc, z), _mm256_set1_pd(TRIG_C3));
+   pc = _mm256_add_pd(_mm256_mul_pd(pc, z), _mm256_set1_pd(TRIG_C2));
+   pc = _mm256_add_pd(_mm256_mul_pd(pc, z), _mm256_set1_pd(TRIG_C1));
+   pc = _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(0.5), z)),
+                      _mm256_mul_pd(_mm256_mul_pd(z, z), pc));
+
+   // odd quadrants swap sin and cos; bit 1 negates sin, bit 0 ^ bit 1 negates cos
+   __m256d swap = _mm256_castsi256_pd(_mm256_sub_epi64(_mm256_setzero_si256(),
+                                      _mm256_and_si256(q, _mm256_set1_epi64x(1))));
+   __m256d sinSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_srli_epi64(q, 1), 63));
+   __m256d cosSign = _mm256_castsi256_pd(_mm256_slli_epi64(
+      _mm256_xor_si256(q, _mm256_srli_epi64(q, 1)), 63));
+
+   s = _mm256_xor_pd(_mm256_blendv_pd(ps, pc, swap), sinSign);
+   c = _mm256_xor_pd(_mm256_blendv_pd(pc, ps, swap), cosSign);
+}
+
+#define TRIG_LANES 4
+#define TRIG_VECTOR __m256d
+#define TRIG_LOAD _mm256_loadu_pd
+#define TRIG_STORE _mm256_storeu_pd
+#define TRIG_SINCOS sincos4
+#define TRIG_IN_RANGE(v) (_mm256_movemask_pd(_mm256_cmp_pd( \
+   _mm256_andnot_pd(_mm256_set1_pd(-0.0), v), \
+   _mm256_set1_pd(FAST_TRIG_MAX_ARGUMENT), _CMP_LT_OQ)) == 0xf)
+
+#elif defined(__SSE2__)
+
+/*************************************************************************
+ * SINCOS 2
+ * Two lanes with SSE2
+ *************************************************************************/
+static inline void sincos2(__m128d x, __m128d& s, __m128d& c)
+{
+   __m128d shifted = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(TRIG_TWO_OVER_PI)),
+                                _mm_set1_pd(TRIG_ROUND));
+   __m128d k = _mm_sub_pd(shifted, _mm_set1_pd(TRIG_ROUND));
+   __m128i q = _mm_and_si128(_mm_castpd_si128(shifted), _mm_set1_epi64x(3));
+
+   __m128d r = _mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(TRIG_PIO2_1)));
+   r = _mm_sub_pd(r, _mm_mul_pd(k, _mm_set1_pd(TRIG_PIO2_2)));
+   r = _mm_sub_pd(r, _mm_mul_pd(k, _mm_set1_pd(TRIG_PIO2_2T)));
+   __m128d z = _mm_mul_pd(r, r);
+
+   __m128d ps = _mm_set1_pd(TRIG_S6);
+   ps = _mm_add_pd(_mm_mul_pd(ps, z), _mm_set1_pd(TRIG_S5));
+   ps = _mm_add_pd(_mm_mul_pd(ps, z), _mm_set1_pd(TRIG_S4));
+   ps = _mm_add_pd(_mm_mul_pd(ps, z), _mm_set1_pd(TRIG_S3));
+   ps = _mm_add_pd(_mm_mul_pd(ps, z), _mm_set1_pd(TRIG_S2));
+   ps = _mm_add_pd(_mm_mul_pd(ps, z), _mm_set1_pd(TRIG_S1));
+   ps = _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, z), ps));
+
+   __m128d pc = _mm_set1_pd(TRIG_C6);
+   pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(TRIG_C5));
+   pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(TRIG_C4));
+   pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(TRIG_C3));
+   pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(TRIG_C2));
+   pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(TRIG_C1));
+   pc = _mm_add_pd(_mm_sub_pd(_mm_set1_pd(1.0), _mm_mul_pd(_mm_set1_pd(0.5), z)),
+                   _mm_mul_pd(_mm_mul_pd(z, z), pc));
+
+   // odd quadrants swap sin and cos; bit 1 negates sin, bit 0 ^ bit 1 negates cos
+   __m128d swap = _mm_castsi128_pd(_mm_sub_epi64(_mm_setzero_si128(),
+                                   _mm_and_si128(q, _mm_set1_epi64x(1))));
+   __m128d sinSign = _mm_castsi128_pd(_mm_slli_epi64(_mm_srli_epi64(q, 1), 63));
+   __m128d cosSign = _mm_castsi128_pd(_mm_slli_epi64(_mm_xor_si128(q, _mm_srli_epi64(q, 1)), 63));
+
+   s = _mm_xor_pd(_mm_or_pd(_mm_and_pd(swap, pc), _mm_andnot_pd(swap, ps)), sinSign);
+   c = _mm_xor_pd(_mm_or_pd(_mm_and_pd(swap, ps), _mm_andnot_pd(swap, pc)), cosSign);
+}
+
+#define TRIG_LANES 2
+#define TRIG_VECTOR __m128d
+#define TRIG_LOAD _mm_loadu_pd
+#define TRIG_STORE _mm_storeu_pd
+#define TRIG_SINCOS sincos2
+#define TRIG_IN_RANGE(v) (_mm_movemask_pd(_mm_cmplt_pd( \
+   _mm_andnot_pd(_mm_set1_pd(-0.0), v), _mm_set1_pd(FAST_TRIG_MAX_ARGUMENT))) == 0x3)
+
+#endif
+
+/*************************************************************************
+ * FAST SINCOS ARRAY
+ * A group with any lane out of range (or NaN) goes one at a time
+ *************************************************************************/
+void fastSincosArray(const double* x, double* s, double* c, int n)
+{
+   int i = 0;
+#ifdef TRIG_LANES
+   for (; i + TRIG_LANES <= n; i += TRIG_LANES)
+   {
+      TRIG_VECTOR v = TRIG_LOAD(x + i);
+      if (!TRIG_IN_RANGE(v))
+      {
+         for (int j = i; j < i + TRIG_LANES; j++)
+            fastSincos(x[j], s[j], c[j]);
+         continue;
+      }
+      TRIG_VECTOR vs, vc;
+      TRIG_SINCOS(v, vs, vc);
+      TRIG_STORE(s + i, vs);
+      TRIG_STORE(c + i, vc);
+   }
+#endif // TRIG_LANES
+   for (; i < n; i++)
+      fastSincos(x[i], s[i], c[i]);
+}
+
+/*************************************************************************
+ * FAST SIN ARRAY
+ *************************************************************************/
+void fastSinArray(const double* x, double* s, int n)
+{
+   double c[64];
+   for (int i = 0; i < n; i += 64)
+      fastSincosArray(x + i, s + i, c, n - i < 64 ? n - i : 64);
+}
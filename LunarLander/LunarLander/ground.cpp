@@ -9,7 +9,9 @@
 
 #include "ground.h"
 #include "uiDraw.h"
+#include "fastMath.h"
 #include <cstdlib>
+#include <vector>
 #include <cmath>
 #include <algorithm>
 
@@ -19,6 +21,15 @@ const double Ground::PLATFORM_MIN_WIDTH = 50.0;
 const double Ground::PLATFORM_MAX_WIDTH = 100.0;
 const int Ground::MIN_PLATFORM_DISTANCE = 50;
 
+/*************************************************************************
+ * CHOOSE
+ * What rand() % range would be, from a fraction of the way through it
+ *************************************************************************/
+static int choose(double fraction, int range)
+{
+   return std::max(0, std::min(range - 1, static_cast<int>(fraction * range)));
+}
+
 /*************************************************************************
  * GROUND : CONSTRUCTOR
  * Initialize the lunar surface
@@ -28,7 +39,8 @@ Ground::Ground(const Position& posUpperRight) :
    ground(nullptr),
    groundSize(0),
    platformWidth(0.0),
-   platformHeight(0.0)
+   platformHeight(0.0),
+   highestElevation(0.0)
 {
    reset(posUpperRight);
 }
@@ -50,7 +62,8 @@ Ground::Ground(const Ground& rhs) :
    groundSize(rhs.groundSize),
    platformPosition(rhs.platformPosition),
    platformWidth(rhs.platformWidth),
-   platformHeight(rhs.platformHeight)
+   platformHeight(rhs.platformHeight),
+   highestElevation(rhs.highestElevation)
 {
    copyGround(rhs);
 }
@@ -68,6 +81,7 @@ Ground& Ground::operator=(const Ground& rhs)
       platformPosition = rhs.platformPosition;
       platformWidth = rhs.platformWidth;
       platformHeight = rhs.platformHeight;
+      highestElevation = rhs.highestElevation;
       copyGround(rhs);
    }
    return *this;
@@ -77,13 +91,15 @@ Ground& Ground::operator=(const Ground& rhs)
  * GROUND : RESET
  * Generate new terrain
  *************************************************************************/
-void Ground::reset(const Position& posUpperRight)
+void Ground::reset(const Position& posUpperRight, const TerrainChoices* choices)
 {
    this->posUpperRight = posUpperRight;
    deallocateGround();
-   generateTerrain();
-   generatePlatform();
+   generateTerrain(choices);
+   generatePlatform(choices);
    // REMOVED: smoothTerrain() - to keep jagged edges
+
+   highestElevation = groundSize > 0 ? *std::max_element(ground, ground + groundSize) : 0.0;
 }
 
 /*************************************************************************
@@ -163,7 +179,7 @@ void Ground::draw(ogstream& gout) const
  * GROUND : GENERATE TERRAIN
  * Generate mountainous terrain with moderate, natural jaggedness
  *************************************************************************/
-void Ground::generateTerrain()
+void Ground::generateTerrain(const TerrainChoices* choices)
 {
    groundSize = static_cast<int>(posUpperRight.getX() / 2); // Better balance of detail vs performance
    allocateGround(groundSize);
@@ -172,22 +188,32 @@ void Ground::generateTerrain()
    double baseHeight = screenHeight * 0.25; // Base at 25% screen height
    double maxHeight = screenHeight * 0.6;   // Mountains up to 60% screen height
    
-   // Generate multiple mountain peaks and valleys
+   // The three sine waves for every column in one pass each
+   std::vector<double> phase(3 * groundSize);
+   std::vector<double> wave(3 * groundSize);
    for (int i = 0; i < groundSize; i++)
    {
       double x = static_cast<double>(i) / groundSize; // Normalize to 0-1
-      
+      phase[i] = x * M_PI * 3.0;
+      phase[groundSize + i] = x * M_PI * 7.0;
+      phase[2 * groundSize + i] = x * M_PI * 15.0;
+   }
+   simSinArray(phase.data(), wave.data(), 3 * groundSize);
+
+   // Generate multiple mountain peaks and valleys
+   for (int i = 0; i < groundSize; i++)
+   {
       // Create multiple sine waves for varied terrain
       double terrain = baseHeight;
       
       // Large mountains (primary features)
-      terrain += sin(x * M_PI * 3.0) * (maxHeight - baseHeight) * 0.4;
+      terrain += wave[i] * (maxHeight - baseHeight) * 0.4;
       
       // Medium hills (secondary features)
-      terrain += sin(x * M_PI * 7.0) * (maxHeight - baseHeight) * 0.2;
+      terrain += wave[groundSize + i] * (maxHeight - baseHeight) * 0.2;
       
       // Small variations (detail)
-      terrain += sin(x * M_PI * 15.0) * (maxHeight - baseHeight) * 0.1;
+      terrain += wave[2 * groundSize + i] * (maxHeight - baseHeight) * 0.1;
       
       // Moderate random noise for natural roughness (reduced from previous)
       double noise = (rand() % 30 - 15) * TERRAIN_ROUGHNESS; // Moderate level
@@ -198,20 +224,22 @@ void Ground::generateTerrain()
    }
    
    // Add some dramatic peaks and valleys
-   addTerrainFeatures();
+   addTerrainFeatures(choices);
 }
 
 /*************************************************************************
  * GROUND : GENERATE PLATFORM
  * Create a flat landing area in the varied terrain
  *************************************************************************/
-void Ground::generatePlatform()
+void Ground::generatePlatform(const TerrainChoices* choices)
 {
    if (!ground || groundSize == 0)
       return;
       
-   platformWidth = PLATFORM_MIN_WIDTH +
-                  (rand() % static_cast<int>(PLATFORM_MAX_WIDTH - PLATFORM_MIN_WIDTH));
+   int range = static_cast<int>(PLATFORM_MAX_WIDTH - PLATFORM_MIN_WIDTH);
+   platformWidth = PLATFORM_MIN_WIDTH + (rand() % range);
+   if (choices)
+      platformWidth = PLATFORM_MIN_WIDTH + choose(choices->platformWidth, range);
    
    // Find a good location for the platform (not too high, not too low)
    int bestLocation = groundSize / 2; // Default to middle
@@ -249,18 +277,27 @@ void Ground::generatePlatform()
  * GROUND : ADD TERRAIN FEATURES - PRIVATE
  * Add dramatic peaks and valleys to make terrain more interesting
  *************************************************************************/
-void Ground::addTerrainFeatures()
+void Ground::addTerrainFeatures(const TerrainChoices* choices)
 {
    if (!ground || groundSize == 0)
       return;
       
    int numFeatures = 2 + (rand() % 3); // 2-4 dramatic features
+   if (choices)
+      numFeatures = 2 + choose(choices->features, 3);
    
    for (int f = 0; f < numFeatures; f++)
    {
-      int center = MIN_PLATFORM_DISTANCE + (rand() % (groundSize - 2 * MIN_PLATFORM_DISTANCE));
+      int span = groundSize - 2 * MIN_PLATFORM_DISTANCE;
+      int center = MIN_PLATFORM_DISTANCE + (rand() % span);
       int width = 20 + (rand() % 40); // Feature width
       bool isPeak = (rand() % 2 == 0); // Randomly choose peak or valley
+      if (choices)
+      {
+         center = MIN_PLATFORM_DISTANCE + choose(choices->center[f], span);
+         width = 20 + choose(choices->width[f], 40);
+         isPeak = choices->peak[f] < 0.5;
+      }
       
       double maxHeight = posUpperRight.getY() * 0.6;
       double minHeight = posUpperRight.getY() * 0.05;
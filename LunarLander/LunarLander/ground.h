@@ -14,6 +14,19 @@
 // Forward declarations
 class ogstream;
 
+#define TERRAIN_MAX_FEATURES  4
+
+// What rand() would otherwise choose for a terrain, each a fraction of
+// the way through its range, in [0, 1)
+struct TerrainChoices
+{
+   double features;                       // how many peaks and valleys
+   double center[TERRAIN_MAX_FEATURES];   // where each one is
+   double width[TERRAIN_MAX_FEATURES];
+   double peak[TERRAIN_MAX_FEATURES];     // under 0.5 for a peak
+   double platformWidth;
+};
+
 /*****************************************************
  * GROUND
  * Represents the lunar surface with landing platforms
@@ -33,8 +46,20 @@ public:
    // Assignment operator - FIXED: Added proper assignment
    Ground& operator=(const Ground& rhs);
 
-   // Reset the ground to a new configuration
-   void reset(const Position& posUpperRight);
+   // Reset the ground to a new configuration, making some of the
+   // choices given rather than at random. rand() is called the same
+   // up to the first of them either way.
+   void reset(const Position& posUpperRight, const TerrainChoices* choices = nullptr);
+
+   // The same, then hooks.terrainGenerated() (see simHooks.h). Named
+   // apart so that a TerrainChoices* never binds to Hooks&.
+   template <class Hooks>
+   void resetHooked(const Position& posUpperRight, Hooks& hooks,
+                    const TerrainChoices* choices = nullptr)
+   {
+      reset(posUpperRight, choices);
+      hooks.terrainGenerated(*this);
+   }
 
    // Get the elevation at a specific position
    double getElevationMeters(const Position& pos) const;
@@ -46,6 +71,14 @@ public:
    Position getPlatformPosition() const { return platformPosition; }
    double getPlatformWidth() const { return platformWidth; }
 
+   // The top of the tallest peak, found once per terrain
+   double getHighestElevation() const { return highestElevation; }
+
+   // Raw elevations, for snapshots that outlive the ground
+   const double* getElevations() const { return ground; }
+   int getNumElevations() const { return groundSize; }
+   Position getUpperRight() const { return posUpperRight; }
+
    // Draw the lunar surface
    void draw(ogstream& gout) const;
 
@@ -56,12 +89,13 @@ private:
    Position platformPosition; // Landing platform location
    double platformWidth;     // Width of landing platform
    double platformHeight;    // Height of landing platform
+   double highestElevation;  // Tallest point of the terrain
    
    // Enhanced terrain generation
-   void generateTerrain();
-   void generatePlatform();
+   void generateTerrain(const TerrainChoices* choices);
+   void generatePlatform(const TerrainChoices* choices);
    void smoothTerrain();
-   void addTerrainFeatures();
+   void addTerrainFeatures(const TerrainChoices* choices);
    
    // Helper functions for memory management - FIXED: Added proper helpers
    void allocateGround(int size);
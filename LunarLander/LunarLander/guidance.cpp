@@ -0,0 +1,156 @@
+/***********************************************************************
+ * Source File:
+ *    GUIDANCE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Closed-form polynomial descent guidance flown by pulse width
+ ************************************************************************/
+
+#include "guidance.h"
+#include "thrust.h"
+#include "world.h"    // for World::GRAVITY
+#include <cmath>
+#include <algorithm>  // for std::min, std::max
+
+// What guidance may ask of each axis, m/s^2. The engine gives 2.98
+// against 1.625 of gravity, so this leaves room to tilt and to catch up.
+static const double MAX_SIDEWAYS = 0.8;
+static const double MAX_UP = 0.8;
+static const double MAX_DOWN = 1.2;
+
+// Attitude: the most it may lean, and standing up for the touchdown
+static const double MAX_TILT = 0.5;              // radians
+static const double UPRIGHT_TILT = 0.1;
+static const double UPRIGHT_ALTITUDE = 12.0;     // m above the ground
+static const double ATTITUDE_DEADBAND = 0.05;    // radians, half a thruster step
+
+/*************************************************************************
+ * FIRST ROOT
+ * The smallest positive root of a s^2 + b s + c, HUGE_VAL if none
+ *************************************************************************/
+static double firstRoot(double a, double b, double c)
+{
+   if (fabs(a) < 1e-12)
+   {
+      double s = fabs(b) < 1e-12 ? -1.0 : -c / b;
+      return s > 0.0 ? s : HUGE_VAL;
+   }
+   double discriminant = b * b - 4.0 * a * c;
+   if (discriminant < 0.0)
+      return HUGE_VAL;
+   double q = sqrt(discriminant);
+   double s1 = (-b - q) / (2.0 * a);
+   double s2 = (-b + q) / (2.0 * a);
+   if (s1 > s2)
+      std::swap(s1, s2);
+   return s1 > 0.0 ? s1 : s2 > 0.0 ? s2 : HUGE_VAL;
+}
+
+/*************************************************************************
+ * GUIDANCE AUTOPILOT : TIME TO GO
+ * With s = 1 / T the starting acceleration is 12 dr s^2 - 6 (vT + v) s
+ * + aT, which is aT for a very long T. Shorten T until it first
+ * reaches low or high.
+ *************************************************************************/
+double GuidanceAutopilot::timeToGo(double r, double v, double rT, double vT, double aT,
+                                   double low, double high)
+{
+   double a = 12.0 * (rT - r);
+   double b = -6.0 * (vT + v);
+   double s = std::min(firstRoot(a, b, aT - high), firstRoot(a, b, aT - low));
+   return s == HUGE_VAL ? GUIDANCE_MIN_TIME : std::max(GUIDANCE_MIN_TIME, 1.0 / s);
+}
+
+/*************************************************************************
+ * GUIDANCE AUTOPILOT : GUIDE
+ *************************************************************************/
+GuidanceCommand GuidanceAutopilot::guide(const Lander& lander, const Ground& ground)
+{
+   Position pos = lander.getPosition();
+   Velocity v = lander.getVelocity();
+   Position pad = ground.getPlatformPosition();
+
+   // Over the pad, and slow enough to stay over it, go down to it.
+   // The aim is below the pad by what touchdown speed covers in the
+   // shortest time to go: the law then settles into a steady descent
+   // through the pad rather than a hover just above it. Anywhere else
+   // go to the gate above the pad, clear of every peak.
+   double room = ground.getPlatformWidth() / 2.0 - lander.getWidth() / 2.0;
+   double stopping = v.getDX() * v.getDX() / (2.0 * MAX_SIDEWAYS);
+   bool overPad = fabs(pos.getX() - pad.getX()) + stopping < 0.7 * room;
+   double yTarget = overPad ? pad.getY() - GUIDANCE_TOUCHDOWN_SPEED * GUIDANCE_MIN_TIME :
+                    std::max(pad.getY(), ground.getHighestElevation()) + GUIDANCE_GATE_CLEARANCE;
+   double dyTarget = overPad ? -GUIDANCE_TOUCHDOWN_SPEED : 0.0;
+
+   GuidanceCommand command;
+   command.timeToGo = std::max(
+      timeToGo(pos.getX(), v.getDX(), pad.getX(), 0.0, 0.0, -MAX_SIDEWAYS, MAX_SIDEWAYS),
+      timeToGo(pos.getY(), v.getDY(), yTarget, dyTarget, 0.0, -MAX_DOWN, MAX_UP));
+   command.ddx = acceleration(pos.getX(), v.getDX(), pad.getX(), 0.0, 0.0, command.timeToGo);
+   command.ddy = acceleration(pos.getY(), v.getDY(), yTarget, dyTarget, 0.0, command.timeToGo);
+
+   // The engine has to supply all but gravity. It pushes toward
+   // -sin(angle), cos(angle).
+   double thrustX = command.ddx;
+   double thrustY = command.ddy - World::GRAVITY;
+   double altitude = pos.getY() - ground.getElevationMeters(pos);
+   double maxTilt = altitude < UPRIGHT_ALTITUDE ? UPRIGHT_TILT : MAX_TILT;
+   if (thrustY <= 0.0)
+   {
+      command.angle = 0.0;
+      command.throttle = 0.0;
+   }
+   else
+   {
+      command.angle = std::max(-maxTilt, std::min(maxTilt, atan2(-thrustX, thrustY)));
+      command.throttle = std::min(1.0, hypot(thrustX, thrustY) / Thrust::MAIN_ENGINE.value());
+   }
+   return command;
+}
+
+/*************************************************************************
+ * GUIDANCE AUTOPILOT : PULSE
+ * Turn toward the angle a step at a time. Fire the main engine for the
+ * share of the wanted thrust it would give at the angle we are at,
+ * against a sawtooth carrier one period long.
+ *************************************************************************/
+unsigned char GuidanceAutopilot::pulse(const Lander& lander, const GuidanceCommand& command,
+                                       uint32_t frame)
+{
+   // The angle is never normalized, so bring it to (-PI, PI]
+   double radians = lander.getAngle().getRadians();
+   double angle = atan2(sin(radians), cos(radians));
+
+   unsigned char bits = 0;
+   if (angle > command.angle + ATTITUDE_DEADBAND)
+      bits |= THRUST_BIT_CLOCK;
+   else if (angle < command.angle - ATTITUDE_DEADBAND)
+      bits |= THRUST_BIT_COUNTER;
+
+   double duty = command.throttle * cos(angle - command.angle);
+   double carrier = ((frame % GUIDANCE_PWM_FRAMES) + 0.5) / GUIDANCE_PWM_FRAMES;
+   if (duty > carrier)
+      bits |= THRUST_BIT_MAIN;
+   return bits;
+}
+
+/*************************************************************************
+ * GUIDANCE AUTOPILOT : DECIDE
+ *************************************************************************/
+unsigned char GuidanceAutopilot::decide(const Lander& lander, const Ground& ground)
+{
+   return pulse(lander, guide(lander, ground), frame++);
+}
+
+/*************************************************************************
+ * GUIDANCE AUTOPILOT : DECIDE ALL
+ * Every lander in the same frame of the pulse period
+ *************************************************************************/
+void GuidanceAutopilot::decideAll(const Lander* const* landers, int count,
+                                  const Ground& ground, unsigned char* bits)
+{
+   for (int i = 0; i < count; i++)
+      bits[i] = pulse(*landers[i], guide(*landers[i], ground), frame);
+   frame++;
+}
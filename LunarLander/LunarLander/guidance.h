@@ -0,0 +1,96 @@
+/***********************************************************************
+ * Header File:
+ *    GUIDANCE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    An autopilot on the lines of the Apollo lunar module's descent
+ *    guidance. Every frame it fits, in closed form, the trajectory whose
+ *    acceleration is quadratic in time (so position is quartic) from
+ *    where the lander is to a target position, velocity and
+ *    acceleration, and flies the acceleration that trajectory starts
+ *    with:
+ *
+ *       a = aT - 6 (vT + v) / T + 12 (rT - r) / T^2
+ *
+ *    T, the time to go, is the shortest for which that stays inside
+ *    what the engine can give on each axis: a quadratic in 1 / T, so
+ *    also closed form. The target is a gate above the pad and clear of
+ *    the highest ground until the lander is over the pad and able to
+ *    stop there, then the pad itself at touchdown speed.
+ *
+ *    The acceleration, less gravity, is the thrust wanted: its direction
+ *    is the attitude to hold and its size over the engine's is the
+ *    throttle. The engine is on or off, so the throttle becomes the
+ *    width of a pulse in a period of GUIDANCE_PWM_FRAMES frames.
+ *
+ *    Nothing is remembered about a lander from one frame to the next
+ *    and nothing looks along the ground, so a decision costs the same
+ *    few dozen flops for one lander or a swarm.
+ ************************************************************************/
+
+#pragma once
+
+#include "controller.h"
+
+// Forward declaration for unit tests
+class TestGuidance;
+
+#define GUIDANCE_PWM_FRAMES      5       // frames in one pulse-width period
+#define GUIDANCE_GATE_CLEARANCE  30.0    // m above the highest ground
+#define GUIDANCE_TOUCHDOWN_SPEED 1.0     // m/s down at the pad
+#define GUIDANCE_MIN_TIME        2.0     // s, the shortest time to go
+
+// What one frame of guidance wants
+struct GuidanceCommand
+{
+   double ddx;        // m/s^2, gravity included
+   double ddy;
+   double timeToGo;   // s
+   double angle;      // radians to hold, 0 upright
+   double throttle;   // 0 to 1 of the main engine
+};
+
+/*****************************************************
+ * GUIDANCE AUTOPILOT
+ *****************************************************/
+class GuidanceAutopilot : public Controller
+{
+   friend TestGuidance;
+
+public:
+   GuidanceAutopilot() : frame(0) {}
+
+   // The shortest time to go for which the acceleration along one axis
+   // from r, v to rT, vT, aT stays within [low, high]
+   static double timeToGo(double r, double v, double rT, double vT, double aT,
+                          double low, double high);
+
+   // The acceleration the trajectory starts with
+   static double acceleration(double r, double v, double rT, double vT, double aT,
+                              double timeToGo)
+   {
+      return aT - 6.0 * (vT + v) / timeToGo + 12.0 * (rT - r) / (timeToGo * timeToGo);
+   }
+
+   // What guidance wants for this lander over this ground
+   static GuidanceCommand guide(const Lander& lander, const Ground& ground);
+
+   // The ThrustBits that fly a command in a given frame
+   static unsigned char pulse(const Lander& lander, const GuidanceCommand& command,
+                              uint32_t frame);
+
+   // Controller
+   int getId() const { return CONTROLLER_GUIDANCE; }
+   void start(uint32_t /*seed*/) { frame = 0; }
+   unsigned char decide(const Lander& lander, const Ground& ground);
+   void decideAll(const Lander* const* landers, int count,
+                  const Ground& ground, unsigned char* bits);
+   std::unique_ptr<Controller> clone() const
+   {
+      return std::unique_ptr<Controller>(new GuidanceAutopilot(*this));
+   }
+
+private:
+   uint32_t frame;   // frames since start(), for the pulse period
+};
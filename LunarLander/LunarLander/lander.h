@@ -14,12 +14,17 @@
 #include "acceleration.h"
 #include "angle.h"
 #include "thrust.h"
+#include "units.h"
+#include "simHooks.h"
+#include "fastMath.h"   // for simSincos
 
 // Enhanced status enumeration
 enum Status { PLAYING, SAFE, DEAD };
 
 // Forward declaration for unit tests
 class TestLander;
+struct SimState;
+class Descent;
 
 /****************************************************************
  * LANDER
@@ -29,20 +34,22 @@ class TestLander;
 class Lander
 {
    friend TestLander;
+   friend SimState;   // same physics constants
+   friend Descent;
    
 public:
    Position pos;        // position of the lander - PUBLIC for tests
    Velocity velocity;   // velocity of the lander - PUBLIC for tests
    Angle angle;         // orientation of the lander - PUBLIC for tests
    Status status;       // current game state - PUBLIC for tests
-   double fuel;         // remaining fuel in kg - PUBLIC for tests
+   Kilograms fuel;      // remaining fuel - PUBLIC for tests
 
    // Constructor - need to know something about the board
    Lander(const Position& posUpperRight) :
       status(DEAD),
-      fuel(5000.0),
-      totalMass(15103.0),
-      dryMass(10183.0)
+      fuel(FUEL_CAPACITY),
+      totalMass(15103.0_kg),
+      dryMass(10183.0_kg)
    {
       reset(posUpperRight);
    }
@@ -60,14 +67,15 @@ public:
    Velocity getVelocity() const { return velocity; }
    Angle getAngle() const { return angle; }
    double getSpeed() const { return velocity.getSpeed(); }
-   int getFuel() const { return static_cast<int>(fuel); }
-   int getWidth() const { return 20; }
-   double getMaxSpeed() const { return 4.0; }
+   int getFuel() const { return static_cast<int>(fuel.value()); }
+   Kilograms getFuelMass() const { return fuel; }
+   int getWidth() const { return WIDTH; }
+   double getMaxSpeed() const { return SAFE_SPEED; }
    
    // Enhanced getters for realistic lunar lander
-   double getTotalMass() const { return dryMass + fuel; }
-   double getFuelPercentage() const { return (fuel / 5000.0) * 100.0; }
-   bool isOutOfFuel() const { return fuel <= 0.0; }
+   Kilograms getTotalMass() const { return dryMass + fuel; }
+   double getFuelPercentage() const { return (getFuelMass() / FUEL_CAPACITY).value() * 100.0; }
+   bool isOutOfFuel() const { return fuel <= Kilograms(); }
    
    // Setters for game state
    void land();    // Successful landing
@@ -76,28 +84,136 @@ public:
    // Physics simulation
    void coast(const Acceleration& acceleration, double time);
    Acceleration input(const Thrust& thrust, double gravity);
+
+   // The same, reporting to a hooks policy (see simHooks.h)
+   template <class Hooks>
+   void coast(const Acceleration& acceleration, double time, Hooks& hooks);
+   template <class Hooks>
+   Acceleration input(const Thrust& thrust, double gravity, Hooks& hooks);
    
    // Enhanced physics functions
    void applyGravity(double gravity, double time);
    void applyThrust(const Thrust& thrust, double time);
-   void updateFuel(double fuelConsumption);
+   void updateFuel(Kilograms fuelConsumption);
    
    // Collision detection
    bool checkGroundCollision(double groundY) const;
    bool checkSafetyLanding() const;
 
-private:
-   double totalMass;    // total mass including fuel
-   double dryMass;      // mass without fuel
-   
+   // Lab specification: one frame is a tenth of a second and a full
+   // load is 5000 lbs
+   static constexpr Seconds FRAME_TIME = Seconds(0.1);
+   static constexpr Kilograms FUEL_CAPACITY = 5000.0_lb;
+
+   // Lab specification: a safe touchdown is slower than SAFE_SPEED m/s,
+   // within SAFE_TILT radians (~12 degrees) either side of upright, with
+   // all WIDTH meters of the lander over the platform
+   static constexpr double SAFE_SPEED = 4.0;
+   static constexpr double SAFE_TILT = 0.2;
+   static constexpr int WIDTH = 20;
+
    // Physics constants
-   static const double FUEL_CONSUMPTION_MAIN;      // kg/s for main engine
-   static const double FUEL_CONSUMPTION_ATTITUDE;  // kg/s for attitude thrusters
-   static const double THRUST_MAIN;                // Newtons for main engine
-   static const double THRUST_ATTITUDE;            // radians/s for rotation
+   static constexpr KilogramsPerSecond FUEL_CONSUMPTION_MAIN = KilogramsPerSecond(22.046);
+   static constexpr KilogramsPerSecond FUEL_CONSUMPTION_ATTITUDE = KilogramsPerSecond(2.2046);
+   static constexpr Newtons THRUST_MAIN = Newtons(45000.0);
+   static constexpr Radians THRUST_ATTITUDE = Radians(0.1);   // per frame
+
+private:
+   Kilograms totalMass; // total mass including fuel
+   Kilograms dryMass;   // mass without fuel
    
    // Helper functions
-   void consumeFuel(double amount);
-   bool hasFuelFor(double amount) const;
+   template <class Hooks>
+   void consumeFuel(Kilograms amount, Hooks& hooks);
+   void consumeFuel(Kilograms amount);
+   bool hasFuelFor(Kilograms amount) const;
    void normalizeAngle();
 };
+
+/***********************************************************
+ * LANDER : COAST
+ * Coast for a given amount of time
+ ***********************************************************/
+template <class Hooks>
+void Lander::coast(const Acceleration& acceleration, double time, Hooks& hooks)
+{
+   hooks.beforeStep(*this, time);
+
+   // Apply physics: update position and velocity
+   pos.add(acceleration, velocity, time);
+   velocity.add(acceleration, time);
+
+   hooks.afterStep(*this, time);
+}
+
+/***********************************************************
+ * LANDER : INPUT
+ * Process input and return resulting acceleration
+ * EXACT LAB SPECIFICATION IMPLEMENTATION
+ ***********************************************************/
+template <class Hooks>
+Acceleration Lander::input(const Thrust& thrust, double gravity, Hooks& hooks)
+{
+   Acceleration acceleration;
+   
+   // Always apply gravity (lab spec: 1.625 m/s²)
+   acceleration.setDDY(gravity);
+   
+   // Only process thrust if we have fuel and are flying
+   if (status == PLAYING && fuel > Kilograms())
+   {
+      // Main engine thrust - LAB SPECIFICATION
+      if (thrust.isMain())
+      {
+         // Lab spec: 45,000 N / 15,103 kg = 2.98 m/s²
+         double thrustAcceleration = thrust.mainEngineThrust();
+         
+         // FIXED THRUST PHYSICS: Correct vertical, fix horizontal direction
+         // Vertical (Y) thrust works correctly: up when pointing up
+         // Horizontal (X) thrust was reversed: need to negate X component
+         double sinA, cosA;
+         simSincos(angle.getRadians(), sinA, cosA);
+         double thrustX = -sinA * thrustAcceleration;  // Negated for correct horizontal
+         double thrustY = cosA * thrustAcceleration;   // Correct for vertical
+         
+         acceleration.addDDX(thrustX);
+         acceleration.addDDY(thrustY);
+         
+         consumeFuel(FUEL_CONSUMPTION_MAIN * FRAME_TIME, hooks);
+      }
+      
+      // Attitude control - CORRECTED ROTATION DIRECTIONS
+      if (thrust.isClock())
+      {
+         // RIGHT arrow = clockwise rotation (when viewed from above)
+         // In screen coordinates, this should be NEGATIVE rotation
+         angle.add(-THRUST_ATTITUDE.value());
+         consumeFuel(FUEL_CONSUMPTION_ATTITUDE * FRAME_TIME, hooks);
+      }
+      
+      if (thrust.isCounter())
+      {
+         // LEFT arrow = counter-clockwise rotation (when viewed from above)
+         // In screen coordinates, this should be POSITIVE rotation
+         angle.add(THRUST_ATTITUDE.value());
+         consumeFuel(FUEL_CONSUMPTION_ATTITUDE * FRAME_TIME, hooks);
+      }
+
+      if (thrust.isMain() || thrust.isClock() || thrust.isCounter())
+         hooks.thrustApplied(*this, acceleration);
+   }
+   
+   return acceleration;
+}
+
+/***********************************************************
+ * LANDER : CONSUME FUEL
+ * Private helper to consume fuel, reporting what was burned
+ ***********************************************************/
+template <class Hooks>
+void Lander::consumeFuel(Kilograms amount, Hooks& hooks)
+{
+   Kilograms before = getFuelMass();
+   consumeFuel(amount);
+   hooks.fuelConsumed(*this, before - getFuelMass());
+}
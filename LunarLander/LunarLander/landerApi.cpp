@@ -0,0 +1,112 @@
+/***********************************************************************
+ * Source File:
+ *    LANDER API
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A stable C interface over the headless simulator (see landerApi.h)
+ ************************************************************************/
+
+#include "landerApi.h"
+#include "world.h"
+
+// The opaque handle is simply the world itself
+struct lander_world
+{
+   World world;
+
+   lander_world(const Position& posUpperRight, int numLanders, unsigned int seed) :
+      world(posUpperRight, numLanders, seed) {}
+};
+
+/*************************************************************************
+ * LANDER WORLD CREATE
+ * Nothing may be thrown across the C boundary, so a failure to allocate
+ * the world or any of its parts is NULL
+ *************************************************************************/
+lander_world* lander_world_create(double width, double height,
+                                  int32_t numLanders, uint32_t seed)
+{
+   if (width <= 0.0 || height <= 0.0 || numLanders <= 0)
+      return nullptr;
+
+   try
+   {
+      return new lander_world(Position(width, height), numLanders, seed);
+   }
+   catch (...)
+   {
+      return nullptr;
+   }
+}
+
+/*************************************************************************
+ * LANDER WORLD DESTROY
+ *************************************************************************/
+void lander_world_destroy(lander_world* world)
+{
+   delete world;
+}
+
+/*************************************************************************
+ * LANDER WORLD RESET
+ * New terrain may allocate; if that fails the world is left as it was
+ *************************************************************************/
+void lander_world_reset(lander_world* world, uint32_t seed)
+{
+   if (!world)
+      return;
+
+   try
+   {
+      World fresh = world->world;
+      fresh.reset(seed);
+      world->world = std::move(fresh);
+   }
+   catch (...)
+   {
+   }
+}
+
+/*************************************************************************
+ * LANDER WORLD SIZE
+ *************************************************************************/
+int32_t lander_world_size(const lander_world* world)
+{
+   return world ? world->world.size() : -1;
+}
+
+/*************************************************************************
+ * LANDER BATCH STEP
+ *************************************************************************/
+int32_t lander_batch_step(lander_world* world, const uint8_t* thrust,
+                          int32_t numFrames)
+{
+   if (!world || numFrames < 0)
+      return -1;
+
+   try
+   {
+      World& w = world->world;
+      for (int32_t frame = 0; frame < numFrames && w.numFlying() > 0; frame++)
+         w.step(thrust ? thrust + static_cast<long>(frame) * w.size() : nullptr);
+
+      return w.numFlying();
+   }
+   catch (...)
+   {
+      return -1;
+   }
+}
+
+/*************************************************************************
+ * LANDER BATCH OBSERVE
+ *************************************************************************/
+int32_t lander_batch_observe(const lander_world* world, int32_t first,
+                             int32_t count, lander_observation* out)
+{
+   if (!world || !out || first < 0 || count < 0 || first > world->world.size())
+      return -1;
+
+   return world->world.observe(first, count, out);
+}
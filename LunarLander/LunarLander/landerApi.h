@@ -0,0 +1,89 @@
+/***********************************************************************
+ * Header File:
+ *    LANDER API
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A stable C interface over the headless simulator so that analysis
+ *    tools written in other languages can drive it through their FFI.
+ *    Every call works on a whole batch of landers and reads from or
+ *    writes into caller-provided buffers, so the cost of crossing the
+ *    language boundary is paid once per batch, not per lander per frame.
+ *
+ *    Build as a shared library (no window is ever opened):
+ *       c++ -std=c++17 -O2 -shared -fPIC -o liblander.so \
+ *           landerApi.cpp world.cpp lander.cpp ground.cpp position.cpp \
+ *           velocity.cpp acceleration.cpp angle.cpp spatialHash.cpp \
+ *           fastMath.cpp uiDraw.cpp \
+ *           -lglut -lGLU -lGL
+ *
+ *    TestLanderApi builds the library with exactly this command, so it
+ *    must list every translation unit World pulls in.
+ ************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Opaque handle to a simulation world
+typedef struct lander_world lander_world;
+
+// Thruster bits, one byte per lander per frame
+#define LANDER_THRUST_MAIN     0x01
+#define LANDER_THRUST_CLOCK    0x02
+#define LANDER_THRUST_COUNTER  0x04
+
+// Lander status, same order as the simulator's Status
+#define LANDER_STATUS_PLAYING  0
+#define LANDER_STATUS_SAFE     1
+#define LANDER_STATUS_DEAD     2
+
+// What the caller sees of one lander
+typedef struct lander_observation
+{
+   double  x;          // meters from the left edge
+   double  y;          // meters from the bottom edge
+   double  dx;         // horizontal velocity in m/s
+   double  dy;         // vertical velocity in m/s
+   double  angle;      // radians, 0 = upright
+   double  fuel;       // kg of fuel left
+   double  altitude;   // meters above the terrain below
+   int32_t status;     // LANDER_STATUS_*
+   int32_t reserved;   // keeps the struct a multiple of 8 bytes
+} lander_observation;
+
+// Create a world of numLanders landers over one seeded terrain.
+// Returns NULL on bad arguments or when out of memory.
+lander_world* lander_world_create(double width, double height,
+                                  int32_t numLanders, uint32_t seed);
+
+// Release a world. NULL is ignored.
+void lander_world_destroy(lander_world* world);
+
+// Regenerate the terrain and restart every lander from a seed. When out
+// of memory the world is left as it was.
+void lander_world_reset(lander_world* world, uint32_t seed);
+
+// Number of landers in the world, or -1 for a NULL world
+int32_t lander_world_size(const lander_world* world);
+
+// Advance the whole batch numFrames frames. thrust holds
+// numFrames * size bytes, frame-major (all landers for frame 0, then
+// frame 1, ...), or is NULL for no thrust. Stops early once every
+// lander is down. Returns the number of landers still flying, or -1 on
+// bad arguments or when out of memory.
+int32_t lander_batch_step(lander_world* world, const uint8_t* thrust,
+                          int32_t numFrames);
+
+// Copy count observations starting at lander first into out.
+// Returns the number written, or -1 on bad arguments.
+int32_t lander_batch_observe(const lander_world* world, int32_t first,
+                             int32_t count, lander_observation* out);
+
+#ifdef __cplusplus
+}
+#endif
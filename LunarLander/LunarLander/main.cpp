@@ -12,27 +12,39 @@
 #include "uiDraw.h"
 #include "ground.h"
 #include "lander.h"
+#include "simServer.h"
+#include "sharedControl.h"
+#include "world.h"
+#include "batchRunner.h"
+#include "resultStore.h"
+#include "trajectoryArchive.h"
+#include "controller.h"
+#include "scene.h"
+#include "arena.h"
+#include "sessionLog.h"
+#include "fastMath.h"
+#include "descent.h"
+#include "tournament.h"
+#include "scriptController.h"
+#include "policyController.h"
+#include "convergence.h"
+#include "splitting.h"
+#include "surrogate.h"
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
 
 // For unit tests
 #include "testRunner.h"
 
-/*************************************************************************
- * STAR
- * Represents a twinkling star in space
- ************************************************************************/
-struct Star
-{
-   Position pos;
-   unsigned char phase;
-   
-   Star() : pos(0, 0), phase(0) {}  // Default constructor
-   Star(double x, double y) : pos(x, y), phase(rand() % 256) {}
-   
-   void update() { phase = (phase + 1) % 256; } // Cycle through phases
-};
-
 /*************************************************************************
  * SIMULATOR
  * Main simulator class following Lab specifications
@@ -40,14 +52,17 @@ struct Star
 class Simulator
 {
 public:
-   Simulator(const Position& posUpperRight) :
+   Simulator(const Position& posUpperRight, SessionLog& sessions,
+             const std::string& pilot) :
       posUpperRight(posUpperRight),
       ground(posUpperRight),
-      lander(posUpperRight),
+      landerEntity(scene.createLander(posUpperRight)),
       gameTime(0.0),
       attempts(0),
       successes(0),
-      showInstructions(true)
+      showInstructions(true),
+      sessions(sessions),
+      pilot(pilot)
    {
       generateStars();
    }
@@ -60,10 +75,14 @@ public:
       // Handle input
       handleInput(pUI);
 
+      // Read the controls once; physics and flames both use them
+      Thrust thrust;
+      thrust.set(pUI);
+
       // Update physics if playing
-      if (lander.isFlying())
+      if (lander().isFlying())
       {
-         updatePhysics(pUI);
+         updatePhysics(thrust);
          gameTime += 0.1; // Increment game time (each frame = 1/10th second per lab spec)
       }
 
@@ -71,24 +90,28 @@ public:
       checkCollisions();
 
       // Draw everything
-      drawGame(gout, pUI);
+      drawGame(gout, thrust);
       
       // Draw UI following lab specifications
-      drawInterface(gout, pUI);
+      drawInterface(gout);
    }
 
 private:
    Position posUpperRight;   // Screen dimensions
    Ground ground;           // Lunar surface
-   Lander lander;          // The lunar lander
+   Scene scene;             // Stars, lander, exhaust and debris
+   Entity landerEntity;     // The lunar lander
    double gameTime;        // Current game time
    int attempts;           // Number of landing attempts
    int successes;          // Number of successful landings
    bool showInstructions;  // Show control instructions
+   SessionLog& sessions;   // Every attempt, across runs
+   std::string pilot;      // Who is flying
    
    // Stars for space background (Lab spec: about 50 stars)
    static const int NUM_STARS = 50;
-   Star stars[NUM_STARS];
+
+   Lander& lander() { return scene.getLander(landerEntity); }
 
    /*************************************************************************
     * GENERATE STARS
@@ -96,12 +119,13 @@ private:
     ************************************************************************/
    void generateStars()
    {
+      scene.destroyAll(SPRITE_STAR);
       for (int i = 0; i < NUM_STARS; i++)
       {
          double x = (rand() % static_cast<int>(posUpperRight.getX()));
          double y = (rand() % static_cast<int>(posUpperRight.getY() * 0.7)) +
                    (posUpperRight.getY() * 0.3); // Stars in upper 70% of screen
-         stars[i] = Star(x, y);
+         scene.createStar(Position(x, y), rand() % 256);
       }
    }
 
@@ -114,7 +138,7 @@ private:
       if (pUI->isDown() || pUI->isLeft() || pUI->isRight())
          showInstructions = false;
 
-      if (pUI->isSpace() && !lander.isFlying())
+      if (pUI->isSpace() && !lander().isFlying())
       {
          resetGame();
       }
@@ -125,27 +149,45 @@ private:
     * Each frame = 1/10th second
     * Lunar gravity = 1.625 m/s²
     * Thrust = 45,000 N / 15,103 kg = 2.98 m/s²
-    * Fuel consumption: 10 lbs/s main, 1 lb/s attitude
+    * Fuel consumption: Lander::FUEL_CONSUMPTION_MAIN and _ATTITUDE
     * Rotation: 0.1 radians/frame
     ************************************************************************/
-   void updatePhysics(const Interface* pUI)
+   void updatePhysics(const Thrust& thrust)
    {
-      Thrust thrust;
-      thrust.set(pUI);
-
       // LAB SPECIFICATION: Each frame accounts for 1/10th of a second
-      double timeStep = 0.1;  // Exactly as specified in lab documents
+      double timeStep = Lander::FRAME_TIME.value();
       
       // LAB SPECIFICATION: Lunar gravity = 1.625 m/s²
-      Acceleration acceleration = lander.input(thrust, -1.625);
+      if (thrust.isMain() && !lander().isOutOfFuel())
+         spawnExhaust();
+      scene.fly(thrust, -1.625, timeStep);
+      scene.move(-1.625, timeStep);
+      scene.expire(timeStep);
 
-      // Update lander position and velocity
-      lander.coast(acceleration, timeStep);
-      
       // Update star twinkling
-      for (int i = 0; i < NUM_STARS; i++)
+      scene.twinkle();
+   }
+
+   /*************************************************************************
+    * SPAWN EXHAUST
+    * A few specks blown out of the descent engine, away from the thrust
+    ************************************************************************/
+   void spawnExhaust()
+   {
+      const Lander& l = lander();
+      double radians = l.getAngle().getRadians();
+      double ex, ey;
+      simSincos(radians, ex, ey);
+      ey = -ey;
+      for (int i = 0; i < 2; i++)
       {
-         stars[i].update();
+         double speed = 15.0 + rand() % 10;
+         double spread = (rand() % 100 - 50) / 10.0;
+         Position pos(l.getPosition().getX() + ex * 8.0,
+                      l.getPosition().getY() + ey * 8.0);
+         Velocity v(l.getVelocity().getDX() + ex * speed - ey * spread,
+                    l.getVelocity().getDY() + ey * speed + ex * spread);
+         scene.createParticle(pos, v, 1.0);
       }
    }
 
@@ -157,30 +199,18 @@ private:
     ************************************************************************/
    void checkCollisions()
    {
-      if (!lander.isFlying())
-         return;
-
-      Position landerPos = lander.getPosition();
-      double groundHeight = ground.getElevationMeters(landerPos);
+      // CORRECTED: the collision system uses checkSafetyLanding() which
+      // includes ALL requirements:
+      // 1. Speed < 4.0 m/s
+      // 2. Nearly upright angle (±12 degrees)
+      // 3. Must also be on the landing platform
+      Touchdowns touchdowns = scene.collide(ground);
+      attempts += touchdowns.landed + touchdowns.crashed;
+      successes += touchdowns.landed;
 
-      if (landerPos.getY() <= groundHeight)
-      {
-         attempts++;
-         
-         // CORRECTED: Use checkSafetyLanding() which includes ALL requirements:
-         // 1. Speed < 4.0 m/s
-         // 2. Nearly upright angle (±12 degrees)
-         // 3. Must also be on the landing platform
-         if (lander.checkSafetyLanding() && ground.onPlatform(landerPos, lander.getWidth()))
-         {
-            lander.land();
-            successes++;
-         }
-         else
-         {
-            lander.crash();
-         }
-      }
+      if (touchdowns.landed + touchdowns.crashed > 0)
+         sessions.record(pilot, lander().isLanded(), lander().getSpeed(),
+                         lander().getFuelMass().value(), time(nullptr));
    }
 
    /*************************************************************************
@@ -188,8 +218,10 @@ private:
     ************************************************************************/
    void resetGame()
    {
-      lander.reset(posUpperRight);
+      lander().reset(posUpperRight);
       ground.reset(posUpperRight);
+      scene.destroyAll(SPRITE_PARTICLE);
+      scene.clearDebris();
       generateStars(); // New stars for each mission
       gameTime = 0.0;
       showInstructions = true;
@@ -199,75 +231,72 @@ private:
     * DRAW GAME
     * Draw all game objects in proper order
     ************************************************************************/
-   void drawGame(ogstream& gout, const Interface* pUI)
+   void drawGame(ogstream& gout, const Thrust& thrust)
    {
-      // 1. Draw stars first (background) - Lab spec: about 50 stars
-      for (int i = 0; i < NUM_STARS; i++)
-      {
-         gout.drawStar(stars[i].pos, stars[i].phase);
-      }
-      
-      // 2. Draw lunar surface (filled terrain)
-      ground.draw(gout);
-
-      // 3. Draw lander
-      gout.drawLander(lander.getPosition(), lander.getAngle().getRadians());
-
-      // 4. Draw thrust flames based on current input
-      Thrust currentThrust;
-      currentThrust.set(pUI);
-      
-      gout.drawLanderFlames(lander.getPosition(),
-                           lander.getAngle().getRadians(),
-                           currentThrust.isMain(),      // Main engine flame
-                           currentThrust.isClock(),     // Clockwise thruster
-                           currentThrust.isCounter());  // Counter-clockwise thruster
+      // Stars, lunar surface, lander, then exhaust and debris
+      scene.draw(gout, ground, thrust);
    }
 
    /*************************************************************************
     * DRAW INTERFACE - LAB SPECIFICATION FORMAT
     * Lab spec shows: Fuel: 2272 lbs, Altitude: 35 meters, Speed: 12.91 m/s
     ************************************************************************/
-   void drawInterface(ogstream& gout, const Interface* pUI)
+   void drawInterface(ogstream& gout)
    {
       // Lab specification format for status display
       Position statusPos(10, posUpperRight.getY() - 30);
       gout.setPosition(statusPos);
       
-      // Convert kg to lbs for fuel display (lab spec shows lbs)
-      int fuelLbs = static_cast<int>(lander.getFuel() * 2.20462); // kg to lbs conversion
-      int altitude = static_cast<int>(lander.getPosition().getY() -
-                                     ground.getElevationMeters(lander.getPosition()));
-      double speed = lander.getSpeed();
+      // The lab spec shows pounds
+      int fuelLbs = static_cast<int>(toPounds(lander().getFuelMass()));
+      int altitude = static_cast<int>(lander().getPosition().getY() -
+                                     ground.getElevationMeters(lander().getPosition()));
+      double speed = lander().getSpeed();
       
-      gout << "Fuel: " << fuelLbs << " lbs\n";
-      gout << "Altitude: " << altitude << " meters\n";
-      gout << "Speed: " << static_cast<int>(speed * 100) / 100.0 << " m/s\n";
+      // Rebuilt every frame, so the text lives in the frame arena
+      ArenaVector<char> status{ ArenaAllocator<char>(frameArena()) };
+      status.resize(128);
+      snprintf(status.data(), status.size(),
+               "Fuel: %d lbs\nAltitude: %d meters\nSpeed: %g m/s\n",
+               fuelLbs, altitude, static_cast<int>(speed * 100) / 100.0);
+      gout << status.data();
+
+      // This session and every session before it
+      const PilotStats* history = sessions.getPilot(pilot);
+      gout << "Pilot: " << pilot << " | This session: " << successes << " of "
+           << attempts << " landed";
+      if (history)
+         gout << " | All time: " << history->successes << " of " << history->attempts;
+      gout << "\n";
 
       // Lab specification physics info
-      Thrust debugThrust;
-      debugThrust.set(pUI);
       gout << "\nLAB SPECIFICATION PHYSICS:\n";
       gout << "Frame time: 1/10th second | Lunar gravity: 1.625 m/s²\n";
       gout << "Thrust: 45,000 N | Mass: 15,103 kg | Accel: 2.98 m/s²\n";
-      gout << "Fuel consumption: 10 lbs/s main, 1 lb/s attitude\n";
       gout << "Rotation: 0.1 radians/frame\n";
-      
-      gout << "\nCONTROLS (Lab Specification):\n";
-      gout << "DOWN ARROW  - Main engine thrust (10 lbs fuel/frame)\n";
-      gout << "LEFT ARROW  - Rotate CCW (1 lb fuel/frame)\n";
-      gout << "RIGHT ARROW - Rotate CW (1 lb fuel/frame)\n";
+
+      // Fuel per frame, in the pounds the display uses
+      status.resize(256);
+      snprintf(status.data(), status.size(),
+               "\nCONTROLS (Lab Specification):\n"
+               "DOWN ARROW  - Main engine thrust (%.1f lbs fuel/frame)\n"
+               "LEFT ARROW  - Rotate CCW (%.2f lb fuel/frame)\n"
+               "RIGHT ARROW - Rotate CW (%.2f lb fuel/frame)\n",
+               toPounds(Lander::FUEL_CONSUMPTION_MAIN * Lander::FRAME_TIME),
+               toPounds(Lander::FUEL_CONSUMPTION_ATTITUDE * Lander::FRAME_TIME),
+               toPounds(Lander::FUEL_CONSUMPTION_ATTITUDE * Lander::FRAME_TIME));
+      gout << status.data();
 
       Position statusPos2(10, 100);
       gout.setPosition(statusPos2);
       
-      if (lander.isDead())
+      if (lander().isDead())
       {
          gout << "MISSION FAILED!\n";
          gout << "The Eagle has crashed.\n";
          gout << "Press SPACE to try again.\n";
       }
-      else if (lander.isLanded())
+      else if (lander().isLanded())
       {
          gout << "THE EAGLE HAS LANDED!\n";
          gout << "Successful lunar touchdown!\n";
@@ -283,7 +312,7 @@ private:
       }
 
       // Lab spec warning at low fuel
-      if (lander.getFuelPercentage() < 20.0 && lander.isFlying())
+      if (lander().getFuelPercentage() < 20.0 && lander().isFlying())
       {
          Position warnPos(posUpperRight.getX() / 2 - 100, posUpperRight.getY() / 2);
          gout.setPosition(warnPos);
@@ -292,6 +321,569 @@ private:
    }
 };
 
+/*************************************************************************
+ * REPORT
+ * Summarize a batch run on the console
+ ************************************************************************/
+void report(const MissionStats& stats)
+{
+   std::cout << "Missions:      " << stats.missions << "\n";
+   std::cout << "Landed:        " << stats.landed << " ("
+             << stats.landingRate() * 100.0 << "%)\n";
+   std::cout << "Crashed:       " << stats.crashed << "\n";
+   std::cout << "Timed out:     " << stats.timeouts << "\n";
+   std::cout << "Fuel left:     " << stats.meanFuel() << " kg\n";
+   std::cout << "Touchdown:     " << stats.meanTouchdownSpeed() << " m/s\n";
+   std::cout << "Flight time:   " << stats.meanFlightTime() << " s\n";
+}
+
+/*************************************************************************
+ * SWARM
+ * Many landers over one terrain, each on an autopilot, bumping into each
+ * other. Reports how fast the world steps. With a level of detail
+ * interval, landers high above the ground coast at reduced rate and the
+ * autopilot only flies the ones that are not. It decides for all the
+ * landers it flies in one batch per frame.
+ ************************************************************************/
+int swarm(int numLanders, int maxFrames, unsigned int seed, int lodInterval,
+          Controller& autopilot)
+{
+   World world(Position(MISSION_WIDTH, MISSION_HEIGHT), numLanders, seed);
+   world.setLanderCollisions(true);
+   world.spreadOut();
+   world.setLevelOfDetail(lodInterval, MISSION_HEIGHT * 0.5);
+   std::vector<unsigned char> bits(world.size());
+   std::vector<const Lander*> active;
+   std::vector<int> activeIds;
+   std::vector<unsigned char> activeBits(world.size());
+
+   long landerFrames = 0;
+   long fullRateFrames = 0;
+   auto start = std::chrono::steady_clock::now();
+   while (world.numFlying() > 0 && world.getFrame() < maxFrames)
+   {
+      active.clear();
+      activeIds.clear();
+      for (int i = 0; i < world.size(); i++)
+         if (world.getLander(i).isFlying() && world.isFullRate(i))
+         {
+            active.push_back(&world.getLander(i));
+            activeIds.push_back(i);
+         }
+      autopilot.decideAll(active.data(), static_cast<int>(active.size()),
+                          world.getGround(), activeBits.data());
+      std::fill(bits.begin(), bits.end(), 0);
+      for (size_t n = 0; n < activeIds.size(); n++)
+         bits[activeIds[n]] = activeBits[n];
+      landerFrames += world.numFlying();
+      fullRateFrames += world.numFullRate();
+      world.step(bits.data());
+   }
+   std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+   int landed = 0;
+   for (int i = 0; i < world.size(); i++)
+      landed += world.getLander(i).isLanded() ? 1 : 0;
+   std::cout << "Landers:       " << world.size() << "\n";
+   std::cout << "Frames:        " << world.getFrame() << "\n";
+   std::cout << "Landed:        " << landed << "\n";
+   std::cout << "Still flying:  " << world.numFlying() << "\n";
+   std::cout << "Collisions:    " << world.numCollisions() << "\n";
+   std::cout << "Full rate:     " << 100.0 * fullRateFrames / std::max(landerFrames, 1L)
+             << "% of lander-frames\n";
+   std::cout << "Lander-frames: " << landerFrames / std::max(seconds.count(), 1e-9)
+             << " per second\n";
+   return 0;
+}
+
+/*************************************************************************
+ * DESCENT
+ * Fly count descents from orbit on the descent autopilot
+ ************************************************************************/
+int descent(uint32_t firstSeed, int count)
+{
+   int landed = 0;
+   double fuel = 0.0;
+   double seconds = 0.0;
+   long frames = 0;
+   auto start = std::chrono::steady_clock::now();
+   for (int i = 0; i < count; i++)
+   {
+      Descent d(firstSeed + i);
+      DescentAutopilot autopilot;
+      autopilot.fly(d, MISSION_MAX_FRAMES * 10);
+      landed += d.isLanded() ? 1 : 0;
+      fuel += d.getFuel();
+      seconds += d.getTime();
+      frames += d.getFrames();
+   }
+   std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+   std::cout << "Descents:      " << count << "\n";
+   std::cout << "Landed:        " << landed << "\n";
+   std::cout << "Fuel left:     " << fuel / std::max(count, 1) << " kg\n";
+   std::cout << "Flight time:   " << seconds / std::max(count, 1) << " s\n";
+   std::cout << "Frames:        " << frames / std::max(count, 1) << " stepped, the rest coasted\n";
+   std::cout << "Wall time:     " << wall.count() * 1000.0 / std::max(count, 1) << " ms each\n";
+   return landed == count ? 0 : 1;
+}
+
+/*************************************************************************
+ * LOAD PILOT
+ * A policy from a weights file, otherwise a script compiled from the
+ * file. NULL, having said why, if it is neither.
+ ************************************************************************/
+std::unique_ptr<Controller> loadPilot(const char* path)
+{
+   if (Policy::isPolicyFile(path))
+   {
+      std::unique_ptr<PolicyController> pilot(new PolicyController);
+      if (!pilot->load(path))
+      {
+         std::cerr << pilot->getError() << "\n";
+         return nullptr;
+      }
+      return std::unique_ptr<Controller>(pilot.release());
+   }
+
+   std::ifstream file(path);
+   if (!file)
+   {
+      std::cerr << "Cannot open " << path << "\n";
+      return nullptr;
+   }
+   std::stringstream source;
+   source << file.rdbuf();
+   std::unique_ptr<ScriptController> pilot(new ScriptController);
+   if (!pilot->compile(source.str()))
+   {
+      std::cerr << path << ", " << pilot->getError() << "\n";
+      return nullptr;
+   }
+   return std::unique_ptr<Controller>(pilot.release());
+}
+
+/*************************************************************************
+ * PILOT MISSIONS
+ * Fly count missions on a scripted or learned autopilot
+ ************************************************************************/
+int pilotMissions(const char* path, uint32_t firstSeed, uint32_t count)
+{
+   std::unique_ptr<Controller> pilot = loadPilot(path);
+   if (!pilot)
+      return 1;
+
+   MissionStats stats;
+   auto start = std::chrono::steady_clock::now();
+   for (uint32_t i = 0; i < count; i++)
+      stats.add(runMission(firstSeed + i, *pilot));
+   std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+   report(stats);
+   std::cout << "Wall time:     " << wall.count() * 1000.0 / std::max<uint32_t>(count, 1)
+             << " ms each\n";
+   return 0;
+}
+
+/*************************************************************************
+ * POLICY INIT
+ * Random weights for a policy of the given hidden widths, to start from
+ * or to measure with, and how fast it decides for big batches
+ ************************************************************************/
+int policyInit(const char* path, uint32_t seed, int numHidden, char** widths)
+{
+   std::vector<int> hidden;
+   for (int i = 0; i < numHidden; i++)
+      hidden.push_back(atoi(widths[i]));
+   Policy policy;
+   if (!policy.randomize(hidden, seed) || !policy.save(path))
+   {
+      std::cerr << "Cannot write a policy to " << path
+                << (policy.getError().empty() ? "" : ": " + policy.getError()) << "\n";
+      return 1;
+   }
+
+   const int batch = 4096;
+   std::vector<float> states(batch * POLICY_NUM_INPUTS);
+   for (size_t i = 0; i < states.size(); i++)
+      states[i] = static_cast<float>((i * 7919 % 2001) / 1000.0 - 1.0);
+   std::vector<unsigned char> bits(batch);
+   int rounds = 0;
+   auto start = std::chrono::steady_clock::now();
+   std::chrono::duration<double> wall(0.0);
+   while (wall.count() < 0.5)
+   {
+      policy.decide(states.data(), batch, bits.data());
+      rounds++;
+      wall = std::chrono::steady_clock::now() - start;
+   }
+
+   std::cout << "Layers:        " << policy.numLayers() << "\n";
+   std::cout << "Parameters:    " << policy.numParameters() << "\n";
+   std::cout << "Decisions:     " << rounds * static_cast<double>(batch) / wall.count()
+             << " per second in batches of " << batch << "\n";
+   return 0;
+}
+
+/*************************************************************************
+ * TOURNAMENT
+ * Fly every plugin over the same missions and print the leaderboard
+ ************************************************************************/
+int tournament(uint32_t firstSeed, uint32_t count, int workers,
+               int numPlugins, char** plugins)
+{
+   Tournament t(firstSeed, count);
+   for (int i = 0; i < numPlugins; i++)
+      t.addPlugin(plugins[i]);
+   t.run(workers);
+
+   static const char* statuses[] = { "pending", "done", "bad plugin", "crashed", "timed out" };
+   int place = 1;
+   for (int i : t.ranking())
+   {
+      const EntryResult& r = t.getResult(i);
+      std::cout << place++ << ". " << (r.name[0] ? r.name : plugins[i])
+                << " (" << statuses[r.status] << ")\n";
+      if (r.status != ENTRY_DONE)
+      {
+         std::cout << "   " << r.error;
+         if (r.signal)
+            std::cout << ", signal " << r.signal;
+         std::cout << "\n";
+         continue;
+      }
+      std::cout << "   Landed:      " << r.stats.landed << " of " << r.stats.missions << "\n";
+      std::cout << "   Fuel left:   " << r.stats.meanFuel() << " kg\n";
+      std::cout << "   Decisions:   " << r.counters.calls << " ("
+                << r.counters.overruns << " over budget)\n";
+      std::cout << "   Decide time: "
+                << r.counters.totalNanos / 1000.0 / std::max<uint64_t>(r.counters.calls, 1)
+                << " us mean, " << r.counters.maxNanos / 1000.0 << " us max\n";
+   }
+   return 0;
+}
+
+/*************************************************************************
+ * QUERY
+ * Filter and aggregate a batch result store from the command line,
+ * e.g. --query results outcome=1 fuel>1134 seed=1..5000 mean:speed
+ ************************************************************************/
+int query(int argc, char** argv)
+{
+   ResultStore store;
+   if (!store.open(argv[0]))
+   {
+      std::cerr << "Cannot open result store " << argv[0] << "\n";
+      return 1;
+   }
+
+   std::vector<ResultFilter> filters;
+   std::string aggregate;
+   int column = -1;
+   for (int i = 1; i < argc; i++)
+   {
+      std::string arg = argv[i];
+      size_t colon = arg.find(':');
+      ResultFilter filter;
+      if (colon != std::string::npos)
+      {
+         aggregate = arg.substr(0, colon);
+         column = ResultStore::columnByName(arg.substr(colon + 1));
+      }
+      else if (ResultStore::parseFilter(arg, filter))
+         filters.push_back(filter);
+      else
+      {
+         std::cerr << "Cannot understand " << arg << "\n";
+         return 1;
+      }
+   }
+   if (!aggregate.empty() && (column < 0 ||
+       (aggregate != "sum" && aggregate != "mean" && aggregate != "min" && aggregate != "max")))
+   {
+      std::cerr << "Aggregate must be sum, mean, min or max of a column\n";
+      return 1;
+   }
+
+   ResultAggregate result = store.query(filters, column);
+   std::cout << "Rows:          " << store.getRows() << "\n";
+   std::cout << "Matching:      " << result.count << "\n";
+   if (column >= 0 && result.count > 0)
+   {
+      std::cout << aggregate << " " << ResultStore::columnName(column) << ": "
+                << (aggregate == "sum" ? result.sum :
+                    aggregate == "min" ? result.min :
+                    aggregate == "max" ? result.max : result.mean()) << "\n";
+   }
+   std::cout << "Blocks read:   " << result.blocksScanned << " (skipped "
+             << result.blocksSkipped << ")\n";
+   return 0;
+}
+
+/*************************************************************************
+ * TRAJECTORIES
+ * How well an archive compressed and how fast it decodes, or one
+ * mission's frames as CSV, e.g. --trajectories flights.lta 1 17
+ ************************************************************************/
+int trajectories(const char* path, int numThreads, long seed)
+{
+   TrajectoryArchive archive;
+   if (!archive.open(path))
+   {
+      std::cerr << "Cannot open trajectory archive " << path << "\n";
+      return 1;
+   }
+
+   std::vector<TrajectoryFrame> frames;
+   if (seed >= 0)
+   {
+      for (size_t i = 0; i < archive.getCount(); i++)
+      {
+         if (archive.getTrajectory(i).seed != static_cast<uint32_t>(seed))
+            continue;
+         if (!archive.read(i, frames))
+            break;
+         std::cout << "frame,x,y,dx,dy,angle,fuel,thrust\n";
+         for (size_t f = 0; f < frames.size(); f++)
+            std::cout << f << "," << frames[f].x << "," << frames[f].y << ","
+                      << frames[f].dx << "," << frames[f].dy << ","
+                      << frames[f].angle << "," << frames[f].fuel << ","
+                      << static_cast<int>(frames[f].thrust) << "\n";
+         return 0;
+      }
+      std::cerr << "No readable trajectory for seed " << seed << "\n";
+      return 1;
+   }
+
+   // best of three, so the first touch of the output is not counted
+   bool ok = true;
+   double best = 0.0;
+   for (int run = 0; run < 3; run++)
+   {
+      auto start = std::chrono::steady_clock::now();
+      ok = archive.readAll(frames, numThreads) && ok;
+      std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+      best = run == 0 ? wall.count() : std::min(best, wall.count());
+   }
+   double raw = static_cast<double>(archive.getFrames()) * TRAJECTORY_RAW_BYTES;
+
+   std::cout << "Trajectories:  " << archive.getCount() << "\n";
+   std::cout << "Frames:        " << archive.getFrames() << "\n";
+   std::cout << "Archive:       " << archive.getBytes() << " bytes, "
+             << archive.getBytes() * 8.0 / std::max<uint64_t>(archive.getFrames(), 1)
+             << " bits per frame\n";
+   std::cout << "Compression:   " << raw / archive.getBytes() << "x over raw doubles\n";
+   std::cout << "Decode:        " << archive.getFrames() / best / 1e6
+             << "M frames/s, " << raw / best / 1e9 << " GB/s of doubles on "
+             << numThreads << " threads\n";
+   if (!ok)
+      std::cerr << "Some blocks are corrupt\n";
+   return ok ? 0 : 1;
+}
+
+/*************************************************************************
+ * CONVERGENCE
+ * Standard error against missions flown, random seeds against Sobol
+ * points, for each estimate a batch reports
+ ************************************************************************/
+int convergence(uint32_t missions, int replicates, const char* pilot, int numThreads)
+{
+   // A controller by number, or a script or policy by file
+   char* end = nullptr;
+   long id = strtol(pilot, &end, 10);
+   bool byNumber = *pilot && !*end;
+   ConvergenceStudy study([&]() -> std::unique_ptr<Controller>
+                          {
+                             return byNumber ? createController(static_cast<int>(id)) :
+                                               loadPilot(pilot);
+                          }, missions, replicates);
+   if (!study.run(numThreads))
+   {
+      std::cerr << "No controller " << pilot << "\n";
+      return 1;
+   }
+
+   static const char* names[] = { "Landing rate", "Fuel left (kg)", "Flight time (s)" };
+   const ConvergenceRow& last = study.getRows().back();
+   std::cout << study.getReplicates() << " replicates of up to " << study.getMissions()
+             << " missions each way\n";
+   for (int metric = 0; metric < NUM_CONVERGENCE_METRICS; metric++)
+   {
+      std::cout << "\n" << names[metric] << ": random " << last.mean[SAMPLING_RANDOM][metric]
+                << ", Sobol " << last.mean[SAMPLING_SOBOL][metric] << "\n";
+      std::cout << "   missions    random error    Sobol error    gain\n";
+      for (const ConvergenceRow& row : study.getRows())
+      {
+         char line[96];
+         snprintf(line, sizeof(line), "   %8u    %12.6g    %11.6g    %4.1f\n", row.missions,
+                  row.error[SAMPLING_RANDOM][metric], row.error[SAMPLING_SOBOL][metric],
+                  row.gain(metric));
+         std::cout << line;
+      }
+      std::cout << "   Order: random " << study.order(SAMPLING_RANDOM, metric)
+                << ", Sobol " << study.order(SAMPLING_SOBOL, metric) << "\n";
+   }
+   return 0;
+}
+
+/*************************************************************************
+ * SPLITTING
+ * Failure rate under a disturbance, with its confidence interval, by
+ * multilevel splitting and optionally by plain Monte Carlo as well
+ ************************************************************************/
+int splitting(int particles, int runs, const char* pilot, double disturbance,
+              bool monteCarlo, int numThreads)
+{
+   // A controller by number, or a script or policy by file
+   char* end = nullptr;
+   long id = strtol(pilot, &end, 10);
+   bool byNumber = *pilot && !*end;
+   Splitting estimator([&]() -> std::unique_ptr<Controller>
+                       {
+                          return byNumber ? createController(static_cast<int>(id)) :
+                                            loadPilot(pilot);
+                       }, particles, runs, disturbance);
+
+   auto show = [](const char* name, const SplittingResult& result, double seconds)
+   {
+      std::cout << name << ": " << result.probability << " +/- " << result.error
+                << ", 95% between " << result.lower << " and " << result.upper << "\n";
+      std::cout << "   " << result.frames << " frames in " << seconds << " s";
+      if (result.levels > 0.0)
+         std::cout << ", " << result.levels << " levels per run";
+      std::cout << "\n";
+   };
+
+   auto start = std::chrono::steady_clock::now();
+   if (!estimator.run(numThreads))
+   {
+      std::cerr << "No controller " << pilot << " that can be cloned\n";
+      return 1;
+   }
+   std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+   SplittingResult split = estimator.getResult();
+   std::cout << split.runs << " runs of " << particles << " particles, disturbance "
+             << disturbance << " m/s^2\n";
+   show("Splitting", split, wall.count());
+   if (split.monteCarloMissions() > 0.0)
+      std::cout << "   Plain Monte Carlo needs " << split.monteCarloMissions()
+                << " missions for the same error\n";
+
+   if (monteCarlo)
+   {
+      start = std::chrono::steady_clock::now();
+      estimator.runMonteCarlo(numThreads);
+      wall = std::chrono::steady_clock::now() - start;
+      show("Monte Carlo", estimator.getResult(), wall.count());
+   }
+   return 0;
+}
+
+/*************************************************************************
+ * TRAIN SURROGATE
+ * From a batch's result store and trajectory archive, seeded or Sobol
+ ************************************************************************/
+int trainSurrogate(const char* storePath, const char* archivePath, const char* modelPath)
+{
+   ResultStore store;
+   TrajectoryArchive archive;
+   if (!store.open(storePath) || !archive.open(archivePath))
+   {
+      std::cerr << "Cannot open " << storePath << " and " << archivePath << "\n";
+      return 1;
+   }
+
+   Surrogate model;
+   if (!model.train(store, archive) || !model.save(modelPath))
+   {
+      std::cerr << "Cannot train " << modelPath << "\n";
+      return 1;
+   }
+   std::cout << "Sampling:  ";
+   if (store.getSampling() == SAMPLING_SOBOL)
+      std::cout << "Sobol, scramble " << store.getScramble() << "\n";
+   else
+      std::cout << "seeded\n";
+   std::cout << "Missions:  " << model.getMissions() << "\n";
+   std::cout << "Samples:   " << model.getSamples() << "\n";
+   std::cout << "Cells:     " << model.getCells() << ", "
+             << sizeof(SurrogateHeader) + model.getCells() * sizeof(SurrogateCell)
+             << " bytes\n";
+   return 0;
+}
+
+/*************************************************************************
+ * SURROGATE
+ * Every state of fresh missions looked up in a model, against how each
+ * mission really ended, and what flying the rest would have cost
+ ************************************************************************/
+int surrogate(const char* path, uint32_t firstSeed, uint32_t count, int controllerId)
+{
+   Surrogate model;
+   std::unique_ptr<Controller> controller = createController(controllerId);
+   if (!model.load(path) || !controller)
+   {
+      std::cerr << "No model " << path << " or no controller " << controllerId << "\n";
+      return 1;
+   }
+
+   uint64_t states = 0, certain = 0, right = 0, frames = 0;
+   uint64_t rest = 0, remaining = 0;   // frames still to fly: from every state, uncertain ones
+   double brier = 0.0, fuelError = 0.0, lookup = 0.0, flying = 0.0;
+   std::vector<TrajectoryFrame> trajectory;
+   std::vector<SurrogatePrediction> predictions;
+   for (uint32_t seed = firstSeed; seed < firstSeed + count; seed++)
+   {
+      auto start = std::chrono::steady_clock::now();
+      MissionResult result = runMission(seed, *controller, &trajectory);
+      std::chrono::duration<double> flown = std::chrono::steady_clock::now() - start;
+      flying += flown.count();
+      frames += result.frames;
+
+      World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, seed);
+      size_t n = trajectory.size() - 1;
+      predictions.resize(n);
+      start = std::chrono::steady_clock::now();
+      for (size_t f = 0; f < n; f++)
+         predictions[f] = model.predict(controllerId, world.getGround(), trajectory[f]);
+      std::chrono::duration<double> looked = std::chrono::steady_clock::now() - start;
+      lookup += looked.count();
+
+      double landed = result.outcome == MISSION_LANDED ? 1.0 : 0.0;
+      for (size_t f = 0; f < n; f++)
+      {
+         states++;
+         rest += n - f;
+         if (!predictions[f].certain)
+         {
+            remaining += n - f;
+            continue;
+         }
+         certain++;
+         brier += (predictions[f].landed - landed) * (predictions[f].landed - landed);
+         right += (predictions[f].landed > 0.5) == (landed > 0.5) ? 1 : 0;
+         fuelError += fabs(predictions[f].fuel - result.fuel);
+      }
+   }
+
+   uint64_t uncertain = states - certain;
+   std::cout << "States:        " << states << " over " << count << " missions\n";
+   std::cout << "Certain:       " << 100.0 * certain / std::max<uint64_t>(states, 1) << "%\n";
+   if (certain)
+      std::cout << "   Brier score " << brier / certain << ", outcome right "
+                << 100.0 * right / certain << "%, fuel off by " << fuelError / certain
+                << " kg\n";
+   double perLookup = lookup / std::max<uint64_t>(states, 1);
+   double perFrame = flying / std::max<uint64_t>(frames, 1);
+   std::cout << "Lookup:        " << perLookup * 1e9 << " ns per state\n";
+   if (uncertain)
+      std::cout << "Fallback:      " << perFrame * remaining / uncertain * 1e6
+                << " us per uncertain state to fly the rest\n";
+   std::cout << "Rollout:       " << perFrame * rest / std::max<uint64_t>(states, 1) * 1e6
+             << " us per state to fly the rest of every one\n";
+   return 0;
+}
+
 /*************************************************************************
  * CALLBACK
  ************************************************************************/
@@ -312,8 +904,165 @@ int main(int argc, char** argv)
    testRunner();
    #endif
 
+   // Headless simulation daemon: --server <socket path> [workers]
+   if (argc > 2 && std::string(argv[1]) == "--server")
+   {
+      int workers = (argc > 3) ? atoi(argv[3]) :
+                    static_cast<int>(std::thread::hardware_concurrency());
+      SimServer server(argv[2], workers);
+      server.setVerbose(true);
+      return server.run();
+   }
+
+   // Sharded batch run:
+   //    --batch <first seed> <count> [workers] [controller] [store] [trajectories]
+   //            [scramble] [checkpoint]
+   // where a store, trajectories or scramble of - is none, a scramble key
+   // starts the missions from scrambled Sobol points instead of seeds, and
+   // a checkpoint file lets an interrupted run pick up where it stopped
+   if (argc > 3 && std::string(argv[1]) == "--batch")
+   {
+      BatchRunner runner(static_cast<uint32_t>(atol(argv[2])),
+                         static_cast<uint32_t>(atol(argv[3])),
+                         (argc > 5) ? atoi(argv[5]) : CONTROLLER_SIMPLE);
+      int workers = (argc > 4) ? atoi(argv[4]) :
+                    static_cast<int>(std::thread::hardware_concurrency());
+      ResultStoreWriter store;
+      if (argc > 6 && std::string(argv[6]) != "-")
+      {
+         if (!store.open(argv[6]))
+         {
+            std::cerr << "Cannot create result store " << argv[6] << "\n";
+            return 1;
+         }
+         runner.setResultStore(&store);
+      }
+      TrajectoryArchiveWriter archive;
+      if (argc > 7 && std::string(argv[7]) != "-")
+      {
+         if (!archive.open(argv[7]))
+         {
+            std::cerr << "Cannot create trajectory archive " << argv[7] << "\n";
+            return 1;
+         }
+         runner.setTrajectoryArchive(&archive);
+      }
+      if (argc > 8 && std::string(argv[8]) != "-")
+         runner.setSobol(static_cast<uint32_t>(atol(argv[8])));
+      if (argc > 9)
+         runner.setCheckpoint(argv[9]);
+      MissionStats stats;
+      bool complete = runner.runSharded(workers, stats);
+      if (runner.getResumed() > 0)
+         std::cout << "Resumed " << runner.getResumed() << " missions from " << argv[9]
+                   << ((argc > 6 && std::string(argv[6]) != "-") ||
+                       (argc > 7 && std::string(argv[7]) != "-") ?
+                       "; the results and trajectories kept are only the rest\n" : "\n");
+      if (!store.close() || !archive.close())
+         complete = false;
+      report(stats);
+      if (runner.getRetries() > 0)
+         std::cout << "Chunks re-run: " << runner.getRetries() << "\n";
+      return complete ? 0 : 1;
+   }
+
+   // Random against Sobol sampling:
+   //    --convergence <missions> [replicates] [controller or pilot file] [threads]
+   if (argc > 2 && std::string(argv[1]) == "--convergence")
+      return convergence(static_cast<uint32_t>(atol(argv[2])),
+                         (argc > 3) ? atoi(argv[3]) : 16,
+                         (argc > 4) ? argv[4] : "1",
+                         (argc > 5) ? atoi(argv[5]) :
+                            static_cast<int>(std::thread::hardware_concurrency()));
+
+   // Rare failures:
+   //    --splitting <particles> [runs] [controller or pilot file] [disturbance] [mc] [threads]
+   // where mc also flies runs * particles plain missions to check against
+   if (argc > 2 && std::string(argv[1]) == "--splitting")
+      return splitting(atoi(argv[2]),
+                       (argc > 3) ? atoi(argv[3]) : 16,
+                       (argc > 4) ? argv[4] : "1",
+                       (argc > 5) ? atof(argv[5]) : 0.1,
+                       argc > 6 && std::string(argv[6]) == "mc",
+                       (argc > 7) ? atoi(argv[7]) :
+                          static_cast<int>(std::thread::hardware_concurrency()));
+
+   // Learned outcomes:
+   //    --train-surrogate <store> <archive> <model>   from a seeded batch
+   //    --surrogate <model> <first seed> <count> [controller]
+   if (argc > 4 && std::string(argv[1]) == "--train-surrogate")
+      return trainSurrogate(argv[2], argv[3], argv[4]);
+   if (argc > 4 && std::string(argv[1]) == "--surrogate")
+      return surrogate(argv[2], static_cast<uint32_t>(atol(argv[3])),
+                       static_cast<uint32_t>(atol(argv[4])),
+                       (argc > 5) ? atoi(argv[5]) : CONTROLLER_SIMPLE);
+
+   // Trajectory archive: --trajectories <archive> [threads] [seed to print]
+   if (argc > 2 && std::string(argv[1]) == "--trajectories")
+      return trajectories(argv[2], (argc > 3) ? atoi(argv[3]) : 1,
+                          (argc > 4) ? atol(argv[4]) : -1);
+
+   // Plugin tournament: --tournament <first seed> <count> <workers> <plugin.so> ...
+   if (argc > 5 && std::string(argv[1]) == "--tournament")
+      return tournament(static_cast<uint32_t>(atol(argv[2])),
+                        static_cast<uint32_t>(atol(argv[3])),
+                        atoi(argv[4]), argc - 5, argv + 5);
+
+   // Query a result store: --query <store> [column<op>value ...] [sum|mean|min|max:column]
+   if (argc > 2 && std::string(argv[1]) == "--query")
+      return query(argc - 2, argv + 2);
+
+   // Powered descent from orbit: --descent [first seed] [count]
+   if (argc > 1 && std::string(argv[1]) == "--descent")
+      return descent((argc > 2) ? static_cast<uint32_t>(atol(argv[2])) : 1,
+                     (argc > 3) ? atoi(argv[3]) : 1);
+
+   // Scripted or learned autopilot: --script <script or weights> [first seed] [count]
+   if (argc > 2 && std::string(argv[1]) == "--script")
+      return pilotMissions(argv[2],
+                           (argc > 3) ? static_cast<uint32_t>(atol(argv[3])) : 1,
+                           (argc > 4) ? static_cast<uint32_t>(atol(argv[4])) : 100);
+
+   // Random policy weights: --policy-init <weights> <seed> [hidden width ...]
+   if (argc > 3 && std::string(argv[1]) == "--policy-init")
+      return policyInit(argv[2], static_cast<uint32_t>(atol(argv[3])), argc - 4, argv + 4);
+
+   // Swarm stress run: --swarm <landers> [frames] [seed] [lod interval] [script or weights]
+   if (argc > 2 && std::string(argv[1]) == "--swarm")
+   {
+      std::unique_ptr<Controller> autopilot(argc > 6 ? loadPilot(argv[6]) :
+                                            createController(CONTROLLER_SIMPLE));
+      if (!autopilot)
+         return 1;
+      return swarm(atoi(argv[2]),
+                   (argc > 3) ? atoi(argv[3]) : MISSION_MAX_FRAMES,
+                   (argc > 4) ? static_cast<unsigned int>(atoi(argv[4])) : 1,
+                   (argc > 5) ? atoi(argv[5]) : 1,
+                   *autopilot);
+   }
+
+   // External agent in lockstep over shared memory: --shm <name> <landers> [seed]
+   if (argc > 3 && std::string(argv[1]) == "--shm")
+   {
+      int numLanders = atoi(argv[3]);
+      unsigned int seed = (argc > 4) ? static_cast<unsigned int>(atoi(argv[4])) : 1;
+      World world(Position(800.0, 600.0), numLanders, seed);
+      SharedControl control;
+      if (!control.create(argv[2], numLanders))
+         return 1;
+      control.serve(world);
+      return 0;
+   }
+
+   // Landing statistics survive between runs: [--pilot <name>]. Static
+   // so that the last attempts are synced when the window closes.
+   static SessionLog sessions;
+   std::string pilot = (argc > 2 && std::string(argv[1]) == "--pilot") ? argv[2] : "guest";
+   if (!sessions.open("lander-stats"))
+      std::cerr << "Landing statistics will not be saved\n";
+
    Position posUpperRight(800.0, 600.0);
-   Simulator simulator(posUpperRight);
+   Simulator simulator(posUpperRight, sessions, pilot);
    Interface ui("Apollo 11 Lunar Lander Module Simulator", posUpperRight);
    ui.run(callBack, &simulator);
 
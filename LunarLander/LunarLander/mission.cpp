@@ -0,0 +1,196 @@
+/***********************************************************************
+ * Source File:
+ *    MISSION
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    One seeded landing attempt flown by a controller
+ ************************************************************************/
+
+#include "mission.h"
+#include "controller.h"
+#include "world.h"
+#include "trajectoryArchive.h"
+#include "sobol.h"
+#include <cmath>   // for llround, fabs, floor
+
+/*************************************************************************
+ * TO MICRO
+ * Fixed point keeps the totals independent of the order of addition
+ *************************************************************************/
+static int64_t toMicro(double value)
+{
+   return static_cast<int64_t>(llround(value * 1000000.0));
+}
+
+/*************************************************************************
+ * MISSION STATS : ADD
+ *************************************************************************/
+void MissionStats::add(const MissionResult& result)
+{
+   missions++;
+   if (result.outcome == MISSION_LANDED)
+      landed++;
+   else if (result.outcome == MISSION_CRASHED)
+      crashed++;
+   else
+      timeouts++;
+
+   frames += result.frames;
+   fuelMicro += toMicro(result.fuel);
+   speedMicro += toMicro(result.touchdownSpeed);
+}
+
+/*************************************************************************
+ * MISSION STATS : MERGE
+ *************************************************************************/
+void MissionStats::merge(const MissionStats& rhs)
+{
+   missions += rhs.missions;
+   landed += rhs.landed;
+   crashed += rhs.crashed;
+   timeouts += rhs.timeouts;
+   frames += rhs.frames;
+   fuelMicro += rhs.fuelMicro;
+   speedMicro += rhs.speedMicro;
+}
+
+/*************************************************************************
+ * MISSION STATS : GETTERS
+ *************************************************************************/
+double MissionStats::landingRate() const
+{
+   return missions ? static_cast<double>(landed) / missions : 0.0;
+}
+
+double MissionStats::meanFuel() const
+{
+   return missions ? fuelMicro / 1000000.0 / missions : 0.0;
+}
+
+double MissionStats::meanTouchdownSpeed() const
+{
+   return missions ? speedMicro / 1000000.0 / missions : 0.0;
+}
+
+double MissionStats::meanFlightTime() const
+{
+   return missions ? frames * World::FRAME_TIME / missions : 0.0;
+}
+
+/*************************************************************************
+ * MISSION STATS : EQUALITY
+ *************************************************************************/
+bool MissionStats::operator==(const MissionStats& rhs) const
+{
+   return missions == rhs.missions && landed == rhs.landed &&
+          crashed == rhs.crashed && timeouts == rhs.timeouts &&
+          frames == rhs.frames && fuelMicro == rhs.fuelMicro &&
+          speedMicro == rhs.speedMicro;
+}
+
+/*************************************************************************
+ * FLY
+ * A world already set up, until the lander is down or time is up
+ *************************************************************************/
+static MissionResult fly(World& world, uint32_t seed, Controller& controller,
+                         std::vector<TrajectoryFrame>* trajectory)
+{
+   const Lander& lander = world.getLander(0);
+   auto keep = [&](unsigned char bits)
+   {
+      trajectory->push_back(TrajectoryFrame{ lander.pos.getX(), lander.pos.getY(),
+                                             lander.velocity.getDX(), lander.velocity.getDY(),
+                                             lander.angle.getRadians(),
+                                             lander.getFuelMass().value(), bits });
+   };
+   if (trajectory)
+      trajectory->clear();
+
+   controller.start(seed);
+   while (world.numFlying() > 0 && world.getFrame() < MISSION_MAX_FRAMES)
+   {
+      unsigned char bits = controller.decide(lander, world.getGround());
+      if (trajectory)
+         keep(bits);
+      world.step(&bits);
+   }
+   if (trajectory)
+      keep(0);
+
+   const Touchdown& touchdown = world.getTouchdown(0);
+   MissionResult result;
+   result.seed = seed;
+   result.controller = controller.getId();
+   result.outcome = lander.isLanded() ? MISSION_LANDED :
+                    lander.isDead()   ? MISSION_CRASHED : MISSION_TIMEOUT;
+   result.frames = static_cast<int32_t>(world.getFrame());
+   result.touchdownSpeed = touchdown.speed;
+   result.touchdownAngle = touchdown.angle;
+   result.fuel = lander.getFuelMass().value();
+   result.padOffset = lander.isFlying() ? 0.0 :
+      touchdown.x - world.getGround().getPlatformPosition().getX();
+   return result;
+}
+
+/*************************************************************************
+ * RUN MISSION
+ * Same seed, same controller, same result - in any process
+ *************************************************************************/
+MissionResult runMission(uint32_t seed, Controller& controller,
+                         std::vector<TrajectoryFrame>* trajectory)
+{
+   World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, seed);
+   return fly(world, seed, controller, trajectory);
+}
+
+/*************************************************************************
+ * RUN MISSION
+ * From conditions rather than a seed
+ *************************************************************************/
+MissionResult runMission(uint32_t seed, const MissionConditions& conditions,
+                         Controller& controller,
+                         std::vector<TrajectoryFrame>* trajectory)
+{
+   World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, conditions.terrainSeed,
+               &conditions.terrain);
+   world.place(0, Position(MISSION_WIDTH - 1.0, conditions.startY),
+               Velocity(conditions.dx, conditions.dy));
+   return fly(world, seed, controller, trajectory);
+}
+
+// The dimensions sobolConditions() draws: dx, startY, dy, the platform
+// width and the number of features, three for each feature, then the
+// terrain seed. The direction numbers must cover every one.
+static constexpr int SOBOL_CONDITIONS = 5 + 3 * TERRAIN_MAX_FEATURES + 1;
+static_assert(SOBOL_CONDITIONS <= SOBOL_DIMENSIONS,
+              "sobolConditions() needs more Sobol dimensions than sobol.cpp has");
+
+/*************************************************************************
+ * SOBOL CONDITIONS
+ * Whole steps from the lander's coordinates, as Lander::reset() takes
+ * them from rand(). The terrain's are fractions already.
+ *************************************************************************/
+MissionConditions sobolConditions(uint32_t index, uint32_t scramble)
+{
+   int dimension = 0;
+   auto next = [&]()
+   {
+      return Sobol::sample(index, dimension++, scramble);
+   };
+
+   MissionConditions conditions;
+   conditions.dx = -4.0 - floor(next() * 7);
+   conditions.startY = MISSION_HEIGHT * 0.75 - 10.0 + floor(next() * 20);
+   conditions.dy = -2.0 + floor(next() * 5);
+   conditions.terrain.platformWidth = next();
+   conditions.terrain.features = next();
+   for (int f = 0; f < TERRAIN_MAX_FEATURES; f++)
+   {
+      conditions.terrain.center[f] = next();
+      conditions.terrain.width[f] = next();
+      conditions.terrain.peak[f] = next();
+   }
+   conditions.terrainSeed = Sobol::sampleBits(index, dimension, scramble);
+   return conditions;
+}
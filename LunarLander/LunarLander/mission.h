@@ -0,0 +1,117 @@
+/***********************************************************************
+ * Header File:
+ *    MISSION
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    One seeded landing attempt flown by a controller, what came of it,
+ *    and running totals over many of them
+ ************************************************************************/
+
+#pragma once
+
+#include "ground.h"   // for TerrainChoices
+#include <stdint.h>
+#include <vector>
+
+class Controller;
+struct TrajectoryFrame;
+
+// Every mission flies over a screen-sized world like the game's
+#define MISSION_WIDTH       800.0
+#define MISSION_HEIGHT      600.0
+#define MISSION_MAX_FRAMES  20000    // give up after 2000 simulated seconds
+
+// How a mission ended
+enum MissionOutcome
+{
+   MISSION_LANDED  = 0,
+   MISSION_CRASHED = 1,
+   MISSION_TIMEOUT = 2
+};
+
+/*****************************************************
+ * MISSION RESULT
+ * Plain data so it can go through pipes and files
+ * exactly as it sits in memory
+ *****************************************************/
+struct MissionResult
+{
+   uint32_t seed;             // the mission
+   int32_t  controller;       // ControllerId that flew it
+   int32_t  outcome;          // MissionOutcome
+   int32_t  frames;           // flight time in frames
+   double   touchdownSpeed;   // m/s at contact
+   double   touchdownAngle;   // radians from upright at contact
+   double   fuel;             // kg left
+   double   padOffset;        // meters from the platform center at contact
+};
+
+// How the missions are chosen
+enum Sampling
+{
+   SAMPLING_RANDOM,   // by seed, as the batch runner always has
+   SAMPLING_SOBOL,    // scrambled Sobol points, see sobolConditions()
+   NUM_SAMPLINGS
+};
+
+/*****************************************************
+ * MISSION CONDITIONS
+ * Where a mission starts, for choosing missions other
+ * than by seed. The lander always starts at the right
+ * edge, upright and full.
+ *****************************************************/
+struct MissionConditions
+{
+   uint32_t       terrainSeed;   // the terrain's roughness, and anything else rand() draws
+   TerrainChoices terrain;       // its peaks, valleys and platform
+   double         startY;        // meters
+   double         dx;            // meters/second
+   double         dy;
+};
+
+/*****************************************************
+ * MISSION STATS
+ * Totals kept in fixed point so that adding missions
+ * in any order, in any number of processes, gives
+ * exactly the same answer
+ *****************************************************/
+struct MissionStats
+{
+   uint64_t missions;
+   uint64_t landed;
+   uint64_t crashed;
+   uint64_t timeouts;
+   int64_t  frames;          // total flight frames
+   int64_t  fuelMicro;       // total fuel left, micro-kg
+   int64_t  speedMicro;      // total touchdown speed, micro-m/s
+
+   MissionStats() : missions(0), landed(0), crashed(0), timeouts(0),
+      frames(0), fuelMicro(0), speedMicro(0) {}
+
+   void add(const MissionResult& result);
+   void merge(const MissionStats& rhs);
+
+   double landingRate() const;
+   double meanFuel() const;
+   double meanTouchdownSpeed() const;
+   double meanFlightTime() const;   // seconds
+
+   bool operator==(const MissionStats& rhs) const;
+};
+
+// Fly the mission for a seed with a controller, keeping every frame
+// in trajectory if there is one
+MissionResult runMission(uint32_t seed, Controller& controller,
+                         std::vector<TrajectoryFrame>* trajectory = nullptr);
+
+// The same from given conditions. The seed only labels the result.
+MissionResult runMission(uint32_t seed, const MissionConditions& conditions,
+                         Controller& controller,
+                         std::vector<TrajectoryFrame>* trajectory = nullptr);
+
+// Point index of a scrambled Sobol sequence (see sobol.h) over exactly
+// the values a seeded mission draws from: a start 10 m either side of
+// 75% of the sky, dx from -4 to -10 and dy from -2 to 2 in whole m/s,
+// and every choice the terrain makes but its roughness
+MissionConditions sobolConditions(uint32_t index, uint32_t scramble);
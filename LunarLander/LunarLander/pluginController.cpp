@@ -0,0 +1,164 @@
+/***********************************************************************
+ * Source File:
+ *    PLUGIN CONTROLLER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A controller loaded at run time
+ ************************************************************************/
+
+#include "pluginController.h"
+#include <dlfcn.h>
+#include <chrono>
+
+/*************************************************************************
+ * PLUGIN CONTROLLER : CONSTRUCTOR
+ *************************************************************************/
+PluginController::PluginController() :
+   handle(nullptr),
+   api(nullptr),
+   context(nullptr),
+   hasContext(false),
+   frame(0),
+   budget(0)
+{
+}
+
+/*************************************************************************
+ * PLUGIN CONTROLLER : DESTRUCTOR
+ * The plugin's code must stay mapped until its last context is gone
+ *************************************************************************/
+PluginController::~PluginController()
+{
+   finish();
+   if (handle)
+      dlclose(handle);
+}
+
+/*************************************************************************
+ * PLUGIN CONTROLLER : LOAD
+ *************************************************************************/
+bool PluginController::load(const std::string& path)
+{
+   // RTLD_LOCAL: two entries may well export the same symbols
+   void* library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+   if (!library)
+   {
+      const char* why = dlerror();
+      error = why ? why : "cannot load " + path;
+      return false;
+   }
+
+   lander_plugin_entry entry = reinterpret_cast<lander_plugin_entry>(
+      dlsym(library, LANDER_PLUGIN_ENTRY));
+   if (!entry || !attach(entry()))
+   {
+      if (!entry)
+         error = path + " has no " LANDER_PLUGIN_ENTRY "()";
+      dlclose(library);
+      return false;
+   }
+
+   if (handle)
+      dlclose(handle);
+   handle = library;
+   return true;
+}
+
+/*************************************************************************
+ * PLUGIN CONTROLLER : ATTACH
+ *************************************************************************/
+bool PluginController::attach(const lander_plugin_api* api)
+{
+   if (!api || !api->decide)
+   {
+      error = "plugin has no decide()";
+      return false;
+   }
+   if (api->abi != LANDER_PLUGIN_ABI)
+   {
+      error = "plugin built for ABI " + std::to_string(api->abi) +
+              ", expected " + std::to_string(LANDER_PLUGIN_ABI);
+      return false;
+   }
+   finish();
+   this->api = api;
+   error.clear();
+   return true;
+}
+
+/*************************************************************************
+ * PLUGIN CONTROLLER : GET NAME
+ *************************************************************************/
+std::string PluginController::getName() const
+{
+   return (api && api->name) ? api->name : "";
+}
+
+/*************************************************************************
+ * PLUGIN CONTROLLER : FINISH
+ * Done with this mission's context
+ *************************************************************************/
+void PluginController::finish()
+{
+   if (hasContext && api->destroy)
+      api->destroy(context);
+   context = nullptr;
+   hasContext = false;
+}
+
+/*************************************************************************
+ * PLUGIN CONTROLLER : START
+ *************************************************************************/
+void PluginController::start(uint32_t seed)
+{
+   if (!api)
+      return;
+   finish();
+   context = api->create ? api->create(seed) : nullptr;
+   hasContext = true;
+   frame = 0;
+}
+
+/*************************************************************************
+ * PLUGIN CONTROLLER : DECIDE
+ * What the plugin sees is exactly what the C interface would show
+ *************************************************************************/
+unsigned char PluginController::decide(const Lander& lander, const Ground& ground)
+{
+   if (!api)
+      return 0;
+
+   lander_plugin_state state;
+   Position pos = lander.getPosition();
+   state.lander.x        = pos.getX();
+   state.lander.y        = pos.getY();
+   state.lander.dx       = lander.getVelocity().getDX();
+   state.lander.dy       = lander.getVelocity().getDY();
+   state.lander.angle    = lander.getAngle().getRadians();
+   state.lander.fuel     = lander.getFuelMass().value();
+   state.lander.altitude = pos.getY() - ground.getElevationMeters(pos);
+   state.lander.status   = static_cast<int32_t>(lander.status);
+   state.lander.reserved = 0;
+   state.padX     = ground.getPlatformPosition().getX();
+   state.padY     = ground.getPlatformPosition().getY();
+   state.padWidth = ground.getPlatformWidth();
+   state.frame    = frame++;
+   state.reserved = 0;
+
+   auto begin = std::chrono::steady_clock::now();
+   uint8_t bits = api->decide(context, &state);
+   int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - begin).count();
+
+   counters.calls++;
+   counters.totalNanos += nanos;
+   if (nanos > counters.maxNanos)
+      counters.maxNanos = nanos;
+   if (budget > 0 && nanos > budget)
+   {
+      counters.overruns++;
+      return 0;
+   }
+   return bits & (LANDER_THRUST_MAIN | LANDER_THRUST_CLOCK | LANDER_THRUST_COUNTER);
+}
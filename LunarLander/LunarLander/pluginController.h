@@ -0,0 +1,81 @@
+/***********************************************************************
+ * Header File:
+ *    PLUGIN CONTROLLER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A Controller whose decisions come from a plugin (controllerPlugin.h),
+ *    either loaded from a shared object with dlopen() or linked in.
+ *
+ *    Every decision is timed. A plugin that takes longer than its
+ *    budget has answered too late: the frame flies with no thrust and
+ *    the overrun is counted.
+ ************************************************************************/
+
+#pragma once
+
+#include "controller.h"
+#include "controllerPlugin.h"
+#include <string>
+
+// Forward declaration for unit tests
+class TestTournament;
+
+/*****************************************************
+ * DECISION COUNTERS
+ * Plain data so it can go through a pipe
+ *****************************************************/
+struct DecisionCounters
+{
+   uint64_t calls;
+   uint64_t overruns;      // over budget, ignored
+   int64_t  totalNanos;
+   int64_t  maxNanos;
+
+   DecisionCounters() : calls(0), overruns(0), totalNanos(0), maxNanos(0) {}
+};
+
+/*****************************************************
+ * PLUGIN CONTROLLER
+ *****************************************************/
+class PluginController : public Controller
+{
+   friend TestTournament;
+
+public:
+   PluginController();
+   ~PluginController();
+   PluginController(const PluginController&) = delete;
+   PluginController& operator=(const PluginController&) = delete;
+
+   // Load a shared object. False, with getError() saying why, if it
+   // is missing, has no lander_plugin(), or was built for another ABI.
+   bool load(const std::string& path);
+
+   // Use a plugin linked into this program
+   bool attach(const lander_plugin_api* api);
+
+   // Nanoseconds a decision may take, 0 for no limit
+   void setBudget(int64_t nanoseconds) { budget = nanoseconds; }
+
+   const std::string& getError() const { return error; }
+   std::string getName() const;
+   const DecisionCounters& getCounters() const { return counters; }
+
+   // Controller
+   int getId() const { return CONTROLLER_PLUGIN; }
+   void start(uint32_t seed);
+   unsigned char decide(const Lander& lander, const Ground& ground);
+
+private:
+   void* handle;                  // from dlopen(), NULL when linked in
+   const lander_plugin_api* api;
+   void* context;                 // the plugin's, for this mission
+   bool hasContext;
+   int32_t frame;
+   int64_t budget;
+   DecisionCounters counters;
+   std::string error;
+
+   void finish();
+};
@@ -0,0 +1,444 @@
+/***********************************************************************
+ * Source File:
+ *    POLICY
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Batched multilayer perceptron inference
+ ************************************************************************/
+
+#include "policy.h"
+#include "thrust.h"   // for THRUST_BIT_*
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*************************************************************************
+ * PAD
+ * Rounded up to a whole vector of eight floats
+ *************************************************************************/
+static int pad(int n)
+{
+   return (n + 7) & ~7;
+}
+
+/*************************************************************************
+ * MULTIPLY TILE
+ * y = x * w + bias for some rows, ReLU if asked. Four rows by
+ * eight outputs stay in registers while the inputs stream past, so
+ * every weight loaded is used four times.
+ *************************************************************************/
+static void multiplyTile(const float* __restrict x, int inPad,
+                         const float* __restrict w, const float* __restrict bias,
+                         int outPad, float* __restrict y, int rows, bool relu)
+{
+   for (int r = 0; r < rows; r += 4)
+   {
+      const float* x0 = x + r * inPad;
+      const float* x1 = x0 + inPad;
+      const float* x2 = x1 + inPad;
+      const float* x3 = x2 + inPad;
+      float* y0 = y + r * outPad;
+
+      for (int o = 0; o < outPad; o += 8)
+      {
+#if defined(__AVX2__)
+         __m256 a0 = _mm256_loadu_ps(bias + o);
+         __m256 a1 = a0, a2 = a0, a3 = a0;
+         for (int k = 0; k < inPad; k++)
+         {
+            __m256 wk = _mm256_loadu_ps(w + k * outPad + o);
+#if defined(__FMA__)
+            a0 = _mm256_fmadd_ps(_mm256_set1_ps(x0[k]), wk, a0);
+            a1 = _mm256_fmadd_ps(_mm256_set1_ps(x1[k]), wk, a1);
+            a2 = _mm256_fmadd_ps(_mm256_set1_ps(x2[k]), wk, a2);
+            a3 = _mm256_fmadd_ps(_mm256_set1_ps(x3[k]), wk, a3);
+#else
+            a0 = _mm256_add_ps(a0, _mm256_mul_ps(_mm256_set1_ps(x0[k]), wk));
+            a1 = _mm256_add_ps(a1, _mm256_mul_ps(_mm256_set1_ps(x1[k]), wk));
+            a2 = _mm256_add_ps(a2, _mm256_mul_ps(_mm256_set1_ps(x2[k]), wk));
+            a3 = _mm256_add_ps(a3, _mm256_mul_ps(_mm256_set1_ps(x3[k]), wk));
+#endif
+         }
+         if (relu)
+         {
+            __m256 zero = _mm256_setzero_ps();
+            a0 = _mm256_max_ps(a0, zero);
+            a1 = _mm256_max_ps(a1, zero);
+            a2 = _mm256_max_ps(a2, zero);
+            a3 = _mm256_max_ps(a3, zero);
+         }
+         _mm256_storeu_ps(y0 + o, a0);
+         _mm256_storeu_ps(y0 + outPad + o, a1);
+         _mm256_storeu_ps(y0 + 2 * outPad + o, a2);
+         _mm256_storeu_ps(y0 + 3 * outPad + o, a3);
+#elif defined(__SSE2__)
+         __m128 lo0 = _mm_loadu_ps(bias + o);
+         __m128 hi0 = _mm_loadu_ps(bias + o + 4);
+         __m128 lo1 = lo0, lo2 = lo0, lo3 = lo0;
+         __m128 hi1 = hi0, hi2 = hi0, hi3 = hi0;
+         for (int k = 0; k < inPad; k++)
+         {
+            __m128 wlo = _mm_loadu_ps(w + k * outPad + o);
+            __m128 whi = _mm_loadu_ps(w + k * outPad + o + 4);
+            __m128 v0 = _mm_set1_ps(x0[k]);
+            __m128 v1 = _mm_set1_ps(x1[k]);
+            __m128 v2 = _mm_set1_ps(x2[k]);
+            __m128 v3 = _mm_set1_ps(x3[k]);
+            lo0 = _mm_add_ps(lo0, _mm_mul_ps(v0, wlo));
+            hi0 = _mm_add_ps(hi0, _mm_mul_ps(v0, whi));
+            lo1 = _mm_add_ps(lo1, _mm_mul_ps(v1, wlo));
+            hi1 = _mm_add_ps(hi1, _mm_mul_ps(v1, whi));
+            lo2 = _mm_add_ps(lo2, _mm_mul_ps(v2, wlo));
+            hi2 = _mm_add_ps(hi2, _mm_mul_ps(v2, whi));
+            lo3 = _mm_add_ps(lo3, _mm_mul_ps(v3, wlo));
+            hi3 = _mm_add_ps(hi3, _mm_mul_ps(v3, whi));
+         }
+         if (relu)
+         {
+            __m128 zero = _mm_setzero_ps();
+            lo0 = _mm_max_ps(lo0, zero);
+            hi0 = _mm_max_ps(hi0, zero);
+            lo1 = _mm_max_ps(lo1, zero);
+            hi1 = _mm_max_ps(hi1, zero);
+            lo2 = _mm_max_ps(lo2, zero);
+            hi2 = _mm_max_ps(hi2, zero);
+            lo3 = _mm_max_ps(lo3, zero);
+            hi3 = _mm_max_ps(hi3, zero);
+         }
+         _mm_storeu_ps(y0 + o, lo0);
+         _mm_storeu_ps(y0 + o + 4, hi0);
+         _mm_storeu_ps(y0 + outPad + o, lo1);
+         _mm_storeu_ps(y0 + outPad + o + 4, hi1);
+         _mm_storeu_ps(y0 + 2 * outPad + o, lo2);
+         _mm_storeu_ps(y0 + 2 * outPad + o + 4, hi2);
+         _mm_storeu_ps(y0 + 3 * outPad + o, lo3);
+         _mm_storeu_ps(y0 + 3 * outPad + o + 4, hi3);
+#else
+         const float* rows[4] = { x0, x1, x2, x3 };
+         for (int i = 0; i < 4; i++)
+         {
+            float acc[8];
+            for (int j = 0; j < 8; j++)
+               acc[j] = bias[o + j];
+            for (int k = 0; k < inPad; k++)
+               for (int j = 0; j < 8; j++)
+                  acc[j] += rows[i][k] * w[k * outPad + o + j];
+            for (int j = 0; j < 8; j++)
+               y0[i * outPad + o + j] = (relu && acc[j] < 0.0f) ? 0.0f : acc[j];
+         }
+#endif
+      }
+   }
+}
+
+/*************************************************************************
+ * POLICY : CHECK SIZES
+ * Whether every width, from the inputs to the outputs, makes a policy
+ *************************************************************************/
+bool Policy::checkSizes(const std::vector<int>& sizes)
+{
+   int numLayers = static_cast<int>(sizes.size()) - 1;
+   if (numLayers < 1 || numLayers > POLICY_MAX_LAYERS)
+   {
+      error = "a policy has 1 to " + std::to_string(POLICY_MAX_LAYERS) + " layers";
+      return false;
+   }
+   for (int size : sizes)
+      if (size < 1 || size > POLICY_MAX_WIDTH)
+      {
+         error = "layer widths run from 1 to " + std::to_string(POLICY_MAX_WIDTH);
+         return false;
+      }
+   if (sizes.front() != POLICY_NUM_INPUTS || sizes.back() != POLICY_NUM_OUTPUTS)
+   {
+      error = "a policy takes " + std::to_string(POLICY_NUM_INPUTS) + " inputs to " +
+              std::to_string(POLICY_NUM_OUTPUTS) + " outputs, not " +
+              std::to_string(sizes.front()) + " to " + std::to_string(sizes.back());
+      return false;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * POLICY : SET LAYERS
+ * From weights[out][in] per layer, as in the file
+ *************************************************************************/
+bool Policy::setLayers(const std::vector<int>& sizes,
+                       const std::vector<std::vector<float> >& weights,
+                       const std::vector<std::vector<float> >& biases)
+{
+   if (!checkSizes(sizes))
+      return false;
+
+   int numLayers = static_cast<int>(sizes.size()) - 1;
+   layers.clear();
+   int widest = 0;
+   for (int l = 0; l < numLayers; l++)
+   {
+      Layer layer;
+      layer.in = sizes[l];
+      layer.out = sizes[l + 1];
+      layer.inPad = pad(layer.in);
+      layer.outPad = pad(layer.out);
+      layer.weights.assign(layer.inPad * layer.outPad, 0.0f);
+      layer.bias.assign(layer.outPad, 0.0f);
+      for (int o = 0; o < layer.out; o++)
+      {
+         for (int i = 0; i < layer.in; i++)
+            layer.weights[i * layer.outPad + o] = weights[l][o * layer.in + i];
+         layer.bias[o] = biases[l][o];
+      }
+      widest = std::max(widest, std::max(layer.inPad, layer.outPad));
+      layers.push_back(layer);
+   }
+
+   tileA.assign(POLICY_TILE * widest, 0.0f);
+   tileB.assign(POLICY_TILE * widest, 0.0f);
+   error.clear();
+   return true;
+}
+
+/*************************************************************************
+ * POLICY : LOAD
+ *************************************************************************/
+bool Policy::load(const std::string& path)
+{
+   FILE* file = fopen(path.c_str(), "rb");
+   if (!file)
+   {
+      error = "cannot open " + path;
+      return false;
+   }
+
+   PolicyHeader header;
+   std::vector<int> sizes;
+   std::vector<std::vector<float> > weights;
+   std::vector<std::vector<float> > biases;
+   bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+             header.magic == POLICY_MAGIC && header.version == POLICY_VERSION &&
+             header.numLayers >= 1 && header.numLayers <= POLICY_MAX_LAYERS;
+   if (ok)
+   {
+      std::vector<int32_t> stored(header.numLayers + 1);
+      ok = fread(stored.data(), sizeof(int32_t), stored.size(), file) == stored.size();
+      sizes.assign(stored.begin(), stored.end());
+      for (size_t l = 0; ok && l < header.numLayers; l++)
+      {
+         if (sizes[l] < 1 || sizes[l] > POLICY_MAX_WIDTH ||
+             sizes[l + 1] < 1 || sizes[l + 1] > POLICY_MAX_WIDTH)
+            ok = false;
+         else
+         {
+            weights.push_back(std::vector<float>(sizes[l] * sizes[l + 1]));
+            biases.push_back(std::vector<float>(sizes[l + 1]));
+            ok = fread(weights.back().data(), sizeof(float), weights.back().size(), file) ==
+                    weights.back().size() &&
+                 fread(biases.back().data(), sizeof(float), biases.back().size(), file) ==
+                    biases.back().size();
+         }
+      }
+      ok = ok && fgetc(file) == EOF;
+   }
+   fclose(file);
+
+   if (!ok)
+   {
+      error = path + " is not a version " + std::to_string(POLICY_VERSION) + " policy";
+      return false;
+   }
+   return setLayers(sizes, weights, biases);
+}
+
+/*************************************************************************
+ * POLICY : SAVE
+ *************************************************************************/
+bool Policy::save(const std::string& path) const
+{
+   if (layers.empty())
+      return false;
+
+   FILE* file = fopen(path.c_str(), "wb");
+   if (!file)
+      return false;
+
+   PolicyHeader header = { POLICY_MAGIC, POLICY_VERSION,
+                           static_cast<uint32_t>(layers.size()), 0 };
+   bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+   for (size_t l = 0; ok && l <= layers.size(); l++)
+   {
+      int32_t size = l < layers.size() ? layers[l].in : layers.back().out;
+      ok = fwrite(&size, sizeof(size), 1, file) == 1;
+   }
+   for (const Layer& layer : layers)
+   {
+      std::vector<float> weights(layer.out * layer.in);
+      for (int o = 0; o < layer.out; o++)
+         for (int i = 0; i < layer.in; i++)
+            weights[o * layer.in + i] = layer.weights[i * layer.outPad + o];
+      ok = ok && fwrite(weights.data(), sizeof(float), weights.size(), file) == weights.size() &&
+           fwrite(layer.bias.data(), sizeof(float), layer.out, file) == static_cast<size_t>(layer.out);
+   }
+   return fclose(file) == 0 && ok;
+}
+
+/*************************************************************************
+ * POLICY : RANDOMIZE
+ * Uniform in +-sqrt(6 / (in + out)), biases zero
+ *************************************************************************/
+bool Policy::randomize(const std::vector<int>& hidden, uint32_t seed)
+{
+   std::vector<int> sizes(1, POLICY_NUM_INPUTS);
+   sizes.insert(sizes.end(), hidden.begin(), hidden.end());
+   sizes.push_back(POLICY_NUM_OUTPUTS);
+   if (!checkSizes(sizes))
+      return false;
+
+   uint64_t state = seed;
+   std::vector<std::vector<float> > weights;
+   std::vector<std::vector<float> > biases;
+   for (size_t l = 0; l + 1 < sizes.size(); l++)
+   {
+      int in = sizes[l];
+      int out = sizes[l + 1];
+      double limit = sqrt(6.0 / (in + out));
+      weights.push_back(std::vector<float>(in * out));
+      for (float& w : weights.back())
+      {
+         // splitmix64
+         uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+         z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+         z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+         z ^= z >> 31;
+         w = static_cast<float>(((z >> 11) * (1.0 / 9007199254740992.0) * 2.0 - 1.0) * limit);
+      }
+      biases.push_back(std::vector<float>(out, 0.0f));
+   }
+   return setLayers(sizes, weights, biases);
+}
+
+/*************************************************************************
+ * POLICY : NUM PARAMETERS
+ *************************************************************************/
+long Policy::numParameters() const
+{
+   long count = 0;
+   for (const Layer& layer : layers)
+      count += layer.in * layer.out + layer.out;
+   return count;
+}
+
+/*************************************************************************
+ * POLICY : FORWARD
+ * Up to POLICY_TILE states through every layer, rounded up to four
+ * with zeros. The logits come back with a row stride of the last
+ * layer's outPad.
+ *************************************************************************/
+const float* Policy::forward(const float* states, int count)
+{
+   int rows = (count + 3) & ~3;
+   memcpy(tileA.data(), states, count * POLICY_NUM_INPUTS * sizeof(float));
+   std::fill(tileA.begin() + count * POLICY_NUM_INPUTS,
+             tileA.begin() + rows * POLICY_NUM_INPUTS, 0.0f);
+
+   float* x = tileA.data();
+   float* y = tileB.data();
+   for (size_t l = 0; l < layers.size(); l++)
+   {
+      const Layer& layer = layers[l];
+      multiplyTile(x, layer.inPad, layer.weights.data(), layer.bias.data(),
+                   layer.outPad, y, rows, l + 1 < layers.size());
+      std::swap(x, y);
+   }
+   return x;
+}
+
+/*************************************************************************
+ * POLICY : EVALUATE
+ *************************************************************************/
+void Policy::evaluate(const float* states, int count, float* probabilities)
+{
+   if (layers.empty())
+   {
+      std::fill(probabilities, probabilities + count * POLICY_NUM_OUTPUTS, 0.0f);
+      return;
+   }
+   int stride = layers.back().outPad;
+   for (int first = 0; first < count; first += POLICY_TILE)
+   {
+      int n = std::min(POLICY_TILE, count - first);
+      const float* logits = forward(states + first * POLICY_NUM_INPUTS, n);
+      for (int r = 0; r < n; r++)
+         for (int o = 0; o < POLICY_NUM_OUTPUTS; o++)
+            probabilities[(first + r) * POLICY_NUM_OUTPUTS + o] =
+               1.0f / (1.0f + expf(-logits[r * stride + o]));
+   }
+}
+
+/*************************************************************************
+ * POLICY : DECIDE
+ * More likely than not is a positive logit, so no exponentials
+ *************************************************************************/
+void Policy::decide(const float* states, int count, unsigned char* bits)
+{
+   if (layers.empty())
+   {
+      std::fill(bits, bits + count, 0);
+      return;
+   }
+   int stride = layers.back().outPad;
+   for (int first = 0; first < count; first += POLICY_TILE)
+   {
+      int n = std::min(POLICY_TILE, count - first);
+      const float* logits = forward(states + first * POLICY_NUM_INPUTS, n);
+      for (int r = 0; r < n; r++)
+      {
+         const float* row = logits + r * stride;
+         bits[first + r] = (row[0] > 0.0f ? THRUST_BIT_MAIN    : 0) |
+                           (row[1] > 0.0f ? THRUST_BIT_CLOCK   : 0) |
+                           (row[2] > 0.0f ? THRUST_BIT_COUNTER : 0);
+      }
+   }
+}
+
+/*************************************************************************
+ * POLICY : OBSERVE
+ * Everything scaled to about -1..1 over the usual flight
+ *************************************************************************/
+void Policy::observe(const Lander& lander, const Ground& ground, float* state)
+{
+   Position pos = lander.getPosition();
+   Velocity v = lander.getVelocity();
+   Position pad = ground.getPlatformPosition();
+   double radians = lander.getAngle().getRadians();
+
+   state[0] = static_cast<float>((pos.getX() - pad.getX()) / 100.0);
+   state[1] = static_cast<float>((pos.getY() - pad.getY()) / 100.0);
+   state[2] = static_cast<float>(v.getDX() / 10.0);
+   state[3] = static_cast<float>(v.getDY() / 10.0);
+   state[4] = static_cast<float>(sin(radians));
+   state[5] = static_cast<float>(cos(radians));
+   state[6] = static_cast<float>((pos.getY() - ground.getElevationMeters(pos)) / 100.0);
+   state[7] = static_cast<float>((lander.getFuelMass() / Lander::FUEL_CAPACITY).value());
+}
+
+/*************************************************************************
+ * POLICY : IS POLICY FILE
+ *************************************************************************/
+bool Policy::isPolicyFile(const std::string& path)
+{
+   FILE* file = fopen(path.c_str(), "rb");
+   if (!file)
+      return false;
+   uint32_t magic = 0;
+   bool ok = fread(&magic, sizeof(magic), 1, file) == 1 && magic == POLICY_MAGIC;
+   fclose(file);
+   return ok;
+}
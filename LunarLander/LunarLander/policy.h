@@ -0,0 +1,113 @@
+/***********************************************************************
+ * Header File:
+ *    POLICY
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A learned autopilot: a small multilayer perceptron from lander
+ *    state to the probability of firing each thruster, evaluated for a
+ *    whole batch of landers at once.
+ *
+ *    The batch goes through in tiles of POLICY_TILE landers, each tile
+ *    through every layer before the next, so its activations never
+ *    leave L1. Each layer is a register-blocked matrix multiply: four
+ *    landers by eight outputs held in vector registers while the inputs
+ *    stream past (AVX2, SSE2, or plain loops elsewhere). Weights are
+ *    stored transposed and padded to eight outputs so every load is a
+ *    full vector. Hidden layers are ReLU; the outputs are logits.
+ *
+ *    A weights file (little-endian):
+ *       PolicyHeader
+ *       int32_t sizes[numLayers + 1]   sizes[0] == POLICY_NUM_INPUTS,
+ *                                      sizes[numLayers] == POLICY_NUM_OUTPUTS
+ *       for each layer: float weights[out][in], float bias[out]
+ ************************************************************************/
+
+#pragma once
+
+#include "lander.h"
+#include "ground.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Forward declaration for unit tests
+class TestPolicy;
+
+#define POLICY_MAGIC        0x504d4c4cu   // "LLMP"
+#define POLICY_VERSION      1u
+#define POLICY_NUM_INPUTS   8             // see Policy::observe()
+#define POLICY_NUM_OUTPUTS  3             // main, clockwise, counter-clockwise
+#define POLICY_TILE         32            // landers per cache block
+#define POLICY_MAX_LAYERS   8
+#define POLICY_MAX_WIDTH    1024
+
+// Start of a weights file
+struct PolicyHeader
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t numLayers;
+   uint32_t reserved;
+};
+
+/*****************************************************
+ * POLICY
+ *****************************************************/
+class Policy
+{
+   friend TestPolicy;
+
+public:
+   Policy() {}
+
+   // False, with getError() saying why, if the file is missing, is not
+   // a policy, or does not take POLICY_NUM_INPUTS to POLICY_NUM_OUTPUTS
+   bool load(const std::string& path);
+
+   // False if there are no layers to save or the file cannot be written
+   bool save(const std::string& path) const;
+   const std::string& getError() const { return error; }
+
+   // Fresh weights for these hidden layer widths, the same for a seed.
+   // False, with getError() saying why and the old layers kept, if the
+   // widths are out of range.
+   bool randomize(const std::vector<int>& hidden, uint32_t seed);
+
+   int numLayers() const { return static_cast<int>(layers.size()); }
+   long numParameters() const;
+
+   // count states (POLICY_NUM_INPUTS each) in, and out either the
+   // probability of each thruster (POLICY_NUM_OUTPUTS each) or the
+   // ThrustBits of those more likely than not
+   void evaluate(const float* states, int count, float* probabilities);
+   void decide(const float* states, int count, unsigned char* bits);
+
+   // The state the policy sees for this lander over this ground
+   static void observe(const Lander& lander, const Ground& ground, float* state);
+
+   // Whether a file starts like a weights file
+   static bool isPolicyFile(const std::string& path);
+
+private:
+   struct Layer
+   {
+      int in;
+      int out;
+      int inPad;                    // rounded up to eight
+      int outPad;
+      std::vector<float> weights;   // [inPad][outPad], zero in the padding
+      std::vector<float> bias;      // [outPad]
+   };
+
+   std::vector<Layer> layers;
+   std::vector<float> tileA;        // activations, POLICY_TILE rows each
+   std::vector<float> tileB;
+   std::string error;
+
+   bool checkSizes(const std::vector<int>& sizes);
+   bool setLayers(const std::vector<int>& sizes,
+                  const std::vector<std::vector<float> >& weights,
+                  const std::vector<std::vector<float> >& biases);
+   const float* forward(const float* states, int count);
+};
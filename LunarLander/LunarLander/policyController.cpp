@@ -0,0 +1,35 @@
+/***********************************************************************
+ * Source File:
+ *    POLICY CONTROLLER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A controller flown by a learned policy
+ ************************************************************************/
+
+#include "policyController.h"
+
+/*************************************************************************
+ * POLICY CONTROLLER : DECIDE
+ *************************************************************************/
+unsigned char PolicyController::decide(const Lander& lander, const Ground& ground)
+{
+   float state[POLICY_NUM_INPUTS];
+   Policy::observe(lander, ground, state);
+   unsigned char bits;
+   policy.decide(state, 1, &bits);
+   return bits;
+}
+
+/*************************************************************************
+ * POLICY CONTROLLER : DECIDE ALL
+ *************************************************************************/
+void PolicyController::decideAll(const Lander* const* landers, int count,
+                                 const Ground& ground, unsigned char* bits)
+{
+   if (static_cast<int>(states.size()) < count * POLICY_NUM_INPUTS)
+      states.resize(count * POLICY_NUM_INPUTS);
+   for (int i = 0; i < count; i++)
+      Policy::observe(*landers[i], ground, &states[i * POLICY_NUM_INPUTS]);
+   policy.decide(states.data(), count, bits);
+}
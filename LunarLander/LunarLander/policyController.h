@@ -0,0 +1,41 @@
+/***********************************************************************
+ * Header File:
+ *    POLICY CONTROLLER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A Controller flown by a learned policy (policy.h)
+ ************************************************************************/
+
+#pragma once
+
+#include "controller.h"
+#include "policy.h"
+#include <string>
+#include <vector>
+
+/*****************************************************
+ * POLICY CONTROLLER
+ *****************************************************/
+class PolicyController : public Controller
+{
+public:
+   // False, with getError() saying why, if the weights do not load
+   bool load(const std::string& path) { return policy.load(path); }
+   const std::string& getError() const { return policy.getError(); }
+   Policy& getPolicy() { return policy; }
+
+   // Controller
+   int getId() const { return CONTROLLER_POLICY; }
+   unsigned char decide(const Lander& lander, const Ground& ground);
+   void decideAll(const Lander* const* landers, int count,
+                  const Ground& ground, unsigned char* bits);
+   std::unique_ptr<Controller> clone() const
+   {
+      return std::unique_ptr<Controller>(new PolicyController(*this));
+   }
+
+private:
+   Policy policy;
+   std::vector<float> states;   // for decideAll(), kept between calls
+};
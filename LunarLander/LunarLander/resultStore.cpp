@@ -0,0 +1,474 @@
+/***********************************************************************
+ * Source File:
+ *    RESULT STORE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Columnar per-mission results with block statistics and a seed index
+ ************************************************************************/
+
+#include "resultStore.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>  // for std::sort, std::lower_bound
+#include <cmath>      // for HUGE_VAL, nextafter, ceil, floor
+#include <cstdlib>    // for strtod
+#include <cerrno>
+
+static const char* const COLUMN_NAMES[NUM_RESULT_COLUMNS] =
+{
+   "seed", "controller", "outcome", "frames",
+   "speed", "angle", "fuel", "offset"
+};
+
+/*************************************************************************
+ * CELL
+ * One column of a result as a double
+ *************************************************************************/
+static double cell(const MissionResult& result, int column)
+{
+   switch (column)
+   {
+      case COLUMN_SEED:       return result.seed;
+      case COLUMN_CONTROLLER: return result.controller;
+      case COLUMN_OUTCOME:    return result.outcome;
+      case COLUMN_FRAMES:     return result.frames;
+      case COLUMN_SPEED:      return result.touchdownSpeed;
+      case COLUMN_ANGLE:      return result.touchdownAngle;
+      case COLUMN_FUEL:       return result.fuel;
+      default:                return result.padOffset;
+   }
+}
+
+/*************************************************************************
+ * RESULT STORE WRITER : CONSTRUCTOR
+ *************************************************************************/
+ResultStoreWriter::ResultStoreWriter() :
+   rows(0),
+   failed(false),
+   sampling(SAMPLING_RANDOM),
+   scramble(0)
+{
+   for (int c = 0; c < NUM_RESULT_COLUMNS; c++)
+      files[c] = nullptr;
+}
+
+/*************************************************************************
+ * RESULT STORE WRITER : OPEN
+ * Starts a new store, replacing whatever was in the directory
+ *************************************************************************/
+bool ResultStoreWriter::open(const std::string& directory)
+{
+   close();
+   if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+      return false;
+
+   // Without a meta file nobody will read a half-written store
+   unlink((directory + "/meta").c_str());
+
+   this->directory = directory;
+   rows = 0;
+   failed = false;
+   sampling = SAMPLING_RANDOM;
+   scramble = 0;
+   block.clear();
+   block.reserve(RESULT_BLOCK_ROWS);
+   ranges.clear();
+   seeds.clear();
+
+   for (int c = 0; c < NUM_RESULT_COLUMNS; c++)
+   {
+      std::string path = directory + "/" + COLUMN_NAMES[c] + ".col";
+      files[c] = fopen(path.c_str(), "wb");
+      if (!files[c])
+      {
+         close();
+         return false;
+      }
+   }
+   return true;
+}
+
+/*************************************************************************
+ * RESULT STORE WRITER : APPEND
+ *************************************************************************/
+void ResultStoreWriter::append(const MissionResult& result)
+{
+   if (directory.empty())
+      return;
+
+   seeds.push_back(SeedEntry{ result.seed, static_cast<uint32_t>(rows) });
+   block.push_back(result);
+   rows++;
+   if (block.size() == RESULT_BLOCK_ROWS)
+      flushBlock();
+}
+
+/*************************************************************************
+ * RESULT STORE WRITER : FLUSH BLOCK
+ * Transpose the block into its columns and note each column's range
+ *************************************************************************/
+void ResultStoreWriter::flushBlock()
+{
+   if (block.empty())
+      return;
+
+   std::vector<int32_t> integers(block.size());
+   std::vector<double> reals(block.size());
+
+   for (int c = 0; c < NUM_RESULT_COLUMNS; c++)
+   {
+      ColumnRange range = { HUGE_VAL, -HUGE_VAL };
+      for (size_t i = 0; i < block.size(); i++)
+      {
+         double v = cell(block[i], c);
+         range.min = std::min(range.min, v);
+         range.max = std::max(range.max, v);
+         if (ResultStore::columnWidth(c) == 4)
+            integers[i] = c == COLUMN_SEED ? static_cast<int32_t>(block[i].seed) :
+                                             static_cast<int32_t>(v);
+         else
+            reals[i] = v;
+      }
+      ranges.push_back(range);
+
+      size_t written = ResultStore::columnWidth(c) == 4 ?
+         fwrite(integers.data(), sizeof(int32_t), block.size(), files[c]) :
+         fwrite(reals.data(), sizeof(double), block.size(), files[c]);
+      if (written != block.size())
+         failed = true;
+   }
+   block.clear();
+}
+
+/*************************************************************************
+ * WRITE FILE
+ *************************************************************************/
+static bool writeFile(const std::string& path, const void* data, size_t size)
+{
+   FILE* file = fopen(path.c_str(), "wb");
+   if (!file)
+      return false;
+   bool ok = size == 0 || fwrite(data, size, 1, file) == 1;
+   return fclose(file) == 0 && ok;
+}
+
+/*************************************************************************
+ * RESULT STORE WRITER : CLOSE
+ * The meta file goes last: a store without one is incomplete
+ *************************************************************************/
+bool ResultStoreWriter::close()
+{
+   if (directory.empty())
+      return true;
+
+   flushBlock();
+   for (int c = 0; c < NUM_RESULT_COLUMNS; c++)
+   {
+      if (files[c] && fclose(files[c]) != 0)
+         failed = true;
+      files[c] = nullptr;
+   }
+
+   if (!failed)
+   {
+      std::sort(seeds.begin(), seeds.end(),
+                [](const SeedEntry& a, const SeedEntry& b)
+                { return a.seed < b.seed || (a.seed == b.seed && a.row < b.row); });
+
+      ResultStoreMeta meta = { RESULT_STORE_MAGIC, RESULT_STORE_VERSION, rows,
+                               RESULT_BLOCK_ROWS, NUM_RESULT_COLUMNS,
+                               static_cast<uint32_t>(sampling), scramble };
+      failed = !writeFile(directory + "/blocks.stat", ranges.data(),
+                          ranges.size() * sizeof(ColumnRange)) ||
+               !writeFile(directory + "/seed.idx", seeds.data(),
+                          seeds.size() * sizeof(SeedEntry)) ||
+               !writeFile(directory + "/meta", &meta, sizeof(meta));
+   }
+
+   bool ok = !failed;
+   directory.clear();
+   ranges.clear();
+   seeds.clear();
+   seeds.shrink_to_fit();
+   return ok;
+}
+
+/*************************************************************************
+ * RESULT STORE : CONSTRUCTOR
+ *************************************************************************/
+ResultStore::ResultStore() : ranges(nullptr), seeds(nullptr)
+{
+   meta = ResultStoreMeta();
+   meta.blockRows = RESULT_BLOCK_ROWS;
+   for (int c = 0; c < NUM_RESULT_COLUMNS; c++)
+      columns[c] = nullptr;
+}
+
+/*************************************************************************
+ * RESULT STORE : MAP
+ * Map a whole file read-only; it must be exactly the size we expect
+ *************************************************************************/
+const void* ResultStore::map(const std::string& path, size_t expected)
+{
+   int fd = ::open(path.c_str(), O_RDONLY);
+   if (fd < 0)
+      return nullptr;
+
+   struct stat info;
+   void* p = MAP_FAILED;
+   if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == expected && expected > 0)
+      p = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+   ::close(fd);
+
+   if (p == MAP_FAILED)
+      return nullptr;
+   mappings.push_back(std::make_pair(p, expected));
+   return p;
+}
+
+/*************************************************************************
+ * RESULT STORE : OPEN
+ *************************************************************************/
+bool ResultStore::open(const std::string& directory)
+{
+   close();
+
+   const ResultStoreMeta* header = static_cast<const ResultStoreMeta*>(
+      map(directory + "/meta", sizeof(ResultStoreMeta)));
+   if (!header || header->magic != RESULT_STORE_MAGIC ||
+       header->version != RESULT_STORE_VERSION ||
+       header->numColumns != NUM_RESULT_COLUMNS || header->blockRows == 0 ||
+       header->sampling >= NUM_SAMPLINGS)
+   {
+      close();
+      return false;
+   }
+   meta = *header;
+   if (meta.rows == 0)
+      return true;
+
+   for (int c = 0; c < NUM_RESULT_COLUMNS; c++)
+   {
+      columns[c] = map(directory + "/" + COLUMN_NAMES[c] + ".col",
+                       meta.rows * columnWidth(c));
+      if (!columns[c])
+      {
+         close();
+         return false;
+      }
+   }
+   ranges = static_cast<const ColumnRange*>(
+      map(directory + "/blocks.stat", getBlocks() * NUM_RESULT_COLUMNS * sizeof(ColumnRange)));
+   seeds = static_cast<const SeedEntry*>(
+      map(directory + "/seed.idx", meta.rows * sizeof(SeedEntry)));
+   if (!ranges || !seeds)
+   {
+      close();
+      return false;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * RESULT STORE : CLOSE
+ *************************************************************************/
+void ResultStore::close()
+{
+   for (auto& mapping : mappings)
+      munmap(mapping.first, mapping.second);
+   mappings.clear();
+
+   meta = ResultStoreMeta();
+   meta.blockRows = RESULT_BLOCK_ROWS;
+   for (int c = 0; c < NUM_RESULT_COLUMNS; c++)
+      columns[c] = nullptr;
+   ranges = nullptr;
+   seeds = nullptr;
+}
+
+/*************************************************************************
+ * RESULT STORE : MATCHES
+ *************************************************************************/
+bool ResultStore::matches(const std::vector<ResultFilter>& filters, uint64_t row) const
+{
+   for (const ResultFilter& filter : filters)
+   {
+      double v = value(filter.column, row);
+      if (v < filter.low || v > filter.high)
+         return false;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * RESULT STORE : ACCUMULATE
+ *************************************************************************/
+void ResultStore::accumulate(ResultAggregate& aggregate, int column, uint64_t row) const
+{
+   aggregate.count++;
+   if (column < 0)
+      return;
+   double v = value(column, row);
+   aggregate.sum += v;
+   aggregate.min = std::min(aggregate.min, v);
+   aggregate.max = std::max(aggregate.max, v);
+}
+
+/*************************************************************************
+ * RESULT STORE : QUERY
+ * A narrow seed range goes through the index. Everything else scans
+ * block by block: a block whose range misses any filter is skipped,
+ * and a filter the whole block satisfies is not checked row by row.
+ *************************************************************************/
+ResultAggregate ResultStore::query(const std::vector<ResultFilter>& filters,
+                                   int aggregateColumn) const
+{
+   ResultAggregate aggregate = { 0, 0.0, HUGE_VAL, -HUGE_VAL, 0, 0 };
+   if (meta.rows == 0)
+      return aggregate;
+
+   for (const ResultFilter& filter : filters)
+      if (filter.column < 0 || filter.column >= NUM_RESULT_COLUMNS)
+         return aggregate;
+
+   // Seeds through the index when that touches few enough rows
+   for (const ResultFilter& filter : filters)
+   {
+      if (filter.column != COLUMN_SEED)
+         continue;
+
+      double low = std::max(0.0, ceil(filter.low));
+      double high = std::min(4294967295.0, floor(filter.high));
+      if (low > high)
+         return aggregate;
+
+      const SeedEntry* end = seeds + meta.rows;
+      const SeedEntry* first = std::lower_bound(seeds, end, static_cast<uint32_t>(low),
+         [](const SeedEntry& e, uint32_t seed) { return e.seed < seed; });
+      const SeedEntry* last = std::upper_bound(first, end, static_cast<uint32_t>(high),
+         [](uint32_t seed, const SeedEntry& e) { return seed < e.seed; });
+
+      if (static_cast<uint64_t>(last - first) * 16 < meta.rows)
+      {
+         for (const SeedEntry* e = first; e != last; e++)
+            if (matches(filters, e->row))
+               accumulate(aggregate, aggregateColumn, e->row);
+         return aggregate;
+      }
+   }
+
+   std::vector<ResultFilter> active;
+   active.reserve(filters.size());
+   for (uint64_t b = 0; b < getBlocks(); b++)
+   {
+      uint64_t begin = b * meta.blockRows;
+      uint64_t end = std::min(begin + meta.blockRows, meta.rows);
+      const ColumnRange* blockRanges = ranges + b * NUM_RESULT_COLUMNS;
+
+      bool skip = false;
+      active.clear();
+      for (const ResultFilter& filter : filters)
+      {
+         const ColumnRange& range = blockRanges[filter.column];
+         if (range.max < filter.low || range.min > filter.high)
+            skip = true;
+         else if (range.min < filter.low || range.max > filter.high)
+            active.push_back(filter);
+      }
+      if (skip)
+      {
+         aggregate.blocksSkipped++;
+         continue;
+      }
+      aggregate.blocksScanned++;
+
+      // Every row matches: a count needs no column at all
+      if (active.empty() && aggregateColumn < 0)
+      {
+         aggregate.count += end - begin;
+         continue;
+      }
+
+      for (uint64_t row = begin; row < end; row++)
+         if (active.empty() || matches(active, row))
+            accumulate(aggregate, aggregateColumn, row);
+   }
+   return aggregate;
+}
+
+/*************************************************************************
+ * RESULT STORE : COLUMN NAME
+ *************************************************************************/
+const char* ResultStore::columnName(int column)
+{
+   return column >= 0 && column < NUM_RESULT_COLUMNS ? COLUMN_NAMES[column] : "";
+}
+
+/*************************************************************************
+ * RESULT STORE : COLUMN BY NAME
+ *************************************************************************/
+int ResultStore::columnByName(const std::string& name)
+{
+   for (int c = 0; c < NUM_RESULT_COLUMNS; c++)
+      if (name == COLUMN_NAMES[c])
+         return c;
+   return -1;
+}
+
+/*************************************************************************
+ * PARSE NUMBER
+ * The whole string must be a number
+ *************************************************************************/
+static bool parseNumber(const std::string& text, double& number)
+{
+   if (text.empty())
+      return false;
+   char* end = nullptr;
+   number = strtod(text.c_str(), &end);
+   return *end == '\0';
+}
+
+/*************************************************************************
+ * RESULT STORE : PARSE FILTER
+ *************************************************************************/
+bool ResultStore::parseFilter(const std::string& text, ResultFilter& filter)
+{
+   size_t op = text.find_first_of("=<>");
+   if (op == std::string::npos)
+      return false;
+
+   filter.column = columnByName(text.substr(0, op));
+   if (filter.column < 0)
+      return false;
+
+   filter.low = -HUGE_VAL;
+   filter.high = HUGE_VAL;
+   bool orEqual = op + 1 < text.size() && text[op + 1] == '=';
+   std::string operand = text.substr(op + (text[op] != '=' && orEqual ? 2 : 1));
+   double number;
+
+   if (text[op] == '=')
+   {
+      size_t dots = operand.find("..");
+      if (dots == std::string::npos)
+      {
+         if (!parseNumber(operand, number))
+            return false;
+         filter.low = filter.high = number;
+         return true;
+      }
+      return parseNumber(operand.substr(0, dots), filter.low) &&
+             parseNumber(operand.substr(dots + 2), filter.high);
+   }
+
+   if (!parseNumber(operand, number))
+      return false;
+   if (text[op] == '>')
+      filter.low = orEqual ? number : nextafter(number, HUGE_VAL);
+   else
+      filter.high = orEqual ? number : nextafter(number, -HUGE_VAL);
+   return true;
+}
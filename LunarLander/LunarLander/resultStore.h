@@ -0,0 +1,188 @@
+/***********************************************************************
+ * Header File:
+ *    RESULT STORE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Per-mission batch results on disk, one file per column, so a query
+ *    reads only the columns it filters or aggregates on. Rows are grouped
+ *    in blocks with the min and max of every column per block, which lets
+ *    a query skip any block that cannot match. A sorted seed index finds
+ *    individual seeds without a scan. The reader memory-maps everything,
+ *    so opening a store of any size is instant.
+ *
+ *    A store is a directory:
+ *       meta          ResultStoreMeta
+ *       <column>.col  the column, 4-byte integers or 8-byte doubles
+ *       blocks.stat   min and max of every column for every block
+ *       seed.idx      (seed, row) pairs sorted by seed
+ ************************************************************************/
+
+#pragma once
+
+#include "mission.h"
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <stdint.h>
+
+// Forward declaration for unit tests
+class TestResultStore;
+
+// The columns, in MissionResult order
+enum ResultColumn
+{
+   COLUMN_SEED,
+   COLUMN_CONTROLLER,
+   COLUMN_OUTCOME,
+   COLUMN_FRAMES,
+   COLUMN_SPEED,
+   COLUMN_ANGLE,
+   COLUMN_FUEL,
+   COLUMN_PAD_OFFSET,
+   NUM_RESULT_COLUMNS
+};
+
+#define RESULT_STORE_MAGIC     0x53524c4cu   // "LLRS"
+#define RESULT_STORE_VERSION   2u
+#define RESULT_BLOCK_ROWS      4096u
+
+// Contents of the meta file
+struct ResultStoreMeta
+{
+   uint32_t magic;
+   uint32_t version;
+   uint64_t rows;
+   uint32_t blockRows;
+   uint32_t numColumns;
+   uint32_t sampling;     // Sampling
+   uint32_t scramble;     // SAMPLING_SOBOL only
+};
+
+// Range of one column inside one block
+struct ColumnRange
+{
+   double min;
+   double max;
+};
+
+// One entry of the seed index
+struct SeedEntry
+{
+   uint32_t seed;
+   uint32_t row;
+};
+
+// Keep rows whose column lies in [low, high]
+struct ResultFilter
+{
+   int column;
+   double low;
+   double high;
+};
+
+// Count plus sum, min and max of one column over the matching rows
+struct ResultAggregate
+{
+   uint64_t count;
+   double sum;
+   double min;
+   double max;
+   uint64_t blocksScanned;
+   uint64_t blocksSkipped;
+
+   double mean() const { return count ? sum / count : 0.0; }
+};
+
+/*****************************************************
+ * RESULT STORE WRITER
+ * Appends rows; close() writes the statistics and index
+ *****************************************************/
+class ResultStoreWriter
+{
+public:
+   ResultStoreWriter();
+   ~ResultStoreWriter() { close(); }
+
+   bool open(const std::string& directory);
+   void append(const MissionResult& result);
+   bool close();
+
+   // How the missions were started, so a reader can fly them again.
+   // By seed unless said otherwise.
+   void setSampling(Sampling sampling, uint32_t scramble)
+   {
+      this->sampling = sampling;
+      this->scramble = sampling == SAMPLING_SOBOL ? scramble : 0;
+   }
+
+   uint64_t getRows() const { return rows; }
+
+private:
+   std::string directory;
+   FILE* files[NUM_RESULT_COLUMNS];
+   std::vector<MissionResult> block;   // rows not yet written
+   std::vector<ColumnRange> ranges;    // NUM_RESULT_COLUMNS per written block
+   std::vector<SeedEntry> seeds;
+   uint64_t rows;
+   bool failed;
+   Sampling sampling;
+   uint32_t scramble;
+
+   void flushBlock();
+};
+
+/*****************************************************
+ * RESULT STORE
+ * Read-only, memory-mapped view of a store
+ *****************************************************/
+class ResultStore
+{
+   friend TestResultStore;
+
+public:
+   ResultStore();
+   ~ResultStore() { close(); }
+   ResultStore(const ResultStore&) = delete;
+   ResultStore& operator=(const ResultStore&) = delete;
+
+   bool open(const std::string& directory);
+   void close();
+
+   uint64_t getRows() const { return meta.rows; }
+   Sampling getSampling() const { return static_cast<Sampling>(meta.sampling); }
+   uint32_t getScramble() const { return meta.scramble; }
+   uint64_t getBlocks() const { return (meta.rows + meta.blockRows - 1) / meta.blockRows; }
+
+   // One cell, whatever the column's type
+   double value(int column, uint64_t row) const
+   {
+      if (column == COLUMN_SEED)
+         return static_cast<const uint32_t*>(columns[column])[row];
+      return columnWidth(column) == 4 ?
+         static_cast<double>(static_cast<const int32_t*>(columns[column])[row]) :
+         static_cast<const double*>(columns[column])[row];
+   }
+
+   // Rows matching every filter; aggregateColumn < 0 just counts
+   ResultAggregate query(const std::vector<ResultFilter>& filters,
+                         int aggregateColumn) const;
+
+   static int columnWidth(int column) { return column < COLUMN_SPEED ? 4 : 8; }
+   static const char* columnName(int column);
+   static int columnByName(const std::string& name);
+
+   // "fuel>1000", "outcome=1", "seed=100..200", "speed<4"
+   static bool parseFilter(const std::string& text, ResultFilter& filter);
+
+private:
+   ResultStoreMeta meta;
+   const void* columns[NUM_RESULT_COLUMNS];
+   const ColumnRange* ranges;
+   const SeedEntry* seeds;
+   std::vector<std::pair<void*, size_t>> mappings;
+
+   const void* map(const std::string& path, size_t expected);
+   bool matches(const std::vector<ResultFilter>& filters, uint64_t row) const;
+   void accumulate(ResultAggregate& aggregate, int column, uint64_t row) const;
+};
@@ -0,0 +1,289 @@
+/***********************************************************************
+ * Source File:
+ *    SCENE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Entity storage and the systems that update and draw it
+ ************************************************************************/
+
+#include "scene.h"
+#include "ground.h"
+#include "thrust.h"
+#include "uiDraw.h"
+
+/*************************************************************************
+ * SCENE : CREATE
+ * Reuse a free row if there is one; every array grows together
+ *************************************************************************/
+Entity Scene::create(uint8_t components, Sprite kind, const Position& pos)
+{
+   Entity e;
+   if (!freeRows.empty())
+   {
+      e = freeRows.back();
+      freeRows.pop_back();
+   }
+   else
+   {
+      e = static_cast<Entity>(mask.size());
+      mask.push_back(0);
+      sprite.push_back(SPRITE_NONE);
+      x.push_back(0.0);
+      y.push_back(0.0);
+      angle.push_back(0.0);
+      dx.push_back(0.0);
+      dy.push_back(0.0);
+      spin.push_back(0.0);
+      phase.push_back(0);
+      life.push_back(0.0);
+      landerIndex.push_back(-1);
+   }
+
+   mask[e] = components | COMPONENT_POSITION;
+   sprite[e] = kind;
+   x[e] = pos.getX();
+   y[e] = pos.getY();
+   angle[e] = 0.0;
+   dx[e] = dy[e] = spin[e] = 0.0;
+   phase[e] = 0;
+   life[e] = 0.0;
+   landerIndex[e] = -1;
+   return e;
+}
+
+/*************************************************************************
+ * SCENE : CREATE STAR
+ *************************************************************************/
+Entity Scene::createStar(const Position& pos, unsigned char phase)
+{
+   Entity e = create(COMPONENT_TWINKLE, SPRITE_STAR, pos);
+   this->phase[e] = phase;
+   return e;
+}
+
+/*************************************************************************
+ * SCENE : CREATE LANDER
+ *************************************************************************/
+Entity Scene::createLander(const Position& posUpperRight)
+{
+   Lander lander(posUpperRight);
+   Entity e = create(COMPONENT_LANDER, SPRITE_LANDER, lander.getPosition());
+   landerIndex[e] = static_cast<int>(landers.size());
+   landers.push_back(lander);
+   landerEntity.push_back(e);
+   return e;
+}
+
+/*************************************************************************
+ * SCENE : CREATE PARTICLE
+ * A speck of exhaust: falls, dies on the ground or when its time is up
+ *************************************************************************/
+Entity Scene::createParticle(const Position& pos, const Velocity& v, double life)
+{
+   Entity e = create(COMPONENT_MOTION | COMPONENT_COLLIDE | COMPONENT_LIFETIME,
+                     SPRITE_PARTICLE, pos);
+   dx[e] = v.getDX();
+   dy[e] = v.getDY();
+   this->life[e] = life;
+   return e;
+}
+
+/*************************************************************************
+ * SCENE : DESTROY
+ * A lander leaves a hole in the lander array, so the last one moves in
+ *************************************************************************/
+void Scene::destroy(Entity e)
+{
+   if (!isAlive(e))
+      return;
+
+   if (mask[e] & COMPONENT_LANDER)
+   {
+      int index = landerIndex[e];
+      int last = static_cast<int>(landers.size()) - 1;
+      if (index != last)
+      {
+         landers[index] = landers[last];
+         landerEntity[index] = landerEntity[last];
+         landerIndex[landerEntity[index]] = index;
+      }
+      landers.pop_back();
+      landerEntity.pop_back();
+   }
+
+   mask[e] = 0;
+   sprite[e] = SPRITE_NONE;
+   landerIndex[e] = -1;
+   freeRows.push_back(e);
+}
+
+/*************************************************************************
+ * SCENE : DESTROY ALL
+ *************************************************************************/
+void Scene::destroyAll(Sprite kind)
+{
+   for (Entity e = 0; e < mask.size(); e++)
+      if (mask[e] && sprite[e] == kind)
+         destroy(e);
+}
+
+/*************************************************************************
+ * SCENE : FLY
+ * Lander system: every lander still in the air gets the same input
+ *************************************************************************/
+void Scene::fly(const Thrust& thrust, double gravity, double time)
+{
+   for (size_t i = 0; i < landers.size(); i++)
+   {
+      Lander& lander = landers[i];
+      if (!lander.isFlying())
+         continue;
+
+      Acceleration acceleration = lander.input(thrust, gravity);
+      lander.coast(acceleration, time);
+
+      Entity e = landerEntity[i];
+      x[e] = lander.pos.getX();
+      y[e] = lander.pos.getY();
+      angle[e] = lander.angle.getRadians();
+   }
+}
+
+/*************************************************************************
+ * SCENE : MOVE
+ * Physics system: ballistic motion under gravity, plus tumbling
+ *************************************************************************/
+void Scene::move(double gravity, double time)
+{
+   const double drop = 0.5 * gravity * time * time;
+   for (size_t e = 0; e < mask.size(); e++)
+   {
+      if (!(mask[e] & COMPONENT_MOTION))
+         continue;
+      x[e] += dx[e] * time;
+      y[e] += dy[e] * time + drop;
+      dy[e] += gravity * time;
+      angle[e] += spin[e] * time;
+   }
+
+   debris.move(gravity, time);
+}
+
+/*************************************************************************
+ * SCENE : TWINKLE
+ *************************************************************************/
+void Scene::twinkle()
+{
+   for (size_t e = 0; e < mask.size(); e++)
+      if (mask[e] & COMPONENT_TWINKLE)
+         phase[e]++;   // wraps at 256
+}
+
+/*************************************************************************
+ * SCENE : COLLIDE
+ * Collision system. Landers follow the lab spec: crash unless on the
+ * platform, slow, and upright. Particles vanish on contact; the debris
+ * pool bounces and settles its own fragments.
+ *************************************************************************/
+Touchdowns Scene::collide(const Ground& ground)
+{
+   Touchdowns touchdowns = { 0, 0 };
+
+   for (size_t i = 0; i < landers.size(); i++)
+   {
+      Lander& lander = landers[i];
+      if (!lander.isFlying())
+         continue;
+
+      Position pos = lander.getPosition();
+      if (pos.getY() > ground.getElevationMeters(pos))
+         continue;
+
+      if (lander.checkSafetyLanding() && ground.onPlatform(pos, lander.getWidth()))
+      {
+         lander.land();
+         touchdowns.landed++;
+      }
+      else
+      {
+         // break it up before crash() turns it over
+         spawnDebris(lander);
+         lander.crash();
+         touchdowns.crashed++;
+      }
+   }
+
+   for (Entity e = 0; e < mask.size(); e++)
+   {
+      if ((mask[e] & (COMPONENT_MOTION | COMPONENT_COLLIDE)) !=
+          (COMPONENT_MOTION | COMPONENT_COLLIDE))
+         continue;
+
+      if (y[e] <= ground.getElevationMeters(Position(x[e], y[e])))
+         destroy(e);
+   }
+
+   debris.collide(ground);
+   return touchdowns;
+}
+
+/*************************************************************************
+ * SCENE : EXPIRE
+ * Lifetime system
+ *************************************************************************/
+void Scene::expire(double time)
+{
+   for (Entity e = 0; e < mask.size(); e++)
+   {
+      if (!(mask[e] & COMPONENT_LIFETIME))
+         continue;
+      life[e] -= time;
+      if (life[e] <= 0.0)
+         destroy(e);
+   }
+}
+
+/*************************************************************************
+ * SCENE : SPAWN DEBRIS
+ * A crash breaks the lander into every line it is drawn with
+ *************************************************************************/
+void Scene::spawnDebris(const Lander& lander)
+{
+   debris.spawn(lander.pos, lander.angle.getRadians(), lander.getVelocity());
+}
+
+/*************************************************************************
+ * SCENE : DRAW
+ * Render system: back to front, so the terrain hides the stars behind it
+ *************************************************************************/
+void Scene::draw(ogstream& gout, const Ground& ground, const Thrust& thrust) const
+{
+   for (size_t e = 0; e < mask.size(); e++)
+      if (sprite[e] == SPRITE_STAR)
+         gout.drawStar(Position(x[e], y[e]), phase[e]);
+
+   ground.draw(gout);
+
+   for (const Lander& lander : landers)
+   {
+      // A wreck is drawn as its debris
+      if (lander.isDead())
+         continue;
+
+      gout.drawLander(lander.getPosition(), lander.getAngle().getRadians());
+      if (lander.isFlying())
+         gout.drawLanderFlames(lander.getPosition(),
+                               lander.getAngle().getRadians(),
+                               thrust.isMain(),
+                               thrust.isClock(),
+                               thrust.isCounter());
+   }
+
+   for (size_t e = 0; e < mask.size(); e++)
+      if (sprite[e] == SPRITE_PARTICLE)
+         gout.drawLine(Position(x[e], y[e]), Position(x[e] + 1.0, y[e]),
+                       1.0, 0.6, 0.1);
+
+   debris.draw(gout);
+}
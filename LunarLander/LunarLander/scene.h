@@ -0,0 +1,113 @@
+/***********************************************************************
+ * Header File:
+ *    SCENE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Everything on the screen as entities: landers, stars, exhaust
+ *    particles and debris. Each component lives in its own array
+ *    (structure of arrays) and each system walks only the arrays it
+ *    needs, so thousands of mixed entities stay cache friendly and a
+ *    new kind of entity is a new combination of components, not a new
+ *    loop in the simulator.
+ ************************************************************************/
+
+#pragma once
+
+#include "position.h"
+#include "velocity.h"
+#include "lander.h"
+#include "debris.h"
+#include <vector>
+#include <stdint.h>
+
+// Forward declarations
+class Ground;
+class Thrust;
+class ogstream;
+class TestScene;
+
+// An entity is a row in every component array
+typedef uint32_t Entity;
+
+// Which components a row has
+enum Component
+{
+   COMPONENT_POSITION = 0x01,   // x, y, angle
+   COMPONENT_MOTION   = 0x02,   // dx, dy, spin: moves ballistically
+   COMPONENT_TWINKLE  = 0x04,   // phase
+   COMPONENT_LANDER   = 0x08,   // full lander physics
+   COMPONENT_COLLIDE  = 0x10,   // removed at the ground
+   COMPONENT_LIFETIME = 0x20    // life: removed when it runs out
+};
+
+// How a row is drawn
+enum Sprite
+{
+   SPRITE_NONE,
+   SPRITE_STAR,
+   SPRITE_LANDER,
+   SPRITE_PARTICLE
+};
+
+// What the collision system saw this frame
+struct Touchdowns
+{
+   int landed;
+   int crashed;
+};
+
+/*****************************************************
+ * SCENE
+ * Component storage plus the systems that run on it
+ *****************************************************/
+class Scene
+{
+   friend TestScene;
+
+public:
+   // Entities
+   Entity createStar(const Position& pos, unsigned char phase);
+   Entity createLander(const Position& posUpperRight);
+   Entity createParticle(const Position& pos, const Velocity& v, double life);
+   void destroy(Entity e);
+   void destroyAll(Sprite sprite);
+   bool isAlive(Entity e) const { return e < mask.size() && mask[e] != 0; }
+   int size() const { return static_cast<int>(mask.size() - freeRows.size()); }
+   const DebrisPool& getDebris() const { return debris; }
+   void clearDebris() { debris.clear(); }
+   Lander& getLander(Entity e) { return landers[landerIndex[e]]; }
+   const Lander& getLander(Entity e) const { return landers[landerIndex[e]]; }
+
+   // Systems, in the order the simulator runs them
+   void fly(const Thrust& thrust, double gravity, double time);   // landers
+   void move(double gravity, double time);                        // ballistic
+   void twinkle();                                                // stars
+   Touchdowns collide(const Ground& ground);                       // ground contact
+   void expire(double time);                                      // lifetimes
+   void draw(ogstream& gout, const Ground& ground,
+             const Thrust& thrust) const;                         // render
+
+private:
+   // Components, one row per entity
+   std::vector<uint8_t> mask;          // Component bits, 0 for a free row
+   std::vector<uint8_t> sprite;        // Sprite
+   std::vector<double> x, y, angle;    // COMPONENT_POSITION
+   std::vector<double> dx, dy, spin;   // COMPONENT_MOTION
+   std::vector<uint8_t> phase;         // COMPONENT_TWINKLE
+   std::vector<double> life;           // COMPONENT_LIFETIME
+   std::vector<int> landerIndex;       // COMPONENT_LANDER, into landers
+
+   // Landers are dense on their own so the lander system never skips
+   std::vector<Lander> landers;
+   std::vector<Entity> landerEntity;
+
+   std::vector<Entity> freeRows;
+
+   // Crash fragments are pooled rather than entities: a crash must not
+   // grow the component arrays in the middle of a frame
+   DebrisPool debris;
+
+   Entity create(uint8_t components, Sprite sprite, const Position& pos);
+   void spawnDebris(const Lander& lander);
+};
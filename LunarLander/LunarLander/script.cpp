@@ -0,0 +1,785 @@
+/***********************************************************************
+ * Source File:
+ *    SCRIPT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    The script compiler and the bytecode interpreter
+ ************************************************************************/
+
+#include "script.h"
+#include "thrust.h"   // for THRUST_BIT_*
+#include <cmath>
+#include <cstdlib>    // for strtod
+#include <cctype>
+#include <cstring>    // for strchr
+#include <algorithm>
+
+// Parentheses and calls the compiler follows before refusing: each
+// level is a dozen frames of recursion
+const int SCRIPT_MAX_DEPTH = 256;
+
+// Instructions. The interpreter's jump table is in this order.
+enum ScriptOp
+{
+   OP_HALT = 0,
+   OP_MOV,           // dst = a
+   OP_ADD,           // dst = a + b
+   OP_SUB,
+   OP_MUL,
+   OP_DIV,
+   OP_NEG,           // dst = -a
+   OP_NOT,           // dst = !a
+   OP_LT,            // dst = a < b
+   OP_LE,
+   OP_GT,
+   OP_GE,
+   OP_EQ,
+   OP_NE,
+   OP_AND,           // dst = a && b
+   OP_OR,
+   OP_ABS,           // dst = abs(a)
+   OP_MIN,           // dst = min(a, b)
+   OP_MAX,
+   OP_SQRT,
+   OP_SIN,
+   OP_COS,
+   OP_ATAN2,         // dst = atan2(a, b)
+   OP_SEL            // dst = dst ? a : b
+};
+
+// Registers after the inputs: the thrusters
+#define SCRIPT_MAIN     (SCRIPT_NUM_INPUTS + 0)
+#define SCRIPT_CLOCK    (SCRIPT_NUM_INPUTS + 1)
+#define SCRIPT_COUNTER  (SCRIPT_NUM_INPUTS + 2)
+#define SCRIPT_FIRST_FREE (SCRIPT_NUM_INPUTS + 3)
+
+static const char* const registerNames[SCRIPT_FIRST_FREE] =
+{
+   "x", "y", "dx", "dy", "speed", "angle", "fuel", "altitude",
+   "padX", "padY", "padWidth", "width", "frame",
+   "main", "clock", "counter"
+};
+
+/*************************************************************************
+ * FOLD
+ * An operation on two known values, at compile time
+ *************************************************************************/
+static double fold(int op, double a, double b)
+{
+   switch (op)
+   {
+      case OP_ADD:   return a + b;
+      case OP_SUB:   return a - b;
+      case OP_MUL:   return a * b;
+      case OP_DIV:   return a / b;
+      case OP_NEG:   return -a;
+      case OP_NOT:   return a == 0.0 ? 1.0 : 0.0;
+      case OP_LT:    return a <  b ? 1.0 : 0.0;
+      case OP_LE:    return a <= b ? 1.0 : 0.0;
+      case OP_GT:    return a >  b ? 1.0 : 0.0;
+      case OP_GE:    return a >= b ? 1.0 : 0.0;
+      case OP_EQ:    return a == b ? 1.0 : 0.0;
+      case OP_NE:    return a != b ? 1.0 : 0.0;
+      case OP_AND:   return (a != 0.0 && b != 0.0) ? 1.0 : 0.0;
+      case OP_OR:    return (a != 0.0 || b != 0.0) ? 1.0 : 0.0;
+      case OP_ABS:   return std::fabs(a);
+      case OP_MIN:   return std::min(a, b);
+      case OP_MAX:   return std::max(a, b);
+      case OP_SQRT:  return std::sqrt(a);
+      case OP_SIN:   return std::sin(a);
+      case OP_COS:   return std::cos(a);
+      case OP_ATAN2: return std::atan2(a, b);
+   }
+   return 0.0;
+}
+
+/*****************************************************
+ * SCRIPT COMPILER
+ * Recursive descent straight to bytecode. Each rule returns the
+ * register holding its value. Variables and constants are given
+ * registers from the bottom up, temporaries from the top down, and
+ * temporaries are released in the reverse order they were taken.
+ *****************************************************/
+class ScriptCompiler
+{
+public:
+   ScriptCompiler(Script& script, const std::string& source) :
+      script(script), source(source), pos(0), line(1), depth(0),
+      nextReg(SCRIPT_FIRST_FREE), tempTop(SCRIPT_MAX_REGISTERS - 1),
+      lowestTemp(SCRIPT_MAX_REGISTERS),
+      type(TOKEN_END), number(0.0)
+   {
+      constant.assign(SCRIPT_MAX_REGISTERS, false);
+      assigned.assign(SCRIPT_MAX_REGISTERS, false);
+      readLine.assign(SCRIPT_MAX_REGISTERS, 0);
+   }
+
+   bool compile();
+
+private:
+   enum TokenType { TOKEN_END, TOKEN_NEWLINE, TOKEN_NUMBER, TOKEN_NAME, TOKEN_SYMBOL };
+
+   Script& script;
+   const std::string& source;
+   size_t pos;
+   int line;
+   int depth;                    // of parentheses: newlines inside are spaces
+   int nextReg;
+   int tempTop;
+   int lowestTemp;               // deepest temporary taken
+   std::vector<bool> constant;
+   std::vector<bool> assigned;
+   std::vector<int> readLine;    // first line a variable was read on
+
+   TokenType type;
+   std::string text;
+   double number;
+
+   void next();
+   bool accept(const char* symbol);
+   void expect(const char* symbol);
+   void fail(const std::string& why);
+
+   void statement();
+   int expression();
+   int ternary();
+   int binary(int level);
+   int unary();
+   int primary();
+   int call(const std::string& name);
+
+   int variable(const std::string& name);
+   int constantReg(double value);
+   int temp();
+   void release(int reg);
+   int emit(int op, int dst, int a, int b);
+   int operation(int op, int a, int b);
+   void compact();
+};
+
+// Thrown to unwind out of the recursion on the first error
+struct ScriptError {};
+
+/*************************************************************************
+ * SCRIPT COMPILER : FAIL
+ *************************************************************************/
+void ScriptCompiler::fail(const std::string& why)
+{
+   script.error = "line " + std::to_string(line) + ": " + why;
+   throw ScriptError();
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : NEXT
+ * The next token into type, text and number
+ *************************************************************************/
+void ScriptCompiler::next()
+{
+   if (type == TOKEN_NEWLINE && text == "\n")
+      line++;
+   for (;;)
+   {
+      while (pos < source.size() && (source[pos] == ' ' || source[pos] == '\t' ||
+             source[pos] == '\r' || (depth > 0 && source[pos] == '\n')))
+         line += source[pos++] == '\n' ? 1 : 0;
+      if (pos < source.size() && source[pos] == '#')
+      {
+         while (pos < source.size() && source[pos] != '\n')
+            pos++;
+         continue;
+      }
+      break;
+   }
+
+   text.clear();
+   if (pos >= source.size())
+   {
+      type = TOKEN_END;
+      return;
+   }
+
+   unsigned char c = source[pos];
+   if (c == '\n' || c == ';')
+   {
+      type = TOKEN_NEWLINE;
+      text = static_cast<char>(c);
+      pos++;
+      return;
+   }
+   if (isdigit(c) || (c == '.' && pos + 1 < source.size() && isdigit(static_cast<unsigned char>(source[pos + 1]))))
+   {
+      char* end;
+      number = strtod(source.c_str() + pos, &end);
+      type = TOKEN_NUMBER;
+      text = source.substr(pos, end - (source.c_str() + pos));
+      pos = end - source.c_str();
+      return;
+   }
+   if (isalpha(c) || c == '_')
+   {
+      size_t start = pos;
+      while (pos < source.size() && (isalnum(static_cast<unsigned char>(source[pos])) || source[pos] == '_'))
+         pos++;
+      type = TOKEN_NAME;
+      text = source.substr(start, pos - start);
+      return;
+   }
+
+   static const char* const pairs[] = { "&&", "||", "==", "!=", "<=", ">=" };
+   type = TOKEN_SYMBOL;
+   for (const char* pair : pairs)
+      if (source.compare(pos, 2, pair) == 0)
+      {
+         text = pair;
+         pos += 2;
+         return;
+      }
+   if (!strchr("+-*/<>!?:(),=", c))
+      fail(std::string("unexpected '") + static_cast<char>(c) + "'");
+   text = static_cast<char>(c);
+   pos++;
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : ACCEPT and EXPECT
+ *************************************************************************/
+bool ScriptCompiler::accept(const char* symbol)
+{
+   if (type != TOKEN_SYMBOL || text != symbol)
+      return false;
+   next();
+   return true;
+}
+
+void ScriptCompiler::expect(const char* symbol)
+{
+   if (!accept(symbol))
+      fail(std::string("expected '") + symbol + "'" +
+           (text.empty() ? "" : " before '" + text + "'"));
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : registers
+ *************************************************************************/
+int ScriptCompiler::variable(const std::string& name)
+{
+   for (int i = 0; i < static_cast<int>(script.names.size()); i++)
+      if (script.names[i] == name)
+         return i;
+   if (nextReg > tempTop)
+      fail("too many variables and constants");
+   script.names[nextReg] = name;
+   return nextReg++;
+}
+
+int ScriptCompiler::constantReg(double value)
+{
+   for (int i = SCRIPT_FIRST_FREE; i < nextReg; i++)
+      if (constant[i] && script.image[i] == value && std::signbit(script.image[i]) == std::signbit(value))
+         return i;
+   if (nextReg > tempTop)
+      fail("too many variables and constants");
+   constant[nextReg] = true;
+   script.image[nextReg] = value;
+   return nextReg++;
+}
+
+int ScriptCompiler::temp()
+{
+   if (tempTop < nextReg)
+      fail("expression too deep");
+   lowestTemp = std::min(lowestTemp, tempTop);
+   return tempTop--;
+}
+
+void ScriptCompiler::release(int reg)
+{
+   if (reg == tempTop + 1)
+      tempTop++;
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : EMIT
+ *************************************************************************/
+int ScriptCompiler::emit(int op, int dst, int a, int b)
+{
+   Script::Instruction in = { static_cast<uint8_t>(op), static_cast<uint8_t>(dst),
+                              static_cast<uint8_t>(a), static_cast<uint8_t>(b) };
+   script.code.push_back(in);
+   return static_cast<int>(script.code.size()) - 1;
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : OPERATION
+ * dst = a op b, folded when both are constants
+ *************************************************************************/
+int ScriptCompiler::operation(int op, int a, int b)
+{
+   if (constant[a] && constant[b])
+      return constantReg(fold(op, script.image[a], script.image[b]));
+   release(b);
+   release(a);
+   int dst = temp();
+   emit(op, dst, a, b);
+   return dst;
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : COMPACT
+ * Move the temporaries down to just above the variables, so the
+ * registers in use are one small block
+ *************************************************************************/
+void ScriptCompiler::compact()
+{
+   auto move = [this](uint8_t& reg)
+   {
+      if (reg >= nextReg)
+         reg = static_cast<uint8_t>(nextReg + SCRIPT_MAX_REGISTERS - 1 - reg);
+   };
+   for (Script::Instruction& in : script.code)
+   {
+      move(in.dst);
+      move(in.a);
+      move(in.b);
+   }
+   script.numRegs = nextReg + SCRIPT_MAX_REGISTERS - lowestTemp;
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : COMPILE
+ *************************************************************************/
+bool ScriptCompiler::compile()
+{
+   try
+   {
+      next();
+      while (type != TOKEN_END)
+      {
+         if (type != TOKEN_NEWLINE)
+            statement();
+         if (type == TOKEN_NEWLINE)
+            next();
+         else if (type != TOKEN_END)
+            fail("expected the end of the line before '" + text + "'");
+      }
+      emit(OP_HALT, 0, 0, 0);
+
+      for (int i = SCRIPT_FIRST_FREE; i < nextReg; i++)
+         if (readLine[i] && !assigned[i])
+         {
+            line = readLine[i];
+            fail(script.names[i] + " is never set");
+         }
+      compact();
+   }
+   catch (const ScriptError&)
+   {
+      return false;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : STATEMENT
+ * name = expression
+ *************************************************************************/
+void ScriptCompiler::statement()
+{
+   if (type != TOKEN_NAME)
+      fail("expected a name before '" + text + "'");
+   std::string name = text;
+   int target = variable(name);
+   if (target < SCRIPT_NUM_INPUTS)
+      fail(name + " is an input and cannot be set");
+   next();
+   expect("=");
+
+   int value = expression();
+   Script::Instruction* last = script.code.empty() ? nullptr : &script.code.back();
+   if (value == tempTop + 1 && last && last->dst == value && last->op != OP_SEL)
+      last->dst = static_cast<uint8_t>(target);   // compute straight into the variable
+   else
+      emit(OP_MOV, target, value, 0);
+   release(value);
+   assigned[target] = true;
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : EXPRESSION
+ *************************************************************************/
+int ScriptCompiler::expression()
+{
+   return ternary();
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : TERNARY
+ * condition ? a : b. Neither side has side effects and both are cheap,
+ * so both are computed and one selected: no branch to mispredict.
+ *************************************************************************/
+int ScriptCompiler::ternary()
+{
+   int condition = binary(0);
+   if (!accept("?"))
+      return condition;
+
+   // The selection overwrites its condition, so that has to be a
+   // temporary of our own
+   int dst = condition;
+   if (condition != tempTop + 1)
+   {
+      dst = temp();
+      emit(OP_MOV, dst, condition, 0);
+   }
+   int a = expression();
+   expect(":");
+   int b = expression();
+   release(b);
+   release(a);
+   emit(OP_SEL, dst, a, b);
+   return dst;
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : BINARY
+ * Left-associative operators, loosest level first
+ *************************************************************************/
+int ScriptCompiler::binary(int level)
+{
+   struct Operator { const char* symbol; int op; };
+   static const Operator levels[][5] =
+   {
+      { { "||", OP_OR } },
+      { { "&&", OP_AND } },
+      { { "==", OP_EQ }, { "!=", OP_NE } },
+      { { "<", OP_LT }, { "<=", OP_LE }, { ">", OP_GT }, { ">=", OP_GE } },
+      { { "+", OP_ADD }, { "-", OP_SUB } },
+      { { "*", OP_MUL }, { "/", OP_DIV } }
+   };
+   const int numLevels = sizeof(levels) / sizeof(levels[0]);
+   if (level == numLevels)
+      return unary();
+
+   int lhs = binary(level + 1);
+   for (;;)
+   {
+      int op = -1;
+      for (const Operator& o : levels[level])
+         if (o.symbol && accept(o.symbol))
+         {
+            op = o.op;
+            break;
+         }
+      if (op < 0)
+         return lhs;
+      int rhs = binary(level + 1);
+      lhs = operation(op, lhs, rhs);
+   }
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : UNARY
+ *************************************************************************/
+int ScriptCompiler::unary()
+{
+   int op = accept("-") ? OP_NEG : accept("!") ? OP_NOT : -1;
+   if (op < 0)
+      return primary();
+   int a = unary();
+   return operation(op, a, a);
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : PRIMARY
+ * number, name, call or parenthesis
+ *************************************************************************/
+int ScriptCompiler::primary()
+{
+   if (type == TOKEN_NUMBER)
+   {
+      double value = number;
+      next();
+      return constantReg(value);
+   }
+   if (type == TOKEN_NAME)
+   {
+      std::string name = text;
+      next();
+      if (type == TOKEN_SYMBOL && text == "(")
+         return call(name);
+      int reg = variable(name);
+      if (!readLine[reg])
+         readLine[reg] = line;
+      return reg;
+   }
+   if (type == TOKEN_SYMBOL && text == "(")
+   {
+      if (depth >= SCRIPT_MAX_DEPTH)
+         fail("nested too deeply");
+      depth++;
+      next();
+      int value = expression();
+      depth--;
+      expect(")");
+      return value;
+   }
+   fail(text.empty() ? "unexpected end of script" : "unexpected '" + text + "'");
+   return 0;
+}
+
+/*************************************************************************
+ * SCRIPT COMPILER : CALL
+ *************************************************************************/
+int ScriptCompiler::call(const std::string& name)
+{
+   struct Function { const char* name; int op; int args; };
+   static const Function functions[] =
+   {
+      { "abs", OP_ABS, 1 }, { "sqrt", OP_SQRT, 1 }, { "sin", OP_SIN, 1 },
+      { "cos", OP_COS, 1 }, { "min", OP_MIN, 2 },   { "max", OP_MAX, 2 },
+      { "atan2", OP_ATAN2, 2 }
+   };
+   const Function* f = nullptr;
+   for (const Function& candidate : functions)
+      if (name == candidate.name)
+         f = &candidate;
+   if (!f)
+      fail("no function called " + name);
+   if (depth >= SCRIPT_MAX_DEPTH)
+      fail("nested too deeply");
+
+   depth++;
+   next();
+   int a = expression();
+   int b = a;
+   if (f->args == 2)
+   {
+      expect(",");
+      b = expression();
+   }
+   depth--;
+   expect(")");
+   return operation(f->op, a, b);
+}
+
+/*************************************************************************
+ * SCRIPT : CONSTRUCTOR
+ * An empty script: it sets nothing
+ *************************************************************************/
+Script::Script()
+{
+   compile("");
+}
+
+/*************************************************************************
+ * SCRIPT : COMPILE
+ *************************************************************************/
+bool Script::compile(const std::string& source)
+{
+   code.clear();
+   names.assign(SCRIPT_MAX_REGISTERS, std::string());
+   for (int i = 0; i < SCRIPT_FIRST_FREE; i++)
+      names[i] = registerNames[i];
+   std::fill(image, image + SCRIPT_MAX_REGISTERS, 0.0);
+   error.clear();
+
+   ScriptCompiler compiler(*this, source);
+   bool compiled = compiler.compile();
+   if (!compiled)
+   {
+      code.assign(1, Instruction{ OP_HALT, 0, 0, 0 });
+      numRegs = SCRIPT_FIRST_FREE;
+      std::fill(image, image + SCRIPT_MAX_REGISTERS, 0.0);
+   }
+   names.resize(numRegs);
+
+   // Constants never change, so each lane gets its copy once, here.
+   // The thrusters and variables are reset for every block.
+   lanes.assign(numRegs * SCRIPT_LANES, 0.0);
+   variables.clear();
+   for (int reg = SCRIPT_NUM_INPUTS; reg < numRegs; reg++)
+   {
+      std::fill(&lanes[reg * SCRIPT_LANES], &lanes[reg * SCRIPT_LANES] + SCRIPT_LANES, image[reg]);
+      if (!names[reg].empty())
+         variables.push_back(static_cast<uint8_t>(reg));
+   }
+
+   reset();
+   return compiled;
+}
+
+/*************************************************************************
+ * SCRIPT : RESET
+ *************************************************************************/
+void Script::reset()
+{
+   std::copy(image, image + numRegs, regs);
+}
+
+/*************************************************************************
+ * SCRIPT : FIND
+ *************************************************************************/
+int Script::find(const std::string& name) const
+{
+   for (int i = 0; i < static_cast<int>(names.size()); i++)
+      if (!name.empty() && names[i] == name)
+         return i;
+   return -1;
+}
+
+/*************************************************************************
+ * SCRIPT : GET THRUST
+ *************************************************************************/
+unsigned char Script::getThrust() const
+{
+   return (regs[SCRIPT_MAIN]    != 0.0 ? THRUST_BIT_MAIN    : 0) |
+          (regs[SCRIPT_CLOCK]   != 0.0 ? THRUST_BIT_CLOCK   : 0) |
+          (regs[SCRIPT_COUNTER] != 0.0 ? THRUST_BIT_COUNTER : 0);
+}
+
+/*************************************************************************
+ * SCRIPT : RUN
+ * The interpreter. Each instruction body ends by dispatching the next
+ * one: through a table of label addresses where the compiler has them
+ * (one indirect branch per instruction, each predicted on its own),
+ * otherwise back around a switch. Left to itself GCC folds the bodies'
+ * dispatches into one shared jump, which predicts far worse.
+ *************************************************************************/
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-crossjumping", "no-gcse")))
+#endif
+void Script::run(const double* inputs)
+{
+   double* r = regs;
+   for (int i = 0; i < SCRIPT_NUM_INPUTS; i++)
+      r[i] = inputs[i];
+
+   const Instruction* ip = code.data();
+
+#define A   r[ip->a]
+#define B   r[ip->b]
+#define DST r[ip->dst]
+#if defined(__GNUC__)
+   static void* const table[] =
+   {
+      &&OP_HALT, &&OP_MOV, &&OP_ADD, &&OP_SUB, &&OP_MUL, &&OP_DIV, &&OP_NEG,
+      &&OP_NOT, &&OP_LT, &&OP_LE, &&OP_GT, &&OP_GE, &&OP_EQ, &&OP_NE,
+      &&OP_AND, &&OP_OR, &&OP_ABS, &&OP_MIN, &&OP_MAX, &&OP_SQRT, &&OP_SIN,
+      &&OP_COS, &&OP_ATAN2, &&OP_SEL
+   };
+#define CASE(op)  op:
+#define NEXT      goto *table[ip->op]
+   NEXT;
+#else
+#define CASE(op)  case op:
+#define NEXT      continue
+   for (;;) switch (ip->op)
+   {
+#endif
+   CASE(OP_HALT)  return;
+   CASE(OP_MOV)   DST = A;                          ip++; NEXT;
+   CASE(OP_ADD)   DST = A + B;                      ip++; NEXT;
+   CASE(OP_SUB)   DST = A - B;                      ip++; NEXT;
+   CASE(OP_MUL)   DST = A * B;                      ip++; NEXT;
+   CASE(OP_DIV)   DST = A / B;                      ip++; NEXT;
+   CASE(OP_NEG)   DST = -A;                         ip++; NEXT;
+   CASE(OP_NOT)   DST = A == 0.0 ? 1.0 : 0.0;       ip++; NEXT;
+   CASE(OP_LT)    DST = A < B ? 1.0 : 0.0;          ip++; NEXT;
+   CASE(OP_LE)    DST = A <= B ? 1.0 : 0.0;         ip++; NEXT;
+   CASE(OP_GT)    DST = A > B ? 1.0 : 0.0;          ip++; NEXT;
+   CASE(OP_GE)    DST = A >= B ? 1.0 : 0.0;         ip++; NEXT;
+   CASE(OP_EQ)    DST = A == B ? 1.0 : 0.0;         ip++; NEXT;
+   CASE(OP_NE)    DST = A != B ? 1.0 : 0.0;         ip++; NEXT;
+   CASE(OP_AND)   DST = (A != 0.0) & (B != 0.0);    ip++; NEXT;
+   CASE(OP_OR)    DST = (A != 0.0) | (B != 0.0);    ip++; NEXT;
+   CASE(OP_ABS)   DST = std::fabs(A);               ip++; NEXT;
+   CASE(OP_MIN)   DST = std::min(A, B);             ip++; NEXT;
+   CASE(OP_MAX)   DST = std::max(A, B);             ip++; NEXT;
+   CASE(OP_SQRT)  DST = std::sqrt(A);               ip++; NEXT;
+   CASE(OP_SIN)   DST = std::sin(A);                ip++; NEXT;
+   CASE(OP_COS)   DST = std::cos(A);                ip++; NEXT;
+   CASE(OP_ATAN2) DST = std::atan2(A, B);           ip++; NEXT;
+   CASE(OP_SEL)   DST = DST != 0.0 ? A : B;         ip++; NEXT;
+#if !defined(__GNUC__)
+   }
+#endif
+#undef CASE
+#undef NEXT
+#undef A
+#undef B
+#undef DST
+}
+
+/*************************************************************************
+ * SCRIPT : RUN BATCH
+ * The same interpreter turned sideways: each instruction is dispatched
+ * once per block of SCRIPT_LANES landers and runs over all of them, so
+ * dispatch costs next to nothing and the loops vectorize. A short last
+ * block is padded with copies of its last lander.
+ *************************************************************************/
+#if defined(__GNUC__) && !defined(__clang__)
+#define IVDEP  _Pragma("GCC ivdep")
+#else
+#define IVDEP
+#endif
+void Script::runBatch(const double* inputs, int count, unsigned char* thrust)
+{
+   double* base = lanes.data();
+   for (int first = 0; first < count; first += SCRIPT_LANES)
+   {
+      int n = std::min(SCRIPT_LANES, count - first);
+      const double* block = inputs + first * SCRIPT_NUM_INPUTS;
+      int rows[SCRIPT_LANES];
+      for (int lane = 0; lane < SCRIPT_LANES; lane++)
+         rows[lane] = std::min(lane, n - 1) * SCRIPT_NUM_INPUTS;
+      for (int i = 0; i < SCRIPT_NUM_INPUTS; i++)
+         for (int lane = 0; lane < SCRIPT_LANES; lane++)
+            base[i * SCRIPT_LANES + lane] = block[rows[lane] + i];
+      for (uint8_t reg : variables)
+         std::fill(base + reg * SCRIPT_LANES, base + (reg + 1) * SCRIPT_LANES, image[reg]);
+
+      for (const Instruction* ip = code.data(); ip->op != OP_HALT; ip++)
+      {
+         double* d = base + ip->dst * SCRIPT_LANES;
+         const double* a = base + ip->a * SCRIPT_LANES;
+         const double* b = base + ip->b * SCRIPT_LANES;
+#define LANES(value)  IVDEP for (int k = 0; k < SCRIPT_LANES; k++) d[k] = (value); break
+         switch (ip->op)
+         {
+            case OP_MOV:   LANES(a[k]);
+            case OP_ADD:   LANES(a[k] + b[k]);
+            case OP_SUB:   LANES(a[k] - b[k]);
+            case OP_MUL:   LANES(a[k] * b[k]);
+            case OP_DIV:   LANES(a[k] / b[k]);
+            case OP_NEG:   LANES(-a[k]);
+            case OP_NOT:   LANES(a[k] == 0.0 ? 1.0 : 0.0);
+            case OP_LT:    LANES(a[k] <  b[k] ? 1.0 : 0.0);
+            case OP_LE:    LANES(a[k] <= b[k] ? 1.0 : 0.0);
+            case OP_GT:    LANES(a[k] >  b[k] ? 1.0 : 0.0);
+            case OP_GE:    LANES(a[k] >= b[k] ? 1.0 : 0.0);
+            case OP_EQ:    LANES(a[k] == b[k] ? 1.0 : 0.0);
+            case OP_NE:    LANES(a[k] != b[k] ? 1.0 : 0.0);
+            case OP_AND:   LANES((a[k] != 0.0) & (b[k] != 0.0) ? 1.0 : 0.0);
+            case OP_OR:    LANES((a[k] != 0.0) | (b[k] != 0.0) ? 1.0 : 0.0);
+            case OP_ABS:   LANES(std::fabs(a[k]));
+            case OP_MIN:   LANES(b[k] < a[k] ? b[k] : a[k]);
+            case OP_MAX:   LANES(a[k] < b[k] ? b[k] : a[k]);
+            case OP_SQRT:  LANES(std::sqrt(a[k]));
+            case OP_SIN:   LANES(std::sin(a[k]));
+            case OP_COS:   LANES(std::cos(a[k]));
+            case OP_ATAN2: LANES(std::atan2(a[k], b[k]));
+            case OP_SEL:   LANES(d[k] != 0.0 ? a[k] : b[k]);
+         }
+#undef LANES
+      }
+
+      const double* main    = base + SCRIPT_MAIN * SCRIPT_LANES;
+      const double* clock   = base + SCRIPT_CLOCK * SCRIPT_LANES;
+      const double* counter = base + SCRIPT_COUNTER * SCRIPT_LANES;
+      for (int lane = 0; lane < n; lane++)
+         thrust[first + lane] = (main[lane]    != 0.0 ? THRUST_BIT_MAIN    : 0) |
+                                (clock[lane]   != 0.0 ? THRUST_BIT_CLOCK   : 0) |
+                                (counter[lane] != 0.0 ? THRUST_BIT_COUNTER : 0);
+   }
+}
@@ -0,0 +1,125 @@
+/***********************************************************************
+ * Header File:
+ *    SCRIPT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A tiny expression language for autopilots and scenario triggers,
+ *    compiled to register bytecode. A script is a list of assignments,
+ *    one per line or separated by semicolons:
+ *
+ *       # tilt toward the pad, burn when falling too fast
+ *       tilt    = max(-0.4, min(0.4, ((padX - x) * 0.05 - dx) * 0.15))
+ *       want    = altitude < 15 ? 0 : -tilt
+ *       clock   = angle > want + 0.05
+ *       counter = angle < want - 0.05
+ *       main    = dy < -(1 + altitude * 0.05)
+ *
+ *    The inputs (x, y, dx, dy, angle, ...) are read-only. main, clock
+ *    and counter are the thrusters: non-zero fires. Anything else is a
+ *    variable, zero until first set, and it keeps its value from one
+ *    run to the next until reset(). A trigger is simply a variable the
+ *    host reads after run().
+ *
+ *    Operators, loosest first: ?:  ||  &&  == !=  < <= > >=  + -  * /
+ *    unary - and !. Comparisons and logic give 1 or 0. Functions: abs,
+ *    min, max, sqrt, sin, cos, atan2.
+ *
+ *    Every register, inputs, constants, variables and temporaries alike,
+ *    lives in one fixed array, so a run touches no heap. Dispatch is a
+ *    computed goto where the compiler has one, a switch elsewhere.
+ ************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Forward declaration for unit tests
+class TestScript;
+
+// The inputs, in register order
+enum ScriptInput
+{
+   SCRIPT_X = 0,        // meters
+   SCRIPT_Y,
+   SCRIPT_DX,           // meters/second
+   SCRIPT_DY,
+   SCRIPT_SPEED,
+   SCRIPT_ANGLE,        // radians in (-PI, PI], 0 is upright
+   SCRIPT_FUEL,         // kilograms
+   SCRIPT_ALTITUDE,     // meters above the ground below
+   SCRIPT_PAD_X,        // meters, center of the platform
+   SCRIPT_PAD_Y,
+   SCRIPT_PAD_WIDTH,
+   SCRIPT_WIDTH,        // meters, of the lander
+   SCRIPT_FRAME,        // frames since the mission started
+   SCRIPT_NUM_INPUTS
+};
+
+// Registers are addressed by a byte
+#define SCRIPT_MAX_REGISTERS  256
+
+// Landers runBatch() takes through each instruction at once
+#define SCRIPT_LANES  16
+
+/*****************************************************
+ * SCRIPT
+ * Compile once, run every frame
+ *****************************************************/
+class Script
+{
+   friend TestScript;
+
+public:
+   Script();
+
+   // False, with getError() saying where and why, if the source does
+   // not compile. The script is then empty.
+   bool compile(const std::string& source);
+   const std::string& getError() const { return error; }
+
+   // Variables back to zero
+   void reset();
+
+   // Run once over the inputs (SCRIPT_NUM_INPUTS of them)
+   void run(const double* inputs);
+
+   // ThrustBits from main, clock and counter
+   unsigned char getThrust() const;
+
+   // Run once for each of count landers: their inputs one after the
+   // other, their ThrustBits out. Every lander starts as if reset(), so
+   // variables carry nothing between frames or between landers, and
+   // the variables run() sees are left alone.
+   void runBatch(const double* inputs, int count, unsigned char* thrust);
+
+   // Register of a variable, input or thruster, -1 if there is none
+   int find(const std::string& name) const;
+   double get(int reg) const { return regs[reg]; }
+
+   // Instructions in the compiled script
+   int size() const { return static_cast<int>(code.size()); }
+
+private:
+   struct Instruction
+   {
+      uint8_t op;
+      uint8_t dst;      // also the condition of a select
+      uint8_t a;
+      uint8_t b;
+   };
+
+   std::vector<Instruction> code;
+   int numRegs;                        // in use: inputs, thrusters, variables,
+                                       // constants, then temporaries
+   std::vector<std::string> names;     // by register, empty for constants and temporaries
+   double image[SCRIPT_MAX_REGISTERS]; // registers as reset() leaves them
+   double regs[SCRIPT_MAX_REGISTERS];
+   std::vector<double> lanes;          // runBatch() registers, SCRIPT_LANES each
+   std::vector<uint8_t> variables;     // thrusters and variables, reset per block
+   std::string error;
+
+   friend class ScriptCompiler;
+};
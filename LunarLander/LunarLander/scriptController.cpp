@@ -0,0 +1,71 @@
+/***********************************************************************
+ * Source File:
+ *    SCRIPT CONTROLLER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A controller flown by a script
+ ************************************************************************/
+
+#include "scriptController.h"
+#include <cmath>   // for atan2, sin, cos
+
+/*************************************************************************
+ * SCRIPT CONTROLLER : OBSERVE
+ *************************************************************************/
+void ScriptController::observe(const Lander& lander, const Ground& ground,
+                               int frame, double* inputs)
+{
+   Position pos = lander.getPosition();
+   Velocity v = lander.getVelocity();
+   double radians = lander.getAngle().getRadians();
+
+   inputs[SCRIPT_X]         = pos.getX();
+   inputs[SCRIPT_Y]         = pos.getY();
+   inputs[SCRIPT_DX]        = v.getDX();
+   inputs[SCRIPT_DY]        = v.getDY();
+   inputs[SCRIPT_SPEED]     = lander.getSpeed();
+   inputs[SCRIPT_ANGLE]     = atan2(sin(radians), cos(radians));
+   inputs[SCRIPT_FUEL]      = lander.getFuelMass().value();
+   inputs[SCRIPT_ALTITUDE]  = pos.getY() - ground.getElevationMeters(pos);
+   inputs[SCRIPT_PAD_X]     = ground.getPlatformPosition().getX();
+   inputs[SCRIPT_PAD_Y]     = ground.getPlatformPosition().getY();
+   inputs[SCRIPT_PAD_WIDTH] = ground.getPlatformWidth();
+   inputs[SCRIPT_WIDTH]     = lander.getWidth();
+   inputs[SCRIPT_FRAME]     = frame;
+}
+
+/*************************************************************************
+ * SCRIPT CONTROLLER : START
+ * Every mission starts with the script's variables at zero
+ *************************************************************************/
+void ScriptController::start(uint32_t /*seed*/)
+{
+   script.reset();
+   frame = 0;
+}
+
+/*************************************************************************
+ * SCRIPT CONTROLLER : DECIDE
+ *************************************************************************/
+unsigned char ScriptController::decide(const Lander& lander, const Ground& ground)
+{
+   double inputs[SCRIPT_NUM_INPUTS];
+   observe(lander, ground, frame++, inputs);
+   script.run(inputs);
+   return script.getThrust();
+}
+
+/*************************************************************************
+ * SCRIPT CONTROLLER : DECIDE ALL
+ *************************************************************************/
+void ScriptController::decideAll(const Lander* const* landers, int count,
+                                 const Ground& ground, unsigned char* bits)
+{
+   if (static_cast<int>(inputs.size()) < count * SCRIPT_NUM_INPUTS)
+      inputs.resize(count * SCRIPT_NUM_INPUTS);
+   for (int i = 0; i < count; i++)
+      observe(*landers[i], ground, frame, &inputs[i * SCRIPT_NUM_INPUTS]);
+   frame++;
+   script.runBatch(inputs.data(), count, bits);
+}
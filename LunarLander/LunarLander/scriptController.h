@@ -0,0 +1,55 @@
+/***********************************************************************
+ * Header File:
+ *    SCRIPT CONTROLLER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A Controller whose decisions come from a script (script.h), so an
+ *    autopilot can be written without a compiler and still fly batch
+ *    evaluations in this process
+ ************************************************************************/
+
+#pragma once
+
+#include "controller.h"
+#include "script.h"
+#include <string>
+#include <vector>
+
+/*****************************************************
+ * SCRIPT CONTROLLER
+ *****************************************************/
+class ScriptController : public Controller
+{
+public:
+   ScriptController() : frame(0) {}
+
+   // False, with getError() saying where and why, if it does not compile
+   bool compile(const std::string& source) { return script.compile(source); }
+   const std::string& getError() const { return script.getError(); }
+   const Script& getScript() const { return script; }
+
+   // The inputs a script sees for this lander over this ground
+   static void observe(const Lander& lander, const Ground& ground, int frame, double* inputs);
+
+   // Controller
+   int getId() const { return CONTROLLER_SCRIPT; }
+   void start(uint32_t seed);
+   unsigned char decide(const Lander& lander, const Ground& ground);
+
+   // All in one go (Script::runBatch). Each lander sees the script's
+   // variables at zero.
+   void decideAll(const Lander* const* landers, int count,
+                  const Ground& ground, unsigned char* bits);
+
+   // With the script's variables as they stand
+   std::unique_ptr<Controller> clone() const
+   {
+      return std::unique_ptr<Controller>(new ScriptController(*this));
+   }
+
+private:
+   Script script;
+   int frame;
+   std::vector<double> inputs;   // for decideAll(), kept between calls
+};
@@ -0,0 +1,352 @@
+/***********************************************************************
+ * Source File:
+ *    SESSION LOG
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Append-only attempt log with batched syncs and compaction
+ ************************************************************************/
+
+#include "sessionLog.h"
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>   // for memcpy, memset, strncpy
+#include <cstdio>    // for rename, snprintf
+#include <cerrno>
+
+/*************************************************************************
+ * CHECKSUM
+ * FNV-1a over the record with the checksum field zeroed. Catches the
+ * torn last record of a log that was cut off mid-write.
+ *************************************************************************/
+static uint32_t checksum(const AttemptRecord& record)
+{
+   AttemptRecord copy = record;
+   copy.checksum = 0;
+   const unsigned char* p = reinterpret_cast<const unsigned char*>(&copy);
+   uint32_t hash = 2166136261u;
+   for (size_t i = 0; i < sizeof(copy); i++)
+      hash = (hash ^ p[i]) * 16777619u;
+   return hash;
+}
+
+/*************************************************************************
+ * WRITE FULLY
+ *************************************************************************/
+static bool writeFully(int fd, const void* buffer, size_t size)
+{
+   const char* p = static_cast<const char*>(buffer);
+   while (size > 0)
+   {
+      ssize_t n = write(fd, p, size);
+      if (n < 0 && errno == EINTR)
+         continue;
+      if (n <= 0)
+         return false;
+      p += n;
+      size -= n;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * SESSION LOG : CONSTRUCTOR
+ *************************************************************************/
+SessionLog::SessionLog() :
+   fd(-1),
+   generation(0),
+   logRecords(0),
+   syncRecords(64),
+   syncSeconds(1.0),
+   lastSync(std::chrono::steady_clock::now()),
+   compactThreshold(10000)
+{
+}
+
+/*************************************************************************
+ * SESSION LOG : SET SYNC POLICY
+ *************************************************************************/
+void SessionLog::setSyncPolicy(int records, double seconds)
+{
+   syncRecords = records > 0 ? records : 1;
+   syncSeconds = seconds;
+}
+
+/*************************************************************************
+ * SESSION LOG : LOG PATH
+ *************************************************************************/
+std::string SessionLog::logPath(uint32_t gen) const
+{
+   char name[32];
+   snprintf(name, sizeof(name), "/attempts.%u", gen);
+   return directory + name;
+}
+
+/*************************************************************************
+ * SESSION LOG : OPEN
+ *************************************************************************/
+bool SessionLog::open(const std::string& directory)
+{
+   close();
+   if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+      return false;
+   this->directory = directory;
+   generation = 0;
+   pilots.clear();
+
+   // The summary: everything up to the current log
+   int summary = ::open((directory + "/summary").c_str(), O_RDONLY);
+   if (summary >= 0)
+   {
+      SessionSummaryHeader header;
+      if (read(summary, &header, sizeof(header)) == sizeof(header) &&
+          header.magic == SESSION_LOG_MAGIC && header.version == SESSION_LOG_VERSION)
+      {
+         std::vector<PilotStats> stats(header.numPilots);
+         size_t bytes = stats.size() * sizeof(PilotStats);
+         if (bytes == 0 || read(summary, stats.data(), bytes) == static_cast<ssize_t>(bytes))
+         {
+            generation = header.generation;
+            for (PilotStats& pilot : stats)
+            {
+               pilot.name[SESSION_PILOT_NAME - 1] = '\0';
+               pilots[pilot.name] = pilot;
+            }
+         }
+      }
+      ::close(summary);
+   }
+
+   // A compaction that stopped before removing the old log
+   if (generation > 0)
+      unlink(logPath(generation - 1).c_str());
+
+   if (!openLog())
+      return false;
+   if (logRecords >= static_cast<uint64_t>(compactThreshold))
+      compact();
+   return true;
+}
+
+/*************************************************************************
+ * SESSION LOG : OPEN LOG
+ * Replay the current log and cut off anything after the last good record
+ *************************************************************************/
+bool SessionLog::openLog()
+{
+   fd = ::open(logPath(generation).c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+   if (fd < 0)
+      return false;
+
+   logRecords = 0;
+   AttemptRecord buffer[256];
+   bool torn = false;
+   ssize_t n;
+   while (!torn && (n = read(fd, buffer, sizeof(buffer))) > 0)
+   {
+      size_t count = n / sizeof(AttemptRecord);
+      for (size_t i = 0; i < count && !torn; i++)
+      {
+         if (buffer[i].magic != SESSION_LOG_MAGIC || buffer[i].checksum != checksum(buffer[i]))
+            torn = true;
+         else
+         {
+            apply(buffer[i]);
+            logRecords++;
+         }
+      }
+      if (n % sizeof(AttemptRecord) != 0)
+         torn = true;
+   }
+
+   if (torn && ftruncate(fd, logRecords * sizeof(AttemptRecord)) != 0)
+      return false;
+   lastSync = std::chrono::steady_clock::now();
+   return true;
+}
+
+/*************************************************************************
+ * SESSION LOG : CLOSE
+ *************************************************************************/
+void SessionLog::close()
+{
+   if (fd < 0)
+      return;
+   flush();
+   ::close(fd);
+   fd = -1;
+}
+
+/*************************************************************************
+ * SESSION LOG : APPLY
+ * Fold one attempt into the pilot's stats
+ *************************************************************************/
+void SessionLog::apply(const AttemptRecord& record)
+{
+   char name[SESSION_PILOT_NAME];
+   memcpy(name, record.pilot, sizeof(name));
+   name[SESSION_PILOT_NAME - 1] = '\0';
+
+   auto it = pilots.find(name);
+   if (it == pilots.end())
+   {
+      PilotStats fresh;
+      memset(&fresh, 0, sizeof(fresh));
+      memcpy(fresh.name, name, sizeof(name));
+      fresh.firstAttempt = record.when;
+      it = pilots.insert(std::make_pair(std::string(name), fresh)).first;
+   }
+
+   PilotStats& pilot = it->second;
+   pilot.attempts++;
+   pilot.recent = (pilot.recent << 1) | (record.landed ? 1u : 0u);
+   pilot.lastAttempt = record.when;
+   if (record.landed)
+   {
+      if (pilot.successes == 0 || record.speed < pilot.softestLanding)
+         pilot.softestLanding = record.speed;
+      pilot.successes++;
+      pilot.fuelLeft += record.fuel;
+   }
+}
+
+/*************************************************************************
+ * SESSION LOG : RECORD
+ *************************************************************************/
+void SessionLog::record(const std::string& pilot, bool landed, double speed,
+                        double fuel, time_t when)
+{
+   AttemptRecord record;
+   memset(&record, 0, sizeof(record));
+   record.magic = SESSION_LOG_MAGIC;
+   strncpy(record.pilot, pilot.c_str(), SESSION_PILOT_NAME - 1);
+   record.when = static_cast<int64_t>(when);
+   record.speed = speed;
+   record.fuel = fuel;
+   record.landed = landed ? 1 : 0;
+   record.checksum = checksum(record);
+
+   apply(record);
+   if (fd < 0)
+      return;
+   pending.push_back(record);
+
+   std::chrono::duration<double> sinceSync = std::chrono::steady_clock::now() - lastSync;
+   if (static_cast<int>(pending.size()) >= syncRecords || sinceSync.count() >= syncSeconds)
+      flush();
+   if (logRecords + pending.size() >= static_cast<uint64_t>(compactThreshold))
+      compact();
+}
+
+/*************************************************************************
+ * SESSION LOG : FLUSH
+ * One write and one sync for everything recorded since the last flush
+ *************************************************************************/
+bool SessionLog::flush()
+{
+   if (fd < 0)
+      return false;
+   lastSync = std::chrono::steady_clock::now();
+   if (pending.empty())
+      return true;
+
+   bool ok = writeFully(fd, pending.data(), pending.size() * sizeof(AttemptRecord)) &&
+             fdatasync(fd) == 0;
+   if (ok)
+   {
+      logRecords += pending.size();
+      pending.clear();
+   }
+   return ok;
+}
+
+/*************************************************************************
+ * SESSION LOG : WRITE SUMMARY
+ * Write, sync, then rename: the summary on disk is always whole
+ *************************************************************************/
+bool SessionLog::writeSummary(uint32_t nextGeneration)
+{
+   std::string path = directory + "/summary";
+   std::string temp = path + ".tmp";
+   int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if (out < 0)
+      return false;
+
+   SessionSummaryHeader header = { SESSION_LOG_MAGIC, SESSION_LOG_VERSION,
+                                   nextGeneration,
+                                   static_cast<uint32_t>(pilots.size()) };
+   std::vector<PilotStats> stats;
+   stats.reserve(pilots.size());
+   for (auto& pilot : pilots)
+      stats.push_back(pilot.second);
+
+   bool ok = writeFully(out, &header, sizeof(header)) &&
+             writeFully(out, stats.data(), stats.size() * sizeof(PilotStats)) &&
+             fsync(out) == 0;
+   ok = ::close(out) == 0 && ok;
+   if (!ok || rename(temp.c_str(), path.c_str()) != 0)
+   {
+      unlink(temp.c_str());
+      return false;
+   }
+
+   // Make the rename itself durable
+   int dir = ::open(directory.c_str(), O_RDONLY);
+   if (dir >= 0)
+   {
+      fsync(dir);
+      ::close(dir);
+   }
+   return true;
+}
+
+/*************************************************************************
+ * SESSION LOG : COMPACT
+ * Everything so far goes into the summary; the next log starts empty
+ *************************************************************************/
+bool SessionLog::compact()
+{
+   if (fd < 0 || !flush() || !writeSummary(generation + 1))
+      return false;
+
+   ::close(fd);
+   fd = -1;
+   unlink(logPath(generation).c_str());
+   generation++;
+   return openLog();
+}
+
+/*************************************************************************
+ * SESSION LOG : GET PILOT
+ *************************************************************************/
+const PilotStats* SessionLog::getPilot(const std::string& pilot) const
+{
+   auto it = pilots.find(pilot.substr(0, SESSION_PILOT_NAME - 1));
+   return it == pilots.end() ? nullptr : &it->second;
+}
+
+/*************************************************************************
+ * SESSION LOG : GET TOTALS
+ * Everybody together; recent is meaningless across pilots and left 0
+ *************************************************************************/
+PilotStats SessionLog::getTotals() const
+{
+   PilotStats totals;
+   memset(&totals, 0, sizeof(totals));
+   for (auto& entry : pilots)
+   {
+      const PilotStats& pilot = entry.second;
+      if (pilot.successes > 0 &&
+          (totals.successes == 0 || pilot.softestLanding < totals.softestLanding))
+         totals.softestLanding = pilot.softestLanding;
+      if (totals.attempts == 0 || pilot.firstAttempt < totals.firstAttempt)
+         totals.firstAttempt = pilot.firstAttempt;
+      if (pilot.lastAttempt > totals.lastAttempt)
+         totals.lastAttempt = pilot.lastAttempt;
+      totals.attempts += pilot.attempts;
+      totals.successes += pilot.successes;
+      totals.fuelLeft += pilot.fuelLeft;
+   }
+   return totals;
+}
@@ -0,0 +1,120 @@
+/***********************************************************************
+ * Header File:
+ *    SESSION LOG
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Every landing attempt, kept across runs of the game. Attempts are
+ *    appended to a log and synced to disk in batches, so recording one
+ *    costs a memory copy. Once the log grows long enough it is folded
+ *    into a summary of per-pilot totals and a fresh log is started, so
+ *    opening the statistics reads one small summary plus a short log no
+ *    matter how many attempts have ever been made.
+ *
+ *    A log directory holds:
+ *       summary          SessionSummaryHeader then PilotStats[numPilots]
+ *       attempts.<gen>   AttemptRecord[], gen from the summary
+ ************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include <chrono>
+#include <stdint.h>
+
+// Forward declaration for unit tests
+class TestSessionLog;
+
+#define SESSION_LOG_MAGIC     0x474c534cu   // "LSLG"
+#define SESSION_LOG_VERSION   1u
+#define SESSION_PILOT_NAME    16            // bytes, including the terminator
+
+// One attempt as it sits in the log
+struct AttemptRecord
+{
+   uint32_t magic;                       // SESSION_LOG_MAGIC
+   uint32_t checksum;                    // of the record with this set to 0
+   char     pilot[SESSION_PILOT_NAME];
+   int64_t  when;                        // time_t of the touchdown
+   double   speed;                       // m/s at touchdown
+   double   fuel;                        // kg left
+   int32_t  landed;                      // 1 landed, 0 crashed
+   int32_t  reserved;
+};
+
+// Everything we remember about one pilot
+struct PilotStats
+{
+   char     name[SESSION_PILOT_NAME];
+   uint64_t attempts;
+   uint64_t successes;
+   double   softestLanding;     // m/s, 0 until the first success
+   double   fuelLeft;           // kg, total over successful landings
+   uint32_t recent;            // last 32 attempts, newest in bit 0, 1 = landed
+   uint32_t reserved;
+   int64_t  firstAttempt;       // time_t
+   int64_t  lastAttempt;        // time_t
+};
+
+// Start of the summary file
+struct SessionSummaryHeader
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t generation;         // which attempts.<gen> continues the summary
+   uint32_t numPilots;
+};
+
+/*****************************************************
+ * SESSION LOG
+ *****************************************************/
+class SessionLog
+{
+   friend TestSessionLog;
+
+public:
+   SessionLog();
+   ~SessionLog() { close(); }
+   SessionLog(const SessionLog&) = delete;
+   SessionLog& operator=(const SessionLog&) = delete;
+
+   // Load the summary and replay the current log
+   bool open(const std::string& directory);
+   void close();
+
+   // Sync after this many attempts or this many seconds, whichever first
+   void setSyncPolicy(int records, double seconds);
+
+   // Fold the log into the summary after this many attempts
+   void setCompactThreshold(int records) { compactThreshold = records > 0 ? records : 1; }
+
+   void record(const std::string& pilot, bool landed, double speed, double fuel,
+               time_t when);
+   bool flush();
+   bool compact();
+
+   // Stats for one pilot (nullptr if never seen) and across everybody
+   const PilotStats* getPilot(const std::string& pilot) const;
+   PilotStats getTotals() const;
+   int getNumPilots() const { return static_cast<int>(pilots.size()); }
+
+private:
+   std::string directory;
+   int fd;                               // current attempts.<gen>, append only
+   uint32_t generation;
+   std::map<std::string, PilotStats> pilots;
+   std::vector<AttemptRecord> pending;   // recorded, not yet on disk
+   uint64_t logRecords;                  // records in the current log
+   int syncRecords;
+   double syncSeconds;
+   std::chrono::steady_clock::time_point lastSync;
+   int compactThreshold;
+
+   std::string logPath(uint32_t gen) const;
+   bool openLog();
+   void apply(const AttemptRecord& record);
+   bool writeSummary(uint32_t nextGeneration);
+};
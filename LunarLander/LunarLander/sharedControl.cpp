@@ -0,0 +1,307 @@
+/***********************************************************************
+ * Source File:
+ *    SHARED CONTROL
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Lockstep control of a batch of landers through shared memory
+ ************************************************************************/
+
+#include "sharedControl.h"
+#include "world.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <new>       // for placement new
+#include <thread>    // for std::this_thread
+#include <chrono>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif // __linux__
+
+// Spin this many times before going to sleep on a doorbell. A lockstep
+// round trip is a few microseconds, so most waits end while spinning.
+// With a single core spinning only delays the other side, so don't.
+static const int SPIN_LIMIT = (std::thread::hardware_concurrency() > 1) ? 20000 : 0;
+
+// How long an agent waits for the simulator to initialize the region
+static const int ATTACH_TIMEOUT_MS = 5000;
+
+/*************************************************************************
+ * ROUND UP
+ * Keep every array on its own cache lines
+ *************************************************************************/
+static size_t roundUp(size_t value)
+{
+   return (value + 63) & ~static_cast<size_t>(63);
+}
+
+/*************************************************************************
+ * CPU RELAX
+ * Be polite to the other hyperthread while spinning
+ *************************************************************************/
+static inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+   __builtin_ia32_pause();
+#elif defined(__aarch64__)
+   asm volatile("yield");
+#endif
+}
+
+/*************************************************************************
+ * SLEEP ON BELL
+ * Block until the bell no longer reads seen (spurious wakeups are fine)
+ *************************************************************************/
+static void sleepOnBell(std::atomic<uint32_t>& bell, uint32_t seen)
+{
+#ifdef __linux__
+   syscall(SYS_futex, reinterpret_cast<uint32_t*>(&bell), FUTEX_WAIT, seen,
+           nullptr, nullptr, 0);
+#else
+   (void)bell;
+   (void)seen;
+   std::this_thread::yield();
+#endif // __linux__
+}
+
+/*************************************************************************
+ * WAKE BELL
+ *************************************************************************/
+static void wakeBell(std::atomic<uint32_t>& bell)
+{
+#ifdef __linux__
+   syscall(SYS_futex, reinterpret_cast<uint32_t*>(&bell), FUTEX_WAKE, 1,
+           nullptr, nullptr, 0);
+#else
+   (void)bell;
+#endif // __linux__
+}
+
+/*************************************************************************
+ * RING BELL
+ * Only pay for the system call when somebody is actually asleep
+ *************************************************************************/
+static void ringBell(std::atomic<uint32_t>& bell, std::atomic<uint32_t>& sleepers)
+{
+   bell.fetch_add(1);
+   if (sleepers.load() > 0)
+      wakeBell(bell);
+}
+
+/*************************************************************************
+ * WAIT BELL
+ * Spin first, then sleep. Returns the new bell value.
+ *************************************************************************/
+static uint32_t waitBell(std::atomic<uint32_t>& bell, std::atomic<uint32_t>& sleepers,
+                         uint32_t seen)
+{
+   for (int spin = 0; spin < SPIN_LIMIT; spin++)
+   {
+      uint32_t now = bell.load(std::memory_order_acquire);
+      if (now != seen)
+         return now;
+      cpuRelax();
+   }
+
+   uint32_t now;
+   while ((now = bell.load()) == seen)
+   {
+      sleepers.fetch_add(1);
+      sleepOnBell(bell, seen);
+      sleepers.fetch_sub(1);
+   }
+   return now;
+}
+
+/*************************************************************************
+ * SHARED CONTROL : REGION SIZE
+ *************************************************************************/
+size_t SharedControl::regionSize(int numLanders)
+{
+   return roundUp(sizeof(SharedControlHeader)) +
+          roundUp(sizeof(lander_observation) * numLanders) +
+          roundUp(static_cast<size_t>(numLanders));
+}
+
+/*************************************************************************
+ * SHARED CONTROL : OBSERVATIONS
+ *************************************************************************/
+lander_observation* SharedControl::observations() const
+{
+   char* base = reinterpret_cast<char*>(region);
+   return reinterpret_cast<lander_observation*>(base + roundUp(sizeof(SharedControlHeader)));
+}
+
+/*************************************************************************
+ * SHARED CONTROL : ACTIONS
+ *************************************************************************/
+uint8_t* SharedControl::actions() const
+{
+   char* base = reinterpret_cast<char*>(region);
+   return reinterpret_cast<uint8_t*>(base + roundUp(sizeof(SharedControlHeader)) +
+                                     roundUp(sizeof(lander_observation) * region->numLanders));
+}
+
+/*************************************************************************
+ * SHARED CONTROL : CREATE
+ *************************************************************************/
+bool SharedControl::create(const std::string& regionName, int numLanders)
+{
+   close();
+   if (numLanders <= 0)
+      return false;
+
+   name = (regionName.empty() || regionName[0] != '/') ? "/" + regionName : regionName;
+   int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+   if (fd < 0)
+      return false;
+
+   size = regionSize(numLanders);
+   void* p = MAP_FAILED;
+   if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+      p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   ::close(fd);
+   if (p == MAP_FAILED)
+   {
+      shm_unlink(name.c_str());
+      return false;
+   }
+
+   // magic stays zero until serve() has published the first observations
+   region = new (p) SharedControlHeader();
+   region->magic = 0;
+   region->version = SHARED_CONTROL_VERSION;
+   region->numLanders = numLanders;
+   owner = true;
+   return true;
+}
+
+/*************************************************************************
+ * SHARED CONTROL : ATTACH
+ *************************************************************************/
+bool SharedControl::attach(const std::string& regionName)
+{
+   close();
+
+   name = (regionName.empty() || regionName[0] != '/') ? "/" + regionName : regionName;
+   int fd = shm_open(name.c_str(), O_RDWR, 0600);
+   if (fd < 0)
+      return false;
+
+   struct stat info;
+   void* p = MAP_FAILED;
+   if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SharedControlHeader))
+   {
+      size = static_cast<size_t>(info.st_size);
+      p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   }
+   ::close(fd);
+   if (p == MAP_FAILED)
+      return false;
+   region = static_cast<SharedControlHeader*>(p);
+
+   // wait for the simulator to publish the first observations
+   auto deadline = std::chrono::steady_clock::now() +
+                   std::chrono::milliseconds(ATTACH_TIMEOUT_MS);
+   while (__atomic_load_n(&region->magic, __ATOMIC_ACQUIRE) != SHARED_CONTROL_MAGIC)
+   {
+      if (std::chrono::steady_clock::now() > deadline)
+      {
+         close();
+         return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+
+   if (region->version != SHARED_CONTROL_VERSION ||
+       size < regionSize(region->numLanders))
+   {
+      close();
+      return false;
+   }
+
+   lastObservation = region->observationBell.load();
+   return true;
+}
+
+/*************************************************************************
+ * SHARED CONTROL : CLOSE
+ *************************************************************************/
+void SharedControl::close()
+{
+   if (region)
+      munmap(region, size);
+   if (owner)
+      shm_unlink(name.c_str());
+
+   region = nullptr;
+   size = 0;
+   owner = false;
+}
+
+/*************************************************************************
+ * SHARED CONTROL : SUBMIT ACTIONS
+ *************************************************************************/
+void SharedControl::submitActions(uint32_t command, uint32_t commandArg)
+{
+   region->command = command;
+   region->commandArg = commandArg;
+   lastObservation = region->observationBell.load();
+   ringBell(region->actionBell, region->actionSleepers);
+}
+
+/*************************************************************************
+ * SHARED CONTROL : WAIT OBSERVATIONS
+ *************************************************************************/
+void SharedControl::waitObservations()
+{
+   lastObservation = waitBell(region->observationBell, region->observationSleepers,
+                              lastObservation);
+}
+
+/*************************************************************************
+ * SHARED CONTROL : PUBLISH
+ *************************************************************************/
+void SharedControl::publish(const World& world)
+{
+   world.observe(0, region->numLanders, observations());
+   region->flying = world.numFlying();
+   region->frame = static_cast<uint64_t>(world.getFrame());
+   ringBell(region->observationBell, region->observationSleepers);
+}
+
+/*************************************************************************
+ * SHARED CONTROL : SERVE
+ * The simulator's half of the lockstep loop
+ *************************************************************************/
+void SharedControl::serve(World& world)
+{
+   if (!region || world.size() != region->numLanders)
+      return;
+
+   lastAction = region->actionBell.load();
+   publish(world);
+   __atomic_store_n(&region->magic, SHARED_CONTROL_MAGIC, __ATOMIC_RELEASE);
+
+   for (;;)
+   {
+      lastAction = waitBell(region->actionBell, region->actionSleepers, lastAction);
+
+      if (region->command == SHARED_STOP)
+      {
+         ringBell(region->observationBell, region->observationSleepers);
+         return;
+      }
+
+      if (region->command == SHARED_RESET)
+         world.reset(region->commandArg);
+      else
+         world.step(actions());
+
+      publish(world);
+   }
+}
@@ -0,0 +1,107 @@
+/***********************************************************************
+ * Header File:
+ *    SHARED CONTROL
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Lockstep control of a batch of landers by another process through
+ *    a shared-memory region. The simulator writes observations, the
+ *    agent writes actions, and each side rings a doorbell when its half
+ *    is ready. Nothing is serialized or copied through the kernel; a
+ *    doorbell only costs a system call when the other side is asleep.
+ *
+ *    Region layout (all offsets 64-byte aligned):
+ *       SharedControlHeader
+ *       lander_observation[numLanders]   written by the simulator
+ *       uint8_t actions[numLanders]      written by the agent (ThrustBits)
+ ************************************************************************/
+
+#pragma once
+
+#include "landerApi.h"   // for lander_observation
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <string>
+
+class World;
+
+#define SHARED_CONTROL_MAGIC   0x4c4e4452u   // "LNDR"
+#define SHARED_CONTROL_VERSION 1u
+
+// What the agent wants done with the actions it just wrote
+enum SharedCommand
+{
+   SHARED_STEP  = 0,   // step one frame with the actions
+   SHARED_RESET = 1,   // new terrain and landers from commandArg as the seed
+   SHARED_STOP  = 2    // the simulator leaves its loop
+};
+
+/*****************************************************
+ * SHARED CONTROL HEADER
+ * Each doorbell sits on its own cache line so the two
+ * sides never fight over the same line
+ *****************************************************/
+struct SharedControlHeader
+{
+   uint32_t magic;                // SHARED_CONTROL_MAGIC once initialized
+   uint32_t version;              // SHARED_CONTROL_VERSION
+   int32_t  numLanders;
+   int32_t  flying;               // landers still in flight, with the observations
+   uint32_t command;              // SharedCommand, written with the actions
+   uint32_t commandArg;           // seed for SHARED_RESET
+   uint64_t frame;                // frames since the last reset
+
+   alignas(64) std::atomic<uint32_t> actionBell;        // agent rings
+   std::atomic<uint32_t> actionSleepers;                // sim asleep on it
+   alignas(64) std::atomic<uint32_t> observationBell;   // simulator rings
+   std::atomic<uint32_t> observationSleepers;           // agent asleep on it
+};
+
+/*****************************************************
+ * SHARED CONTROL
+ * One side's view of the region
+ *****************************************************/
+class SharedControl
+{
+public:
+   SharedControl() : region(nullptr), size(0), owner(false),
+      lastObservation(0), lastAction(0) {}
+   ~SharedControl() { close(); }
+
+   // Simulator side: create the named region for numLanders landers
+   bool create(const std::string& name, int numLanders);
+
+   // Agent side: map a region the simulator already created
+   bool attach(const std::string& name);
+
+   // Unmap, and unlink if we created it
+   void close();
+
+   SharedControlHeader* header() const { return region; }
+   lander_observation* observations() const;
+   uint8_t* actions() const;
+   int numLanders() const { return region ? region->numLanders : 0; }
+
+   // Agent: the actions are written, go (command is a SharedCommand)
+   void submitActions(uint32_t command = SHARED_STEP, uint32_t commandArg = 0);
+
+   // Agent: wait for the observations that answer the last submit
+   void waitObservations();
+
+   // Simulator: serve the agent until it sends SHARED_STOP
+   void serve(World& world);
+
+   // Bytes needed for a region of numLanders landers
+   static size_t regionSize(int numLanders);
+
+private:
+   SharedControlHeader* region;
+   size_t size;
+   bool owner;
+   std::string name;
+   uint32_t lastObservation;   // agent: observation bell when it last looked
+   uint32_t lastAction;        // simulator: action bell when it last looked
+
+   void publish(const World& world);
+};
@@ -0,0 +1,67 @@
+/***********************************************************************
+ * Header File:
+ *    SIM HOOKS
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Observer hooks into the physics. Lander::input(), Lander::coast(),
+ *    World::step() and terrain generation each come in a version that
+ *    takes a hooks policy as a template parameter and calls it at fixed
+ *    points:
+ *
+ *       beforeStep / afterStep   around every Lander::coast()
+ *       thrustApplied            the acceleration Lander::input() settled on
+ *       fuelConsumed             every burn
+ *       contact                  a lander met the ground (or another lander)
+ *       terrainGenerated         a new ground is ready
+ *
+ *    The calls are resolved at compile time. The plain versions pass
+ *    NoHooks, whose members are empty and inline, so the default build
+ *    has nothing left of them. A hooks policy derives from NoHooks and
+ *    hides only the members it cares about.
+ ************************************************************************/
+
+#pragma once
+
+#include "units.h"
+
+// Forward declarations
+class Lander;
+class Acceleration;
+class Ground;
+struct Touchdown;
+
+/*****************************************************
+ * NO HOOKS
+ * The default policy: every hook does nothing
+ *****************************************************/
+struct NoHooks
+{
+   void beforeStep(const Lander& /*lander*/, double /*time*/) {}
+   void afterStep(const Lander& /*lander*/, double /*time*/) {}
+   void thrustApplied(const Lander& /*lander*/, const Acceleration& /*acceleration*/) {}
+   void fuelConsumed(const Lander& /*lander*/, Kilograms /*burned*/) {}
+   void contact(const Lander& /*lander*/, const Touchdown& /*touchdown*/) {}
+   void terrainGenerated(const Ground& /*ground*/) {}
+};
+
+/*****************************************************
+ * COUNTING HOOKS
+ * Tallies for profiling and for checking the physics
+ * from outside: how often each hook fired
+ *****************************************************/
+struct CountingHooks : public NoHooks
+{
+   long steps = 0;
+   double seconds = 0.0;      // simulated, summed over every coast
+   long thrusts = 0;
+   double fuelBurned = 0.0;   // kg
+   long contacts = 0;
+   long terrains = 0;
+
+   void afterStep(const Lander& /*lander*/, double time) { steps++; seconds += time; }
+   void thrustApplied(const Lander& /*lander*/, const Acceleration& /*acceleration*/) { thrusts++; }
+   void fuelConsumed(const Lander& /*lander*/, Kilograms burned) { fuelBurned += burned.value(); }
+   void contact(const Lander& /*lander*/, const Touchdown& /*touchdown*/) { contacts++; }
+   void terrainGenerated(const Ground& /*ground*/) { terrains++; }
+};
@@ -0,0 +1,519 @@
+/***********************************************************************
+ * Source File:
+ *    SIM SERVER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A long-running local simulation daemon over a Unix domain socket
+ ************************************************************************/
+
+#include "simServer.h"
+#include "arena.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cstring>   // for memcpy, strncpy
+#include <cstdio>    // for snprintf
+#include <algorithm> // for std::min
+#include <chrono>
+#include <iostream>
+
+// How often blocked threads wake up to notice stop()
+static const int POLL_MS = 200;
+
+// Largest payload we accept, to protect against garbage headers
+static const uint32_t MAX_PAYLOAD = 256u * 1024u * 1024u;
+
+// How many warm terrains we keep before starting over
+static const size_t MAX_TERRAINS = 256;
+
+/*************************************************************************
+ * READ FULLY
+ * Keep reading until we have every byte, false on EOF or error
+ *************************************************************************/
+static bool readFully(int fd, void* buffer, size_t size)
+{
+   char* p = static_cast<char*>(buffer);
+   while (size > 0)
+   {
+      ssize_t n = ::read(fd, p, size);
+      if (n <= 0)
+         return false;
+      p += n;
+      size -= n;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * WRITE FULLY
+ * Keep writing until every byte is out, false on error
+ *************************************************************************/
+static bool writeFully(int fd, const void* buffer, size_t size)
+{
+   const char* p = static_cast<const char*>(buffer);
+   while (size > 0)
+   {
+      ssize_t n = ::write(fd, p, size);
+      if (n <= 0)
+         return false;
+      p += n;
+      size -= n;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * WAIT READABLE
+ * True when fd has data; false on timeout so the caller can check stop()
+ *************************************************************************/
+static bool waitReadable(int fd)
+{
+   pollfd pfd = { fd, POLLIN, 0 };
+   return ::poll(&pfd, 1, POLL_MS) > 0;
+}
+
+/*****************************************************
+ * CONNECTION
+ * One client. Shared by its reader and any worker
+ * still answering its requests, so its missions live
+ * until the last of those is done.
+ *****************************************************/
+struct SimServer::Connection
+{
+   int fd;
+   std::mutex writeMutex;
+   std::atomic<uint64_t> landerSteps;
+   std::mutex missionsMutex;
+   std::map<uint32_t, std::unique_ptr<World>> missions;   // this client's alone
+   std::chrono::steady_clock::time_point opened;
+
+   Connection(int fd) : fd(fd), landerSteps(0),
+      opened(std::chrono::steady_clock::now()) {}
+   ~Connection() { ::close(fd); }
+
+   double seconds() const
+   {
+      return std::chrono::duration<double>(
+         std::chrono::steady_clock::now() - opened).count();
+   }
+
+   // Responses from different workers must not interleave
+   void respond(const SimResponseHeader& header, const void* payload)
+   {
+      std::lock_guard<std::mutex> lock(writeMutex);
+      if (writeFully(fd, &header, sizeof(header)) && header.length > 0)
+         writeFully(fd, payload, header.length);
+   }
+
+   void respond(uint32_t requestId, int32_t status, uint32_t mission,
+                const void* payload = nullptr, uint32_t length = 0)
+   {
+      SimResponseHeader header = { length, requestId, status, mission };
+      respond(header, payload);
+   }
+};
+
+/*************************************************************************
+ * SIM SERVER : CONSTRUCTOR
+ *************************************************************************/
+SimServer::SimServer(const std::string& socketPath, int numWorkers) :
+   socketPath(socketPath),
+   listenFd(-1),
+   running(false),
+   verbose(false),
+   activeReaders(0),
+   nextMission(SIM_SERVER_MISSIONS)
+{
+   for (int i = 0; i < (numWorkers > 0 ? numWorkers : 1); i++)
+      workers.push_back(std::unique_ptr<Worker>(new Worker));
+}
+
+/*************************************************************************
+ * SIM SERVER : DESTRUCTOR
+ *************************************************************************/
+SimServer::~SimServer()
+{
+   stop();
+}
+
+/*************************************************************************
+ * SIM SERVER : START
+ *************************************************************************/
+bool SimServer::start()
+{
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   if (socketPath.size() >= sizeof(address.sun_path))
+      return false;
+   strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+   // a client that hangs up should not take the whole server down
+   signal(SIGPIPE, SIG_IGN);
+
+   listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+   if (listenFd < 0)
+      return false;
+
+   ::unlink(socketPath.c_str());
+   if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+       ::listen(listenFd, 64) < 0)
+   {
+      ::close(listenFd);
+      listenFd = -1;
+      return false;
+   }
+
+   running = true;
+   for (auto& worker : workers)
+      worker->thread = std::thread(&SimServer::workLoop, this, std::ref(*worker));
+   acceptThread = std::thread(&SimServer::acceptLoop, this);
+   return true;
+}
+
+/*************************************************************************
+ * SIM SERVER : STOP
+ *************************************************************************/
+void SimServer::stop()
+{
+   if (!running.exchange(false))
+      return;
+
+   acceptThread.join();
+   {
+      std::unique_lock<std::mutex> lock(readersMutex);
+      readersDone.wait(lock, [&] { return activeReaders == 0; });
+   }
+
+   for (auto& worker : workers)
+   {
+      worker->ready.notify_all();
+      worker->thread.join();
+   }
+
+   ::close(listenFd);
+   ::unlink(socketPath.c_str());
+   listenFd = -1;
+}
+
+/*************************************************************************
+ * SIM SERVER : RUN
+ *************************************************************************/
+int SimServer::run()
+{
+   if (!start())
+   {
+      std::cerr << "Unable to listen on " << socketPath << "\n";
+      return 1;
+   }
+
+   std::cout << "Simulation server listening on " << socketPath
+             << " with " << workers.size() << " workers\n";
+   while (running)
+      std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MS));
+   return 0;
+}
+
+/*************************************************************************
+ * SIM SERVER : ACCEPT LOOP
+ * Every client gets its own reader thread
+ *************************************************************************/
+void SimServer::acceptLoop()
+{
+   while (running)
+   {
+      if (!waitReadable(listenFd))
+         continue;
+
+      int fd = ::accept(listenFd, nullptr, nullptr);
+      if (fd < 0)
+         continue;
+
+      std::shared_ptr<Connection> connection(new Connection(fd));
+      {
+         std::lock_guard<std::mutex> lock(readersMutex);
+         activeReaders++;
+      }
+      std::thread(&SimServer::readLoop, this, connection).detach();
+   }
+}
+
+/*************************************************************************
+ * SIM SERVER : READ LOOP
+ * Read requests as fast as the client pipelines them
+ *************************************************************************/
+void SimServer::readLoop(std::shared_ptr<Connection> connection)
+{
+   while (running)
+   {
+      if (!waitReadable(connection->fd))
+         continue;
+
+      Job job;
+      job.connection = connection;
+      if (!readFully(connection->fd, &job.header, sizeof(job.header)) ||
+          job.header.length > MAX_PAYLOAD)
+         break;
+
+      job.payload.resize(job.header.length);
+      if (job.header.length > 0 &&
+          !readFully(connection->fd, job.payload.data(), job.header.length))
+         break;
+
+      dispatch(std::move(job));
+   }
+
+   if (verbose)
+   {
+      double seconds = connection->seconds();
+      std::cout << "Client disconnected: " << connection->landerSteps
+                << " lander steps in " << seconds << " s ("
+                << (seconds > 0.0 ? connection->landerSteps / seconds : 0.0)
+                << " steps/s)\n";
+   }
+
+   std::lock_guard<std::mutex> lock(readersMutex);
+   activeReaders--;
+   readersDone.notify_all();
+}
+
+/*************************************************************************
+ * SIM SERVER : DISPATCH
+ * Each mission always goes to the same worker, which keeps its
+ * requests in order without any locking on the world itself
+ *************************************************************************/
+void SimServer::dispatch(Job&& job)
+{
+   if (job.header.opcode == SIM_STATS)
+   {
+      struct { uint64_t landerSteps; double seconds; } stats =
+         { job.connection->landerSteps, job.connection->seconds() };
+      job.connection->respond(job.header.requestId, SIM_OK, 0,
+                              &stats, sizeof(stats));
+      return;
+   }
+
+   // naming the mission up front lets a client pipeline its first steps;
+   // the names from SIM_SERVER_MISSIONS up are the server's alone
+   if (job.header.opcode == SIM_CREATE && job.header.mission >= SIM_SERVER_MISSIONS)
+   {
+      job.connection->respond(job.header.requestId, SIM_BAD_REQUEST, job.header.mission);
+      return;
+   }
+   if (job.header.opcode == SIM_CREATE && job.header.mission == 0)
+      job.header.mission = nextMission++;
+
+   Worker& worker = *workers[job.header.mission % workers.size()];
+   {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.queue.push_back(std::move(job));
+   }
+   worker.ready.notify_one();
+}
+
+/*************************************************************************
+ * SIM SERVER : WORK LOOP
+ *************************************************************************/
+void SimServer::workLoop(Worker& worker)
+{
+   for (;;)
+   {
+      Job job;
+      {
+         std::unique_lock<std::mutex> lock(worker.mutex);
+         worker.ready.wait(lock, [&] { return !worker.queue.empty() || !running; });
+         if (worker.queue.empty())
+            return;
+         job = std::move(worker.queue.front());
+         worker.queue.pop_front();
+      }
+      execute(job);
+      threadArena().reset();
+   }
+}
+
+/*************************************************************************
+ * SIM SERVER : EXECUTE
+ * Carry out one request and answer it
+ *************************************************************************/
+void SimServer::execute(Job& job)
+{
+   const SimRequestHeader& header = job.header;
+   Connection& connection = *job.connection;
+   const char* payload = job.payload.data();
+
+   if (header.opcode == SIM_CREATE)
+   {
+      struct { double width; double height; int32_t landers; uint32_t seed; } args;
+      if (job.payload.size() != sizeof(args))
+         return connection.respond(header.requestId, SIM_BAD_REQUEST, 0);
+      memcpy(&args, payload, sizeof(args));
+      if (args.width <= 0.0 || args.height <= 0.0 || args.landers <= 0)
+         return connection.respond(header.requestId, SIM_BAD_REQUEST, 0);
+
+      std::unique_ptr<World> world = createMission(Position(args.width, args.height),
+                                                   args.landers, args.seed);
+      {
+         std::lock_guard<std::mutex> lock(connection.missionsMutex);
+         connection.missions[header.mission] = std::move(world);
+      }
+      return connection.respond(header.requestId, SIM_OK, header.mission);
+   }
+
+   World* world = findMission(connection, header.mission);
+   if (!world)
+      return connection.respond(header.requestId, SIM_NO_MISSION, header.mission);
+
+   if (header.opcode == SIM_STEP)
+   {
+      int32_t frames = 0;
+      if (job.payload.size() < sizeof(frames))
+         return connection.respond(header.requestId, SIM_BAD_REQUEST, header.mission);
+      memcpy(&frames, payload, sizeof(frames));
+      const unsigned char* tape = reinterpret_cast<const unsigned char*>(payload + sizeof(frames));
+      if (frames < 0 ||
+          job.payload.size() != sizeof(frames) + static_cast<size_t>(frames) * world->size())
+         return connection.respond(header.requestId, SIM_BAD_REQUEST, header.mission);
+
+      uint64_t steps = 0;
+      for (int32_t f = 0; f < frames && world->numFlying() > 0; f++)
+      {
+         steps += world->numFlying();
+         world->step(tape + static_cast<size_t>(f) * world->size());
+      }
+      connection.landerSteps += steps;
+
+      int32_t flying = world->numFlying();
+      return connection.respond(header.requestId, SIM_OK, header.mission,
+                                &flying, sizeof(flying));
+   }
+
+   if (header.opcode == SIM_OBSERVE)
+   {
+      int32_t range[2];
+      if (job.payload.size() != sizeof(range))
+         return connection.respond(header.requestId, SIM_BAD_REQUEST, header.mission);
+      memcpy(range, payload, sizeof(range));
+      if (range[0] < 0 || range[1] < 0 || range[0] > world->size())
+         return connection.respond(header.requestId, SIM_BAD_REQUEST, header.mission);
+
+      ArenaVector<lander_observation> observations(std::min(range[1], world->size() - range[0]),
+                                                   lander_observation(),
+                                                   threadArena());
+      int count = world->observe(range[0], static_cast<int>(observations.size()),
+                                 observations.data());
+      return connection.respond(header.requestId, SIM_OK, header.mission,
+                                observations.data(),
+                                static_cast<uint32_t>(count * sizeof(lander_observation)));
+   }
+
+   if (header.opcode == SIM_DESTROY)
+   {
+      std::lock_guard<std::mutex> lock(connection.missionsMutex);
+      connection.missions.erase(header.mission);
+      return connection.respond(header.requestId, SIM_OK, header.mission);
+   }
+
+   connection.respond(header.requestId, SIM_BAD_REQUEST, header.mission);
+}
+
+/*************************************************************************
+ * SIM SERVER : FIND MISSION
+ * Only among the client's own missions
+ *************************************************************************/
+World* SimServer::findMission(Connection& connection, uint32_t mission)
+{
+   std::lock_guard<std::mutex> lock(connection.missionsMutex);
+   auto it = connection.missions.find(mission);
+   return it == connection.missions.end() ? nullptr : it->second.get();
+}
+
+/*************************************************************************
+ * SIM SERVER : CREATE MISSION
+ * The first request for a terrain generates it; later ones copy it
+ *************************************************************************/
+std::unique_ptr<World> SimServer::createMission(const Position& posUpperRight,
+                                                int numLanders, unsigned int seed)
+{
+   char key[96];
+   snprintf(key, sizeof(key), "%.17g:%.17g:%d:%u",
+            posUpperRight.getX(), posUpperRight.getY(), numLanders, seed);
+
+   std::lock_guard<std::mutex> lock(terrainMutex);
+   auto it = terrains.find(key);
+   if (it != terrains.end())
+      return std::unique_ptr<World>(new World(*it->second));
+
+   if (terrains.size() >= MAX_TERRAINS)
+      terrains.clear();
+
+   std::unique_ptr<World> world(new World(posUpperRight, numLanders, seed));
+   terrains[key] = std::unique_ptr<World>(new World(*world));
+   return world;
+}
+
+/*************************************************************************
+ * SIM CLIENT : CONNECT
+ *************************************************************************/
+bool SimClient::connect(const std::string& socketPath)
+{
+   close();
+
+   sockaddr_un address;
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   if (socketPath.size() >= sizeof(address.sun_path))
+      return false;
+   strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+   fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+   if (fd < 0)
+      return false;
+
+   if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+   {
+      close();
+      return false;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * SIM CLIENT : CLOSE
+ *************************************************************************/
+void SimClient::close()
+{
+   if (fd >= 0)
+      ::close(fd);
+   fd = -1;
+}
+
+/*************************************************************************
+ * SIM CLIENT : SEND
+ *************************************************************************/
+uint32_t SimClient::send(SimOpcode opcode, uint32_t mission,
+                         const void* payload, uint32_t length)
+{
+   SimRequestHeader header = { length, nextRequest,
+                               static_cast<uint16_t>(opcode), 0, mission };
+   if (fd < 0 ||
+       !writeFully(fd, &header, sizeof(header)) ||
+       (length > 0 && !writeFully(fd, payload, length)))
+      return 0;
+   return nextRequest++;
+}
+
+/*************************************************************************
+ * SIM CLIENT : RECEIVE
+ *************************************************************************/
+bool SimClient::receive(SimResponseHeader& header, std::vector<char>& payload)
+{
+   if (fd < 0 || !readFully(fd, &header, sizeof(header)) || header.length > MAX_PAYLOAD)
+      return false;
+
+   payload.resize(header.length);
+   return header.length == 0 || readFully(fd, payload.data(), header.length);
+}
@@ -0,0 +1,173 @@
+/***********************************************************************
+ * Header File:
+ *    SIM SERVER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A long-running local simulation daemon. Terrains and worker threads
+ *    stay warm while any number of client tools send pipelined binary
+ *    batch requests over a Unix domain socket.
+ *
+ *    Every message is a fixed header followed by `length` payload bytes.
+ *    Clients may send many requests without waiting; each response
+ *    carries the requestId it answers. Requests for the same mission are
+ *    always answered in the order they were sent.
+ *
+ *    Missions belong to the connection that created them: another client
+ *    can neither see, replace nor destroy them, and they are dropped once
+ *    their client hangs up and its last request is answered.
+ ************************************************************************/
+
+#pragma once
+
+#include "world.h"
+#include "landerApi.h"      // for lander_observation
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Forward declaration for unit tests
+class TestSimServer;
+
+// What a request asks for
+enum SimOpcode
+{
+   SIM_CREATE  = 1,   // {double width, height; int32 landers; uint32 seed}
+   SIM_STEP    = 2,   // {int32 frames} then frames * landers thrust bytes
+   SIM_OBSERVE = 3,   // {int32 first, count} -> count lander_observations
+   SIM_DESTROY = 4,   // nothing
+   SIM_STATS   = 5    // nothing -> {uint64 landerSteps; double seconds}
+};
+
+// How a request went
+enum SimStatus
+{
+   SIM_OK          =  0,
+   SIM_NO_MISSION  = -1,
+   SIM_BAD_REQUEST = -2
+};
+
+// Client to server
+struct SimRequestHeader
+{
+   uint32_t length;      // payload bytes that follow
+   uint32_t requestId;   // echoed back in the response
+   uint16_t opcode;      // SimOpcode
+   uint16_t reserved;
+   uint32_t mission;     // SIM_CREATE: 0 lets the server pick one, otherwise
+                         // the client names it (below SIM_SERVER_MISSIONS,
+                         // or SIM_BAD_REQUEST).
+                         // A client sees only its own missions.
+};
+
+// Missions the server names itself start here
+#define SIM_SERVER_MISSIONS 0x80000000u
+
+// Server to client
+struct SimResponseHeader
+{
+   uint32_t length;      // payload bytes that follow
+   uint32_t requestId;   // the request being answered
+   int32_t  status;      // SimStatus
+   uint32_t mission;     // the mission, new for SIM_CREATE
+};
+
+/*****************************************************
+ * SIM SERVER
+ * Accepts clients on a Unix domain socket and hands
+ * their requests to a fixed pool of worker threads
+ *****************************************************/
+class SimServer
+{
+   friend TestSimServer;
+
+public:
+   SimServer(const std::string& socketPath, int numWorkers);
+   ~SimServer();
+
+   // Bind the socket and start the threads. False if the socket failed.
+   bool start();
+
+   // Stop accepting, finish queued work, and join every thread
+   void stop();
+
+   // Start and serve until the process is killed
+   int run();
+
+   // Report each client's throughput when it hangs up
+   void setVerbose(bool verbose) { this->verbose = verbose; }
+
+private:
+   struct Connection;
+   struct Job
+   {
+      std::shared_ptr<Connection> connection;
+      SimRequestHeader header;
+      std::vector<char> payload;
+   };
+   struct Worker
+   {
+      std::thread thread;
+      std::mutex mutex;
+      std::condition_variable ready;
+      std::deque<Job> queue;
+   };
+
+   std::string socketPath;
+   int listenFd;
+   std::atomic<bool> running;
+   bool verbose;
+   std::thread acceptThread;
+   std::vector<std::unique_ptr<Worker>> workers;
+
+   std::mutex readersMutex;
+   std::condition_variable readersDone;
+   int activeReaders;                    // detached reader threads still running
+
+   std::atomic<uint32_t> nextMission;
+
+   std::mutex terrainMutex;
+   std::map<std::string, std::unique_ptr<World>> terrains;   // warm prototypes
+
+   void acceptLoop();
+   void readLoop(std::shared_ptr<Connection> connection);
+   void workLoop(Worker& worker);
+   void dispatch(Job&& job);
+   void execute(Job& job);
+
+   static World* findMission(Connection& connection, uint32_t mission);
+   std::unique_ptr<World> createMission(const Position& posUpperRight,
+                                        int numLanders, unsigned int seed);
+};
+
+/*****************************************************
+ * SIM CLIENT
+ * The client side of the protocol, for C++ tools
+ *****************************************************/
+class SimClient
+{
+public:
+   SimClient() : fd(-1), nextRequest(1) {}
+   ~SimClient() { close(); }
+
+   bool connect(const std::string& socketPath);
+   void close();
+
+   // Send a request without waiting for its answer. Returns its id, 0 on error.
+   uint32_t send(SimOpcode opcode, uint32_t mission,
+                 const void* payload, uint32_t length);
+
+   // Wait for the next response, whichever request it answers
+   bool receive(SimResponseHeader& header, std::vector<char>& payload);
+
+private:
+   int fd;
+   uint32_t nextRequest;
+};
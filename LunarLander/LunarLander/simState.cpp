@@ -0,0 +1,117 @@
+/***********************************************************************
+ * Source File:
+ *    SIM STATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Cheap branching copies of a lander in flight
+ ************************************************************************/
+
+#include "simState.h"
+#include "world.h"   // for GRAVITY, FRAME_TIME
+#include "fastMath.h" // for simSincos
+#include <cmath>     // for sin, cos, sqrt
+#include <algorithm> // for std::max
+
+/*************************************************************************
+ * TERRAIN : CONSTRUCTOR
+ *************************************************************************/
+Terrain::Terrain(const Ground& ground) :
+   elevations(ground.getElevations(),
+              ground.getElevations() + ground.getNumElevations()),
+   size(ground.getNumElevations()),
+   width(ground.getUpperRight().getX()),
+   platformX(ground.getPlatformPosition().getX()),
+   platformY(ground.getPlatformPosition().getY()),
+   platformWidth(ground.getPlatformWidth())
+{
+}
+
+/*************************************************************************
+ * SIM STATE : FROM LANDER
+ *************************************************************************/
+SimState SimState::fromLander(const Lander& lander, const Terrain& terrain)
+{
+   SimState state;
+   state.x = lander.pos.getX();
+   state.y = lander.pos.getY();
+   state.dx = lander.velocity.getDX();
+   state.dy = lander.velocity.getDY();
+   state.angle = lander.angle.getRadians();
+   state.fuel = lander.getFuelMass().value();
+   state.status = static_cast<int32_t>(lander.status);
+   state.frame = 0;
+   state.terrain = &terrain;
+   return state;
+}
+
+/*************************************************************************
+ * SIM STATE : STEP
+ * Must stay in step with Lander::input(), Lander::coast() and
+ * World::checkCollision(); TestSimState flies both side by side
+ *************************************************************************/
+void SimState::step(unsigned char thrustBits)
+{
+   if (status != PLAYING)
+      return;
+
+   const double time = World::FRAME_TIME;
+   double ddx = 0.0;
+   double ddy = World::GRAVITY;
+
+   if (fuel > 0.0)
+   {
+      if (thrustBits & THRUST_BIT_MAIN)
+      {
+         double thrust = Thrust::MAIN_ENGINE.value();
+         double sinA, cosA;
+         simSincos(angle, sinA, cosA);    // the same call Lander makes
+         ddx += -sinA * thrust;
+         ddy += cosA * thrust;
+         fuel = std::max(0.0, fuel - (Lander::FUEL_CONSUMPTION_MAIN * Seconds(time)).value());
+      }
+      if (thrustBits & THRUST_BIT_CLOCK)
+      {
+         angle += -Lander::THRUST_ATTITUDE.value();
+         fuel = std::max(0.0, fuel - (Lander::FUEL_CONSUMPTION_ATTITUDE * Seconds(time)).value());
+      }
+      if (thrustBits & THRUST_BIT_COUNTER)
+      {
+         angle += Lander::THRUST_ATTITUDE.value();
+         fuel = std::max(0.0, fuel - (Lander::FUEL_CONSUMPTION_ATTITUDE * Seconds(time)).value());
+      }
+   }
+
+   // s = s_0 + vt + 1/2 at^2, then v = v_0 + at
+   x = x + (dx * time) + (0.5 * ddx * time * time);
+   y = y + (dy * time) + (0.5 * ddy * time * time);
+   dx = dx + ddx * time;
+   dy = dy + ddy * time;
+   frame++;
+
+   // Lab spec: crash unless on the platform, slow, and upright
+   if (y > terrain->getElevationMeters(x))
+      return;
+
+   bool slow = sqrt((dx * dx) + (dy * dy)) < Lander::SAFE_SPEED;
+   bool upright = angle < Lander::SAFE_TILT || angle > 2.0 * M_PI - Lander::SAFE_TILT;
+   if (slow && upright && terrain->onPlatform(x, Lander::WIDTH))
+   {
+      angle = 0.0;
+      status = SAFE;
+   }
+   else
+   {
+      angle = M_PI;
+      status = DEAD;
+   }
+}
+
+/*************************************************************************
+ * SIM STATE : COAST UNTIL DOWN
+ *************************************************************************/
+void SimState::coastUntilDown(unsigned char thrustBits, uint32_t maxFrames)
+{
+   for (uint32_t i = 0; i < maxFrames && status == PLAYING; i++)
+      step(thrustBits);
+}
@@ -0,0 +1,96 @@
+/***********************************************************************
+ * Header File:
+ *    SIM STATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A flat, trivially copyable snapshot of one lander in flight, for
+ *    autopilots and estimators that branch from the live state many
+ *    times per frame. The terrain is not part of the state: it is an
+ *    immutable Terrain shared by every branch, so cloning is a copy of
+ *    a few dozen bytes and discarding a branch frees nothing.
+ ************************************************************************/
+
+#pragma once
+
+#include "ground.h"
+#include "lander.h"
+#include <vector>
+#include <type_traits>
+#include <stdint.h>
+
+/*****************************************************
+ * TERRAIN
+ * Read-only copy of a Ground's elevations and platform
+ *****************************************************/
+class Terrain
+{
+public:
+   explicit Terrain(const Ground& ground);
+
+   double getElevationMeters(double x) const
+   {
+      int index = static_cast<int>((x / width) * size);
+      index = index < 0 ? 0 : (index > size - 1 ? size - 1 : index);
+      return size > 0 ? elevations[index] : 0.0;
+   }
+
+   bool onPlatform(double x, int landerWidth) const
+   {
+      return x - landerWidth / 2.0 >= platformX - platformWidth / 2.0 &&
+             x + landerWidth / 2.0 <= platformX + platformWidth / 2.0;
+   }
+
+   double getPlatformX() const { return platformX; }
+   double getPlatformY() const { return platformY; }
+   double getPlatformWidth() const { return platformWidth; }
+
+private:
+   std::vector<double> elevations;
+   int size;
+   double width;
+   double platformX;
+   double platformY;
+   double platformWidth;
+};
+
+/*****************************************************
+ * SIM STATE
+ * The same physics as Lander::input() and Lander::coast(), followed by
+ * the lab-spec touchdown check, on plain fields
+ *****************************************************/
+struct SimState
+{
+   double x;
+   double y;
+   double dx;
+   double dy;
+   double angle;              // radians, never normalized (same as Angle)
+   double fuel;               // kg
+   int32_t status;            // Status
+   uint32_t frame;
+   const Terrain* terrain;    // shared, never owned
+
+   // Snapshot a live lander over a shared terrain
+   static SimState fromLander(const Lander& lander, const Terrain& terrain);
+
+   bool isFlying() const { return status == PLAYING; }
+   bool isLanded() const { return status == SAFE; }
+   bool isDead() const { return status == DEAD; }
+   double getAltitude() const { return y - terrain->getElevationMeters(x); }
+
+   // A branch is a plain copy
+   SimState clone() const { return *this; }
+
+   // One frame with these THRUST_BIT_* bits
+   void step(unsigned char thrustBits);
+
+   // Fly until down or out of frames, same bits every frame
+   void coastUntilDown(unsigned char thrustBits, uint32_t maxFrames);
+
+   // Nothing to release: the terrain belongs to whoever made it
+   void discard() { terrain = nullptr; }
+};
+
+static_assert(std::is_trivially_copyable<SimState>::value,
+              "SimState must stay cheap to clone");
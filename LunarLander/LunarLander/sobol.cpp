@@ -0,0 +1,131 @@
+/***********************************************************************
+ * Source File:
+ *    SOBOL
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A scrambled Sobol sequence for quasi-Monte Carlo sampling
+ ************************************************************************/
+
+#include "sobol.h"
+
+// Primitive polynomials and starting direction numbers for dimensions
+// after the first, from Joe and Kuo's new-joe-kuo-6.21201 table
+struct SobolPolynomial
+{
+   int degree;
+   uint32_t coefficients;   // the middle ones, highest first
+   uint32_t initial[6];     // m_1 .. m_degree
+};
+
+static constexpr SobolPolynomial POLYNOMIALS[SOBOL_DIMENSIONS - 1] =
+{
+   { 1, 0,  { 1 } },
+   { 2, 1,  { 1, 3 } },
+   { 3, 1,  { 1, 3, 1 } },
+   { 3, 2,  { 1, 1, 1 } },
+   { 4, 1,  { 1, 1, 3, 3 } },
+   { 4, 4,  { 1, 3, 5, 13 } },
+   { 5, 2,  { 1, 1, 5, 5, 17 } },
+   { 5, 4,  { 1, 1, 5, 5, 5 } },
+   { 5, 7,  { 1, 1, 7, 11, 19 } },
+   { 5, 11, { 1, 1, 5, 1, 1 } },
+   { 5, 13, { 1, 1, 1, 3, 11 } },
+   { 5, 14, { 1, 3, 5, 5, 31 } },
+   { 6, 1,  { 1, 3, 3, 9, 7, 49 } },
+   { 6, 13, { 1, 1, 1, 15, 21, 21 } },
+   { 6, 16, { 1, 3, 1, 13, 27, 49 } },
+   { 6, 19, { 1, 1, 1, 15, 7, 5 } },
+   { 6, 22, { 1, 3, 1, 15, 13, 25 } }
+};
+
+// Every direction number, worked out by the compiler
+struct SobolDirections
+{
+   uint32_t v[SOBOL_DIMENSIONS][SOBOL_BITS];
+
+   constexpr SobolDirections() : v()
+   {
+      // The first dimension is the van der Corput sequence
+      for (int k = 0; k < SOBOL_BITS; k++)
+         v[0][k] = 1u << (31 - k);
+
+      for (int d = 1; d < SOBOL_DIMENSIONS; d++)
+      {
+         const SobolPolynomial& p = POLYNOMIALS[d - 1];
+         for (int k = 0; k < SOBOL_BITS; k++)
+         {
+            if (k < p.degree)
+               v[d][k] = p.initial[k] << (31 - k);
+            else
+            {
+               uint32_t value = v[d][k - p.degree] ^ (v[d][k - p.degree] >> p.degree);
+               for (int j = 1; j < p.degree; j++)
+                  if ((p.coefficients >> (p.degree - 1 - j)) & 1)
+                     value ^= v[d][k - j];
+               v[d][k] = value;
+            }
+         }
+      }
+   }
+};
+
+static constexpr SobolDirections DIRECTIONS;
+
+/*************************************************************************
+ * SOBOL : SAMPLE BITS
+ * The XOR of the direction numbers for the set bits of the index
+ *************************************************************************/
+uint32_t Sobol::sampleBits(uint32_t index, int dimension)
+{
+   const uint32_t* v = DIRECTIONS.v[dimension];
+   uint32_t x = 0;
+   for (int k = 0; index; k++, index >>= 1)
+      if (index & 1)
+         x ^= v[k];
+   return x;
+}
+
+/*************************************************************************
+ * SOBOL : SAMPLE BITS
+ * Owen-scrambled: each bit is flipped or not according to the bits above
+ * it. Reversed, that is a hash in which every bit depends only on the
+ * bits below it. Each dimension gets its own key.
+ *************************************************************************/
+uint32_t Sobol::sampleBits(uint32_t index, int dimension, uint32_t scramble)
+{
+   uint32_t seed = hash(scramble ^ hash(static_cast<uint32_t>(dimension) + 0x9e3779b9u));
+   uint32_t x = reverse(sampleBits(index, dimension));
+   x += seed;
+   x ^= x * 0x6c50b47cu;
+   x ^= x * 0xb82f1e52u;
+   x ^= x * 0xc7afe638u;
+   x ^= x * 0x8d22f6e6u;
+   return reverse(x);
+}
+
+/*************************************************************************
+ * SOBOL : REVERSE
+ *************************************************************************/
+uint32_t Sobol::reverse(uint32_t x)
+{
+   x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+   x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+   x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+   x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+   return (x >> 16) | (x << 16);
+}
+
+/*************************************************************************
+ * SOBOL : HASH
+ * Any key to a well-mixed one
+ *************************************************************************/
+uint32_t Sobol::hash(uint32_t x)
+{
+   x ^= x >> 16;
+   x *= 0x7feb352du;
+   x ^= x >> 15;
+   x *= 0x846ca68bu;
+   x ^= x >> 16;
+   return x;
+}
@@ -0,0 +1,56 @@
+/***********************************************************************
+ * Header File:
+ *    SOBOL
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A scrambled Sobol sequence for quasi-Monte Carlo sampling. The
+ *    first 2^m points split every dimension into 2^m equal intervals
+ *    with one point in each, and any two of the first dimensions into
+ *    2^m equal boxes the same way, so averages over them converge much
+ *    faster than over random points when what is averaged is smooth.
+ *
+ *    The raw sequence is the same every time and always starts at the
+ *    origin. Nested uniform (Owen) scrambling, done with Laine and
+ *    Karras' hash on the reversed bits, randomizes it while keeping the
+ *    stratification: different scrambles are independent estimates,
+ *    and the spread between them is an honest error bar.
+ *
+ *    Point i is computed straight from i, so a worker can start
+ *    anywhere in the sequence.
+ ************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+// Forward declaration for unit tests
+class TestSobol;
+
+#define SOBOL_DIMENSIONS  18
+#define SOBOL_BITS        32
+
+/*****************************************************
+ * SOBOL
+ *****************************************************/
+class Sobol
+{
+   friend TestSobol;
+
+public:
+   // Point index of the sequence in one dimension, in [0, 2^32)
+   static uint32_t sampleBits(uint32_t index, int dimension);
+
+   // The same, scrambled by a key. Key 0 scrambles too.
+   static uint32_t sampleBits(uint32_t index, int dimension, uint32_t scramble);
+
+   // As a number in [0, 1)
+   static double sample(uint32_t index, int dimension, uint32_t scramble)
+   {
+      return sampleBits(index, dimension, scramble) * (1.0 / 4294967296.0);
+   }
+
+private:
+   static uint32_t reverse(uint32_t x);
+   static uint32_t hash(uint32_t x);
+};
@@ -0,0 +1,92 @@
+/***********************************************************************
+ * Source File:
+ *    SPATIAL HASH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A uniform grid over the world, rebuilt every frame
+ ************************************************************************/
+
+#include "spatialHash.h"
+#include <cmath>
+#include <algorithm>  // for std::max
+
+/*************************************************************************
+ * SPATIAL HASH : CONSTRUCTOR
+ *************************************************************************/
+SpatialHash::SpatialHash(const Position& posUpperRight, double cellSize) :
+   cellSize(cellSize > 0.0 ? cellSize : 1.0)
+{
+   cols = std::max(1, static_cast<int>(ceil(posUpperRight.getX() / this->cellSize)));
+   rows = std::max(1, static_cast<int>(ceil(posUpperRight.getY() / this->cellSize)));
+   cellStart.assign(cols * rows + 1, 0);
+}
+
+/*************************************************************************
+ * SPATIAL HASH : COLUMN / ROW
+ *************************************************************************/
+int SpatialHash::column(double x) const
+{
+   int c = static_cast<int>(floor(x / cellSize));
+   return c < 0 ? 0 : (c >= cols ? cols - 1 : c);
+}
+
+int SpatialHash::row(double y) const
+{
+   int r = static_cast<int>(floor(y / cellSize));
+   return r < 0 ? 0 : (r >= rows ? rows - 1 : r);
+}
+
+/*************************************************************************
+ * SPATIAL HASH : REBUILD
+ * Counting sort by cell: count, running total to the end of each cell,
+ * then place from the back so each cell keeps the input order and ends
+ * up with cellStart at its first point
+ *************************************************************************/
+void SpatialHash::rebuild(const double* x, const double* y, const int* ids, int n)
+{
+   int numCells = cols * rows;
+   cellStart.assign(numCells + 1, 0);
+   cellOf.resize(n);
+   for (int i = 0; i < n; i++)
+   {
+      cellOf[i] = row(y[i]) * cols + column(x[i]);
+      cellStart[cellOf[i]]++;
+   }
+   for (int c = 1; c < numCells; c++)
+      cellStart[c] += cellStart[c - 1];
+   cellStart[numCells] = n;
+
+   xs.resize(n);
+   ys.resize(n);
+   this->ids.resize(n);
+   for (int i = n - 1; i >= 0; i--)
+   {
+      int slot = --cellStart[cellOf[i]];
+      xs[slot] = x[i];
+      ys[slot] = y[i];
+      this->ids[slot] = ids[i];
+   }
+}
+
+/*************************************************************************
+ * SPATIAL HASH : QUERY
+ *************************************************************************/
+void SpatialHash::query(double x, double y, double radius, std::vector<int>& out) const
+{
+   double radius2 = radius * radius;
+   int c0 = column(x - radius), c1 = column(x + radius);
+   int r0 = row(y - radius), r1 = row(y + radius);
+   for (int r = r0; r <= r1; r++)
+      for (int c = c0; c <= c1; c++)
+      {
+         int cell = r * cols + c;
+         for (int i = cellStart[cell]; i < cellStart[cell + 1]; i++)
+         {
+            double dx = xs[i] - x;
+            double dy = ys[i] - y;
+            if (dx * dx + dy * dy < radius2)
+               out.push_back(ids[i]);
+         }
+      }
+}
@@ -0,0 +1,108 @@
+/***********************************************************************
+ * Header File:
+ *    SPATIAL HASH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A uniform grid over the world for finding which landers are near
+ *    each other without comparing every pair. It is rebuilt from scratch
+ *    every frame with a counting sort, so a rebuild is O(n + cells) and
+ *    the points of one cell sit next to each other in memory.
+ *
+ *    Points outside the world are clamped into the edge cells. That
+ *    never loses a pair, it only makes those cells a bit more crowded.
+ ************************************************************************/
+
+#pragma once
+
+#include "position.h"
+#include <vector>
+
+// Forward declaration for unit tests
+class TestSpatialHash;
+
+/*****************************************************
+ * SPATIAL HASH
+ * Points by cell; ids are whatever the caller passes in
+ *****************************************************/
+class SpatialHash
+{
+   friend TestSpatialHash;
+
+public:
+   SpatialHash(const Position& posUpperRight, double cellSize);
+
+   // Replace everything with these n points
+   void rebuild(const double* x, const double* y, const int* ids, int n);
+
+   // Every pair closer than radius, each once. radius <= cellSize.
+   template <class Visit>
+   void forEachPair(double radius, Visit visit) const;
+
+   // Ids of the points within radius of (x, y), appended to out
+   void query(double x, double y, double radius, std::vector<int>& out) const;
+
+   int size() const { return static_cast<int>(ids.size()); }
+   double getCellSize() const { return cellSize; }
+
+private:
+   double cellSize;
+   int cols;
+   int rows;
+   std::vector<int> cellStart;   // points of cell c are [cellStart[c], cellStart[c+1])
+   std::vector<double> xs;       // sorted by cell
+   std::vector<double> ys;
+   std::vector<int> ids;
+   std::vector<int> cellOf;      // scratch for rebuild
+
+   int column(double x) const;
+   int row(double y) const;
+};
+
+/*************************************************************************
+ * SPATIAL HASH : FOR EACH PAIR
+ * A cell against itself and four of its neighbors (right and the three
+ * above), so that every neighboring pair of cells is looked at once
+ *************************************************************************/
+template <class Visit>
+void SpatialHash::forEachPair(double radius, Visit visit) const
+{
+   static const int neighbors[4][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+   double radius2 = radius * radius;
+
+   for (int r = 0; r < rows; r++)
+      for (int c = 0; c < cols; c++)
+      {
+         int cell = r * cols + c;
+         int begin = cellStart[cell];
+         int end = cellStart[cell + 1];
+         if (begin == end)
+            continue;
+
+         for (int i = begin; i < end; i++)
+            for (int j = i + 1; j < end; j++)
+            {
+               double dx = xs[i] - xs[j];
+               double dy = ys[i] - ys[j];
+               if (dx * dx + dy * dy < radius2)
+                  visit(ids[i], ids[j]);
+            }
+
+         for (const int* n : neighbors)
+         {
+            int nc = c + n[0];
+            int nr = r + n[1];
+            if (nc < 0 || nc >= cols || nr >= rows)
+               continue;
+            int other = nr * cols + nc;
+            for (int i = begin; i < end; i++)
+               for (int j = cellStart[other]; j < cellStart[other + 1]; j++)
+               {
+                  double dx = xs[i] - xs[j];
+                  double dy = ys[i] - ys[j];
+                  if (dx * dx + dy * dy < radius2)
+                     visit(ids[i], ids[j]);
+               }
+         }
+      }
+}
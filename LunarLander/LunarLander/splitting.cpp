@@ -0,0 +1,324 @@
+/***********************************************************************
+ * Source File:
+ *    SPLITTING
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Adaptive multilevel splitting for rare autopilot failures
+ ************************************************************************/
+
+#include "splitting.h"
+#include "controller.h"
+#include "mission.h"   // for MISSION_WIDTH, MISSION_MAX_FRAMES
+#include "world.h"
+#include <algorithm>   // for std::min, std::max, std::min_element
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+// A lander this high is half as close to failing as one on the ground
+static const double SCORE_ALTITUDE = 10.0;
+
+// In flight a score stays below that of a failure
+static const double ALMOST_FAILED = 1.0 - 1e-9;
+
+// Give up on a run after this many rounds per particle, a chance of e^-64
+static const int MAX_ROUNDS = 64;
+
+/*************************************************************************
+ * NEXT
+ * splitmix64, one stream per particle and one per run
+ *************************************************************************/
+static uint64_t next(uint64_t& state)
+{
+   uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+   return z ^ (z >> 31);
+}
+
+/*************************************************************************
+ * UNIFORM
+ * In (0, 1), so its log is finite
+ *************************************************************************/
+static double uniform(uint64_t& state)
+{
+   return ((next(state) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+/*****************************************************
+ * SPLITTING : PARTICLE
+ * A mission as of some frame: everything needed to fly
+ * it on exactly as it would have gone
+ *****************************************************/
+struct Splitting::Particle
+{
+   World world;
+   std::unique_ptr<Controller> controller;
+   uint64_t noise;     // the disturbances still to come
+   double maxScore;    // since it was taken
+
+   Particle copy() const
+   {
+      return Particle{ world, controller->clone(), noise, 0.0 };
+   }
+};
+
+/*************************************************************************
+ * SPLITTING RESULT : MONTE CARLO MISSIONS
+ *************************************************************************/
+double SplittingResult::monteCarloMissions() const
+{
+   if (probability <= 0.0 || error <= 0.0)
+      return 0.0;
+   double relative = error / probability;
+   return (1.0 - probability) / (probability * relative * relative);
+}
+
+/*************************************************************************
+ * SPLITTING : CONSTRUCTOR
+ *************************************************************************/
+Splitting::Splitting(const ControllerFactory& factory, int particles, int runs,
+                     double disturbance) :
+   factory(factory),
+   particles(particles > 1 ? particles : 2),
+   runs(runs > 1 ? runs : 2),
+   disturbance(disturbance),
+   firstSeed(1),
+   result()
+{
+}
+
+Splitting::Splitting(int controllerId, int particles, int runs, double disturbance) :
+   Splitting([controllerId]() { return createController(controllerId); },
+             particles, runs, disturbance)
+{
+}
+
+/*************************************************************************
+ * SPLITTING : SCORE
+ * The worse of speed and tilt against the limits checkSafetyLanding()
+ * and World share, or the worst if not over the platform, scaled down
+ * with altitude
+ *************************************************************************/
+double Splitting::score(const World& world)
+{
+   const Lander& lander = world.getLander(0);
+   if (lander.isDead() || (lander.isFlying() && world.getFrame() >= MISSION_MAX_FRAMES))
+      return 1.0;
+   if (lander.isLanded())
+      return 0.0;
+
+   double radians = lander.getAngle().getRadians();
+   double tilt = fabs(atan2(sin(radians), cos(radians)));
+   double hazard = std::max(lander.getSpeed() / Lander::SAFE_SPEED, tilt / Lander::SAFE_TILT);
+   if (!world.getGround().onPlatform(lander.getPosition(), Lander::WIDTH))
+      hazard = 1.0;
+   double altitude = std::max(world.getAltitude(0), 0.0);
+   return std::min(std::min(hazard, 1.0) / (1.0 + altitude / SCORE_ALTITUDE), ALMOST_FAILED);
+}
+
+/*************************************************************************
+ * SPLITTING : ADVANCE
+ * The controller decides, the disturbance pushes, the world steps
+ *************************************************************************/
+bool Splitting::advance(Particle& particle, double level, uint64_t& frames) const
+{
+   World& world = particle.world;
+   const Lander& lander = world.getLander(0);
+   const double push = disturbance * World::FRAME_TIME;
+   while (true)
+   {
+      double now = score(world);
+      particle.maxScore = std::max(particle.maxScore, now);
+      if (now > level)
+         return true;
+      if (world.numFlying() == 0 || world.getFrame() >= MISSION_MAX_FRAMES)
+         return false;
+
+      unsigned char bits = particle.controller->decide(lander, world.getGround());
+
+      // Box-Muller: two independent normals, one for each way
+      double radius = sqrt(-2.0 * log(uniform(particle.noise))) * push;
+      double theta = 2.0 * M_PI * uniform(particle.noise);
+      world.place(0, lander.getPosition(),
+                  Velocity(lander.getVelocity().getDX() + radius * cos(theta),
+                           lander.getVelocity().getDY() + radius * sin(theta)));
+      world.step(&bits);
+      frames++;
+   }
+}
+
+/*************************************************************************
+ * SPLITTING : SPLIT RUN
+ * branches[i] is particle i as of where it was taken, best[i] its score
+ * from there to the end of its mission. Particles that came no closer
+ * than the level are dropped; each is replaced by replaying a survivor
+ * from its branch to where it passed the level and going on from there
+ * with disturbances of its own.
+ *************************************************************************/
+double Splitting::splitRun(int r, int& levels, uint64_t& frames) const
+{
+   uint64_t stream = (static_cast<uint64_t>(firstSeed) << 32) ^ static_cast<uint64_t>(r);
+   std::vector<Particle> branches;
+   std::vector<double> best(particles);
+   branches.reserve(particles);
+   levels = 0;
+   frames = 0;
+
+   for (int i = 0; i < particles; i++)
+   {
+      uint32_t seed = firstSeed + static_cast<uint32_t>(r * particles + i);
+      std::unique_ptr<Controller> controller = factory();
+      controller->start(seed);
+      branches.push_back(Particle{ World(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, seed),
+                                   std::move(controller), next(stream), 0.0 });
+      Particle flight = branches.back().copy();
+      advance(flight, 1.0, frames);
+      best[i] = flight.maxScore;
+   }
+
+   double kept = 1.0;
+   std::vector<int> dropped;
+   std::vector<int> survivors;
+   while (levels < MAX_ROUNDS * particles)
+   {
+      double level = *std::min_element(best.begin(), best.end());
+      if (level >= 1.0)
+         break;
+      dropped.clear();
+      survivors.clear();
+      for (int i = 0; i < particles; i++)
+         (best[i] <= level ? dropped : survivors).push_back(i);
+      if (survivors.empty())
+         return 0.0;
+      kept *= static_cast<double>(survivors.size()) / particles;
+      levels++;
+
+      for (int i : dropped)
+      {
+         int parent = survivors[next(stream) % survivors.size()];
+         Particle child = branches[parent].copy();
+
+         // A replay goes exactly as the parent went, so it always passes
+         // the level. If the controller's copy flew differently, take
+         // the parent as it is.
+         if (!advance(child, level, frames))
+         {
+            branches[i] = branches[parent].copy();
+            best[i] = best[parent];
+            continue;
+         }
+         child.noise = next(stream);
+         branches[i] = child.copy();
+         child.maxScore = 0.0;
+         advance(child, 1.0, frames);
+         best[i] = child.maxScore;
+      }
+   }
+
+   int failed = 0;
+   for (double highest : best)
+      failed += highest >= 1.0 ? 1 : 0;
+   return kept * failed / particles;
+}
+
+/*************************************************************************
+ * SPLITTING : MONTE CARLO RUN
+ * The same missions and disturbances, flown once each
+ *************************************************************************/
+double Splitting::monteCarloRun(int r, uint64_t& frames) const
+{
+   uint64_t stream = (static_cast<uint64_t>(firstSeed) << 32) ^ static_cast<uint64_t>(r);
+   std::unique_ptr<Controller> controller = factory();
+   int failed = 0;
+   frames = 0;
+   for (int i = 0; i < particles; i++)
+   {
+      uint32_t seed = firstSeed + static_cast<uint32_t>(r * particles + i);
+      controller->start(seed);
+      Particle flight{ World(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, seed),
+                       controller->clone(), next(stream), 0.0 };
+      advance(flight, 1.0, frames);
+      failed += flight.maxScore >= 1.0 ? 1 : 0;
+   }
+   return static_cast<double>(failed) / particles;
+}
+
+/*************************************************************************
+ * SPLITTING : RUN ALL
+ * The runs are independent, so their spread is the error of their mean
+ *************************************************************************/
+template <class Estimate>
+void Splitting::runAll(int numThreads, Estimate estimate)
+{
+   std::vector<double> estimates(runs);
+   std::vector<int> levels(runs, 0);
+   std::vector<uint64_t> frames(runs, 0);
+   std::atomic<int> nextRun(0);
+   auto work = [&]()
+   {
+      for (int r = nextRun++; r < runs; r = nextRun++)
+         estimates[r] = estimate(r, levels[r], frames[r]);
+   };
+   std::vector<std::thread> threads;
+   for (int t = 1; t < numThreads && t < runs; t++)
+      threads.emplace_back(work);
+   work();
+   for (std::thread& thread : threads)
+      thread.join();
+
+   double mean = 0.0;
+   result.levels = 0.0;
+   result.frames = 0;
+   for (int r = 0; r < runs; r++)
+   {
+      mean += estimates[r];
+      result.levels += static_cast<double>(levels[r]) / runs;
+      result.frames += frames[r];
+   }
+   mean /= runs;
+   double variance = 0.0;
+   for (int r = 0; r < runs; r++)
+      variance += (estimates[r] - mean) * (estimates[r] - mean) / (runs - 1);
+
+   result.probability = mean;
+   result.error = sqrt(variance / runs);
+   result.lower = std::max(mean - 1.96 * result.error, 0.0);
+   result.upper = mean + 1.96 * result.error;
+   result.runs = runs;
+}
+
+/*************************************************************************
+ * SPLITTING : RUN
+ *************************************************************************/
+bool Splitting::run(int numThreads)
+{
+   std::unique_ptr<Controller> controller = factory();
+   if (!controller || !controller->clone())
+      return false;
+
+   runAll(numThreads, [this](int r, int& levels, uint64_t& frames)
+   {
+      return splitRun(r, levels, frames);
+   });
+   return true;
+}
+
+/*************************************************************************
+ * SPLITTING : RUN MONTE CARLO
+ *************************************************************************/
+bool Splitting::runMonteCarlo(int numThreads)
+{
+   std::unique_ptr<Controller> controller = factory();
+   if (!controller || !controller->clone())
+      return false;
+
+   runAll(numThreads, [this](int r, int& levels, uint64_t& frames)
+   {
+      levels = 0;
+      return monteCarloRun(r, frames);
+   });
+   return true;
+}
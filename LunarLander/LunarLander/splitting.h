@@ -0,0 +1,109 @@
+/***********************************************************************
+ * Header File:
+ *    SPLITTING
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    How often an autopilot fails when failures are far too rare to
+ *    count one mission at a time, by adaptive multilevel splitting.
+ *
+ *    A mission is deterministic once its seed is chosen, so there is
+ *    nothing to split. Here every frame also gets a small random push
+ *    (a disturbance, in m/s^2 each way), and what is estimated is the
+ *    chance that a random mission under that disturbance does not land.
+ *
+ *    A score says how close a lander is to failing: near 1 low down and
+ *    fast, tilted or off the platform, 1 once it has crashed or run out
+ *    of time. N missions are flown. Over and over, the one that came
+ *    least close is dropped and replaced by a copy of another taken from
+ *    the moment that one passed the dropped one's best score, flown on
+ *    with fresh disturbances. Each round keeps 1 - 1/N of the chance to
+ *    get that far, so when every mission has failed or none can be
+ *    dropped the product of the rounds, times the share that failed, is
+ *    an unbiased estimate. A chance of 1e-6 takes about 14 N rounds of
+ *    part of a mission each, not a million missions.
+ *
+ *    Independent runs on separate threads give the error bar.
+ ************************************************************************/
+
+#pragma once
+
+#include "controller.h"   // for ControllerFactory
+#include <stdint.h>
+
+// Forward declarations
+class TestSplitting;
+class World;
+
+/*****************************************************
+ * SPLITTING RESULT
+ * A failure rate with its 95% confidence interval
+ *****************************************************/
+struct SplittingResult
+{
+   double probability;   // of failure, per mission
+   double error;         // standard error of the probability
+   double lower;         // 95% confidence interval, never below 0
+   double upper;
+   int runs;             // independent estimates behind it
+   double levels;        // rounds per run, on average
+   uint64_t frames;      // simulated, over every run
+
+   // Plain missions needed for the same relative error: (1 - p) / (p e^2)
+   // for relative error e. 0 if there is no estimate.
+   double monteCarloMissions() const;
+};
+
+/*****************************************************
+ * SPLITTING
+ *****************************************************/
+class Splitting
+{
+   friend TestSplitting;
+
+public:
+   // particles missions per run; disturbance in m/s^2 each way. The
+   // controller must be able to clone() itself.
+   Splitting(const ControllerFactory& factory, int particles, int runs, double disturbance);
+   Splitting(int controllerId, int particles, int runs, double disturbance);
+
+   // Missions of run r take seeds firstSeed + r * particles onward
+   void setFirstSeed(uint32_t seed) { firstSeed = seed; }
+
+   // Every run, spread over numThreads. False if the factory makes no
+   // controller or the controller cannot be cloned.
+   bool run(int numThreads);
+
+   // The same failure rate by plain Monte Carlo, to check against: runs
+   // batches of particles disturbed missions each
+   bool runMonteCarlo(int numThreads);
+
+   const SplittingResult& getResult() const { return result; }
+
+   // How near a lander is to failing, from 0 to just under 1 in flight.
+   // 1 once it has crashed or run out of time.
+   static double score(const World& world);
+
+private:
+   ControllerFactory factory;
+   int particles;
+   int runs;
+   double disturbance;
+   uint32_t firstSeed;
+   SplittingResult result;
+
+   struct Particle;
+
+   // One independent estimate: the probability, its rounds and frames
+   double splitRun(int r, int& levels, uint64_t& frames) const;
+   double monteCarloRun(int r, uint64_t& frames) const;
+
+   // Fly from where the particle is until its score passes level or the
+   // mission is over, with the particle's own disturbances. True if it
+   // passed the level.
+   bool advance(Particle& particle, double level, uint64_t& frames) const;
+
+   // Every run through estimate(), then the mean and its spread
+   template <class Estimate>
+   void runAll(int numThreads, Estimate estimate);
+};
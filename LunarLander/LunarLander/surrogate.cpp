@@ -0,0 +1,317 @@
+/***********************************************************************
+ * Source File:
+ *    SURROGATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Landing chance and fuel left, looked up instead of flown
+ ************************************************************************/
+
+#include "surrogate.h"
+#include "controller.h"
+#include "ground.h"
+#include "mission.h"            // for MISSION_WIDTH, MISSION_MAX_FRAMES, sobolConditions
+#include "resultStore.h"
+#include "trajectoryArchive.h"
+#include "world.h"
+#include <cmath>
+#include <cstdio>
+#include <unordered_map>
+
+// Upper edges of every feature's bins; past the last is one more bin
+static const double ALTITUDE_EDGES[]  = { 1.0, 2.0, 4.0, 8.0, 16.0, 32.0, 64.0, 128.0, 256.0 };
+static const double OFFSET_EDGES[]    = { -200.0, -80.0, -30.0, -10.0, 10.0, 30.0, 80.0, 200.0 };
+static const double DX_EDGES[]        = { -8.0, -4.0, -2.0, -0.5, 0.5, 2.0, 4.0, 8.0 };
+static const double DY_EDGES[]        = { -12.0, -8.0, -4.0, -2.0, -1.0, 0.0 };
+static const double TILT_EDGES[]      = { -0.6, -0.2, -0.05, 0.05, 0.2, 0.6 };
+static const double FUEL_EDGES[]      = { 250.0, 750.0, 1500.0 };
+static const double CLEARANCE_EDGES[] = { -50.0, 0.0, 50.0 };
+
+/*************************************************************************
+ * BIN
+ * Which bin of a feature a value falls in, and the radix to the next
+ *************************************************************************/
+template <size_t N>
+static uint32_t bin(uint32_t cell, double value, const double (&edges)[N])
+{
+   uint32_t i = 0;
+   while (i < N && value >= edges[i])
+      i++;
+   return cell * (N + 1) + i;
+}
+
+/*************************************************************************
+ * SLOT
+ * Where in a table a key's probe starts. The middle bits of the product
+ * depend on the cell and the controller both.
+ *************************************************************************/
+static size_t slot(uint64_t key, size_t mask)
+{
+   return static_cast<size_t>((key * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+}
+
+/*************************************************************************
+ * SURROGATE : CONSTRUCTOR
+ *************************************************************************/
+Surrogate::Surrogate() :
+   table(1024, Entry{ 0, 0, 0, 0.0 }),
+   used(0),
+   samples(0),
+   missions(0),
+   maxError(SURROGATE_MAX_ERROR)
+{
+}
+
+/*************************************************************************
+ * SURROGATE : CELL
+ * The pad offset is from the lander to the platform's center; the tilt
+ * is either side of upright, however many turns the angle has made
+ * (without remainder(), which is exact and slow)
+ *************************************************************************/
+uint32_t Surrogate::cell(const Ground& ground, const TrajectoryFrame& state)
+{
+   Position pos(state.x, state.y);
+   double tilt = state.angle - 2.0 * M_PI * floor(state.angle / (2.0 * M_PI) + 0.5);
+   uint32_t cell = 0;
+   cell = bin(cell, state.y - ground.getElevationMeters(pos), ALTITUDE_EDGES);
+   cell = bin(cell, state.x - ground.getPlatformPosition().getX(), OFFSET_EDGES);
+   cell = bin(cell, state.dx, DX_EDGES);
+   cell = bin(cell, state.dy, DY_EDGES);
+   cell = bin(cell, tilt, TILT_EDGES);
+   cell = bin(cell, state.fuel, FUEL_EDGES);
+   cell = bin(cell, state.y - ground.getHighestElevation(), CLEARANCE_EDGES);
+   return cell;
+}
+
+/*************************************************************************
+ * SURROGATE : KEY
+ * Never 0, which marks an empty entry
+ *************************************************************************/
+uint64_t Surrogate::key(int controller, uint32_t cell)
+{
+   return (static_cast<uint64_t>(static_cast<uint32_t>(controller) + 1u) << 32) | cell;
+}
+
+/*************************************************************************
+ * SURROGATE : FIND
+ * Linear probing from the key's hash
+ *************************************************************************/
+const Surrogate::Entry* Surrogate::find(uint64_t key) const
+{
+   size_t mask = table.size() - 1;
+   for (size_t i = slot(key, mask); ; i = (i + 1) & mask)
+   {
+      if (table[i].key == key)
+         return &table[i];
+      if (table[i].key == 0)
+         return nullptr;
+   }
+}
+
+/*************************************************************************
+ * SURROGATE : INSERT
+ * The entry for a key, made empty if there was none. The table doubles
+ * before it is half full, so a probe stays short.
+ *************************************************************************/
+Surrogate::Entry& Surrogate::insert(uint64_t key)
+{
+   if ((used + 1) * 2 > table.size())
+   {
+      std::vector<Entry> old(table.size() * 2, Entry{ 0, 0, 0, 0.0 });
+      old.swap(table);
+      used = 0;
+      for (const Entry& entry : old)
+         if (entry.key)
+            insert(entry.key) = entry;
+   }
+
+   size_t mask = table.size() - 1;
+   size_t i = slot(key, mask);
+   while (table[i].key != key && table[i].key != 0)
+      i = (i + 1) & mask;
+   if (table[i].key == 0)
+   {
+      table[i].key = key;
+      used++;
+   }
+   return table[i];
+}
+
+/*************************************************************************
+ * SURROGATE : ADD
+ *************************************************************************/
+void Surrogate::add(int controller, const Ground& ground,
+                    const std::vector<TrajectoryFrame>& trajectory, bool landed, double fuel)
+{
+   for (size_t f = 0; f + 1 < trajectory.size(); f++)
+   {
+      Entry& entry = insert(key(controller, cell(ground, trajectory[f])));
+      entry.samples++;
+      entry.landed += landed ? 1 : 0;
+      entry.fuel += fuel;
+      samples++;
+   }
+   missions++;
+}
+
+/*************************************************************************
+ * SURROGATE : MISSION
+ * A seed and controller together name one mission of a store; several
+ * controllers may have flown the same seed
+ *************************************************************************/
+static uint64_t mission(uint32_t seed, int controller)
+{
+   return (static_cast<uint64_t>(static_cast<uint32_t>(controller)) << 32) | seed;
+}
+
+/*************************************************************************
+ * SURROGATE : TRAIN
+ * Results found by seed and controller, the terrain made again as the
+ * store says the batch made it
+ *************************************************************************/
+bool Surrogate::train(const ResultStore& store, const TrajectoryArchive& archive)
+{
+   std::unordered_map<uint64_t, uint64_t> rows;
+   for (uint64_t row = 0; row < store.getRows(); row++)
+      rows[mission(static_cast<uint32_t>(store.value(COLUMN_SEED, row)),
+                   static_cast<int>(store.value(COLUMN_CONTROLLER, row)))] = row;
+
+   bool sobol = store.getSampling() == SAMPLING_SOBOL;
+   std::vector<TrajectoryFrame> frames;
+   for (size_t i = 0; i < archive.getCount(); i++)
+   {
+      const TrajectoryArchive::Trajectory& trajectory = archive.getTrajectory(i);
+      auto found = rows.find(mission(trajectory.seed, trajectory.controller));
+      if (found == rows.end())
+         continue;
+      if (!archive.read(i, frames))
+         return false;
+
+      MissionConditions conditions = sobol ?
+         sobolConditions(trajectory.seed, store.getScramble()) : MissionConditions();
+      World world = sobol ?
+         World(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, conditions.terrainSeed,
+               &conditions.terrain) :
+         World(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, trajectory.seed);
+      add(trajectory.controller, world.getGround(), frames,
+          static_cast<int>(store.value(COLUMN_OUTCOME, found->second)) == MISSION_LANDED,
+          store.value(COLUMN_FUEL, found->second));
+   }
+   return true;
+}
+
+/*************************************************************************
+ * SURROGATE : SAVE
+ *************************************************************************/
+bool Surrogate::save(const std::string& path) const
+{
+   FILE* file = fopen(path.c_str(), "wb");
+   if (!file)
+      return false;
+
+   SurrogateHeader header = { SURROGATE_MAGIC, SURROGATE_VERSION,
+                              static_cast<uint32_t>(used), 0 };
+   bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+   for (const Entry& entry : table)
+   {
+      if (!entry.key)
+         continue;
+      SurrogateCell cell = { static_cast<int32_t>((entry.key >> 32) - 1),
+                             static_cast<uint32_t>(entry.key), entry.samples, entry.landed,
+                             static_cast<float>(entry.fuel / entry.samples) };
+      ok = ok && fwrite(&cell, sizeof(cell), 1, file) == 1;
+   }
+   return fclose(file) == 0 && ok;
+}
+
+/*************************************************************************
+ * SURROGATE : LOAD
+ * Replaces whatever was learned before
+ *************************************************************************/
+bool Surrogate::load(const std::string& path)
+{
+   FILE* file = fopen(path.c_str(), "rb");
+   if (!file)
+      return false;
+
+   SurrogateHeader header;
+   std::vector<SurrogateCell> cells;
+   bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+             header.magic == SURROGATE_MAGIC && header.version == SURROGATE_VERSION;
+   if (ok)
+   {
+      cells.resize(header.numCells);
+      ok = fread(cells.data(), sizeof(SurrogateCell), cells.size(), file) == cells.size() &&
+           fgetc(file) == EOF;
+   }
+   fclose(file);
+   if (!ok)
+      return false;
+
+   double tolerance = maxError;
+   *this = Surrogate();
+   maxError = tolerance;
+   for (const SurrogateCell& cell : cells)
+   {
+      Entry& entry = insert(key(cell.controller, cell.cell));
+      entry.samples = cell.samples;
+      entry.landed = cell.landed;
+      entry.fuel = static_cast<double>(cell.fuel) * cell.samples;
+      samples += cell.samples;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * SURROGATE : PREDICT
+ * The Beta(1, 1) prior gives a cell nobody has seen a chance of one half
+ * and an error too big to be certain of
+ *************************************************************************/
+SurrogatePrediction Surrogate::predict(int controller, const Ground& ground,
+                                       const TrajectoryFrame& state) const
+{
+   const Entry* entry = find(key(controller, cell(ground, state)));
+   double n = entry ? entry->samples : 0.0;
+   double landed = entry ? entry->landed : 0.0;
+
+   SurrogatePrediction prediction;
+   prediction.landed = (landed + 1.0) / (n + 2.0);
+   prediction.fuel = entry ? entry->fuel / n : state.fuel;
+   prediction.error = sqrt(prediction.landed * (1.0 - prediction.landed) / (n + 3.0));
+   prediction.samples = entry ? entry->samples : 0;
+   prediction.certain = entry && prediction.error <= maxError;
+   prediction.simulated = false;
+   return prediction;
+}
+
+/*************************************************************************
+ * SURROGATE : PREDICT OR SIMULATE
+ * The world is deterministic, so what a copy does is what will happen
+ *************************************************************************/
+SurrogatePrediction Surrogate::predictOrSimulate(const World& world,
+                                                 const Controller& controller) const
+{
+   const Lander& lander = world.getLander(0);
+   TrajectoryFrame state = { lander.getPosition().getX(), lander.getPosition().getY(),
+                             lander.getVelocity().getDX(), lander.getVelocity().getDY(),
+                             lander.getAngle().getRadians(), lander.getFuelMass().value(), 0 };
+   SurrogatePrediction prediction = predict(controller.getId(), world.getGround(), state);
+   std::unique_ptr<Controller> pilot;
+   if (prediction.certain || !lander.isFlying() || !(pilot = controller.clone()))
+      return prediction;
+
+   World rest = world;
+   const Lander& flown = rest.getLander(0);
+   while (rest.numFlying() > 0 && rest.getFrame() < MISSION_MAX_FRAMES)
+   {
+      unsigned char bits = pilot->decide(flown, rest.getGround());
+      rest.step(&bits);
+   }
+   prediction.landed = flown.isLanded() ? 1.0 : 0.0;
+   prediction.fuel = flown.getFuelMass().value();
+   prediction.error = 0.0;
+   prediction.samples = 0;
+   prediction.certain = true;
+   prediction.simulated = true;
+   return prediction;
+}
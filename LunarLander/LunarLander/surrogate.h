@@ -0,0 +1,141 @@
+/***********************************************************************
+ * Header File:
+ *    SURROGATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A cheap stand-in for flying the rest of a mission: the chance that
+ *    a controller lands from where a lander is, and the fuel it will have
+ *    left, learned from batch results.
+ *
+ *    Every frame of every archived mission is a sample, labeled with how
+ *    that mission ended. A state is binned on seven features - altitude,
+ *    distance from the pad, dx, dy, tilt, fuel and height over the
+ *    tallest peak - and a cell keeps how many samples fell in it, how
+ *    many of them landed and their fuel. A prediction is one hash lookup.
+ *
+ *    The landing chance is the mean of its Beta posterior, so a cell with
+ *    few samples says so: a prediction whose posterior standard error is
+ *    over the tolerance is not certain, and predictOrSimulate() flies the
+ *    rest of the mission instead.
+ *
+ *    A model file:
+ *       SurrogateHeader
+ *       SurrogateCell[numCells]
+ ************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class TestSurrogate;
+class Controller;
+class Ground;
+class World;
+class ResultStore;
+class TrajectoryArchive;
+struct TrajectoryFrame;
+
+#define SURROGATE_MAGIC          0x4d534c4cu   // "LLSM"
+#define SURROGATE_VERSION        1u
+#define SURROGATE_MAX_ERROR      0.05          // default tolerance
+#define SURROGATE_NUM_FEATURES   7
+
+// Start of a model file
+struct SurrogateHeader
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t numCells;
+   uint32_t reserved;
+};
+
+// One occupied cell of a model file
+struct SurrogateCell
+{
+   int32_t  controller;   // ControllerId
+   uint32_t cell;         // the binned state
+   uint32_t samples;
+   uint32_t landed;       // of the samples
+   float    fuel;         // mean kg left at the end
+};
+
+/*****************************************************
+ * SURROGATE PREDICTION
+ *****************************************************/
+struct SurrogatePrediction
+{
+   double landed;       // chance of landing
+   double fuel;         // kg left at the end
+   double error;        // standard error of the chance, 0 if simulated
+   uint32_t samples;    // behind the cell, 0 if simulated
+   bool certain;        // error within the tolerance, or simulated
+   bool simulated;      // flown rather than looked up
+};
+
+/*****************************************************
+ * SURROGATE
+ *****************************************************/
+class Surrogate
+{
+   friend TestSurrogate;
+
+public:
+   Surrogate();
+
+   // A prediction is certain when its standard error is at most this
+   void setTolerance(double maxError) { this->maxError = maxError; }
+
+   // Every frame of a flown mission but the last, which is already down
+   void add(int controller, const Ground& ground,
+            const std::vector<TrajectoryFrame>& trajectory, bool landed, double fuel);
+
+   // Every archived mission that has a result in the store for the same
+   // seed and controller, over the terrain it flew: from the seed, or
+   // from sobolConditions() if the store says the batch was Sobol.
+   // False if the archive is corrupt.
+   bool train(const ResultStore& store, const TrajectoryArchive& archive);
+
+   bool save(const std::string& path) const;
+
+   // False, with nothing kept, if the file is not a model
+   bool load(const std::string& path);
+
+   // A lander's state as the archive keeps it
+   SurrogatePrediction predict(int controller, const Ground& ground,
+                               const TrajectoryFrame& state) const;
+
+   // The same for lander 0 of a mission's world, flying the rest of the
+   // mission on a copy when the model is not certain. The controller must
+   // be able to clone() itself for that.
+   SurrogatePrediction predictOrSimulate(const World& world, const Controller& controller) const;
+
+   size_t getCells() const { return used; }
+   uint64_t getSamples() const { return samples; }
+   uint64_t getMissions() const { return missions; }
+
+private:
+   struct Entry
+   {
+      uint64_t key;        // 0 for empty
+      uint32_t samples;
+      uint32_t landed;
+      double fuel;         // total kg left
+   };
+
+   std::vector<Entry> table;   // open addressing, a power of two long
+   size_t used;
+   uint64_t samples;
+   uint64_t missions;
+   double maxError;
+
+   // The binned state, in mixed radix
+   static uint32_t cell(const Ground& ground, const TrajectoryFrame& state);
+   static uint64_t key(int controller, uint32_t cell);
+
+   const Entry* find(uint64_t key) const;
+   Entry& insert(uint64_t key);
+};
@@ -0,0 +1,138 @@
+/***********************************************************************
+ * Source File:
+ *    TERRAIN STREAM
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Terrain along the ground track, made one tile at a time
+ ************************************************************************/
+
+#include "terrainStream.h"
+#include <cmath>
+
+// Hills on four scales, meters: lattice spacing and height
+static const double OCTAVE_SPACING[4] = { 8000.0, 2000.0, 500.0, 100.0 };
+static const double OCTAVE_HEIGHT[4]  = {  600.0,  150.0,  40.0,   8.0 };
+
+// The ground eases into the pad over this many meters on each side
+static const double PAD_APPROACH = 200.0;
+
+/*************************************************************************
+ * LATTICE
+ * A repeatable value in [-1, 1] for one lattice point (splitmix64)
+ *************************************************************************/
+static double lattice(uint32_t seed, int octave, int64_t point)
+{
+   uint64_t z = (static_cast<uint64_t>(seed) << 32) ^
+                (static_cast<uint64_t>(octave) << 56) ^
+                static_cast<uint64_t>(point);
+   z += 0x9e3779b97f4a7c15ull;
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+   z ^= z >> 31;
+   return (z >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+}
+
+/*************************************************************************
+ * TERRAIN STREAM : CONSTRUCTOR
+ *************************************************************************/
+TerrainStream::TerrainStream(uint32_t seed, double padX, double padWidth) :
+   seed(seed),
+   padX(padX),
+   padWidth(padWidth),
+   clock(0),
+   tilesGenerated(0)
+{
+   padElevation = noise(padX);
+   for (Tile& t : tiles)
+   {
+      t.index = INT64_MIN;
+      t.lastUsed = 0;
+   }
+}
+
+/*************************************************************************
+ * TERRAIN STREAM : NOISE
+ * Smoothly interpolated value noise, summed over the octaves
+ *************************************************************************/
+double TerrainStream::noise(double s) const
+{
+   double elevation = 0.0;
+   for (int octave = 0; octave < 4; octave++)
+   {
+      double u = s / OCTAVE_SPACING[octave];
+      double cell = floor(u);
+      double f = u - cell;
+      f = f * f * (3.0 - 2.0 * f);
+      int64_t point = static_cast<int64_t>(cell);
+      double a = lattice(seed, octave, point);
+      double b = lattice(seed, octave, point + 1);
+      elevation += (a + (b - a) * f) * OCTAVE_HEIGHT[octave];
+   }
+   return elevation;
+}
+
+/*************************************************************************
+ * TERRAIN STREAM : RAW
+ * The noise, flattened to the pad elevation around the pad
+ *************************************************************************/
+double TerrainStream::raw(double s) const
+{
+   double fromPad = fabs(s - padX) - padWidth / 2.0;
+   if (fromPad <= 0.0)
+      return padElevation;
+   double elevation = noise(s);
+   if (fromPad >= PAD_APPROACH)
+      return elevation;
+   double w = fromPad / PAD_APPROACH;
+   return padElevation + (elevation - padElevation) * w;
+}
+
+/*************************************************************************
+ * TERRAIN STREAM : TILE
+ * Least recently used tile goes when a new one is needed
+ *************************************************************************/
+const TerrainStream::Tile& TerrainStream::tile(int64_t index)
+{
+   clock++;
+   Tile* oldest = &tiles[0];
+   for (Tile& t : tiles)
+   {
+      if (t.index == index)
+      {
+         t.lastUsed = clock;
+         return t;
+      }
+      if (t.lastUsed < oldest->lastUsed)
+         oldest = &t;
+   }
+
+   // One extra sample so that interpolation never reaches the next tile
+   oldest->index = index;
+   oldest->lastUsed = clock;
+   oldest->samples.resize(TERRAIN_TILE_SAMPLES + 1);
+   double start = index * TERRAIN_TILE_SAMPLES * TERRAIN_SAMPLE_SPACING;
+   for (int i = 0; i <= TERRAIN_TILE_SAMPLES; i++)
+      oldest->samples[i] = raw(start + i * TERRAIN_SAMPLE_SPACING);
+   tilesGenerated++;
+   return *oldest;
+}
+
+/*************************************************************************
+ * TERRAIN STREAM : GET ELEVATION
+ * Linear between the samples of the tile s falls in. The pad itself is
+ * exact, so a lander sitting on it sits at padElevation.
+ *************************************************************************/
+double TerrainStream::getElevation(double s)
+{
+   if (fabs(s - padX) <= padWidth / 2.0)
+      return padElevation;
+
+   double u = s / TERRAIN_SAMPLE_SPACING;
+   double sample = floor(u);
+   int64_t index = static_cast<int64_t>(floor(sample / TERRAIN_TILE_SAMPLES));
+   const Tile& t = tile(index);
+   int i = static_cast<int>(static_cast<int64_t>(sample) - index * TERRAIN_TILE_SAMPLES);
+   double f = u - sample;
+   return t.samples[i] + (t.samples[i + 1] - t.samples[i]) * f;
+}
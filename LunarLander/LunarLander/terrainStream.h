@@ -0,0 +1,74 @@
+/***********************************************************************
+ * Header File:
+ *    TERRAIN STREAM
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Terrain along a ground track hundreds of kilometers long. Nothing
+ *    is generated until somebody asks for the elevation there; then the
+ *    whole tile around it is made from the seed and kept in a small
+ *    cache. The same seed gives the same terrain in any order of
+ *    requests, so a batch worker that only ever looks at the last few
+ *    kilometers pays for the last few kilometers.
+ ************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+// Forward declaration for unit tests
+class TestTerrainStream;
+
+#define TERRAIN_SAMPLE_SPACING   10.0     // meters between samples
+#define TERRAIN_TILE_SAMPLES     1024     // so a tile is 10.24 km
+#define TERRAIN_CACHED_TILES     4
+
+/*****************************************************
+ * TERRAIN STREAM
+ * Elevation by downrange distance, with one landing pad
+ *****************************************************/
+class TerrainStream
+{
+   friend TestTerrainStream;
+
+public:
+   // The pad is padWidth meters wide, centered padX meters downrange
+   TerrainStream(uint32_t seed, double padX, double padWidth);
+
+   // Meters above the datum (the mean lunar radius) at s meters downrange
+   double getElevation(double s);
+
+   bool onPad(double s, double width) const
+   {
+      return s - width / 2.0 >= padX - padWidth / 2.0 &&
+             s + width / 2.0 <= padX + padWidth / 2.0;
+   }
+
+   double getPadX() const { return padX; }
+   double getPadWidth() const { return padWidth; }
+   double getPadElevation() const { return padElevation; }
+
+   // How many tiles have been made, for tests and reports
+   int getTilesGenerated() const { return tilesGenerated; }
+
+private:
+   struct Tile
+   {
+      int64_t index;               // tile number along the track
+      uint64_t lastUsed;
+      std::vector<double> samples;
+   };
+
+   uint32_t seed;
+   double padX;
+   double padWidth;
+   double padElevation;
+   Tile tiles[TERRAIN_CACHED_TILES];
+   uint64_t clock;
+   int tilesGenerated;
+
+   double noise(double s) const;
+   double raw(double s) const;
+   const Tile& tile(int64_t index);
+};
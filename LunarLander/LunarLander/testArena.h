@@ -0,0 +1,161 @@
+/***********************************************************************
+ * Header File:
+ *    TEST ARENA
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for ARENA
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "arena.h"
+#include <cstdint>
+#include <thread>
+
+/*******************************
+ * TEST ARENA
+ * A friend class for Arena which contains the Arena unit tests
+ ********************************/
+class TestArena : public UnitTest
+{
+public:
+	void run()
+	{
+		// allocate
+		allocate_aligned();
+		allocate_overflow();
+
+		// reset
+		reset_rewinds();
+		reset_grows();
+
+		// allocator
+		vector_inArena();
+		threadArena_perThread();
+
+		report("Arena");
+	}
+
+private:
+
+	/*********************************************
+	 * name:    ALLOCATE ALIGNED
+	 * input:   1 byte, then a double
+	 * output:  the double is 8-byte aligned, right after the byte
+	 *********************************************/
+	void allocate_aligned()
+	{  // setup
+		Arena a(256);
+
+		// exercise
+		char* c = static_cast<char*>(a.allocate(1, 1));
+		double* d = static_cast<double*>(a.allocate(sizeof(double), alignof(double)));
+
+		// verify
+		assertUnit(reinterpret_cast<uintptr_t>(d) % alignof(double) == 0);
+		assertUnit(reinterpret_cast<char*>(d) - c <= static_cast<long>(alignof(double)));
+		assertUnit(a.getUsed() <= 16);
+	}  // teardown
+
+	/*********************************************
+	 * name:    ALLOCATE OVERFLOW
+	 * input:   64-byte arena, three 40-byte allocations
+	 * output:  all three usable, the full blocks are retired
+	 *********************************************/
+	void allocate_overflow()
+	{  // setup
+		Arena a(64);
+
+		// exercise
+		char* p1 = static_cast<char*>(a.allocate(40, 8));
+		char* p2 = static_cast<char*>(a.allocate(40, 8));
+		char* p3 = static_cast<char*>(a.allocate(40, 8));
+		p1[39] = p2[39] = p3[39] = 'x';
+
+		// verify
+		assertUnit(p1 != p2 && p2 != p3);
+		assertUnit(a.retired.size() == 1);
+		assertUnit(a.getUsed() == 120);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RESET REWINDS
+	 * input:   allocate, reset, allocate again
+	 * output:  the same address both times
+	 *********************************************/
+	void reset_rewinds()
+	{  // setup
+		Arena a(256);
+		void* first = a.allocate(100);
+
+		// exercise
+		a.reset();
+		void* second = a.allocate(100);
+
+		// verify
+		assertUnit(first == second);
+		assertUnit(a.getCapacity() == 256);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RESET GROWS
+	 * input:   a frame that needs 300 bytes of a 64-byte arena
+	 * output:  after reset the same frame fits in one block
+	 *********************************************/
+	void reset_grows()
+	{  // setup
+		Arena a(64);
+		for (int i = 0; i < 5; i++)
+			a.allocate(60, 4);
+
+		// exercise
+		a.reset();
+		for (int i = 0; i < 5; i++)
+			a.allocate(60, 4);
+
+		// verify
+		assertUnit(a.getCapacity() >= 300);
+		assertUnit(a.retired.empty());
+	}  // teardown
+
+	/*********************************************
+	 * name:    VECTOR IN ARENA
+	 * input:   an ArenaVector of 100 ints
+	 * output:  the elements live inside the arena
+	 *********************************************/
+	void vector_inArena()
+	{  // setup
+		Arena a(4096);
+
+		// exercise
+		ArenaVector<int> v{ ArenaAllocator<int>(a) };
+		for (int i = 0; i < 100; i++)
+			v.push_back(i);
+
+		// verify
+		char* data = reinterpret_cast<char*>(v.data());
+		assertUnit(data >= a.block && data < a.block + a.capacity);
+		assertUnit(v[99] == 99);
+	}  // teardown
+
+	/*********************************************
+	 * name:    THREAD ARENA PER THREAD
+	 * input:   threadArena() here and on another thread
+	 * output:  two different arenas
+	 *********************************************/
+	void threadArena_perThread()
+	{  // setup
+		Arena* mine = &threadArena();
+		Arena* theirs = nullptr;
+
+		// exercise
+		std::thread other([&] { theirs = &threadArena(); });
+		other.join();
+
+		// verify
+		assertUnit(mine != theirs);
+		assertUnit(mine == &threadArena());
+	}  // teardown
+};
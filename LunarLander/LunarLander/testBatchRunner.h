@@ -0,0 +1,268 @@
+/***********************************************************************
+ * Header File:
+ *    TEST BATCH RUNNER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for missions and the batch runner
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "batchRunner.h"
+#include "controller.h"
+#include <cstdlib>   // for mkdtemp, system
+#include <unistd.h>  // for access, truncate
+#include <string>
+#include <vector>
+
+/*******************************
+ * TEST BATCH RUNNER
+ * A friend class for BatchRunner which contains the BatchRunner unit tests
+ ********************************/
+class TestBatchRunner : public UnitTest
+{
+public:
+	void run()
+	{
+		char pattern[] = "/tmp/batchRunnerXXXXXX";
+		if (!mkdtemp(pattern))
+			return;
+		directory = pattern;
+
+		// missions
+		runMission_sameSeed();
+		runMission_freeFallCrashes();
+		stats_orderIndependent();
+
+		// batch
+		runLocal_count();
+		runSharded_matchesLocal();
+		runSharded_workerDies();
+
+		// checkpoints
+		checkpoint_resumes();
+		checkpoint_otherRunIgnored();
+
+		std::string cleanup = "rm -rf " + directory;
+		if (system(cleanup.c_str()) != 0)
+			std::cerr << "could not remove " << directory << "\n";
+
+		report("BatchRunner");
+	}
+
+private:
+	std::string directory;
+
+	/*********************************************
+	 * name:    RUN MISSION SAME SEED
+	 * input:   seed 12 twice with the simple autopilot
+	 * output:  identical results
+	 *********************************************/
+	void runMission_sameSeed()
+	{  // setup
+		SimpleAutopilot pilot;
+
+		// exercise
+		MissionResult r1 = runMission(12, pilot);
+		MissionResult r2 = runMission(12, pilot);
+
+		// verify
+		assertUnit(r1.seed == 12);
+		assertUnit(r1.controller == CONTROLLER_SIMPLE);
+		assertUnit(r1.outcome == r2.outcome);
+		assertUnit(r1.frames == r2.frames);
+		assertEquals(r1.fuel, r2.fuel);
+		assertEquals(r1.touchdownSpeed, r2.touchdownSpeed);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN MISSION FREE FALL CRASHES
+	 * input:   nobody at the controls
+	 * output:  a crash with all the fuel left
+	 *********************************************/
+	void runMission_freeFallCrashes()
+	{  // setup
+		FreeFall nobody;
+
+		// exercise
+		MissionResult r = runMission(5, nobody);
+
+		// verify
+		assertUnit(r.outcome == MISSION_CRASHED);
+		assertUnit(r.touchdownSpeed > 4.0);
+		assertEquals(r.fuel, 2267.96185);   // 5000 lbs
+	}  // teardown
+
+	/*********************************************
+	 * name:    STATS ORDER INDEPENDENT
+	 * input:   three results added forward and backward
+	 * output:  exactly equal totals
+	 *********************************************/
+	void stats_orderIndependent()
+	{  // setup
+		MissionResult r[3] = {};
+		r[0].fuel = 0.1;  r[0].touchdownSpeed = 1e-3;
+		r[1].fuel = 1e9;  r[1].touchdownSpeed = 3.3;  r[1].outcome = MISSION_CRASHED;
+		r[2].fuel = 0.2;  r[2].touchdownSpeed = 7.77; r[2].outcome = MISSION_TIMEOUT;
+		MissionStats forward;
+		MissionStats backward;
+
+		// exercise
+		for (int i = 0; i < 3; i++)
+			forward.add(r[i]);
+		for (int i = 2; i >= 0; i--)
+			backward.add(r[i]);
+
+		// verify
+		assertUnit(forward == backward);
+		assertUnit(forward.landed == 1 && forward.crashed == 1 && forward.timeouts == 1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN LOCAL COUNT
+	 * input:   10 missions in chunks of 3
+	 * output:  10 missions counted
+	 *********************************************/
+	void runLocal_count()
+	{  // setup
+		BatchRunner runner(100, 10, CONTROLLER_NONE);
+		runner.setChunkSize(3);
+
+		// exercise
+		MissionStats stats = runner.runLocal();
+
+		// verify
+		assertUnit(runner.numChunks() == 4);
+		assertUnit(stats.missions == 10);
+		assertUnit(stats.crashed == 10);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN SHARDED MATCHES LOCAL
+	 * input:   20 missions over 3 workers
+	 * output:  the same totals as one process
+	 *********************************************/
+	void runSharded_matchesLocal()
+	{  // setup
+		BatchRunner runner(1, 20, CONTROLLER_SIMPLE);
+		runner.setChunkSize(4);
+		runner.setPinning(false);
+		MissionStats sharded;
+
+		// exercise
+		bool complete = runner.runSharded(3, sharded);
+
+		// verify
+		assertUnit(complete);
+		assertUnit(sharded == runner.runLocal());
+		assertUnit(runner.getRetries() == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN SHARDED WORKER DIES
+	 * input:   the worker holding chunk 2 dies on it
+	 * output:  its chunks are re-run, totals still match
+	 *********************************************/
+	void runSharded_workerDies()
+	{  // setup
+		BatchRunner runner(1, 20, CONTROLLER_NONE);
+		runner.setChunkSize(2);
+		runner.setPinning(false);
+		runner.failChunk = 2;
+		MissionStats sharded;
+
+		// exercise
+		bool complete = runner.runSharded(2, sharded);
+
+		// verify
+		assertUnit(complete);
+		assertUnit(runner.getRetries() > 0);
+		assertUnit(sharded == runner.runLocal());
+	}  // teardown
+
+	/*********************************************
+	 * name:    CHECKPOINT RESUMES
+	 * input:   22 missions in chunks of 4 with
+	 *          chunks 0, 1, 3 and 5 checkpointed,
+	 *          over 2 workers; then the same again
+	 * output:  14 missions resumed and the totals
+	 *          of a run from scratch; then all 22
+	 *          resumed, nothing left beside the file
+	 *********************************************/
+	void checkpoint_resumes()
+	{  // setup
+		std::string path = directory + "/resume";
+		BatchRunner partial(1, 22, CONTROLLER_SIMPLE);
+		partial.setChunkSize(4);
+		partial.setCheckpoint(path);
+		std::vector<bool> done(partial.numChunks(), false);
+		MissionStats partialStats;
+		for (uint32_t chunk : { 0u, 1u, 3u, 5u })
+		{
+			done[chunk] = true;
+			partialStats.merge(partial.runChunk(chunk, nullptr, nullptr));
+		}
+		bool written = partial.writeCheckpoint(done, partialStats);
+		BatchRunner resumed(1, 22, CONTROLLER_SIMPLE);
+		resumed.setChunkSize(4);
+		resumed.setPinning(false);
+		resumed.setCheckpoint(path, 0.0);
+		BatchRunner again(1, 22, CONTROLLER_SIMPLE);
+		again.setChunkSize(4);
+		again.setCheckpoint(path);
+		BatchRunner scratch(1, 22, CONTROLLER_SIMPLE);
+		scratch.setChunkSize(4);
+		MissionStats sharded;
+
+		// exercise
+		bool complete = resumed.runSharded(2, sharded);
+		MissionStats local = again.runLocal();
+
+		// verify
+		MissionStats expected = scratch.runLocal();
+		assertUnit(written && complete);
+		assertUnit(partial.numChunks() == 6);
+		assertUnit(resumed.getResumed() == 14);
+		assertUnit(sharded == expected);
+		assertUnit(again.getResumed() == 22);
+		assertUnit(local == expected);
+		assertUnit(scratch.getResumed() == 0);
+		assertUnit(access((path + ".tmp").c_str(), F_OK) != 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    CHECKPOINT OTHER RUN IGNORED
+	 * input:   a finished free fall checkpoint
+	 *          under a simple autopilot run; that
+	 *          one's checkpoint cut short
+	 * output:  neither resumed, both run in full
+	 *********************************************/
+	void checkpoint_otherRunIgnored()
+	{  // setup
+		std::string path = directory + "/other";
+		BatchRunner freeFall(1, 12, CONTROLLER_NONE);
+		freeFall.setChunkSize(4);
+		freeFall.setCheckpoint(path);
+		freeFall.runLocal();
+		BatchRunner simple(1, 12, CONTROLLER_SIMPLE);
+		simple.setChunkSize(4);
+		simple.setCheckpoint(path);
+		BatchRunner cut(1, 12, CONTROLLER_SIMPLE);
+		cut.setChunkSize(4);
+		cut.setCheckpoint(path);
+
+		// exercise
+		MissionStats other = simple.runLocal();
+		bool truncated = truncate(path.c_str(), sizeof(BatchCheckpointHeader) + 4) == 0;
+		MissionStats shortened = cut.runLocal();
+
+		// verify
+		assertUnit(truncated);
+		assertUnit(simple.getResumed() == 0);
+		assertUnit(other.missions == 12 && other.landed == 12);
+		assertUnit(cut.getResumed() == 0);
+		assertUnit(shortened == other);
+	}  // teardown
+};
@@ -0,0 +1,77 @@
+/***********************************************************************
+ * Header File:
+ *    TEST CONVERGENCE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for the CONVERGENCE study
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "convergence.h"
+#include "controller.h"
+
+/*******************************
+ * TEST CONVERGENCE
+ * A friend class for ConvergenceStudy which contains its unit tests
+ ********************************/
+class TestConvergence : public UnitTest
+{
+public:
+	void run()
+	{
+		run_rows();
+		run_noController();
+
+		report("Convergence");
+	}
+
+private:
+	/*********************************************
+	 * name:    RUN ROWS
+	 * input:   40 missions, 3 replicates, guidance
+	 *          on two threads
+	 * output:  rows for 1 to 32 missions; every
+	 *          landing, so no error in the rate but
+	 *          some in the fuel
+	 *********************************************/
+	void run_rows()
+	{  // setup
+		ConvergenceStudy study(CONTROLLER_GUIDANCE, 40, 3);
+
+		// exercise
+		bool ran = study.run(2);
+
+		// verify
+		assertUnit(ran);
+		assertUnit(study.getMissions() == 32);
+		assertUnit(study.getRows().size() == 6);
+		const ConvergenceRow& last = study.getRows().back();
+		assertUnit(last.missions == 32);
+		assertEquals(last.mean[SAMPLING_SOBOL][METRIC_LANDED], 1.0);
+		assertEquals(last.error[SAMPLING_RANDOM][METRIC_LANDED], 0.0);
+		assertEquals(last.gain(METRIC_LANDED), 0.0);
+		assertUnit(last.error[SAMPLING_RANDOM][METRIC_FUEL] > 0.0);
+		assertUnit(last.mean[SAMPLING_SOBOL][METRIC_FUEL] > 0.0);
+		assertUnit(study.order(SAMPLING_RANDOM, METRIC_FUEL) > 0.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN NO CONTROLLER
+	 * input:   a controller number nobody has
+	 * output:  refused, no rows
+	 *********************************************/
+	void run_noController()
+	{  // setup
+		ConvergenceStudy study(99, 8, 2);
+
+		// exercise
+		bool ran = study.run(1);
+
+		// verify
+		assertUnit(!ran);
+		assertUnit(study.getRows().empty());
+	}  // teardown
+};
@@ -0,0 +1,171 @@
+/***********************************************************************
+ * Header File:
+ *    TEST DEBRIS
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for DEBRIS
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "debris.h"
+#include "ground.h"
+#include <cmath>
+
+/*******************************
+ * TEST DEBRIS
+ * A friend class for DebrisPool which contains the DebrisPool unit tests
+ ********************************/
+class TestDebris : public UnitTest
+{
+public:
+	void run()
+	{
+		// spawn
+		spawn_oneFragmentPerLine();
+		spawn_fullPoolReusesOldest();
+		spawn_keepsMomentum();
+
+		// flight
+		move_restingStaysPut();
+		collide_bouncesThenRests();
+
+		report("Debris");
+	}
+
+private:
+	/*********************************************
+	 * name:    SPAWN ONE FRAGMENT PER LINE
+	 * input:   an upright lander at (100, 200), at rest
+	 * output:  40 fragments, the legs near the feet, no new storage
+	 *********************************************/
+	void spawn_oneFragmentPerLine()
+	{  // setup
+		DebrisPool pool(100);
+		const double* storage = pool.x.data();
+
+		// exercise
+		int n = pool.spawn(Position(100.0, 200.0), 0.0, Velocity());
+
+		// verify
+		assertUnit(n == 40);
+		assertUnit(n == DebrisPool::fragmentsPerCrash());
+		assertUnit(pool.size() == 40);
+		assertUnit(pool.numMoving() == 40);
+		assertUnit(pool.x.data() == storage);
+		assertUnit(pool.x.size() == 100);
+		assertEquals(pool.x[0], 92.0);      // (-10,0) to (-6,0)
+		assertEquals(pool.y[0], 200.0);
+		assertEquals(pool.half[0], 2.0);
+		assertEquals(pool.angle[0], 0.0);
+		assertUnit(pool.color[13] == 1);    // gold engine unit
+	}  // teardown
+
+	/*********************************************
+	 * name:    SPAWN FULL POOL REUSES OLDEST
+	 * input:   pool of 50, two crashes
+	 * output:  50 fragments, the second crash wrapped to the front
+	 *********************************************/
+	void spawn_fullPoolReusesOldest()
+	{  // setup
+		DebrisPool pool(50);
+		pool.spawn(Position(100.0, 200.0), 0.0, Velocity());
+
+		// exercise
+		pool.spawn(Position(500.0, 200.0), 0.0, Velocity());
+
+		// verify
+		assertUnit(pool.size() == 50);
+		assertUnit(pool.next == 30);
+		assertEquals(pool.x[40], 492.0);   // second crash, first fragment
+		assertUnit(pool.x[29] > 450.0);    // second crash, wrapped over the first
+		assertUnit(pool.x[30] < 150.0);    // first crash, still there
+		pool.clear();
+		assertUnit(pool.size() == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SPAWN KEEPS MOMENTUM
+	 * input:   lander moving right at 40 m/s
+	 * output:  the fragments on average move right
+	 *********************************************/
+	void spawn_keepsMomentum()
+	{  // setup
+		DebrisPool pool(100);
+
+		// exercise
+		pool.spawn(Position(100.0, 200.0), 0.0, Velocity(40.0, 0.0));
+
+		// verify
+		double sum = 0.0;
+		for (int i = 0; i < pool.size(); i++)
+			sum += pool.dx[i];
+		assertUnit(sum / pool.size() > 10.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    MOVE RESTING STAYS PUT
+	 * input:   one fragment at rest, one in flight, one 0.1s frame
+	 * output:  the resting one has not moved, the other fell
+	 *********************************************/
+	void move_restingStaysPut()
+	{  // setup
+		DebrisPool pool(100);
+		pool.spawn(Position(100.0, 200.0), 0.0, Velocity());
+		pool.awake[0] = 0.0;
+		pool.dx[0] = pool.dy[0] = pool.spin[0] = 0.0;
+		pool.dx[1] = pool.dy[1] = 0.0;
+		double x0 = pool.x[0];
+		double y0 = pool.y[0];
+		double y1 = pool.y[1];
+
+		// exercise
+		pool.move(-1.625, 0.1);
+
+		// verify
+		assertEquals(pool.x[0], x0);
+		assertEquals(pool.y[0], y0);
+		assertEquals(pool.y[1], y1 - 0.5 * 1.625 * 0.01);
+		assertEquals(pool.dy[1], -0.1625);
+	}  // teardown
+
+	/*********************************************
+	 * name:    COLLIDE BOUNCES THEN RESTS
+	 * input:   a crash just above the ground, 60 seconds of frames
+	 * output:  a fragment hitting at -10 m/s leaves at 3.5 m/s;
+	 *          everything ends at rest, none under the ground
+	 *********************************************/
+	void collide_bouncesThenRests()
+	{  // setup
+		Ground ground(Position(800.0, 600.0));
+		DebrisPool pool(100);
+		double elevation = ground.getElevationMeters(Position(400.0, 0.0));
+		pool.spawn(Position(400.0, elevation + 1.0), 0.0, Velocity(0.0, -20.0));
+		pool.y[0] = elevation - 0.1;
+		pool.dy[0] = -10.0;
+		pool.dx[0] = 5.0;
+
+		// exercise
+		pool.collide(ground);
+		double bounce = pool.dy[0];
+		double slide = pool.dx[0];
+		for (int frame = 0; frame < 600; frame++)
+		{
+			pool.move(-1.625, 0.1);
+			pool.collide(ground);
+		}
+
+		// verify
+		assertEquals(bounce, 3.5);
+		assertEquals(slide, 3.0);
+		assertUnit(pool.numMoving() == 0);
+		for (int i = 0; i < pool.size(); i++)
+		{
+			double under = ground.getElevationMeters(Position(pool.x[i], 0.0));
+			assertUnit(pool.y[i] + 0.001 >= under);
+			assertEquals(pool.dy[i], 0.0);
+		}
+	}  // teardown
+};
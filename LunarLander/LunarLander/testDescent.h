@@ -0,0 +1,206 @@
+/***********************************************************************
+ * Header File:
+ *    TEST DESCENT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for DESCENT
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "descent.h"
+#include "thrust.h"
+#include <cmath>
+
+/*******************************
+ * TEST DESCENT
+ * A friend class for Descent which contains the Descent unit tests
+ ********************************/
+class TestDescent : public UnitTest
+{
+public:
+	void run()
+	{
+		// orbit
+		construct_circularOrbit();
+		coast_wholeOrbit();
+		coast_matchesFrames();
+
+		// handoff and touchdown
+		step_handoffKeepsState();
+		step_touchdownOnPad();
+		step_touchdownAfterTurns();
+
+		// autopilot
+		autopilot_landsFromOrbit();
+
+		report("Descent");
+	}
+
+private:
+	/*********************************************
+	 * name:    CONSTRUCT CIRCULAR ORBIT
+	 * input:   seed 1
+	 * output:  15 km up, 1673 m/s prograde, pad 800-1100 km on
+	 *********************************************/
+	void construct_circularOrbit()
+	{  // setup
+		// exercise
+		Descent d(1);
+
+		// verify
+		assertEquals(d.getHeight(), DESCENT_ORBIT_ALTITUDE);
+		assertUnit(fabs(d.getHorizontalSpeed() - 1673.0) < 1.0);
+		assertEquals(d.getVerticalSpeed(), 0.0);
+		assertUnit(d.getPhase() == DESCENT_ORBIT);
+		assertUnit(d.getTerrain().getPadX() >= 800000.0 &&
+		           d.getTerrain().getPadX() < 1100000.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    COAST WHOLE ORBIT
+	 * input:   one orbital period with the engine off
+	 * output:  back where it started, in a few hundred steps
+	 *********************************************/
+	void coast_wholeOrbit()
+	{  // setup
+		Descent d(1);
+		double r = MOON_RADIUS + DESCENT_ORBIT_ALTITUDE;
+		double period = 2.0 * M_PI * sqrt(r * r * r / MOON_MU);
+
+		// exercise
+		double flown = d.coast(period, 0.0);
+
+		// verify
+		assertEquals(flown, period);
+		assertUnit(fabs(d.px) < 5.0 && fabs(d.py - r) < 5.0);
+		assertUnit(fabs(d.getDownrange() - 2.0 * M_PI * MOON_RADIUS) < 5.0);
+		assertUnit(d.getCoastSteps() < 500);
+		assertUnit(d.getFrames() == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    COAST MATCHES FRAMES
+	 * input:   60 s in one coast and 600 frames without thrust
+	 * output:  the same place to the centimeter
+	 *********************************************/
+	void coast_matchesFrames()
+	{  // setup
+		Descent big(3);
+		Descent small(3);
+
+		// exercise
+		big.coast(60.0, 0.0);
+		for (int i = 0; i < 600; i++)
+			small.step(0);
+
+		// verify
+		assertUnit(fabs(big.px - small.px) < 0.01 && fabs(big.py - small.py) < 0.01);
+		assertUnit(fabs(big.getHorizontalSpeed() - small.getHorizontalSpeed()) < 0.001);
+		assertUnit(small.getFrames() == 600);
+	}  // teardown
+
+	/*********************************************
+	 * name:    STEP HANDOFF KEEPS STATE
+	 * input:   2 km up, 50 m/s across, over downrange 10 km
+	 * output:  flat from the next frame on, nothing jumps
+	 *********************************************/
+	void step_handoffKeepsState()
+	{  // setup
+		Descent d(4);
+		double theta = 10000.0 / MOON_RADIUS;
+		double r = MOON_RADIUS + d.getTerrain().getElevation(10000.0) + 2000.0;
+		d.px = r * sin(theta);
+		d.py = r * cos(theta);
+		d.vx = 50.0 * cos(theta);
+		d.vy = -50.0 * sin(theta);
+		d.trackAngle = theta;
+		double height = d.getHeight();
+
+		// exercise
+		d.step(0);
+
+		// verify
+		assertUnit(d.getPhase() == DESCENT_FLAT);
+		assertUnit(fabs(d.getDownrange() - 10005.0) < 0.1);
+		assertUnit(fabs(d.getHeight() - height) < 0.1);
+		assertUnit(fabs(d.getHorizontalSpeed() - 50.0) < 0.1);
+		assertUnit(fabs(d.getVerticalSpeed() + 0.1625) < 0.01);
+	}  // teardown
+
+	/*********************************************
+	 * name:    STEP TOUCHDOWN ON PAD
+	 * input:   flat, 0.1 m over the pad, 1 m/s down
+	 * output:  landed
+	 *********************************************/
+	void step_touchdownOnPad()
+	{  // setup
+		Descent d(6);
+		TerrainStream& t = d.getTerrain();
+		d.phase = DESCENT_FLAT;
+		d.x = t.getPadX();
+		d.y = t.getPadElevation() + 0.1;
+		d.dx = 0.0;
+		d.dy = -1.0;
+
+		// exercise
+		d.step(0);
+
+		// verify
+		assertUnit(d.isLanded());
+		assertUnit(d.getTouchdownSpeed() < 4.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    STEP TOUCHDOWN AFTER TURNS
+	 * input:   as on the pad, but turned a whole
+	 *          turn back and a bit; then two whole
+	 *          turns on and tilted 0.3
+	 * output:  landed; crashed
+	 *********************************************/
+	void step_touchdownAfterTurns()
+	{  // setup
+		Descent upright(6);
+		Descent tilted(6);
+		for (Descent* d : { &upright, &tilted })
+		{
+			d->phase = DESCENT_FLAT;
+			d->x = d->getTerrain().getPadX();
+			d->y = d->getTerrain().getPadElevation() + 0.1;
+			d->dx = 0.0;
+			d->dy = -1.0;
+		}
+		upright.angle = -2.0 * M_PI + 0.05;
+		tilted.angle = 4.0 * M_PI + 0.3;
+
+		// exercise
+		upright.step(0);
+		tilted.step(0);
+
+		// verify
+		assertUnit(upright.isLanded());
+		assertUnit(tilted.getStatus() == DEAD);
+	}  // teardown
+
+	/*********************************************
+	 * name:    AUTOPILOT LANDS FROM ORBIT
+	 * input:   seed 7, the descent autopilot
+	 * output:  on the pad with fuel to spare, mostly coasting up high
+	 *********************************************/
+	void autopilot_landsFromOrbit()
+	{  // setup
+		Descent d(7);
+		DescentAutopilot autopilot;
+
+		// exercise
+		autopilot.fly(d, 50000);
+
+		// verify
+		assertUnit(d.isLanded());
+		assertUnit(fabs(d.getDownrange() - d.getTerrain().getPadX()) < 5.0);
+		assertUnit(d.getFuel() > 0.0);
+		assertUnit(d.getTime() > d.getFrames() * 0.1 + 60.0);
+	}  // teardown
+};
@@ -0,0 +1,151 @@
+/***********************************************************************
+ * Header File:
+ *    TEST FAST MATH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for FAST MATH
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "fastMath.h"
+#include <cmath>
+#include <vector>
+#include <algorithm>  // for std::max
+
+/*******************************
+ * TEST FAST MATH
+ * The kernels against libm, one value at a time and whole arrays
+ ********************************/
+class TestFastMath : public UnitTest
+{
+public:
+	void run()
+	{
+		// scalar
+		sincos_denseErrorBound();
+		sincos_quadrantBoundaries();
+		sincos_largeArgument();
+
+		// array
+		array_matchesScalar();
+		array_oddLengthAndFallback();
+
+		report("FastMath");
+	}
+
+private:
+	/*********************************************
+	 * name:    SINCOS DENSE ERROR BOUND
+	 * input:   2,000,001 points over [-1000, 1000]
+	 * output:  every sin and cos within FAST_TRIG_MAX_ERROR of libm
+	 *********************************************/
+	void sincos_denseErrorBound()
+	{  // setup
+		double worst = 0.0;
+
+		// exercise
+		for (int i = -1000000; i <= 1000000; i++)
+		{
+			double x = i * 0.001 + 0.0001234;
+			double s, c;
+			fastSincos(x, s, c);
+			worst = std::max(worst, std::max(fabs(s - sin(x)), fabs(c - cos(x))));
+		}
+
+		// verify
+		assertUnit(worst <= FAST_TRIG_MAX_ERROR);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SINCOS QUADRANT BOUNDARIES
+	 * input:   k PI/4 for k = -16..16, and one ulp either side
+	 * output:  within FAST_TRIG_MAX_ERROR of libm
+	 *********************************************/
+	void sincos_quadrantBoundaries()
+	{  // setup
+		bool ok = true;
+
+		// exercise
+		for (int k = -16; k <= 16; k++)
+		{
+			double center = k * M_PI / 4.0;
+			double xs[3] = { nextafter(center, -1e9), center, nextafter(center, 1e9) };
+			for (double x : xs)
+			{
+				double s, c;
+				fastSincos(x, s, c);
+				if (fabs(s - sin(x)) > FAST_TRIG_MAX_ERROR ||
+				    fabs(c - cos(x)) > FAST_TRIG_MAX_ERROR)
+					ok = false;
+			}
+		}
+
+		// verify
+		assertUnit(ok);
+		assertEquals(fastSin(0.0), 0.0);
+		assertEquals(fastCos(0.0), 1.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SINCOS LARGE ARGUMENT
+	 * input:   1e7, -3e9 and NaN
+	 * output:  exactly what libm says
+	 *********************************************/
+	void sincos_largeArgument()
+	{  // setup
+		double xs[2] = { 1.0e7, -3.0e9 };
+
+		// exercise and verify
+		for (double x : xs)
+		{
+			assertUnit(fastSin(x) == sin(x));
+			assertUnit(fastCos(x) == cos(x));
+		}
+		assertUnit(std::isnan(fastSin(NAN)));
+	}  // teardown
+
+	/*********************************************
+	 * name:    ARRAY MATCHES SCALAR
+	 * input:   4096 angles spread over [-50, 50]
+	 * output:  the array kernel agrees with the scalar one
+	 *********************************************/
+	void array_matchesScalar()
+	{  // setup
+		const int n = 4096;
+		std::vector<double> x(n), s(n), c(n);
+		for (int i = 0; i < n; i++)
+			x[i] = (i - n / 2) * 0.0244140625 + 0.001;
+
+		// exercise
+		fastSincosArray(x.data(), s.data(), c.data(), n);
+
+		// verify
+		double worst = 0.0;
+		for (int i = 0; i < n; i++)
+			worst = std::max(worst, std::max(fabs(s[i] - fastSin(x[i])),
+			                                 fabs(c[i] - fastCos(x[i]))));
+		assertUnit(worst <= FAST_TRIG_MAX_ERROR);
+	}  // teardown
+
+	/*********************************************
+	 * name:    ARRAY ODD LENGTH AND FALLBACK
+	 * input:   7 values, one of them 1e8
+	 * output:  every value filled in, the big one from libm
+	 *********************************************/
+	void array_oddLengthAndFallback()
+	{  // setup
+		double x[7] = { 0.1, 1.0e8, -2.0, 3.0, 4.0, -5.0, 6.0 };
+		double s[7] = { 9, 9, 9, 9, 9, 9, 9 };
+
+		// exercise
+		fastSinArray(x, s, 7);
+
+		// verify
+		assertUnit(s[1] == sin(1.0e8));
+		for (int i = 0; i < 7; i++)
+			assertUnit(fabs(s[i] - sin(x[i])) <= FAST_TRIG_MAX_ERROR);
+	}  // teardown
+};
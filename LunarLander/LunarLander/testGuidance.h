@@ -0,0 +1,209 @@
+/***********************************************************************
+ * Header File:
+ *    TEST GUIDANCE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for the GUIDANCE autopilot
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "guidance.h"
+#include "mission.h"
+#include "thrust.h"
+#include "world.h"
+#include <cmath>
+#include <cstdlib>   // for srand
+
+/*******************************
+ * TEST GUIDANCE
+ * A friend class for GuidanceAutopilot which contains its unit tests
+ ********************************/
+class TestGuidance : public UnitTest
+{
+public:
+	void run()
+	{
+		// the law
+		timeToGo_closedForm();
+		acceleration_reachesTarget();
+
+		// flying it
+		pulse_dutyOverPeriod();
+		guide_descendsOverPad();
+		mission_lands();
+
+		report("Guidance");
+	}
+
+private:
+	/*********************************************
+	 * name:    TIME TO GO CLOSED FORM
+	 * input:   100 m away at rest, limit 0.8 m/s^2;
+	 *          already there
+	 * output:  the T that asks for exactly 0.8;
+	 *          the shortest time
+	 *********************************************/
+	void timeToGo_closedForm()
+	{  // setup
+		double far;
+		double there;
+
+		// exercise
+		far = GuidanceAutopilot::timeToGo(0.0, 0.0, 100.0, 0.0, 0.0, -0.8, 0.8);
+		there = GuidanceAutopilot::timeToGo(5.0, 0.0, 5.0, 0.0, 0.0, -0.8, 0.8);
+
+		// verify
+		assertUnit(fabs(far - sqrt(1500.0)) < 1e-9);
+		assertUnit(fabs(GuidanceAutopilot::acceleration(0.0, 0.0, 100.0, 0.0, 0.0, far) - 0.8) < 1e-9);
+		assertUnit(there == GUIDANCE_MIN_TIME);
+	}  // teardown
+
+	/*********************************************
+	 * name:    ACCELERATION REACHES TARGET
+	 * input:   from 0 m at 5 m/s, re-solved every
+	 *          millisecond with T counting down
+	 * output:  at 50 m going -1 m/s when T runs out
+	 *********************************************/
+	void acceleration_reachesTarget()
+	{  // setup
+		double r = 0.0;
+		double v = 5.0;
+		const double dt = 0.001;
+
+		// exercise
+		for (double t = 20.0; t > 0.01; t -= dt)
+		{
+			double a = GuidanceAutopilot::acceleration(r, v, 50.0, -1.0, 0.0, t);
+			r += v * dt + 0.5 * a * dt * dt;
+			v += a * dt;
+		}
+
+		// verify
+		assertUnit(fabs(r - 50.0) < 0.05);
+		assertUnit(fabs(v + 1.0) < 0.05);
+	}  // teardown
+
+	/*********************************************
+	 * name:    PULSE DUTY OVER PERIOD
+	 * input:   upright, throttle 0, 0.6 and 1 for a
+	 *          period; tilted 0.3 off the command
+	 * output:  0, 3 and 5 burns; turns back
+	 *********************************************/
+	void pulse_dutyOverPeriod()
+	{  // setup
+		Lander lander(Position(800.0, 600.0));
+		lander.angle.setRadians(0.0);
+		GuidanceCommand command = { 0.0, 0.0, 10.0, 0.0, 0.0 };
+		int burns[3] = { 0, 0, 0 };
+		const double throttles[3] = { 0.0, 0.6, 1.0 };
+		bool straight = true;
+
+		// exercise
+		for (int i = 0; i < 3; i++)
+		{
+			command.throttle = throttles[i];
+			for (uint32_t frame = 0; frame < GUIDANCE_PWM_FRAMES; frame++)
+			{
+				unsigned char bits = GuidanceAutopilot::pulse(lander, command, frame);
+				burns[i] += (bits & THRUST_BIT_MAIN) ? 1 : 0;
+				straight = straight && (bits & ~THRUST_BIT_MAIN) == 0;
+			}
+		}
+		lander.angle.setRadians(0.3);
+		unsigned char right = GuidanceAutopilot::pulse(lander, command, 0);
+		lander.angle.setRadians(2.0 * M_PI - 0.3);
+		unsigned char left = GuidanceAutopilot::pulse(lander, command, 0);
+
+		// verify
+		assertEquals(burns[0], 0);
+		assertEquals(burns[1], 3);
+		assertEquals(burns[2], 5);
+		assertUnit(straight);
+		assertUnit(right & THRUST_BIT_CLOCK);
+		assertUnit(left & THRUST_BIT_COUNTER);
+	}  // teardown
+
+	/*********************************************
+	 * name:    GUIDE DESCENDS OVER PAD
+	 * input:   still, 50 m over the pad; 300 m to
+	 *          one side, below the gate
+	 * output:  upright and less than hover thrust;
+	 *          climbing and leaning toward the pad
+	 *********************************************/
+	void guide_descendsOverPad()
+	{  // setup
+		srand(5);
+		Ground ground(Position(800.0, 600.0));
+		Position pad = ground.getPlatformPosition();
+		Lander lander(Position(800.0, 600.0));
+		lander.angle.setRadians(0.0);
+		lander.velocity = Velocity(0.0, 0.0);
+		GuidanceCommand over;
+		GuidanceCommand away;
+		bool highest = true;
+		for (int i = 0; i < 800; i++)
+			highest = highest && ground.getElevationMeters(Position(i, 0.0)) <= ground.getHighestElevation();
+
+		// exercise
+		lander.pos = Position(pad.getX(), pad.getY() + 50.0);
+		over = GuidanceAutopilot::guide(lander, ground);
+		double side = pad.getX() < 400.0 ? 300.0 : -300.0;
+		lander.pos = Position(pad.getX() + side, ground.getHighestElevation());
+		away = GuidanceAutopilot::guide(lander, ground);
+
+		// verify
+		assertUnit(highest);
+		assertUnit(fabs(over.angle) < 1e-9);
+		assertUnit(over.ddy < 0.0);
+		assertUnit(over.throttle * Thrust::MAIN_ENGINE.value() < -World::GRAVITY);
+		assertUnit(away.ddy > 0.0);
+		assertUnit(away.ddx * side < 0.0);
+		assertUnit(away.angle * side > 0.0);   // the engine pushes toward -sin(angle)
+		assertUnit(away.throttle > 0.0 && away.throttle <= 1.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    MISSION LANDS
+	 * input:   40 missions one at a time, and a
+	 *          frame of three landers at once
+	 * output:  every one lands; decideAll agrees
+	 *          with decide
+	 *********************************************/
+	void mission_lands()
+	{  // setup
+		std::unique_ptr<Controller> pilot = createController(CONTROLLER_GUIDANCE);
+		int landed = 0;
+		srand(9);
+		Ground ground(Position(800.0, 600.0));
+		Lander a(Position(800.0, 600.0));
+		Lander b(Position(800.0, 600.0));
+		Lander c(Position(800.0, 600.0));
+		b.angle.setRadians(0.4);
+		c.pos = Position(100.0, 300.0);
+		const Lander* landers[3] = { &a, &b, &c };
+		unsigned char all[3];
+		unsigned char one[3];
+
+		// exercise
+		for (uint32_t seed = 300; seed < 340; seed++)
+			landed += runMission(seed, *pilot).outcome == MISSION_LANDED ? 1 : 0;
+		GuidanceAutopilot swarm;
+		swarm.start(1);
+		swarm.decideAll(landers, 3, ground, all);
+		for (int i = 0; i < 3; i++)
+		{
+			GuidanceAutopilot single;
+			single.start(1);
+			one[i] = single.decide(*landers[i], ground);
+		}
+
+		// verify
+		assertUnit(pilot != nullptr);
+		assertEquals(landed, 40);
+		assertUnit(all[0] == one[0] && all[1] == one[1] && all[2] == one[2]);
+		assertUnit(swarm.frame == 1);
+	}  // teardown
+};
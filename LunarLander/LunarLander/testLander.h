@@ -206,7 +206,7 @@ private:
 	void getFuel_empty()
 	{  // setup
 		Lander l(p);
-		l.fuel = 0.0;
+		l.fuel = Kilograms(0.0);
 		int f = 9;
 
 		// exercise
@@ -214,7 +214,7 @@ private:
 
 		// verify
 		assertUnit(f == 0);
-		assertEquals(l.fuel, 0.0);
+		assertEquals(l.fuel.value(), 0.0);
 	}  // teardown
 
 	/*********************************************
@@ -225,7 +225,7 @@ private:
 	void getFuel_some()
 	{  // setup
 		Lander l(p);
-		l.fuel = 555.5;
+		l.fuel = Kilograms(555.5);
 		int f = 9;
 
 		// exercise
@@ -233,7 +233,7 @@ private:
 
 		// verify
 		assertUnit(f == 555);
-		assertEquals(l.fuel, 555.5);
+		assertEquals(l.fuel.value(), 555.5);
 	}  // teardown
 
 	/*********************************************
@@ -590,7 +590,7 @@ private:
 		assertUnit(-10.0 <= l.velocity.dx && l.velocity.dx <= -4.0);
 		assertUnit(-2.0 <= l.velocity.dy && l.velocity.dy <= 2.0);
 		assertUnit(l.status == PLAYING);
-		assertEquals(l.fuel, 5000.0);
+		assertEquals(l.fuel.value(), Lander::FUEL_CAPACITY.value());
 	}  // teardown
 
 	/*********************************************
@@ -621,7 +621,7 @@ private:
 		assertUnit(-10.0 <= l.velocity.dx && l.velocity.dx <= -4.0);
 		assertUnit(-2.0 <= l.velocity.dy && l.velocity.dy <= 2.0);
 		assertUnit(l.status == PLAYING);
-		assertEquals(l.fuel, 5000.0);
+		assertEquals(l.fuel.value(), Lander::FUEL_CAPACITY.value());
 	}  // teardown
 
 	/*****************************************************************
@@ -800,7 +800,7 @@ private:
 		l.velocity.dx = 0.0;
 		l.velocity.dy = 0.0;
 		l.angle.radians = 0.0;
-		l.fuel = 100.0;
+		l.fuel = Kilograms(100.0);
 		Thrust t;
 		t.clockwise = false;
 		t.counterClockwise = false;
@@ -817,7 +817,7 @@ private:
 		assertEquals(a.ddx, 0.0);        // no thrust, no horizontal acceleration
 		assertEquals(a.ddy, -1.0);       // gravity
 		assertUnit(l.status == PLAYING);
-		assertEquals(l.fuel, 100.0);     // no fuel consumed
+		assertEquals(l.fuel.value(), 100.0);     // no fuel consumed
 		assertEquals(l.pos.x, 0.0);      // did not move
 		assertEquals(l.pos.y, 0.0);
 		assertEquals(l.velocity.dx, 0.0);
@@ -842,7 +842,7 @@ private:
 		l.velocity.dx = 0.0;
 		l.velocity.dy = 0.0;
 		l.angle.radians = 0.0;
-		l.fuel = 100.0;
+		l.fuel = Kilograms(100.0);
 		Thrust t;
 		t.clockwise = false;
 		t.counterClockwise = false;
@@ -859,7 +859,7 @@ private:
 		assertEquals(a.ddx, 0.0);              // no horizonal acceleration
 		assertEquals(a.ddy, -1.0 + 2.9795404); // gravity + thrust
 		assertUnit(l.status == PLAYING);
-		assertEquals(l.fuel, 90.0);            // 10 units of fuel
+		assertEquals(l.fuel.value(), 90.0);            // 10 units of fuel
 		assertEquals(l.pos.x, 0.0);            // did not move
 		assertEquals(l.pos.y, 0.0);
 		assertEquals(l.velocity.dx, 0.0);
@@ -885,7 +885,7 @@ private:
 		l.velocity.dx = 0.0;
 		l.velocity.dy = 0.0;
 		l.angle.radians = 4.71239; // 270 degrees to the left
-		l.fuel = 100.0;
+		l.fuel = Kilograms(100.0);
 		Thrust t;
 		t.clockwise = false;
 		t.counterClockwise = false;
@@ -902,7 +902,7 @@ private:
 		assertEquals(a.ddx, 2.9795404);  // thrust
 		assertEquals(a.ddy, -1.0);       // gravity
 		assertUnit(l.status == PLAYING);
-		assertEquals(l.fuel, 90.0);      // 10 units of fuel
+		assertEquals(l.fuel.value(), 90.0);      // 10 units of fuel
 		assertEquals(l.pos.x, 0.0);      // did not move
 		assertEquals(l.pos.y, 0.0);
 		assertEquals(l.velocity.dx, 0.0);
@@ -928,7 +928,7 @@ private:
 		l.velocity.dx = 0.0;
 		l.velocity.dy = 0.0;
 		l.angle.radians = 0.523599; // 30 degrees to the right
-		l.fuel = 100.0;
+		l.fuel = Kilograms(100.0);
 		Thrust t;
 		t.clockwise = false;
 		t.counterClockwise = false;
@@ -945,7 +945,7 @@ private:
 		assertEquals(a.ddx, -1.4897702);           // thrust: - sin(30) * 2.9795404 
 		assertEquals(a.ddy, -1.0 + 2.58035734368); // gravity + cos(30) * 2.9795404
 		assertUnit(l.status == PLAYING);
-		assertEquals(l.fuel, 90.0);                // 10 units of fuel
+		assertEquals(l.fuel.value(), 90.0);                // 10 units of fuel
 		assertEquals(l.pos.x, 0.0);                // did not move
 		assertEquals(l.pos.y, 0.0);
 		assertEquals(l.velocity.dx, 0.0);
@@ -971,7 +971,7 @@ private:
 		l.velocity.dx = 0.0;
 		l.velocity.dy = 0.0;
 		l.angle.radians = 0.0;
-		l.fuel = 100.0;
+		l.fuel = Kilograms(100.0);
 		Thrust t;
 		t.clockwise = true;
 		t.counterClockwise = false;
@@ -988,7 +988,7 @@ private:
 		assertEquals(a.ddx, 0.0);          // no horizontal acceleration
 		assertEquals(a.ddy, -1.0);         // gravity
 		assertUnit(l.status == PLAYING);
-		assertEquals(l.fuel, 99.0);        // small amount of fuel
+		assertEquals(l.fuel.value(), 99.0);        // small amount of fuel
 		assertEquals(l.pos.x, 0.0);        // did not move
 		assertEquals(l.pos.y, 0.0);
 		assertEquals(l.velocity.dx, 0.0);
@@ -1014,7 +1014,7 @@ private:
 		l.velocity.dx = 0.0;
 		l.velocity.dy = 0.0;
 		l.angle.radians = 0.4;
-		l.fuel = 100.0;
+		l.fuel = Kilograms(100.0);
 		Thrust t;
 		t.clockwise = false;
 		t.counterClockwise = true;
@@ -1031,7 +1031,7 @@ private:
 		assertEquals(a.ddx, 0.0);            // no horizontal acceleration
 		assertEquals(a.ddy, -1.0);           // gravity
 		assertUnit(l.status == PLAYING);
-		assertEquals(l.fuel, 99.0);          // small amount of fuel
+		assertEquals(l.fuel.value(), 99.0);          // small amount of fuel
 		assertEquals(l.pos.x, 0.0);          // did not move
 		assertEquals(l.pos.y, 0.0);
 		assertEquals(l.velocity.dx, 0.0);
@@ -1057,7 +1057,7 @@ private:
 		l.velocity.dx = 0.0;
 		l.velocity.dy = 0.0;
 		l.angle.radians = 2.0;
-		l.fuel = 0.0;
+		l.fuel = Kilograms(0.0);
 		Thrust t;
 		t.clockwise = true;
 		t.counterClockwise = true;
@@ -1074,7 +1074,7 @@ private:
 		assertEquals(a.ddx, 0.0);           // no horizontal acceleration
 		assertEquals(a.ddy, -1.0);          // gravity
 		assertUnit(l.status == PLAYING);
-		assertEquals(l.fuel, 0.0);
+		assertEquals(l.fuel.value(), 0.0);
 		assertEquals(l.pos.x, 0.0);
 		assertEquals(l.pos.y, 0.0);
 		assertEquals(l.velocity.dx, 0.0);
@@ -0,0 +1,173 @@
+/***********************************************************************
+ * Header File:
+ *    TEST LANDER API
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for the C interface, through the shared library
+ *    built just as landerApi.h documents
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "landerApi.h"
+#include "world.h"
+#include <dlfcn.h>
+#include <cstdlib>   // for mkdtemp, system
+#include <fstream>
+#include <string>
+
+/*******************************
+ * TEST LANDER API
+ * The unit tests for liblander.so, loaded as another language would
+ ********************************/
+class TestLanderApi : public UnitTest
+{
+public:
+	void run()
+	{
+		char pattern[] = "/tmp/landerApiXXXXXX";
+		if (!mkdtemp(pattern))
+			return;
+		directory = pattern;
+		library = nullptr;
+
+		build_dlopen();
+		batchStep_matchesWorld();
+
+		if (library)
+			dlclose(library);
+		std::string cleanup = "rm -rf " + directory;
+		if (system(cleanup.c_str()) != 0)
+			std::cerr << "could not remove " << directory << "\n";
+
+		report("LanderApi");
+	}
+
+private:
+	std::string directory;
+	void* library;
+
+	/*********************************************
+	 * SOURCES
+	 * Where landerApi.h and the files it lists are
+	 *********************************************/
+	static std::string sources()
+	{
+		std::string file = __FILE__;
+		size_t slash = file.rfind('/');
+		return slash == std::string::npos ? "." : file.substr(0, slash);
+	}
+
+	/*********************************************
+	 * BUILD COMMAND
+	 * The documented command, its continued lines
+	 * joined, writing the library to a directory.
+	 * Empty if landerApi.h has none.
+	 *********************************************/
+	static std::string buildCommand(const std::string& output)
+	{
+		std::ifstream header(sources() + "/landerApi.h");
+		std::string line;
+		std::string command;
+		bool continued = false;
+		while (std::getline(header, line))
+		{
+			size_t start = line.find_first_not_of(" *");
+			if (start == std::string::npos)
+				start = line.size();
+			std::string text = line.substr(start);
+			if (!continued && text.compare(0, 4, "c++ ") != 0)
+				continue;
+			continued = !text.empty() && text.back() == '\\';
+			command += continued ? text.substr(0, text.size() - 1) : text;
+			if (!continued)
+				break;
+		}
+
+		size_t target = command.find("-o liblander.so");
+		if (target == std::string::npos)
+			return "";
+		command.replace(target, 15, "-o " + output);
+		return "cd " + sources() + " && " + command + " -O0";
+	}
+
+	/*********************************************
+	 * name:    BUILD DLOPEN
+	 * input:   the command in landerApi.h
+	 * output:  a library that loads with every
+	 *          symbol resolved, and every entry
+	 *          point found in it
+	 *********************************************/
+	void build_dlopen()
+	{  // setup
+		std::string path = directory + "/liblander.so";
+		std::string command = buildCommand(path);
+
+		// exercise
+		bool built = !command.empty() && system(command.c_str()) == 0;
+		library = built ? dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL) : nullptr;
+
+		// verify
+		assertUnit(!command.empty());
+		assertUnit(built);
+		assertUnit(library != nullptr);
+		if (!library)
+			return;
+		const char* entries[] = { "lander_world_create", "lander_world_destroy",
+		                          "lander_world_reset", "lander_world_size",
+		                          "lander_batch_step", "lander_batch_observe" };
+		bool found = true;
+		for (const char* entry : entries)
+			found = found && dlsym(library, entry) != nullptr;
+		assertUnit(found);
+	}  // teardown
+
+	/*********************************************
+	 * name:    BATCH STEP MATCHES WORLD
+	 * input:   two landers on seed 9 stepped 3
+	 *          frames through the library; then a
+	 *          world with no landers
+	 * output:  the same as a World here; NULL
+	 *********************************************/
+	void batchStep_matchesWorld()
+	{  // setup
+		assertUnit(library != nullptr);
+		if (!library)
+			return;
+		auto create = reinterpret_cast<lander_world* (*)(double, double, int32_t, uint32_t)>(
+			dlsym(library, "lander_world_create"));
+		auto destroy = reinterpret_cast<void (*)(lander_world*)>(
+			dlsym(library, "lander_world_destroy"));
+		auto step = reinterpret_cast<int32_t (*)(lander_world*, const uint8_t*, int32_t)>(
+			dlsym(library, "lander_batch_step"));
+		auto observe = reinterpret_cast<int32_t (*)(const lander_world*, int32_t, int32_t,
+		                                            lander_observation*)>(
+			dlsym(library, "lander_batch_observe"));
+		assertUnit(create && destroy && step && observe);
+		if (!create || !destroy || !step || !observe)
+			return;
+		World local(Position(800.0, 600.0), 2, 9);
+		for (int i = 0; i < 3; i++)
+			local.step(nullptr);
+		lander_observation obs[2];
+
+		// exercise
+		lander_world* world = create(800.0, 600.0, 2, 9);
+		lander_world* empty = create(800.0, 600.0, 0, 9);
+		int32_t flying = step(world, nullptr, 3);
+		int32_t count = observe(world, 0, 2, obs);
+
+		// verify
+		assertUnit(world != nullptr);
+		assertUnit(empty == nullptr);
+		assertUnit(flying == local.numFlying());
+		assertUnit(count == 2);
+		assertEquals(obs[1].y, local.getLander(1).getPosition().getY());
+		assertEquals(obs[0].dx, local.getLander(0).getVelocity().getDX());
+
+		// teardown
+		destroy(world);
+	}
+};
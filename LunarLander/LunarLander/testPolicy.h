@@ -0,0 +1,288 @@
+/***********************************************************************
+ * Header File:
+ *    TEST POLICY
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for POLICY and the policy controller
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "policy.h"
+#include "policyController.h"
+#include "thrust.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>  // for close, unlink, access, rmdir
+
+/*******************************
+ * TEST POLICY
+ * A friend class for Policy which contains the Policy unit tests
+ ********************************/
+class TestPolicy : public UnitTest
+{
+public:
+	void run()
+	{
+		// inference
+		evaluate_matchesReference();
+		decide_signOfLogits();
+
+		// file
+		load_refused();
+		save_roundTrip();
+		save_nothing();
+		randomize_refused();
+
+		// controller
+		controller_decideAllMatchesDecide();
+
+		report("Policy");
+	}
+
+private:
+	/*********************************************
+	 * name:    EVALUATE MATCHES REFERENCE
+	 * input:   8-20-13-3, 45 random states, a short last tile
+	 * output:  the sigmoid of a plain double forward pass
+	 *********************************************/
+	void evaluate_matchesReference()
+	{  // setup
+		Policy policy;
+		policy.randomize({ 20, 13 }, 7);
+		const int count = 45;
+		float states[count * POLICY_NUM_INPUTS];
+		srand(3);
+		for (float& state : states)
+			state = (rand() % 2000 - 1000) / 500.0f;
+		float probabilities[count * POLICY_NUM_OUTPUTS];
+
+		// exercise
+		policy.evaluate(states, count, probabilities);
+
+		// verify
+		assertUnit(policy.numLayers() == 3);
+		assertUnit(policy.numParameters() == 8 * 20 + 20 + 20 * 13 + 13 + 13 * 3 + 3);
+		double worst = 0.0;
+		for (int s = 0; s < count; s++)
+		{
+			std::vector<double> x(states + s * POLICY_NUM_INPUTS,
+			                      states + (s + 1) * POLICY_NUM_INPUTS);
+			for (size_t l = 0; l < policy.layers.size(); l++)
+			{
+				const Policy::Layer& layer = policy.layers[l];
+				std::vector<double> y(layer.out);
+				for (int o = 0; o < layer.out; o++)
+				{
+					y[o] = layer.bias[o];
+					for (int i = 0; i < layer.in; i++)
+						y[o] += x[i] * layer.weights[i * layer.outPad + o];
+					if (l + 1 < policy.layers.size() && y[o] < 0.0)
+						y[o] = 0.0;
+				}
+				x = y;
+			}
+			for (int o = 0; o < POLICY_NUM_OUTPUTS; o++)
+				worst = std::max(worst, fabs(1.0 / (1.0 + exp(-x[o])) -
+				                             probabilities[s * POLICY_NUM_OUTPUTS + o]));
+		}
+		assertUnit(worst < 1e-5);
+	}  // teardown
+
+	/*********************************************
+	 * name:    DECIDE SIGN OF LOGITS
+	 * input:   one layer, main = x, clock = -x, counter = y - 1
+	 * output:  a thruster fires when its logit is positive
+	 *********************************************/
+	void decide_signOfLogits()
+	{  // setup
+		Policy policy;
+		std::vector<float> weights(POLICY_NUM_OUTPUTS * POLICY_NUM_INPUTS, 0.0f);
+		weights[0 * POLICY_NUM_INPUTS + 0] = 1.0f;
+		weights[1 * POLICY_NUM_INPUTS + 0] = -1.0f;
+		weights[2 * POLICY_NUM_INPUTS + 1] = 1.0f;
+		bool set = policy.setLayers({ POLICY_NUM_INPUTS, POLICY_NUM_OUTPUTS },
+		                            { weights }, { { 0.0f, 0.0f, -1.0f } });
+		float states[3 * POLICY_NUM_INPUTS] = {};
+		states[0 * POLICY_NUM_INPUTS + 0] = 0.5f;
+		states[1 * POLICY_NUM_INPUTS + 0] = -0.5f;
+		states[2 * POLICY_NUM_INPUTS + 1] = 2.0f;
+		unsigned char bits[3];
+		Policy empty;
+		unsigned char none = 0xff;
+
+		// exercise
+		policy.decide(states, 3, bits);
+		empty.decide(states, 1, &none);
+
+		// verify
+		assertUnit(set);
+		assertUnit(bits[0] == THRUST_BIT_MAIN);
+		assertUnit(bits[1] == THRUST_BIT_CLOCK);
+		assertUnit(bits[2] == THRUST_BIT_COUNTER);
+		assertUnit(none == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    LOAD REFUSED
+	 * input:   no file, the wrong magic, the wrong number of inputs
+	 * output:  refused with an error, the old layers kept
+	 *********************************************/
+	void load_refused()
+	{  // setup
+		char path[] = "/tmp/policyXXXXXX";
+		int fd = mkstemp(path);
+		if (fd < 0)
+			return;
+		close(fd);
+		Policy policy;
+		policy.randomize({ 4 }, 1);
+		Policy wrongInputs;
+		wrongInputs.randomize({ 4 }, 1);
+		wrongInputs.layers.front().in = POLICY_NUM_INPUTS - 1;
+
+		// exercise
+		bool missing = policy.load("/tmp/no/such/policy");
+		bool missingError = !policy.getError().empty();
+		FILE* file = fopen(path, "wb");
+		fputs("not a policy at all", file);
+		fclose(file);
+		bool badMagic = policy.load(path);
+		bool isPolicy = Policy::isPolicyFile(path);
+		wrongInputs.save(path);
+		bool badInputs = policy.load(path);
+		std::string error = policy.getError();
+		unlink(path);
+
+		// verify
+		assertUnit(!missing);
+		assertUnit(missingError);
+		assertUnit(!badMagic);
+		assertUnit(!isPolicy);
+		assertUnit(!badInputs);
+		assertUnit(error == "a policy takes 8 inputs to 3 outputs, not 7 to 3");
+		assertUnit(policy.numLayers() == 2);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SAVE NOTHING
+	 * input:   a policy never given any layers
+	 * output:  not saved, and no file made
+	 *********************************************/
+	void save_nothing()
+	{  // setup
+		char pattern[] = "/tmp/policyXXXXXX";
+		if (!mkdtemp(pattern))
+			return;
+		std::string path = std::string(pattern) + "/empty";
+		Policy policy;
+
+		// exercise
+		bool saved = policy.save(path);
+		bool made = access(path.c_str(), F_OK) == 0;
+		rmdir(pattern);
+
+		// verify
+		assertUnit(!saved);
+		assertUnit(!made);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RANDOMIZE REFUSED
+	 * input:   8-16-3, then a hidden layer wider
+	 *          than POLICY_MAX_WIDTH, then eight
+	 *          hidden layers, nine in all
+	 * output:  the first made; the others refused
+	 *          with an error, 8-16-3 kept
+	 *********************************************/
+	void randomize_refused()
+	{  // setup
+		Policy policy;
+
+		// exercise
+		bool made = policy.randomize({ 16 }, 3);
+		bool wide = policy.randomize({ POLICY_MAX_WIDTH + 1 }, 3);
+		std::string error = policy.getError();
+		bool deep = policy.randomize(std::vector<int>(POLICY_MAX_LAYERS, 4), 3);
+
+		// verify
+		assertUnit(made);
+		assertUnit(!wide);
+		assertUnit(error == "layer widths run from 1 to 1024");
+		assertUnit(!deep);
+		assertUnit(policy.numLayers() == 2);
+		assertUnit(policy.numParameters() == 8 * 16 + 16 + 16 * 3 + 3);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SAVE ROUND TRIP
+	 * input:   8-16-3 saved and loaded again
+	 * output:  a policy file giving the same probabilities
+	 *********************************************/
+	void save_roundTrip()
+	{  // setup
+		char path[] = "/tmp/policyXXXXXX";
+		int fd = mkstemp(path);
+		if (fd < 0)
+			return;
+		close(fd);
+		Policy original;
+		original.randomize({ 16 }, 9);
+		Policy loaded;
+		float states[5 * POLICY_NUM_INPUTS];
+		for (int i = 0; i < 5 * POLICY_NUM_INPUTS; i++)
+			states[i] = static_cast<float>(i % 7) * 0.3f - 1.0f;
+		float before[5 * POLICY_NUM_OUTPUTS];
+		float after[5 * POLICY_NUM_OUTPUTS];
+
+		// exercise
+		bool saved = original.save(path);
+		bool isPolicy = Policy::isPolicyFile(path);
+		bool read = loaded.load(path);
+		original.evaluate(states, 5, before);
+		loaded.evaluate(states, 5, after);
+		unlink(path);
+
+		// verify
+		assertUnit(saved);
+		assertUnit(isPolicy);
+		assertUnit(read);
+		assertUnit(loaded.numParameters() == original.numParameters());
+		for (int i = 0; i < 5 * POLICY_NUM_OUTPUTS; i++)
+			assertUnit(before[i] == after[i]);
+	}  // teardown
+
+	/*********************************************
+	 * name:    CONTROLLER DECIDE ALL MATCHES DECIDE
+	 * input:   40 landers scattered over the ground
+	 * output:  the same bits as asking one lander at a time
+	 *********************************************/
+	void controller_decideAllMatchesDecide()
+	{  // setup
+		PolicyController pilot;
+		pilot.getPolicy().randomize({ 32, 32 }, 11);
+		Ground ground(Position(800.0, 600.0));
+		const int count = 40;
+		std::vector<Lander> landers(count, Lander(Position(800.0, 600.0)));
+		std::vector<const Lander*> pointers;
+		for (int i = 0; i < count; i++)
+		{
+			landers[i].pos = Position(20.0 * i, 300.0 + 5.0 * i);
+			landers[i].velocity = Velocity(i % 5 - 2.0, -(i % 7));
+			landers[i].angle.setRadians(0.1 * (i % 9) - 0.4);
+			pointers.push_back(&landers[i]);
+		}
+		unsigned char bits[count];
+
+		// exercise
+		pilot.decideAll(pointers.data(), count, ground, bits);
+
+		// verify
+		assertUnit(pilot.getId() == CONTROLLER_POLICY);
+		for (int i = 0; i < count; i++)
+			assertUnit(bits[i] == pilot.decide(landers[i], ground));
+	}  // teardown
+};
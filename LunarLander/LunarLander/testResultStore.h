@@ -0,0 +1,308 @@
+/***********************************************************************
+ * Header File:
+ *    TEST RESULT STORE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for the columnar RESULT STORE
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "resultStore.h"
+#include "batchRunner.h"
+#include "controller.h"
+#include <cmath>
+#include <cstdlib>  // for mkdtemp, system
+#include <string>
+
+/*******************************
+ * TEST RESULT STORE
+ * A friend class for ResultStore which contains the ResultStore unit tests
+ ********************************/
+class TestResultStore : public UnitTest
+{
+public:
+	void run()
+	{
+		char pattern[] = "/tmp/resultStoreXXXXXX";
+		if (!mkdtemp(pattern))
+			return;
+		directory = pattern;
+
+		// parse
+		parseFilter_forms();
+		parseFilter_bad();
+
+		// write and read
+		write_readBack();
+		open_missing();
+
+		// query
+		query_skipsBlocks();
+		query_seedIndex();
+		query_aggregate();
+
+		// batch
+		batch_storesEveryMission();
+		batch_recordsSampling();
+
+		std::string cleanup = "rm -rf " + directory;
+		if (system(cleanup.c_str()) != 0)
+			std::cerr << "could not remove " << directory << "\n";
+
+		report("ResultStore");
+	}
+
+private:
+	std::string directory;
+
+	/*********************************************
+	 * SAMPLE
+	 * Row i: seed 1000 + i, crash every third,
+	 * fuel falls steadily from 2000 kg
+	 *********************************************/
+	static MissionResult sample(uint32_t i)
+	{
+		MissionResult r;
+		r.seed = 1000 + i;
+		r.controller = CONTROLLER_SIMPLE;
+		r.outcome = (i % 3 == 0) ? MISSION_CRASHED : MISSION_LANDED;
+		r.frames = 100 + i % 50;
+		r.touchdownSpeed = (i % 3 == 0) ? 9.0 : 1.5;
+		r.touchdownAngle = 0.01;
+		r.fuel = 2000.0 - i * 0.1;
+		r.padOffset = 0.0;
+		return r;
+	}
+
+	/*********************************************
+	 * WRITE SAMPLES
+	 *********************************************/
+	bool writeSamples(const std::string& path, uint32_t count)
+	{
+		ResultStoreWriter writer;
+		if (!writer.open(path))
+			return false;
+		for (uint32_t i = 0; i < count; i++)
+			writer.append(sample(i));
+		return writer.close();
+	}
+
+	/*********************************************
+	 * name:    PARSE FILTER FORMS
+	 * input:   =, .., >, >=, <
+	 * output:  the matching closed ranges
+	 *********************************************/
+	void parseFilter_forms()
+	{  // setup
+		ResultFilter eq, range, gt, ge, lt;
+
+		// exercise
+		bool ok = ResultStore::parseFilter("outcome=1", eq) &&
+		          ResultStore::parseFilter("seed=5..9", range) &&
+		          ResultStore::parseFilter("fuel>50", gt) &&
+		          ResultStore::parseFilter("fuel>=50", ge) &&
+		          ResultStore::parseFilter("speed<4", lt);
+
+		// verify
+		assertUnit(ok);
+		assertUnit(eq.column == COLUMN_OUTCOME && eq.low == 1.0 && eq.high == 1.0);
+		assertUnit(range.column == COLUMN_SEED && range.low == 5.0 && range.high == 9.0);
+		assertUnit(gt.low > 50.0 && gt.low < 50.0001 && gt.high == HUGE_VAL);
+		assertUnit(ge.low == 50.0);
+		assertUnit(lt.column == COLUMN_SPEED && lt.high < 4.0 && lt.low == -HUGE_VAL);
+	}  // teardown
+
+	/*********************************************
+	 * name:    PARSE FILTER BAD
+	 * input:   unknown column, no operator, junk number
+	 * output:  all rejected
+	 *********************************************/
+	void parseFilter_bad()
+	{  // setup
+		ResultFilter f;
+
+		// exercise and verify
+		assertUnit(!ResultStore::parseFilter("height>3", f));
+		assertUnit(!ResultStore::parseFilter("fuel", f));
+		assertUnit(!ResultStore::parseFilter("fuel>lots", f));
+		assertUnit(!ResultStore::parseFilter("seed=1..", f));
+	}  // teardown
+
+	/*********************************************
+	 * name:    WRITE READ BACK
+	 * input:   10000 rows (three blocks, the last partial)
+	 * output:  every column reads back as written, the
+	 *          missions seeded
+	 *********************************************/
+	void write_readBack()
+	{  // setup
+		std::string path = directory + "/readBack";
+		bool written = writeSamples(path, 10000);
+		ResultStore store;
+
+		// exercise
+		bool opened = store.open(path);
+
+		// verify
+		assertUnit(written);
+		assertUnit(opened);
+		assertUnit(store.getRows() == 10000);
+		assertUnit(store.getBlocks() == 3);
+		assertUnit(store.getSampling() == SAMPLING_RANDOM);
+		assertUnit(store.getScramble() == 0);
+		assertEquals(store.value(COLUMN_SEED, 9999), 10999.0);
+		assertEquals(store.value(COLUMN_OUTCOME, 9999), static_cast<double>(MISSION_CRASHED));
+		assertEquals(store.value(COLUMN_FUEL, 4097), 2000.0 - 409.7);
+		assertEquals(store.ranges[2 * NUM_RESULT_COLUMNS + COLUMN_SEED].min, 1000.0 + 8192);
+	}  // teardown
+
+	/*********************************************
+	 * name:    OPEN MISSING
+	 * input:   a directory with no store
+	 * output:  false
+	 *********************************************/
+	void open_missing()
+	{  // setup
+		ResultStore store;
+
+		// exercise and verify
+		assertUnit(!store.open(directory + "/nothingHere"));
+		assertUnit(store.getRows() == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    QUERY SKIPS BLOCKS
+	 * input:   fuel > 1500 over 10000 rows
+	 * output:  only the first two blocks are read
+	 *********************************************/
+	void query_skipsBlocks()
+	{  // setup
+		std::string path = directory + "/skip";
+		writeSamples(path, 10000);
+		ResultStore store;
+		store.open(path);
+		ResultFilter filter;
+		ResultStore::parseFilter("fuel>1500", filter);
+
+		// exercise
+		ResultAggregate a = store.query(std::vector<ResultFilter>(1, filter), -1);
+
+		// verify
+		assertUnit(a.count == 5000);   // rows 0 .. 4999
+		assertUnit(a.blocksScanned == 2);
+		assertUnit(a.blocksSkipped == 1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    QUERY SEED INDEX
+	 * input:   crashes with seeds 1000..1099 out of 10000 rows
+	 * output:  34 rows, found without a block scan
+	 *********************************************/
+	void query_seedIndex()
+	{  // setup
+		std::string path = directory + "/seeds";
+		writeSamples(path, 10000);
+		ResultStore store;
+		store.open(path);
+		std::vector<ResultFilter> filters(2);
+		ResultStore::parseFilter("seed=1000..1099", filters[0]);
+		ResultStore::parseFilter("outcome=1", filters[1]);
+
+		// exercise
+		ResultAggregate a = store.query(filters, -1);
+
+		// verify
+		assertUnit(a.count == 34);     // i = 0, 3, ... 99
+		assertUnit(a.blocksScanned == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    QUERY AGGREGATE
+	 * input:   mean speed of crashes, max frames of landings
+	 * output:  9.0, frames from 100 to 149
+	 *********************************************/
+	void query_aggregate()
+	{  // setup
+		std::string path = directory + "/aggregate";
+		writeSamples(path, 5000);
+		ResultStore store;
+		store.open(path);
+		ResultFilter crashed, landed;
+		ResultStore::parseFilter("outcome=1", crashed);
+		ResultStore::parseFilter("outcome=0", landed);
+
+		// exercise
+		ResultAggregate speed = store.query(std::vector<ResultFilter>(1, crashed), COLUMN_SPEED);
+		ResultAggregate frames = store.query(std::vector<ResultFilter>(1, landed), COLUMN_FRAMES);
+
+		// verify
+		assertUnit(speed.count == 1667);
+		assertEquals(speed.mean(), 9.0);
+		assertEquals(frames.max, 149.0);
+		assertEquals(frames.min, 100.0);   // i = 50
+	}  // teardown
+
+	/*********************************************
+	 * name:    BATCH STORES EVERY MISSION
+	 * input:   300 missions on 2 workers into a store
+	 * output:  300 rows, one per seed, same landings as the totals
+	 *********************************************/
+	void batch_storesEveryMission()
+	{  // setup
+		std::string path = directory + "/batch";
+		ResultStoreWriter writer;
+		writer.open(path);
+		BatchRunner runner(500, 300, CONTROLLER_SIMPLE);
+		runner.setChunkSize(64);
+		runner.setPinning(false);
+		runner.setResultStore(&writer);
+		MissionStats stats;
+
+		// exercise
+		bool complete = runner.runSharded(2, stats);
+		bool closed = writer.close();
+
+		// verify
+		ResultStore store;
+		assertUnit(complete && closed);
+		assertUnit(store.open(path));
+		assertUnit(store.getRows() == 300);
+		ResultFilter landed;
+		ResultStore::parseFilter("outcome=0", landed);
+		assertUnit(store.query(std::vector<ResultFilter>(1, landed), -1).count == stats.landed);
+		ResultFilter one;
+		ResultStore::parseFilter("seed=650", one);
+		assertUnit(store.query(std::vector<ResultFilter>(1, one), -1).count == 1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    BATCH RECORDS SAMPLING
+	 * input:   8 Sobol missions, scramble 77, into
+	 *          a store
+	 * output:  the store says so
+	 *********************************************/
+	void batch_recordsSampling()
+	{  // setup
+		std::string path = directory + "/sobol";
+		ResultStoreWriter writer;
+		writer.open(path);
+		BatchRunner runner(0, 8, CONTROLLER_NONE);
+		runner.setResultStore(&writer);
+		runner.setSobol(77);
+
+		// exercise
+		runner.runLocal();
+		bool closed = writer.close();
+
+		// verify
+		ResultStore store;
+		assertUnit(closed);
+		assertUnit(store.open(path));
+		assertUnit(store.getRows() == 8);
+		assertUnit(store.getSampling() == SAMPLING_SOBOL);
+		assertUnit(store.getScramble() == 77);
+	}  // teardown
+};
@@ -15,6 +15,32 @@
 #include "testVelocity.h"
 #include "testThrust.h"
 #include "testLander.h"
+#include "testWorld.h"
+#include "testScene.h"
+#include "testArena.h"
+#include "testSimState.h"
+#include "testSimServer.h"
+#include "testSharedControl.h"
+#include "testBatchRunner.h"
+#include "testResultStore.h"
+#include "testSessionLog.h"
+#include "testFastMath.h"
+#include "testSpatialHash.h"
+#include "testTerrainStream.h"
+#include "testDescent.h"
+#include "testDebris.h"
+#include "testSimHooks.h"
+#include "testUnits.h"
+#include "testTournament.h"
+#include "testScript.h"
+#include "testPolicy.h"
+#include "testTrajectoryArchive.h"
+#include "testGuidance.h"
+#include "testSobol.h"
+#include "testConvergence.h"
+#include "testSplitting.h"
+#include "testSurrogate.h"
+#include "testLanderApi.h"
 
 #include <iostream>
 
@@ -34,6 +60,32 @@ void testRunner()
    TestVelocity().run();
    TestThrust().run();
    TestLander().run();
+   TestWorld().run();
+   TestScene().run();
+   TestArena().run();
+   TestSimState().run();
+   TestSimServer().run();
+   TestSharedControl().run();
+   TestBatchRunner().run();
+   TestResultStore().run();
+   TestSessionLog().run();
+   TestFastMath().run();
+   TestSpatialHash().run();
+   TestTerrainStream().run();
+   TestDescent().run();
+   TestDebris().run();
+   TestSimHooks().run();
+   TestUnits().run();
+   TestTournament().run();
+   TestScript().run();
+   TestPolicy().run();
+   TestTrajectoryArchive().run();
+   TestGuidance().run();
+   TestSobol().run();
+   TestConvergence().run();
+   TestSplitting().run();
+   TestSurrogate().run();
+   TestLanderApi().run();
 
    std::cout << "\n===================================\n";
    std::cout << " All Unit Tests Complete\n";
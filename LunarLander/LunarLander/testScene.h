@@ -0,0 +1,202 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SCENE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for SCENE
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "scene.h"
+#include "ground.h"
+#include "thrust.h"
+
+/*******************************
+ * TEST SCENE
+ * A friend class for Scene which contains the Scene unit tests
+ ********************************/
+class TestScene : public UnitTest
+{
+public:
+	void run()
+	{
+		// entities
+		create_reusesRow();
+		destroy_landerSwap();
+
+		// systems
+		twinkle_wraps();
+		move_ballistic();
+		fly_sameAsLander();
+		collide_particleAndCrash();
+		expire_removes();
+
+		report("Scene");
+	}
+
+private:
+
+	/*********************************************
+	 * name:    CREATE REUSES ROW
+	 * input:   two stars, destroy the first, add a particle
+	 * output:  the particle takes the free row
+	 *********************************************/
+	void create_reusesRow()
+	{  // setup
+		Scene s;
+		Entity a = s.createStar(Position(1.0, 2.0), 10);
+		Entity b = s.createStar(Position(3.0, 4.0), 20);
+		s.destroy(a);
+
+		// exercise
+		Entity c = s.createParticle(Position(5.0, 6.0), Velocity(), 1.0);
+
+		// verify
+		assertUnit(c == a);
+		assertUnit(s.size() == 2);
+		assertUnit(s.isAlive(b));
+		assertUnit(s.sprite[c] == SPRITE_PARTICLE);
+		assertUnit(!(s.mask[c] & COMPONENT_TWINKLE));
+		assertEquals(s.x[c], 5.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    DESTROY LANDER SWAP
+	 * input:   three landers, destroy the first
+	 * output:  the last one moves into its slot and is still found
+	 *********************************************/
+	void destroy_landerSwap()
+	{  // setup
+		Scene s;
+		Position posUpperRight(800.0, 600.0);
+		Entity a = s.createLander(posUpperRight);
+		s.createLander(posUpperRight);
+		Entity c = s.createLander(posUpperRight);
+		s.getLander(c).fuel = Kilograms(123.0);
+
+		// exercise
+		s.destroy(a);
+
+		// verify
+		assertUnit(s.landers.size() == 2);
+		assertUnit(!s.isAlive(a));
+		assertEquals(s.getLander(c).fuel.value(), 123.0);
+		assertUnit(s.landerIndex[c] == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    TWINKLE WRAPS
+	 * input:   star at phase 255, particle
+	 * output:  star at phase 0, particle untouched
+	 *********************************************/
+	void twinkle_wraps()
+	{  // setup
+		Scene s;
+		Entity star = s.createStar(Position(), 255);
+		Entity speck = s.createParticle(Position(), Velocity(), 1.0);
+
+		// exercise
+		s.twinkle();
+
+		// verify
+		assertUnit(s.phase[star] == 0);
+		assertUnit(s.phase[speck] == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    MOVE BALLISTIC
+	 * input:   particle at (10,100) v=(2,3), star at (10,100)
+	 * output:  particle follows s = s0 + vt + at^2/2, star stays
+	 *********************************************/
+	void move_ballistic()
+	{  // setup
+		Scene s;
+		Entity speck = s.createParticle(Position(10.0, 100.0), Velocity(2.0, 3.0), 1.0);
+		Entity star = s.createStar(Position(10.0, 100.0), 0);
+
+		// exercise
+		s.move(-1.625, 0.1);
+
+		// verify
+		assertEquals(s.x[speck], 10.2);
+		assertEquals(s.y[speck], 100.3 - 0.5 * 1.625 * 0.01);
+		assertEquals(s.dy[speck], 3.0 - 0.1625);
+		assertEquals(s.y[star], 100.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    FLY SAME AS LANDER
+	 * input:   a scene lander and a copy, main engine, one frame
+	 * output:  both end up in the same place
+	 *********************************************/
+	void fly_sameAsLander()
+	{  // setup
+		Scene s;
+		Entity e = s.createLander(Position(800.0, 600.0));
+		Lander copy = s.getLander(e);
+		Thrust thrust;
+		thrust.setBits(THRUST_BIT_MAIN);
+
+		// exercise
+		s.fly(thrust, -1.625, 0.1);
+		copy.coast(copy.input(thrust, -1.625), 0.1);
+
+		// verify
+		assertEquals(s.getLander(e).pos.x, copy.pos.x);
+		assertEquals(s.getLander(e).pos.y, copy.pos.y);
+		assertEquals(s.getLander(e).fuel.value(), copy.fuel.value());
+		assertEquals(s.y[e], copy.pos.y);
+	}  // teardown
+
+	/*********************************************
+	 * name:    COLLIDE PARTICLE AND CRASH
+	 * input:   a particle and a lander falling fast,
+	 *          both below the ground
+	 * output:  the particle is gone; the lander
+	 *          crashed and broke into the debris pool
+	 *********************************************/
+	void collide_particleAndCrash()
+	{  // setup
+		Ground ground(Position(800.0, 600.0));
+		Scene s;
+		Entity speck = s.createParticle(Position(400.0, -10.0), Velocity(0.0, -5.0), 1.0);
+		Entity e = s.createLander(Position(800.0, 600.0));
+		s.getLander(e).pos = Position(400.0, -10.0);
+		s.getLander(e).velocity = Velocity(0.0, -50.0);
+
+		// exercise
+		Touchdowns t = s.collide(ground);
+
+		// verify
+		assertUnit(t.landed == 0 && t.crashed == 1);
+		assertUnit(!s.isAlive(speck));
+		assertUnit(s.getLander(e).isDead());
+		assertUnit(s.getDebris().size() == DebrisPool::fragmentsPerCrash());
+	}  // teardown
+
+	/*********************************************
+	 * name:    EXPIRE REMOVES
+	 * input:   particle with 0.15s to live, star, two 0.1s frames
+	 * output:  particle gone after the second, star still there
+	 *********************************************/
+	void expire_removes()
+	{  // setup
+		Scene s;
+		Entity speck = s.createParticle(Position(), Velocity(), 0.15);
+		Entity star = s.createStar(Position(), 0);
+
+		// exercise
+		s.expire(0.1);
+		bool aliveAfterOne = s.isAlive(speck);
+		s.expire(0.1);
+
+		// verify
+		assertUnit(aliveAfterOne);
+		assertUnit(!s.isAlive(speck));
+		assertUnit(s.isAlive(star));
+		assertUnit(s.size() == 1);
+	}  // teardown
+};
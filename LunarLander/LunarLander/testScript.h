@@ -0,0 +1,276 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SCRIPT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for SCRIPT and the scripted controller
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "script.h"
+#include "scriptController.h"
+#include "mission.h"
+#include "thrust.h"
+#include <cstdlib>
+
+/*******************************
+ * TEST SCRIPT
+ * A friend class for Script which contains the Script unit tests
+ ********************************/
+class TestScript : public UnitTest
+{
+public:
+	void run()
+	{
+		// compiler
+		compile_errors();
+		compile_foldsConstants();
+
+		// interpreter
+		run_precedence();
+		run_inputsToThrust();
+		run_ternaryAndFunctions();
+		run_variablesKeptUntilReset();
+		runBatch_matchesRun();
+
+		// controller
+		controller_freeFallScript();
+
+		report("Script");
+	}
+
+private:
+	/*********************************************
+	 * name:    COMPILE ERRORS
+	 * input:   scripts that should not compile, one
+	 *          10,000 parentheses deep; one 200 deep
+	 * output:  refused with the line, leaving an empty
+	 *          script; the 200 deep compiles
+	 *********************************************/
+	void compile_errors()
+	{  // setup
+		Script script;
+		double inputs[SCRIPT_NUM_INPUTS] = {};
+
+		// exercise
+		bool badFunction = script.compile("main = 1\nclock = tan(x)");
+		std::string error = script.getError();
+		bool setsInput = script.compile("dy = 3");
+		bool neverSet = script.compile("main = speed > limit");
+		bool badSymbol = script.compile("main = x $ 2");
+		bool unclosed = script.compile("main = (x + 2");
+		bool deep = script.compile("v=" + std::string(10000, '('));
+		std::string deepError = script.getError();
+		bool nested = script.compile("v=" + std::string(200, '(') + "1" + std::string(200, ')'));
+		bool good = script.compile("# nothing\n\nmain = 1;clock = 1");
+		bool failed = script.compile("main = 1\ncounter = ");
+		script.run(inputs);
+
+		// verify
+		assertUnit(!badFunction);
+		assertUnit(error == "line 2: no function called tan");
+		assertUnit(!setsInput);
+		assertUnit(!neverSet);
+		assertUnit(script.find("limit") < 0);
+		assertUnit(!badSymbol);
+		assertUnit(!unclosed);
+		assertUnit(!deep);
+		assertUnit(deepError == "line 1: nested too deeply");
+		assertUnit(nested);
+		assertUnit(good);
+		assertUnit(!failed);
+		assertUnit(script.size() == 1);
+		assertUnit(script.getThrust() == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    COMPILE FOLDS CONSTANTS
+	 * input:   v = 2 * (3 + 1) - -1
+	 * output:  one move and the halt
+	 *********************************************/
+	void compile_foldsConstants()
+	{  // setup
+		Script script;
+		double inputs[SCRIPT_NUM_INPUTS] = {};
+
+		// exercise
+		bool compiled = script.compile("v = 2 * (3 + 1) - -1");
+		script.run(inputs);
+
+		// verify
+		assertUnit(compiled);
+		assertUnit(script.size() == 2);
+		assertEquals(script.get(script.find("v")), 9.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN PRECEDENCE
+	 * input:   arithmetic, comparison and logic mixed, x = 2
+	 * output:  the usual precedence, left to right
+	 *********************************************/
+	void run_precedence()
+	{  // setup
+		Script script;
+		script.compile("a = 1 + x * 3 - 8 / x / 2\n"
+		               "b = (1 + x) * 3\n"
+		               "c = x > 1 && x < 3 || 0\n"
+		               "d = !(x == 2) + (x != 2)\n"
+		               "e = 10 - x - 3");
+		double inputs[SCRIPT_NUM_INPUTS] = {};
+		inputs[SCRIPT_X] = 2.0;
+
+		// exercise
+		script.run(inputs);
+
+		// verify
+		assertEquals(script.get(script.find("a")), 5.0);
+		assertEquals(script.get(script.find("b")), 9.0);
+		assertEquals(script.get(script.find("c")), 1.0);
+		assertEquals(script.get(script.find("d")), 0.0);
+		assertEquals(script.get(script.find("e")), 5.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN INPUTS TO THRUST
+	 * input:   falling at 5 m/s, tilted left, a simple hover script
+	 * output:  main and clockwise fire
+	 *********************************************/
+	void run_inputsToThrust()
+	{  // setup
+		Script script;
+		script.compile("main    = dy < -3\n"
+		               "clock   = angle > 0.05\n"
+		               "counter = angle < -0.05");
+		double inputs[SCRIPT_NUM_INPUTS] = {};
+		inputs[SCRIPT_DY] = -5.0;
+		inputs[SCRIPT_ANGLE] = 0.2;
+
+		// exercise
+		script.run(inputs);
+		unsigned char falling = script.getThrust();
+		inputs[SCRIPT_DY] = -1.0;
+		inputs[SCRIPT_ANGLE] = -0.2;
+		script.run(inputs);
+
+		// verify
+		assertUnit(falling == (THRUST_BIT_MAIN | THRUST_BIT_CLOCK));
+		assertUnit(script.getThrust() == THRUST_BIT_COUNTER);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN TERNARY AND FUNCTIONS
+	 * input:   x = 10 and x = -3 through a ternary of functions
+	 * output:  the side the condition picks
+	 *********************************************/
+	void run_ternaryAndFunctions()
+	{  // setup
+		Script script;
+		script.compile("t = x > 0 ? min(x, 5) : abs(x) + sqrt(4)\n"
+		               "u = x > 0 ? 1 : x < -5 ? 2 : 3\n"
+		               "w = max(atan2(1, 1) * 4, cos(0))");
+		double inputs[SCRIPT_NUM_INPUTS] = {};
+
+		// exercise
+		inputs[SCRIPT_X] = 10.0;
+		script.run(inputs);
+		double t1 = script.get(script.find("t"));
+		double u1 = script.get(script.find("u"));
+		inputs[SCRIPT_X] = -3.0;
+		script.run(inputs);
+
+		// verify
+		assertEquals(t1, 5.0);
+		assertEquals(u1, 1.0);
+		assertEquals(script.get(script.find("t")), 5.0);
+		assertEquals(script.get(script.find("u")), 3.0);
+		assertEquals(script.get(script.find("w")), M_PI);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN VARIABLES KEPT UNTIL RESET
+	 * input:   a counter run three times, then reset
+	 * output:  3, then 0
+	 *********************************************/
+	void run_variablesKeptUntilReset()
+	{  // setup
+		Script script;
+		script.compile("count = count + 1; main = count > 2");
+		double inputs[SCRIPT_NUM_INPUTS] = {};
+
+		// exercise
+		script.run(inputs);
+		script.run(inputs);
+		script.run(inputs);
+		double counted = script.get(script.find("count"));
+		unsigned char third = script.getThrust();
+		script.reset();
+
+		// verify
+		assertEquals(counted, 3.0);
+		assertUnit(third == THRUST_BIT_MAIN);
+		assertEquals(script.get(script.find("count")), 0.0);
+		assertUnit(script.getThrust() == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN BATCH MATCHES RUN
+	 * input:   37 landers, a short last block, random inputs
+	 * output:  the same thrust as one at a time from reset
+	 *********************************************/
+	void runBatch_matchesRun()
+	{  // setup
+		Script script;
+		script.compile("tilt    = max(-0.4, min(0.4, ((padX - x) * 0.05 - dx) * 0.15))\n"
+		               "want    = altitude < 15 ? 0 : -tilt\n"
+		               "clock   = angle > want + 0.05\n"
+		               "counter = angle < want - 0.05\n"
+		               "main    = dy < -(1 + altitude * 0.05) && !(fuel == 0)");
+		const int count = 37;
+		double inputs[count * SCRIPT_NUM_INPUTS];
+		srand(5);
+		for (double& input : inputs)
+			input = (rand() % 2000 - 1000) / 100.0;
+		unsigned char batch[count];
+
+		// exercise
+		script.runBatch(inputs, count, batch);
+
+		// verify
+		for (int i = 0; i < count; i++)
+		{
+			script.reset();
+			script.run(inputs + i * SCRIPT_NUM_INPUTS);
+			assertUnit(batch[i] == script.getThrust());
+		}
+	}  // teardown
+
+	/*********************************************
+	 * name:    CONTROLLER FREE FALL SCRIPT
+	 * input:   a script that never fires, and one with an error
+	 * output:  the same mission as free fall, recorded as a script
+	 *********************************************/
+	void controller_freeFallScript()
+	{  // setup
+		ScriptController pilot;
+		ScriptController broken;
+		FreeFall freeFall;
+		bool compiled = pilot.compile("main = 0 && dy < 0");
+		bool brokenCompiled = broken.compile("main = ");
+
+		// exercise
+		MissionResult scripted = runMission(3, pilot);
+		MissionResult baseline = runMission(3, freeFall);
+
+		// verify
+		assertUnit(compiled);
+		assertUnit(!brokenCompiled);
+		assertUnit(!broken.getError().empty());
+		assertUnit(scripted.controller == CONTROLLER_SCRIPT);
+		assertUnit(scripted.outcome == baseline.outcome);
+		assertUnit(scripted.frames == baseline.frames);
+		assertEquals(scripted.fuel, baseline.fuel);
+	}  // teardown
+};
@@ -0,0 +1,218 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SESSION LOG
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for SESSION LOG
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "sessionLog.h"
+#include <cstdlib>   // for mkdtemp, system
+#include <cstdio>    // for fopen
+#include <sys/stat.h>
+
+/*******************************
+ * TEST SESSION LOG
+ * A friend class for SessionLog which contains the SessionLog unit tests
+ ********************************/
+class TestSessionLog : public UnitTest
+{
+public:
+	void run()
+	{
+		char pattern[] = "/tmp/sessionLogXXXXXX";
+		if (!mkdtemp(pattern))
+			return;
+		directory = pattern;
+
+		// record
+		record_pilotStats();
+		record_batchesSyncs();
+
+		// open
+		open_replays();
+		open_dropsTornTail();
+
+		// compact
+		compact_keepsEverything();
+		totals_allPilots();
+
+		std::string cleanup = "rm -rf " + directory;
+		if (system(cleanup.c_str()) != 0)
+			std::cerr << "could not remove " << directory << "\n";
+
+		report("SessionLog");
+	}
+
+private:
+	std::string directory;
+
+	static long fileSize(const std::string& path)
+	{
+		struct stat info;
+		return stat(path.c_str(), &info) == 0 ? static_cast<long>(info.st_size) : -1;
+	}
+
+	/*********************************************
+	 * name:    RECORD PILOT STATS
+	 * input:   crash, land at 3.0, land at 1.5
+	 * output:  3 attempts, 2 landed, softest 1.5, recent 011
+	 *********************************************/
+	void record_pilotStats()
+	{  // setup
+		SessionLog log;
+		log.open(directory + "/stats");
+
+		// exercise
+		log.record("eagle", false, 9.0, 100.0, 1000);
+		log.record("eagle", true, 3.0, 200.0, 1010);
+		log.record("eagle", true, 1.5, 300.0, 1020);
+
+		// verify
+		const PilotStats* p = log.getPilot("eagle");
+		assertUnit(p != nullptr);
+		assertUnit(p->attempts == 3 && p->successes == 2);
+		assertEquals(p->softestLanding, 1.5);
+		assertEquals(p->fuelLeft, 500.0);
+		assertUnit(p->recent == 3u);
+		assertUnit(p->firstAttempt == 1000 && p->lastAttempt == 1020);
+		assertUnit(log.getPilot("falcon") == nullptr);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RECORD BATCHES SYNCS
+	 * input:   sync every 4 records, 3 then 4 records
+	 * output:  nothing on disk after 3, all 4 after the 4th
+	 *********************************************/
+	void record_batchesSyncs()
+	{  // setup
+		SessionLog log;
+		log.open(directory + "/batch");
+		log.setSyncPolicy(4, 1000.0);
+		std::string path = log.logPath(log.generation);
+
+		// exercise
+		for (int i = 0; i < 3; i++)
+			log.record("eagle", true, 1.0, 1.0, i);
+		long afterThree = fileSize(path);
+		log.record("eagle", true, 1.0, 1.0, 3);
+
+		// verify
+		assertUnit(afterThree == 0);
+		assertUnit(fileSize(path) == static_cast<long>(4 * sizeof(AttemptRecord)));
+		assertUnit(log.pending.empty());
+	}  // teardown
+
+	/*********************************************
+	 * name:    OPEN REPLAYS
+	 * input:   two pilots recorded, closed, reopened
+	 * output:  the same stats after reopening
+	 *********************************************/
+	void open_replays()
+	{  // setup
+		std::string path = directory + "/replay";
+		{
+			SessionLog log;
+			log.open(path);
+			log.record("eagle", true, 2.0, 10.0, 5);
+			log.record("falcon", false, 8.0, 0.0, 6);
+		}
+		SessionLog log;
+
+		// exercise
+		bool opened = log.open(path);
+
+		// verify
+		assertUnit(opened);
+		assertUnit(log.getNumPilots() == 2);
+		assertUnit(log.getPilot("eagle")->successes == 1);
+		assertUnit(log.getPilot("falcon")->attempts == 1);
+		assertUnit(log.logRecords == 2);
+	}  // teardown
+
+	/*********************************************
+	 * name:    OPEN DROPS TORN TAIL
+	 * input:   one good record then half a record
+	 * output:  one attempt, the log cut back to one record
+	 *********************************************/
+	void open_dropsTornTail()
+	{  // setup
+		std::string path = directory + "/torn";
+		{
+			SessionLog log;
+			log.open(path);
+			log.record("eagle", true, 2.0, 10.0, 5);
+		}
+		FILE* file = fopen((path + "/attempts.0").c_str(), "ab");
+		char junk[sizeof(AttemptRecord) / 2] = { 1, 2, 3 };
+		fwrite(junk, sizeof(junk), 1, file);
+		fclose(file);
+		SessionLog log;
+
+		// exercise
+		log.open(path);
+
+		// verify
+		assertUnit(log.getPilot("eagle")->attempts == 1);
+		assertUnit(fileSize(path + "/attempts.0") == static_cast<long>(sizeof(AttemptRecord)));
+	}  // teardown
+
+	/*********************************************
+	 * name:    COMPACT KEEPS EVERYTHING
+	 * input:   compact every 5, record 12, reopen
+	 * output:  two compactions, 2 in the log, 12 in total
+	 *********************************************/
+	void compact_keepsEverything()
+	{  // setup
+		std::string path = directory + "/compact";
+		{
+			SessionLog log;
+			log.open(path);
+			log.setCompactThreshold(5);
+
+			// exercise
+			for (int i = 0; i < 12; i++)
+				log.record("eagle", i % 2 == 0, 1.0 + i, 50.0, 100 + i);
+		}
+		SessionLog log;
+		log.open(path);
+
+		// verify
+		assertUnit(log.generation == 2);
+		assertUnit(log.logRecords == 2);
+		assertUnit(fileSize(path + "/attempts.0") == -1);
+		const PilotStats* p = log.getPilot("eagle");
+		assertUnit(p->attempts == 12 && p->successes == 6);
+		assertEquals(p->softestLanding, 1.0);
+		assertUnit(p->lastAttempt == 111);
+	}  // teardown
+
+	/*********************************************
+	 * name:    TOTALS ALL PILOTS
+	 * input:   three pilots
+	 * output:  summed attempts and landings, softest overall
+	 *********************************************/
+	void totals_allPilots()
+	{  // setup
+		SessionLog log;
+		log.open(directory + "/totals");
+		log.record("a", true, 3.0, 10.0, 50);
+		log.record("b", true, 2.0, 20.0, 40);
+		log.record("c", false, 9.0, 0.0, 60);
+		log.record("a-very-long-pilot-name", true, 3.5, 1.0, 70);
+
+		// exercise
+		PilotStats t = log.getTotals();
+
+		// verify
+		assertUnit(t.attempts == 4 && t.successes == 3);
+		assertEquals(t.softestLanding, 2.0);
+		assertEquals(t.fuelLeft, 31.0);
+		assertUnit(t.firstAttempt == 40 && t.lastAttempt == 70);
+		assertUnit(log.getPilot("a-very-long-pilot-name") != nullptr);
+	}  // teardown
+};
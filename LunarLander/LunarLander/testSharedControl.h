@@ -0,0 +1,121 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SHARED CONTROL
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for the shared-memory control interface
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "sharedControl.h"
+#include "world.h"
+#include <string>
+#include <thread>
+#include <unistd.h>  // for getpid()
+
+/*******************************
+ * TEST SHARED CONTROL
+ * Unit tests for SharedControl, the simulator running on its own thread
+ ********************************/
+class TestSharedControl : public UnitTest
+{
+public:
+	void run()
+	{
+		regionSize_aligned();
+		attach_missing();
+		lockstep_matchesWorld();
+
+		report("SharedControl");
+	}
+
+private:
+
+	/*********************************************
+	 * name:    REGION SIZE ALIGNED
+	 * input:   3 landers
+	 * output:  every section on its own cache lines
+	 *********************************************/
+	void regionSize_aligned()
+	{  // setup
+		size_t size = 0;
+
+		// exercise
+		size = SharedControl::regionSize(3);
+
+		// verify
+		assertUnit(size % 64 == 0);
+		assertUnit(size >= sizeof(SharedControlHeader) + 3 * sizeof(lander_observation) + 3);
+	}  // teardown
+
+	/*********************************************
+	 * name:    ATTACH MISSING
+	 * input:   a region nobody created
+	 * output:  false
+	 *********************************************/
+	void attach_missing()
+	{  // setup
+		SharedControl agent;
+
+		// exercise
+		bool attached = agent.attach("/lunarlander-missing-" + std::to_string(getpid()));
+
+		// verify
+		assertUnit(attached == false);
+		assertUnit(agent.header() == nullptr);
+	}  // teardown
+
+	/*********************************************
+	 * name:    LOCKSTEP MATCHES WORLD
+	 * input:   2 landers, lander 1 fires main for 5 frames, then a reset
+	 * output:  observations identical to a local World
+	 *********************************************/
+	void lockstep_matchesWorld()
+	{  // setup
+		std::string name = "/lunarlander-test-" + std::to_string(getpid());
+		Position posUpperRight(800.0, 600.0);
+		World world(posUpperRight, 2, 17);
+		World local(posUpperRight, 2, 17);
+		SharedControl simulator;
+		simulator.create(name, 2);
+		std::thread sim([&] { simulator.serve(world); });
+		SharedControl agent;
+		bool attached = agent.attach(name);
+		unsigned char thrust[2] = { 0, THRUST_BIT_MAIN };
+
+		// exercise
+		for (int i = 0; attached && i < 5; i++)
+		{
+			agent.actions()[0] = thrust[0];
+			agent.actions()[1] = thrust[1];
+			agent.submitActions();
+			agent.waitObservations();
+			local.step(thrust);
+		}
+
+		// verify
+		assertUnit(attached);
+		if (attached)
+		{
+			lander_observation expected[2];
+			local.observe(0, 2, expected);
+			assertEquals(agent.observations()[1].y, expected[1].y);
+			assertEquals(agent.observations()[1].fuel, expected[1].fuel);
+			assertEquals(agent.observations()[0].dy, expected[0].dy);
+			assertUnit(agent.header()->frame == 5);
+
+			agent.submitActions(SHARED_RESET, 17);
+			agent.waitObservations();
+			assertUnit(agent.header()->frame == 0);
+			agent.submitActions(SHARED_STOP);
+		}
+
+		// teardown
+		sim.join();
+		agent.close();
+		simulator.close();
+	}
+};
@@ -0,0 +1,236 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SIM HOOKS
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for SIM HOOKS
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "simHooks.h"
+#include "lander.h"
+#include "world.h"
+#include <cstdlib>   // for srand
+#include <vector>
+
+/*******************************
+ * RECORDING HOOKS
+ * Where the lander was on each side of a step, and
+ * every touchdown in the order it came
+ ********************************/
+struct RecordingHooks : public NoHooks
+{
+	double yBefore = 0.0;
+	double yAfter = 0.0;
+	double time = 0.0;
+	std::vector<int> others;
+
+	void beforeStep(const Lander& lander, double /*time*/) { yBefore = lander.getPosition().getY(); }
+	void afterStep(const Lander& lander, double time)
+	{
+		yAfter = lander.getPosition().getY();
+		this->time = time;
+	}
+	void contact(const Lander& /*lander*/, const Touchdown& touchdown) { others.push_back(touchdown.other); }
+};
+
+/*******************************
+ * TEST SIM HOOKS
+ * A friend class for World which contains the hooks unit tests
+ ********************************/
+class TestSimHooks : public UnitTest
+{
+public:
+	void run()
+	{
+		// lander
+		input_fuelAndThrust();
+		input_noThrustNoHooks();
+		coast_beforeAndAfter();
+
+		// world
+		step_sameAsWithout();
+		step_landerContact();
+		reset_terrainGenerated();
+
+		report("SimHooks");
+	}
+
+private:
+	/*********************************************
+	 * name:    INPUT FUEL AND THRUST
+	 * input:   main engine and clockwise thruster, one frame
+	 * output:  one thrust, every kg the lander lost reported
+	 *********************************************/
+	void input_fuelAndThrust()
+	{  // setup
+		Lander lander(Position(800.0, 600.0));
+		Thrust thrust;
+		thrust.setBits(THRUST_BIT_MAIN | THRUST_BIT_CLOCK);
+		CountingHooks hooks;
+		Kilograms fuel = lander.fuel;
+
+		// exercise
+		lander.input(thrust, -1.625, hooks);
+
+		// verify
+		assertUnit(hooks.thrusts == 1);
+		assertEquals(hooks.fuelBurned, 2.2046 + 0.22046);
+		assertEquals((fuel - lander.fuel).value(), hooks.fuelBurned);
+		assertUnit(hooks.steps == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    INPUT NO THRUST NO HOOKS
+	 * input:   no thrust, then main engine on a dead lander
+	 * output:  neither reports a thrust or a burn
+	 *********************************************/
+	void input_noThrustNoHooks()
+	{  // setup
+		Lander lander(Position(800.0, 600.0));
+		Thrust thrust;
+		CountingHooks hooks;
+
+		// exercise
+		lander.input(thrust, -1.625, hooks);
+		lander.crash();
+		thrust.setBits(THRUST_BIT_MAIN);
+		lander.input(thrust, -1.625, hooks);
+
+		// verify
+		assertUnit(hooks.thrusts == 0);
+		assertEquals(hooks.fuelBurned, 0.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    COAST BEFORE AND AFTER
+	 * input:   at rest at y=100, one second of lunar gravity
+	 * output:  seen at 100 before the step and 99.1875 after
+	 *********************************************/
+	void coast_beforeAndAfter()
+	{  // setup
+		Lander lander(Position(800.0, 600.0));
+		lander.pos = Position(400.0, 100.0);
+		lander.velocity = Velocity();
+		RecordingHooks hooks;
+
+		// exercise
+		lander.coast(Acceleration(0.0, -1.625), 1.0, hooks);
+
+		// verify
+		assertEquals(hooks.yBefore, 100.0);
+		assertEquals(hooks.yAfter, 99.1875);
+		assertEquals(hooks.time, 1.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    STEP SAME AS WITHOUT
+	 * input:   two worlds from seed 5, one watched, half the landers
+	 *          burning for 5 seconds, until everyone is down
+	 * output:  identical landers; one step per lander-frame in flight,
+	 *          one contact per lander, every burn accounted for
+	 *********************************************/
+	void step_sameAsWithout()
+	{  // setup
+		World plain(Position(800.0, 600.0), 8, 5);
+		World watched(Position(800.0, 600.0), 8, 5);
+		CountingHooks hooks;
+		unsigned char bits[8];
+		for (int i = 0; i < 8; i++)
+			bits[i] = (i % 2) ? THRUST_BIT_MAIN : 0;
+		Kilograms fuel;
+		for (int i = 0; i < 8; i++)
+			fuel += watched.getLander(i).fuel;
+		long flyingFrames = 0;
+
+		// exercise
+		for (int frame = 0; frame < 2000 && watched.numFlying() > 0; frame++)
+		{
+			if (frame == 50)
+				for (int i = 0; i < 8; i++)
+					bits[i] = 0;
+			flyingFrames += watched.numFlying();
+			plain.step(bits);
+			watched.step(bits, hooks);
+		}
+
+		// verify
+		for (int i = 0; i < 8; i++)
+		{
+			assertEquals(watched.getLander(i).pos.getX(), plain.getLander(i).pos.getX());
+			assertEquals(watched.getLander(i).pos.getY(), plain.getLander(i).pos.getY());
+			assertUnit(watched.getLander(i).status == plain.getLander(i).status);
+			fuel -= watched.getLander(i).fuel;
+		}
+		assertUnit(watched.numFlying() == 0);
+		assertUnit(hooks.steps == flyingFrames);
+		assertUnit(hooks.contacts == 8);
+		assertUnit(hooks.thrusts > 0);
+		assertEquals(hooks.fuelBurned, fuel.value());
+	}  // teardown
+
+	/*********************************************
+	 * name:    STEP LANDER CONTACT
+	 * input:   two landers closing head on, lander collisions on
+	 * output:  a contact for each, naming the other
+	 *********************************************/
+	void step_landerContact()
+	{  // setup
+		World w(Position(800.0, 600.0), 2, 1);
+		w.setLanderCollisions(true);
+		for (int i = 0; i < 2; i++)
+		{
+			w.landers[i].pos.setY(500.0);
+			w.landers[i].velocity.setDY(0.0);
+		}
+		w.landers[0].pos.setX(300.0);
+		w.landers[0].velocity.setDX(10.0);
+		w.landers[1].pos.setX(330.0);
+		w.landers[1].velocity.setDX(-10.0);
+		RecordingHooks hooks;
+
+		// exercise
+		for (int i = 0; i < 10; i++)
+			w.step(nullptr, hooks);
+
+		// verify
+		assertUnit(hooks.others.size() == 2);
+		assertUnit(hooks.others[0] == 1 && hooks.others[1] == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RESET TERRAIN GENERATED
+	 * input:   a world reset with hooks, a ground reset with hooks,
+	 *          one with hooks and choices, one with just choices
+	 * output:  terrainGenerated once for each hooked reset; the
+	 *          choices make the same terrain either way
+	 *********************************************/
+	void reset_terrainGenerated()
+	{  // setup
+		World w(Position(800.0, 600.0), 1, 3);
+		Ground ground(Position(800.0, 600.0));
+		Ground hooked(Position(800.0, 600.0));
+		Ground chosen(Position(800.0, 600.0));
+		CountingHooks hooks;
+		TerrainChoices choices = { 0.9, { 0.1, 0.3, 0.6, 0.9 }, { 0.5, 0.5, 0.5, 0.5 },
+		                           { 0.2, 0.7, 0.2, 0.7 }, 0.5 };
+		TerrainChoices* pick = &choices;
+
+		// exercise
+		w.reset(4, hooks);
+		ground.resetHooked(Position(800.0, 600.0), hooks);
+		srand(8);
+		hooked.resetHooked(Position(800.0, 600.0), hooks, pick);
+		srand(8);
+		chosen.reset(Position(800.0, 600.0), pick);
+
+		// verify
+		assertUnit(hooks.terrains == 3);
+		assertUnit(hooks.steps == 0);
+		assertUnit(hooked.getPlatformPosition() == chosen.getPlatformPosition());
+		assertEquals(hooked.getHighestElevation(), chosen.getHighestElevation());
+	}  // teardown
+};
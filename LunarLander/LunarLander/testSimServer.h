@@ -0,0 +1,264 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SIM SERVER
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for the simulation daemon and its client
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "simServer.h"
+#include <cstring>   // for memcpy
+#include <string>
+#include <unistd.h>  // for getpid()
+
+/*******************************
+ * TEST SIM SERVER
+ * A friend class for SimServer which contains the SimServer unit tests
+ ********************************/
+class TestSimServer : public UnitTest
+{
+public:
+	void run()
+	{
+		socketPath = "/tmp/lunarlander-test-" + std::to_string(getpid()) + ".sock";
+
+		pipeline_createStepObserve();
+		stats_countsSteps();
+		noMission();
+		missions_perClient();
+		create_serverNameRefused();
+		warmTerrain_sameAsFresh();
+
+		report("SimServer");
+	}
+
+private:
+	std::string socketPath;
+
+	struct CreateArgs { double width; double height; int32_t landers; uint32_t seed; };
+
+	/*********************************************
+	 * name:    PIPELINE CREATE STEP OBSERVE
+	 * input:   create mission 7, step 3 frames, observe, all before reading
+	 * output:  three answers in order, matching a local World
+	 *********************************************/
+	void pipeline_createStepObserve()
+	{  // setup
+		SimServer server(socketPath, 2);
+		server.start();
+		SimClient client;
+		client.connect(socketPath);
+		CreateArgs create = { 800.0, 600.0, 2, 9 };
+		char step[sizeof(int32_t) + 6] = {};
+		int32_t frames = 3;
+		memcpy(step, &frames, sizeof(frames));
+		int32_t range[2] = { 0, 2 };
+		World local(Position(800.0, 600.0), 2, 9);
+		for (int i = 0; i < 3; i++)
+			local.step(nullptr);
+
+		// exercise
+		uint32_t id1 = client.send(SIM_CREATE, 7, &create, sizeof(create));
+		uint32_t id2 = client.send(SIM_STEP, 7, step, sizeof(step));
+		uint32_t id3 = client.send(SIM_OBSERVE, 7, range, sizeof(range));
+		SimResponseHeader r1, r2, r3;
+		std::vector<char> p1, p2, p3;
+		client.receive(r1, p1);
+		client.receive(r2, p2);
+		client.receive(r3, p3);
+
+		// verify
+		assertUnit(r1.requestId == id1 && r1.status == SIM_OK && r1.mission == 7);
+		assertUnit(r2.requestId == id2 && r2.status == SIM_OK);
+		assertUnit(r3.requestId == id3 && r3.status == SIM_OK);
+		assertUnit(p3.size() == 2 * sizeof(lander_observation));
+		lander_observation obs[2];
+		memcpy(obs, p3.data(), sizeof(obs));
+		assertEquals(obs[1].y, local.getLander(1).getPosition().getY());
+		assertEquals(obs[0].dx, local.getLander(0).getVelocity().getDX());
+
+		// teardown
+		client.close();
+		server.stop();
+	}
+
+	/*********************************************
+	 * name:    STATS COUNTS STEPS
+	 * input:   one lander stepped 4 frames
+	 * output:  4 lander steps
+	 *********************************************/
+	void stats_countsSteps()
+	{  // setup
+		SimServer server(socketPath, 1);
+		server.start();
+		SimClient client;
+		client.connect(socketPath);
+		CreateArgs create = { 800.0, 600.0, 1, 2 };
+		char step[sizeof(int32_t) + 4] = {};
+		int32_t frames = 4;
+		memcpy(step, &frames, sizeof(frames));
+		SimResponseHeader r;
+		std::vector<char> p;
+
+		// exercise
+		client.send(SIM_CREATE, 1, &create, sizeof(create));
+		client.send(SIM_STEP, 1, step, sizeof(step));
+		client.receive(r, p);
+		client.receive(r, p);
+		client.send(SIM_STATS, 0, nullptr, 0);
+		client.receive(r, p);
+
+		// verify
+		assertUnit(r.status == SIM_OK);
+		uint64_t landerSteps = 0;
+		if (p.size() >= sizeof(landerSteps))
+			memcpy(&landerSteps, p.data(), sizeof(landerSteps));
+		assertUnit(landerSteps == 4);
+
+		// teardown
+		client.close();
+		server.stop();
+	}
+
+	/*********************************************
+	 * name:    NO MISSION
+	 * input:   step a mission that was never created
+	 * output:  SIM_NO_MISSION
+	 *********************************************/
+	void noMission()
+	{  // setup
+		SimServer server(socketPath, 1);
+		server.start();
+		SimClient client;
+		client.connect(socketPath);
+		int32_t frames = 0;
+		SimResponseHeader r;
+		std::vector<char> p;
+
+		// exercise
+		client.send(SIM_STEP, 1234, &frames, sizeof(frames));
+		client.receive(r, p);
+
+		// verify
+		assertUnit(r.status == SIM_NO_MISSION);
+
+		// teardown
+		client.close();
+		server.stop();
+	}
+
+	/*********************************************
+	 * name:    MISSIONS PER CLIENT
+	 * input:   two clients both create mission 7,
+	 *          the second destroys it, then the
+	 *          first reconnects
+	 * output:  the first still steps its own two
+	 *          landers; after reconnecting it has
+	 *          no mission 7
+	 *********************************************/
+	void missions_perClient()
+	{  // setup
+		SimServer server(socketPath, 2);
+		server.start();
+		SimClient first;
+		SimClient second;
+		first.connect(socketPath);
+		second.connect(socketPath);
+		CreateArgs createTwo = { 800.0, 600.0, 2, 9 };
+		CreateArgs createOne = { 800.0, 600.0, 1, 9 };
+		char step[sizeof(int32_t) + 2] = {};
+		int32_t frames = 1;
+		memcpy(step, &frames, sizeof(frames));
+		SimResponseHeader r1, r2, r3, r4, r5;
+		std::vector<char> p;
+
+		// exercise
+		first.send(SIM_CREATE, 7, &createTwo, sizeof(createTwo));
+		first.receive(r1, p);
+		second.send(SIM_CREATE, 7, &createOne, sizeof(createOne));
+		second.receive(r2, p);
+		second.send(SIM_DESTROY, 7, nullptr, 0);
+		second.receive(r3, p);
+		first.send(SIM_STEP, 7, step, sizeof(step));
+		first.receive(r4, p);
+		first.close();
+		first.connect(socketPath);
+		first.send(SIM_STEP, 7, step, sizeof(step));
+		first.receive(r5, p);
+
+		// verify
+		assertUnit(r1.status == SIM_OK && r2.status == SIM_OK && r3.status == SIM_OK);
+		assertUnit(r4.status == SIM_OK);
+		assertUnit(r5.status == SIM_NO_MISSION);
+
+		// teardown
+		first.close();
+		second.close();
+		server.stop();
+	}
+
+	/*********************************************
+	 * name:    CREATE SERVER NAME REFUSED
+	 * input:   create mission SIM_SERVER_MISSIONS,
+	 *          then let the server name one
+	 * output:  the first refused; the second gets
+	 *          that name with its own world
+	 *********************************************/
+	void create_serverNameRefused()
+	{  // setup
+		SimServer server(socketPath, 1);
+		server.start();
+		SimClient client;
+		client.connect(socketPath);
+		CreateArgs createTwo = { 800.0, 600.0, 2, 9 };
+		CreateArgs createOne = { 800.0, 600.0, 1, 9 };
+		char step[sizeof(int32_t) + 1] = {};
+		int32_t frames = 1;
+		memcpy(step, &frames, sizeof(frames));
+		SimResponseHeader r1, r2, r3;
+		std::vector<char> p;
+
+		// exercise
+		client.send(SIM_CREATE, SIM_SERVER_MISSIONS, &createTwo, sizeof(createTwo));
+		client.receive(r1, p);
+		client.send(SIM_CREATE, 0, &createOne, sizeof(createOne));
+		client.receive(r2, p);
+		client.send(SIM_STEP, r2.mission, step, sizeof(step));
+		client.receive(r3, p);
+
+		// verify
+		assertUnit(r1.status == SIM_BAD_REQUEST);
+		assertUnit(r2.status == SIM_OK && r2.mission == SIM_SERVER_MISSIONS);
+		assertUnit(r3.status == SIM_OK);
+
+		// teardown
+		client.close();
+		server.stop();
+	}
+
+	/*********************************************
+	 * name:    WARM TERRAIN SAME AS FRESH
+	 * input:   the same terrain requested twice
+	 * output:  the copy matches a freshly generated world
+	 *********************************************/
+	void warmTerrain_sameAsFresh()
+	{  // setup
+		SimServer server(socketPath, 1);
+		Position posUpperRight(800.0, 600.0);
+
+		// exercise
+		std::unique_ptr<World> first = server.createMission(posUpperRight, 3, 21);
+		std::unique_ptr<World> second = server.createMission(posUpperRight, 3, 21);
+
+		// verify
+		World fresh(posUpperRight, 3, 21);
+		assertUnit(server.terrains.size() == 1);
+		assertUnit(second->getLander(2).getPosition() == fresh.getLander(2).getPosition());
+		assertEquals(second->getAltitude(1), fresh.getAltitude(1));
+		assertEquals(first->getAltitude(0), second->getAltitude(0));
+	}  // teardown
+};
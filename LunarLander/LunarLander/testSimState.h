@@ -0,0 +1,159 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SIM STATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for SIM STATE and TERRAIN
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "simState.h"
+#include "world.h"
+
+/*******************************
+ * TEST SIM STATE
+ * Contains the SimState unit tests
+ ********************************/
+class TestSimState : public UnitTest
+{
+public:
+	void run()
+	{
+		// terrain
+		terrain_sameAsGround();
+
+		// clone
+		clone_independent();
+
+		// step
+		step_sameAsWorld();
+		step_notFlying();
+		coastUntilDown_freeFall();
+
+		report("SimState");
+	}
+
+private:
+
+	/*********************************************
+	 * name:    TERRAIN SAME AS GROUND
+	 * input:   terrain copied from a seeded world
+	 * output:  same elevations and platform everywhere
+	 *********************************************/
+	void terrain_sameAsGround()
+	{  // setup
+		World w(Position(800.0, 600.0), 1, 9);
+		const Ground& g = w.getGround();
+
+		// exercise
+		Terrain t(g);
+
+		// verify
+		bool same = true;
+		for (double x = -5.0; x < 810.0; x += 0.7)
+			if (t.getElevationMeters(x) != g.getElevationMeters(Position(x, 0.0)))
+				same = false;
+		assertUnit(same);
+		assertUnit(t.onPlatform(g.getPlatformPosition().getX(), 20));
+		assertUnit(!t.onPlatform(g.getPlatformPosition().getX() + 200.0, 20));
+	}  // teardown
+
+	/*********************************************
+	 * name:    CLONE INDEPENDENT
+	 * input:   a state and its clone, step only the clone
+	 * output:  the original has not moved
+	 *********************************************/
+	void clone_independent()
+	{  // setup
+		World w(Position(800.0, 600.0), 1, 4);
+		Terrain t(w.getGround());
+		SimState s = SimState::fromLander(w.getLander(0), t);
+
+		// exercise
+		SimState c = s.clone();
+		c.step(THRUST_BIT_MAIN);
+
+		// verify
+		assertEquals(s.y, w.getLander(0).pos.y);
+		assertEquals(s.fuel, w.getLander(0).fuel.value());
+		assertUnit(s.frame == 0);
+		assertUnit(c.frame == 1);
+		assertUnit(c.fuel < s.fuel);
+		assertUnit(c.terrain == s.terrain);
+	}  // teardown
+
+	/*********************************************
+	 * name:    STEP SAME AS WORLD
+	 * input:   a world and a state side by side, mixed thrust
+	 * output:  identical every frame until touchdown
+	 *********************************************/
+	void step_sameAsWorld()
+	{  // setup
+		World w(Position(800.0, 600.0), 1, 21);
+		Terrain t(w.getGround());
+		SimState s = SimState::fromLander(w.getLander(0), t);
+		const Lander& l = w.getLander(0);
+		bool same = true;
+
+		// exercise
+		for (int frame = 0; frame < 5000 && w.numFlying() > 0; frame++)
+		{
+			unsigned char bits = static_cast<unsigned char>((frame * 7 + frame / 13) % 8);
+			w.step(&bits);
+			s.step(bits);
+			if (s.x != l.pos.x || s.y != l.pos.y ||
+			    s.dx != l.velocity.dx || s.dy != l.velocity.dy ||
+			    s.angle != l.angle.radians || s.fuel != l.fuel.value() ||
+			    s.status != static_cast<int32_t>(l.status))
+				same = false;
+		}
+
+		// verify
+		assertUnit(same);
+		assertUnit(!s.isFlying());
+		assertUnit(s.frame == w.getFrame());
+	}  // teardown
+
+	/*********************************************
+	 * name:    STEP NOT FLYING
+	 * input:   a crashed state
+	 * output:  nothing changes
+	 *********************************************/
+	void step_notFlying()
+	{  // setup
+		World w(Position(800.0, 600.0), 1, 2);
+		Terrain t(w.getGround());
+		SimState s = SimState::fromLander(w.getLander(0), t);
+		s.status = DEAD;
+
+		// exercise
+		s.step(THRUST_BIT_MAIN);
+
+		// verify
+		assertEquals(s.y, w.getLander(0).pos.y);
+		assertUnit(s.frame == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    COAST UNTIL DOWN FREE FALL
+	 * input:   no thrust from the start position
+	 * output:  down, never burned fuel, at or below the ground
+	 *********************************************/
+	void coastUntilDown_freeFall()
+	{  // setup
+		World w(Position(800.0, 600.0), 1, 6);
+		Terrain t(w.getGround());
+		SimState s = SimState::fromLander(w.getLander(0), t);
+
+		// exercise
+		s.coastUntilDown(0, 10000);
+
+		// verify
+		assertUnit(!s.isFlying());
+		assertEquals(s.fuel, w.getLander(0).fuel.value());
+		assertUnit(s.getAltitude() <= 0.0);
+	}  // teardown
+};
@@ -0,0 +1,251 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SOBOL
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for the SOBOL sequence and the missions drawn
+ *    from it
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "sobol.h"
+#include "mission.h"
+#include "batchRunner.h"
+#include "controller.h"
+#include "world.h"
+#include <cmath>
+#include <cstdlib>   // for srand
+#include <vector>
+
+/*******************************
+ * TEST SOBOL
+ * A friend class for Sobol which contains its unit tests
+ ********************************/
+class TestSobol : public UnitTest
+{
+public:
+	void run()
+	{
+		// the sequence
+		sampleBits_vanDerCorput();
+		sampleBits_stratified();
+		sample_scramblesDiffer();
+
+		// missions from it
+		sobolConditions_sameValues();
+		world_terrainChoices();
+		batch_sobolShardedMatchesLocal();
+
+		report("Sobol");
+	}
+
+private:
+	/*********************************************
+	 * STRATIFIED
+	 * The first 2^m points of dimension a against
+	 * dimension b: one in each of 2^q by 2^(m-q)
+	 * boxes for every q. A dimension against
+	 * itself: one in each 1/2^m.
+	 *********************************************/
+	static bool stratified(int m, int a, int b, uint32_t scramble, bool scrambled)
+	{
+		uint32_t n = 1u << m;
+		for (int q = (a == b ? m : 0); q <= m; q++)
+		{
+			std::vector<int> boxes(n, 0);
+			for (uint32_t i = 0; i < n; i++)
+			{
+				uint32_t x = scrambled ? Sobol::sampleBits(i, a, scramble) : Sobol::sampleBits(i, a);
+				uint32_t y = scrambled ? Sobol::sampleBits(i, b, scramble) : Sobol::sampleBits(i, b);
+				uint32_t row = q ? x >> (32 - q) : 0;
+				uint32_t column = q < m ? y >> (32 - (m - q)) : 0;
+				if (++boxes[(row << (m - q)) | column] > 1)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	/*********************************************
+	 * name:    SAMPLE BITS VAN DER CORPUT
+	 * input:   points 0 to 3, 5 of the first dimension
+	 * output:  0, 1/2, 1/4, 3/4, 5/8
+	 *********************************************/
+	void sampleBits_vanDerCorput()
+	{  // setup
+		uint32_t points[5];
+		const uint32_t indices[5] = { 0, 1, 2, 3, 5 };
+
+		// exercise
+		for (int i = 0; i < 5; i++)
+			points[i] = Sobol::sampleBits(indices[i], 0);
+
+		// verify
+		assertUnit(points[0] == 0);
+		assertUnit(points[1] == 0x80000000u);
+		assertUnit(points[2] == 0x40000000u);
+		assertUnit(points[3] == 0xc0000000u);
+		assertUnit(points[4] == 0xa0000000u);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SAMPLE BITS STRATIFIED
+	 * input:   the first 1024 points, raw and
+	 *          scrambled
+	 * output:  every dimension has one point in each
+	 *          1/1024; the first two, one in every
+	 *          box of area 1/1024
+	 *********************************************/
+	void sampleBits_stratified()
+	{  // setup
+		bool each = true;
+
+		// exercise
+		for (int d = 1; d < SOBOL_DIMENSIONS; d++)
+			each = each && stratified(10, d, d, 0, false) && stratified(10, d, d, 41, true);
+		bool pair = stratified(10, 0, 1, 0, false);
+		bool pairScrambled = stratified(10, 0, 1, 41, true);
+
+		// verify
+		assertUnit(each);
+		assertUnit(pair);
+		assertUnit(pairScrambled);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SAMPLE SCRAMBLES DIFFER
+	 * input:   the first 256 points under keys 0, 1
+	 * output:  different points, both averaging a
+	 *          half to within a point's stratum
+	 *********************************************/
+	void sample_scramblesDiffer()
+	{  // setup
+		int same = 0;
+		double mean0 = 0.0;
+		double mean1 = 0.0;
+
+		// exercise
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			double a = Sobol::sample(i, 3, 0);
+			double b = Sobol::sample(i, 3, 1);
+			same += a == b ? 1 : 0;
+			mean0 += a / 256.0;
+			mean1 += b / 256.0;
+		}
+
+		// verify
+		assertUnit(same < 4);
+		assertUnit(fabs(mean0 - 0.5) < 1.0 / 256.0);
+		assertUnit(fabs(mean1 - 0.5) < 1.0 / 256.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SOBOL CONDITIONS SAME VALUES
+	 * input:   the first 1024 points
+	 * output:  whole steps in the ranges seeded
+	 *          missions use, each dx as often as
+	 *          the others give or take a point
+	 *********************************************/
+	void sobolConditions_sameValues()
+	{  // setup
+		int counts[7] = { 0, 0, 0, 0, 0, 0, 0 };
+		bool inRange = true;
+
+		// exercise
+		for (uint32_t i = 0; i < 1024; i++)
+		{
+			MissionConditions c = sobolConditions(i, 5);
+			int dx = static_cast<int>(-c.dx);
+			inRange = inRange && c.dx == floor(c.dx) && dx >= 4 && dx <= 10 &&
+			          c.startY == floor(c.startY) && c.startY >= 440.0 && c.startY <= 459.0 &&
+			          c.dy == floor(c.dy) && c.dy >= -2.0 && c.dy <= 2.0 &&
+			          c.terrain.platformWidth >= 0.0 && c.terrain.platformWidth < 1.0 &&
+			          c.terrain.peak[3] >= 0.0 && c.terrain.peak[3] < 1.0;
+			if (dx >= 4 && dx <= 10)
+				counts[dx - 4]++;
+		}
+
+		// verify
+		assertUnit(inRange);
+		for (int count : counts)
+			assertUnit(count >= 145 && count <= 148);
+	}  // teardown
+
+	/*********************************************
+	 * name:    WORLD TERRAIN CHOICES
+	 * input:   the same choices from seeds 5, 5, 6,
+	 *          and the lander placed
+	 * output:  same terrain, then one that differs
+	 *          by little more than roughness; a 75 m
+	 *          platform;
+	 *          the lander where it was put
+	 *********************************************/
+	void world_terrainChoices()
+	{  // setup
+		TerrainChoices choices = { 0.9, { 0.1, 0.3, 0.6, 0.9 }, { 0.5, 0.5, 0.5, 0.5 },
+		                           { 0.2, 0.7, 0.2, 0.7 }, 0.5 };
+		Position size(800.0, 600.0);
+
+		// exercise
+		World a(size, 1, 5, &choices);
+		World b(size, 1, 5, &choices);
+		World c(size, 1, 6, &choices);
+		c.place(0, Position(799.0, 444.0), Velocity(-9.0, 1.0));
+
+		// verify
+		const Ground& ga = a.getGround();
+		const Ground& gb = b.getGround();
+		const Ground& gc = c.getGround();
+		bool same = true;
+		bool differ = false;
+		int farApart = 0;   // more than the roughness, where the platform shifted
+		for (int i = 0; i < ga.getNumElevations(); i++)
+		{
+			double apart = fabs(ga.getElevations()[i] - gc.getElevations()[i]);
+			same = same && ga.getElevations()[i] == gb.getElevations()[i];
+			differ = differ || apart > 0.0;
+			farApart += apart > 20.0 ? 1 : 0;
+		}
+		assertUnit(same);
+		assertUnit(differ);
+		assertUnit(farApart <= 2);
+		assertEquals(ga.getPlatformWidth(), 75.0);
+		assertEquals(gc.getPlatformWidth(), 75.0);
+		assertEquals(c.getLander(0).getPosition().getY(), 444.0);
+		assertEquals(c.getLander(0).getVelocity().getDX(), -9.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    BATCH SOBOL SHARDED MATCHES LOCAL
+	 * input:   64 Sobol missions, in this process
+	 *          and over two workers; by seed
+	 * output:  the same totals either way, and not
+	 *          those of the seeded missions
+	 *********************************************/
+	void batch_sobolShardedMatchesLocal()
+	{  // setup
+		BatchRunner local(0, 64, CONTROLLER_GUIDANCE);
+		BatchRunner sharded(0, 64, CONTROLLER_GUIDANCE);
+		BatchRunner seeded(0, 64, CONTROLLER_GUIDANCE);
+		local.setSobol(3);
+		sharded.setSobol(3);
+		sharded.setChunkSize(16);
+		sharded.setPinning(false);
+		MissionStats shardedStats;
+
+		// exercise
+		MissionStats localStats = local.runLocal();
+		bool complete = sharded.runSharded(2, shardedStats);
+		MissionStats seededStats = seeded.runLocal();
+
+		// verify
+		assertUnit(complete);
+		assertUnit(localStats == shardedStats);
+		assertUnit(localStats.missions == 64);
+		assertUnit(!(localStats == seededStats));
+	}  // teardown
+};
@@ -0,0 +1,152 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SPATIAL HASH
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for SPATIAL HASH
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "spatialHash.h"
+#include <vector>
+#include <set>
+#include <utility>
+#include <cstdlib>
+
+/*******************************
+ * TEST SPATIAL HASH
+ * A friend class for SpatialHash which contains the SpatialHash unit tests
+ ********************************/
+class TestSpatialHash : public UnitTest
+{
+public:
+	void run()
+	{
+		// rebuild
+		rebuild_cellsInOrder();
+
+		// pairs
+		forEachPair_matchesBruteForce();
+		forEachPair_outsideWorld();
+
+		// query
+		query_radius();
+
+		report("SpatialHash");
+	}
+
+private:
+	/*********************************************
+	 * name:    REBUILD CELLS IN ORDER
+	 * input:   (5,5) (25,5) (6,6) in 20m cells
+	 * output:  two points in cell 0 in input order, one in cell 1
+	 *********************************************/
+	void rebuild_cellsInOrder()
+	{  // setup
+		SpatialHash hash(Position(100.0, 100.0), 20.0);
+		double x[3] = { 5.0, 25.0, 6.0 };
+		double y[3] = { 5.0, 5.0, 6.0 };
+		int ids[3] = { 10, 11, 12 };
+
+		// exercise
+		hash.rebuild(x, y, ids, 3);
+
+		// verify
+		assertUnit(hash.cols == 5 && hash.rows == 5);
+		assertUnit(hash.cellStart[0] == 0 && hash.cellStart[1] == 2);
+		assertUnit(hash.cellStart[2] == 3 && hash.cellStart[25] == 3);
+		assertUnit(hash.ids[0] == 10 && hash.ids[1] == 12 && hash.ids[2] == 11);
+	}  // teardown
+
+	/*********************************************
+	 * name:    FOR EACH PAIR MATCHES BRUTE FORCE
+	 * input:   500 random points
+	 * output:  exactly the pairs the n^2 check finds, each once
+	 *********************************************/
+	void forEachPair_matchesBruteForce()
+	{  // setup
+		const int n = 500;
+		SpatialHash hash(Position(400.0, 300.0), 20.0);
+		std::vector<double> x(n), y(n);
+		std::vector<int> ids(n);
+		srand(3);
+		for (int i = 0; i < n; i++)
+		{
+			x[i] = (rand() % 40000) / 100.0;
+			y[i] = (rand() % 30000) / 100.0;
+			ids[i] = i;
+		}
+		std::set<std::pair<int, int>> expected;
+		for (int i = 0; i < n; i++)
+			for (int j = i + 1; j < n; j++)
+				if ((x[i] - x[j]) * (x[i] - x[j]) + (y[i] - y[j]) * (y[i] - y[j]) < 400.0)
+					expected.insert(std::make_pair(i, j));
+
+		// exercise
+		hash.rebuild(x.data(), y.data(), ids.data(), n);
+		std::set<std::pair<int, int>> found;
+		int visits = 0;
+		hash.forEachPair(20.0, [&](int a, int b)
+		{
+			found.insert(std::make_pair(std::min(a, b), std::max(a, b)));
+			visits++;
+		});
+
+		// verify
+		assertUnit(!expected.empty());
+		assertUnit(found == expected);
+		assertUnit(visits == static_cast<int>(expected.size()));
+	}  // teardown
+
+	/*********************************************
+	 * name:    FOR EACH PAIR OUTSIDE WORLD
+	 * input:   two points above the top, one to the left of the left edge
+	 * output:  the close pair above the top is still found
+	 *********************************************/
+	void forEachPair_outsideWorld()
+	{  // setup
+		SpatialHash hash(Position(100.0, 100.0), 20.0);
+		double x[3] = { 50.0, 55.0, -500.0 };
+		double y[3] = { 900.0, 910.0, 50.0 };
+		int ids[3] = { 0, 1, 2 };
+		hash.rebuild(x, y, ids, 3);
+		int pairs = 0;
+
+		// exercise
+		hash.forEachPair(20.0, [&](int, int) { pairs++; });
+
+		// verify
+		assertUnit(pairs == 1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    QUERY RADIUS
+	 * input:   a row of points 10m apart, radius 25 around (50, 50)
+	 * output:  the five points within 25m
+	 *********************************************/
+	void query_radius()
+	{  // setup
+		SpatialHash hash(Position(100.0, 100.0), 20.0);
+		double x[10], y[10];
+		int ids[10];
+		for (int i = 0; i < 10; i++)
+		{
+			x[i] = i * 10.0;
+			y[i] = 50.0;
+			ids[i] = i;
+		}
+		hash.rebuild(x, y, ids, 10);
+		std::vector<int> out;
+
+		// exercise
+		hash.query(50.0, 50.0, 25.0, out);
+
+		// verify
+		std::set<int> found(out.begin(), out.end());
+		assertUnit(out.size() == 5);
+		assertUnit(found == std::set<int>({ 3, 4, 5, 6, 7 }));
+	}  // teardown
+};
@@ -0,0 +1,178 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SPLITTING
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for multilevel SPLITTING and the controller
+ *    copies it depends on
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "splitting.h"
+#include "controller.h"
+#include "guidance.h"
+#include "pluginController.h"
+#include "mission.h"
+#include "world.h"
+#include <cmath>
+#include <memory>
+
+/*******************************
+ * TEST SPLITTING
+ * A friend class for Splitting which contains its unit tests
+ ********************************/
+class TestSplitting : public UnitTest
+{
+public:
+	void run()
+	{
+		// what it relies on
+		score_flightAndCrash();
+		clone_fliesTheSame();
+
+		// estimates
+		run_freeFallAlwaysFails();
+		run_agreesWithMonteCarlo();
+		run_noClone();
+
+		report("Splitting");
+	}
+
+private:
+	/*********************************************
+	 * name:    SCORE FLIGHT AND CRASH
+	 * input:   a lander where it starts, then
+	 *          after falling to the ground
+	 * output:  far from failing, then failed
+	 *********************************************/
+	void score_flightAndCrash()
+	{  // setup
+		World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, 3);
+
+		// exercise
+		double start = Splitting::score(world);
+		while (world.numFlying() > 0)
+			world.step(nullptr);
+		double end = Splitting::score(world);
+
+		// verify
+		assertUnit(start > 0.0 && start < 0.05);
+		assertUnit(world.getLander(0).isDead());
+		assertEquals(end, 1.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    CLONE FLIES THE SAME
+	 * input:   guidance 100 frames into a mission,
+	 *          cloned with its world
+	 * output:  the clone decides exactly as the
+	 *          original for the rest of it
+	 *********************************************/
+	void clone_fliesTheSame()
+	{  // setup
+		GuidanceAutopilot original;
+		World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, 11);
+		original.start(11);
+		for (int f = 0; f < 100; f++)
+		{
+			unsigned char bits = original.decide(world.getLander(0), world.getGround());
+			world.step(&bits);
+		}
+		World copy = world;
+		int differ = 0;
+
+		// exercise
+		std::unique_ptr<Controller> clone = original.clone();
+		while (world.numFlying() > 0 && world.getFrame() < MISSION_MAX_FRAMES)
+		{
+			unsigned char bits = original.decide(world.getLander(0), world.getGround());
+			unsigned char cloneBits = clone->decide(copy.getLander(0), copy.getGround());
+			differ += bits != cloneBits ? 1 : 0;
+			world.step(&bits);
+			copy.step(&cloneBits);
+		}
+
+		// verify
+		assertUnit(clone != nullptr);
+		assertUnit(differ == 0);
+		assertUnit(copy.getLander(0).isLanded());
+		assertEquals(copy.getFrame(), world.getFrame());
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN FREE FALL ALWAYS FAILS
+	 * input:   no thrust at all, 8 particles,
+	 *          2 runs
+	 * output:  failure every time with no doubt,
+	 *          and no levels needed
+	 *********************************************/
+	void run_freeFallAlwaysFails()
+	{  // setup
+		Splitting splitting(CONTROLLER_NONE, 8, 2, 0.1);
+
+		// exercise
+		bool ran = splitting.run(2);
+
+		// verify
+		assertUnit(ran);
+		assertEquals(splitting.getResult().probability, 1.0);
+		assertEquals(splitting.getResult().error, 0.0);
+		assertEquals(splitting.getResult().levels, 0.0);
+		assertUnit(splitting.getResult().frames > 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN AGREES WITH MONTE CARLO
+	 * input:   guidance pushed 2 m/s^2 about, 20
+	 *          particles, 8 runs, by splitting on
+	 *          one and four threads and plainly
+	 * output:  the same estimate on any threads,
+	 *          within the error of plain missions
+	 *********************************************/
+	void run_agreesWithMonteCarlo()
+	{  // setup
+		Splitting splitting(CONTROLLER_GUIDANCE, 20, 8, 2.0);
+
+		// exercise
+		splitting.run(1);
+		SplittingResult one = splitting.getResult();
+		splitting.run(4);
+		SplittingResult four = splitting.getResult();
+		splitting.runMonteCarlo(4);
+		SplittingResult plain = splitting.getResult();
+
+		// verify
+		assertEquals(four.probability, one.probability);
+		assertUnit(four.frames == one.frames);
+		assertUnit(one.probability > 0.0 && one.probability < 1.0);
+		assertUnit(one.lower <= one.probability && one.probability <= one.upper);
+		assertUnit(one.levels > 1.0);
+		assertUnit(fabs(one.probability - plain.probability) <
+		           1.96 * sqrt(one.error * one.error + plain.error * plain.error));
+		assertUnit(one.monteCarloMissions() > 0.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN NO CLONE
+	 * input:   a plugin, which cannot be copied
+	 *          mid-mission, and no controller
+	 * output:  both refused
+	 *********************************************/
+	void run_noClone()
+	{  // setup
+		Splitting plugin([]() { return std::unique_ptr<Controller>(new PluginController); },
+		                 4, 2, 0.1);
+		Splitting nobody(99, 4, 2, 0.1);
+
+		// exercise
+		bool ranPlugin = plugin.run(1);
+		bool ranNobody = nobody.run(1);
+
+		// verify
+		assertUnit(!ranPlugin);
+		assertUnit(!ranNobody);
+	}  // teardown
+};
@@ -0,0 +1,358 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SURROGATE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for the SURROGATE landing model
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "surrogate.h"
+#include "batchRunner.h"
+#include "controller.h"
+#include "guidance.h"
+#include "mission.h"
+#include "resultStore.h"
+#include "trajectoryArchive.h"
+#include "world.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>   // for mkdtemp, system
+#include <string>
+#include <vector>
+
+/*******************************
+ * TEST SURROGATE
+ * A friend class for Surrogate which contains its unit tests
+ ********************************/
+class TestSurrogate : public UnitTest
+{
+public:
+	void run()
+	{
+		char pattern[] = "/tmp/surrogateXXXXXX";
+		if (!mkdtemp(pattern))
+			return;
+		directory = pattern;
+
+		// the model
+		predict_unseen();
+		add_learnsCell();
+		save_roundTrip();
+
+		// using it
+		predictOrSimulate_fallsBack();
+		train_fromBatch();
+		train_fromSobolBatch();
+		train_seedSharedByControllers();
+
+		std::string cleanup = "rm -rf " + directory;
+		if (system(cleanup.c_str()) != 0)
+			std::cerr << "could not remove " << directory << "\n";
+
+		report("Surrogate");
+	}
+
+private:
+	std::string directory;
+
+	/*********************************************
+	 * HOVER
+	 * frames of a lander 100 m over a pad, still and
+	 * upright, then one more for the touchdown
+	 *********************************************/
+	static std::vector<TrajectoryFrame> hover(const Ground& ground, int frames)
+	{
+		TrajectoryFrame frame;
+		frame.x = ground.getPlatformPosition().getX();
+		frame.y = ground.getPlatformPosition().getY() + 100.0;
+		frame.dx = 0.0;
+		frame.dy = -1.5;
+		frame.angle = 2.0 * M_PI;   // a whole turn, still upright
+		frame.fuel = 1000.0;
+		frame.thrust = 0;
+		return std::vector<TrajectoryFrame>(frames + 1, frame);
+	}
+
+	/*********************************************
+	 * name:    PREDICT UNSEEN
+	 * input:   an empty model
+	 * output:  even odds, the fuel it has now, and
+	 *          not certain
+	 *********************************************/
+	void predict_unseen()
+	{  // setup
+		Surrogate model;
+		World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, 2);
+		TrajectoryFrame state = hover(world.getGround(), 1)[0];
+
+		// exercise
+		SurrogatePrediction prediction = model.predict(CONTROLLER_SIMPLE, world.getGround(), state);
+
+		// verify
+		assertEquals(prediction.landed, 0.5);
+		assertEquals(prediction.fuel, 1000.0);
+		assertUnit(prediction.samples == 0);
+		assertUnit(!prediction.certain);
+		assertUnit(!prediction.simulated);
+		assertUnit(model.getCells() == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    ADD LEARNS CELL
+	 * input:   20 landings from a hover keeping
+	 *          300 kg, 20 keeping 500, both two
+	 *          frames long, for the simple autopilot
+	 * output:  one cell, 80 samples; 41 in 42 to
+	 *          land with 400 kg, certain, but not
+	 *          to a tolerance of 0.01; nothing for
+	 *          guidance
+	 *********************************************/
+	void add_learnsCell()
+	{  // setup
+		Surrogate model;
+		World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, 2);
+		std::vector<TrajectoryFrame> trajectory = hover(world.getGround(), 2);
+
+		// exercise
+		for (int i = 0; i < 40; i++)
+			model.add(CONTROLLER_SIMPLE, world.getGround(), trajectory, true, i < 20 ? 300.0 : 500.0);
+		SurrogatePrediction prediction = model.predict(CONTROLLER_SIMPLE, world.getGround(), trajectory[0]);
+		SurrogatePrediction other = model.predict(CONTROLLER_GUIDANCE, world.getGround(), trajectory[0]);
+		model.setTolerance(0.01);
+		SurrogatePrediction strict = model.predict(CONTROLLER_SIMPLE, world.getGround(), trajectory[0]);
+
+		// verify
+		assertUnit(model.getCells() == 1);
+		assertUnit(model.getSamples() == 80);
+		assertUnit(model.getMissions() == 40);
+		assertUnit(prediction.samples == 80);
+		assertUnit(fabs(prediction.landed - 81.0 / 82.0) < 1e-12);
+		assertUnit(fabs(prediction.fuel - 400.0) < 1e-9);
+		assertUnit(prediction.certain);
+		assertUnit(!strict.certain);
+		assertUnit(other.samples == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SAVE ROUND TRIP
+	 * input:   a model of 3000 cells saved, then
+	 *          loaded; then a file that is no model
+	 * output:  the same predictions; the bad file
+	 *          refused with the model kept
+	 *********************************************/
+	void save_roundTrip()
+	{  // setup
+		Surrogate model;
+		World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, 2);
+		std::vector<TrajectoryFrame> trajectory = hover(world.getGround(), 1);
+		std::vector<TrajectoryFrame> states;
+		for (int i = 0; i < 3000; i++)
+		{
+			trajectory[0].dx = (i % 10) - 5.0;
+			trajectory[0].dy = -(i / 10 % 10) * 1.5;
+			trajectory[0].fuel = (i / 100 % 4) * 500.0;
+			trajectory[0].x = 20.0 + (i / 400) * 100.0;
+			model.add(i % 7, world.getGround(), trajectory, i % 3 != 0, i);
+			states.push_back(trajectory[0]);
+		}
+		std::string path = directory + "/model";
+		std::string junk = directory + "/junk";
+		FILE* file = fopen(junk.c_str(), "wb");
+		if (file)
+		{
+			fputs("not a surrogate model at all", file);
+			fclose(file);
+		}
+
+		// exercise
+		bool saved = model.save(path);
+		Surrogate loaded;
+		bool read = loaded.load(path);
+		bool readJunk = loaded.load(junk);
+
+		// verify
+		assertUnit(saved && read && !readJunk);
+		assertUnit(loaded.getCells() == model.getCells());
+		assertUnit(loaded.getSamples() == model.getSamples());
+		bool same = true;
+		for (int i = 0; i < 3000; i++)
+		{
+			SurrogatePrediction a = model.predict(i % 7, world.getGround(), states[i]);
+			SurrogatePrediction b = loaded.predict(i % 7, world.getGround(), states[i]);
+			same = same && a.landed == b.landed && a.samples == b.samples &&
+			       fabs(a.fuel - b.fuel) < 1e-3 * (1.0 + a.fuel);
+		}
+		assertUnit(same);
+	}  // teardown
+
+	/*********************************************
+	 * name:    PREDICT OR SIMULATE FALLS BACK
+	 * input:   guidance 50 frames into mission 4,
+	 *          with an empty model and one that has
+	 *          seen that mission 30 times
+	 * output:  flown to the end the first time,
+	 *          just as the mission goes; looked up
+	 *          the second
+	 *********************************************/
+	void predictOrSimulate_fallsBack()
+	{  // setup
+		GuidanceAutopilot pilot;
+		std::vector<TrajectoryFrame> trajectory;
+		MissionResult result = runMission(4, pilot, &trajectory);
+		World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, 4);
+		pilot.start(4);
+		for (int f = 0; f < 50; f++)
+		{
+			unsigned char bits = pilot.decide(world.getLander(0), world.getGround());
+			world.step(&bits);
+		}
+		Surrogate empty;
+		Surrogate trained;
+		for (int i = 0; i < 30; i++)
+			trained.add(CONTROLLER_GUIDANCE, world.getGround(), trajectory, true, result.fuel);
+
+		// exercise
+		SurrogatePrediction flown = empty.predictOrSimulate(world, pilot);
+		SurrogatePrediction looked = trained.predictOrSimulate(world, pilot);
+
+		// verify
+		assertUnit(result.outcome == MISSION_LANDED);
+		assertUnit(flown.simulated && flown.certain);
+		assertEquals(flown.landed, 1.0);
+		assertEquals(flown.fuel, result.fuel);
+		assertUnit(world.getFrame() == 50);
+		assertUnit(!looked.simulated && looked.certain);
+		assertUnit(looked.samples >= 30);
+		assertUnit(looked.landed > 0.95);
+	}  // teardown
+
+	/*********************************************
+	 * name:    TRAIN FROM BATCH
+	 * input:   16 missions in free fall, kept in
+	 *          a result store and trajectory archive
+	 * output:  every frame but the last of each is
+	 *          a sample; a state of one of them is
+	 *          likely to crash
+	 *********************************************/
+	void train_fromBatch()
+	{  // setup
+		std::string storePath = directory + "/store";
+		std::string archivePath = directory + "/archive";
+		ResultStoreWriter storeWriter;
+		TrajectoryArchiveWriter archiveWriter;
+		storeWriter.open(storePath);
+		archiveWriter.open(archivePath);
+		BatchRunner runner(1, 16, CONTROLLER_NONE);
+		runner.setResultStore(&storeWriter);
+		runner.setTrajectoryArchive(&archiveWriter);
+		MissionStats stats = runner.runLocal();
+		bool closed = storeWriter.close() && archiveWriter.close();
+		ResultStore store;
+		TrajectoryArchive archive;
+		bool opened = store.open(storePath) && archive.open(archivePath);
+		Surrogate model;
+
+		// exercise
+		bool trained = model.train(store, archive);
+
+		// verify
+		assertUnit(closed && opened && trained);
+		assertUnit(model.getMissions() == 16);
+		assertUnit(model.getSamples() == static_cast<uint64_t>(stats.frames));
+		std::vector<TrajectoryFrame> frames;
+		archive.read(3, frames);
+		World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, archive.getTrajectory(3).seed);
+		SurrogatePrediction prediction = model.predict(CONTROLLER_NONE, world.getGround(), frames[10]);
+		assertUnit(prediction.samples > 0);
+		assertUnit(prediction.landed < 0.5);
+	}  // teardown
+
+	/*********************************************
+	 * name:    TRAIN FROM SOBOL BATCH
+	 * input:   16 Sobol missions in free fall,
+	 *          scramble 5, kept in a result store
+	 *          and trajectory archive
+	 * output:  every frame of every mission found
+	 *          again over the terrain it flew
+	 *********************************************/
+	void train_fromSobolBatch()
+	{  // setup
+		std::string storePath = directory + "/sobolStore";
+		std::string archivePath = directory + "/sobolArchive";
+		ResultStoreWriter storeWriter;
+		TrajectoryArchiveWriter archiveWriter;
+		storeWriter.open(storePath);
+		archiveWriter.open(archivePath);
+		BatchRunner runner(0, 16, CONTROLLER_NONE);
+		runner.setSobol(5);
+		runner.setResultStore(&storeWriter);
+		runner.setTrajectoryArchive(&archiveWriter);
+		runner.runLocal();
+		bool closed = storeWriter.close() && archiveWriter.close();
+		ResultStore store;
+		TrajectoryArchive archive;
+		bool opened = store.open(storePath) && archive.open(archivePath);
+		Surrogate model;
+
+		// exercise
+		bool trained = model.train(store, archive);
+
+		// verify
+		assertUnit(closed && opened && trained);
+		assertUnit(model.getMissions() == 16);
+		uint32_t unseen = 0;
+		std::vector<TrajectoryFrame> frames;
+		for (size_t i = 0; i < archive.getCount(); i++)
+		{
+			archive.read(i, frames);
+			MissionConditions conditions = sobolConditions(archive.getTrajectory(i).seed, 5);
+			World world(Position(MISSION_WIDTH, MISSION_HEIGHT), 1, conditions.terrainSeed,
+			            &conditions.terrain);
+			for (size_t f = 0; f + 1 < frames.size(); f++)
+				unseen += model.predict(CONTROLLER_NONE, world.getGround(), frames[f]).samples == 0;
+		}
+		assertUnit(unseen == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    TRAIN SEED SHARED BY CONTROLLERS
+	 * input:   seed 6 flown in free fall and by
+	 *          guidance, both in one store and
+	 *          archive
+	 * output:  both missions learned
+	 *********************************************/
+	void train_seedSharedByControllers()
+	{  // setup
+		std::string storePath = directory + "/sharedStore";
+		std::string archivePath = directory + "/sharedArchive";
+		ResultStoreWriter storeWriter;
+		TrajectoryArchiveWriter archiveWriter;
+		storeWriter.open(storePath);
+		archiveWriter.open(archivePath);
+		FreeFall fall;
+		GuidanceAutopilot guidance;
+		std::vector<TrajectoryFrame> fallen;
+		std::vector<TrajectoryFrame> guided;
+		storeWriter.append(runMission(6, fall, &fallen));
+		storeWriter.append(runMission(6, guidance, &guided));
+		archiveWriter.append(6, CONTROLLER_NONE, fallen);
+		archiveWriter.append(6, CONTROLLER_GUIDANCE, guided);
+		bool closed = storeWriter.close() && archiveWriter.close();
+		ResultStore store;
+		TrajectoryArchive archive;
+		bool opened = store.open(storePath) && archive.open(archivePath);
+		Surrogate model;
+
+		// exercise
+		bool trained = model.train(store, archive);
+
+		// verify
+		assertUnit(closed && opened && trained);
+		assertUnit(model.getMissions() == 2);
+		assertUnit(model.getSamples() == fallen.size() + guided.size() - 2);
+	}  // teardown
+};
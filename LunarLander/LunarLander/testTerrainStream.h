@@ -0,0 +1,121 @@
+/***********************************************************************
+ * Header File:
+ *    TEST TERRAIN STREAM
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for TERRAIN STREAM
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "terrainStream.h"
+#include <cmath>
+
+/*******************************
+ * TEST TERRAIN STREAM
+ * A friend class for TerrainStream which contains the TerrainStream unit tests
+ ********************************/
+class TestTerrainStream : public UnitTest
+{
+public:
+	void run()
+	{
+		// elevation
+		elevation_anyOrder();
+		elevation_acrossTiles();
+		elevation_flatPad();
+
+		// tiles
+		tiles_onlyWhereAsked();
+
+		report("TerrainStream");
+	}
+
+private:
+	/*********************************************
+	 * name:    ELEVATION ANY ORDER
+	 * input:   the same spots, forward in one stream, backward in another
+	 * output:  the same elevations
+	 *********************************************/
+	void elevation_anyOrder()
+	{  // setup
+		TerrainStream forward(5, 500000.0, 30.0);
+		TerrainStream backward(5, 500000.0, 30.0);
+		double a[20], b[20];
+
+		// exercise
+		for (int i = 0; i < 20; i++)
+			a[i] = forward.getElevation(i * 37000.0 + 3.5);
+		for (int i = 19; i >= 0; i--)
+			b[i] = backward.getElevation(i * 37000.0 + 3.5);
+
+		// verify
+		bool same = true;
+		for (int i = 0; i < 20; i++)
+			same = same && a[i] == b[i];
+		assertUnit(same);
+		assertUnit(a[3] != a[4]);
+	}  // teardown
+
+	/*********************************************
+	 * name:    ELEVATION ACROSS TILES
+	 * input:   either side of the boundary at 10240 m
+	 * output:  no step in the ground
+	 *********************************************/
+	void elevation_acrossTiles()
+	{  // setup
+		TerrainStream t(9, 500000.0, 30.0);
+
+		// exercise
+		double before = t.getElevation(10239.999);
+		double after = t.getElevation(10240.0);
+
+		// verify
+		assertUnit(fabs(after - before) < 0.01);
+		assertUnit(t.tilesGenerated == 2);
+	}  // teardown
+
+	/*********************************************
+	 * name:    ELEVATION FLAT PAD
+	 * input:   a 30 m pad at 100 km
+	 * output:  the same elevation all the way across, on the pad
+	 *********************************************/
+	void elevation_flatPad()
+	{  // setup
+		TerrainStream t(2, 100000.0, 30.0);
+
+		// exercise
+		double left = t.getElevation(99985.0);
+		double middle = t.getElevation(100000.0);
+		double right = t.getElevation(100015.0);
+
+		// verify
+		assertEquals(left, t.getPadElevation());
+		assertEquals(middle, t.getPadElevation());
+		assertEquals(right, t.getPadElevation());
+		assertUnit(t.onPad(100000.0, 20));
+		assertUnit(!t.onPad(100010.0, 20));
+	}  // teardown
+
+	/*********************************************
+	 * name:    TILES ONLY WHERE ASKED
+	 * input:   back and forth inside one tile, then two far away
+	 * output:  three tiles made, never more than the cache holds
+	 *********************************************/
+	void tiles_onlyWhereAsked()
+	{  // setup
+		TerrainStream t(1, 900000.0, 30.0);
+
+		// exercise
+		for (int i = 0; i < 1000; i++)
+			t.getElevation(20500.0 + (i % 50) * 10.0);
+		t.getElevation(400000.0);
+		t.getElevation(800000.0);
+
+		// verify
+		assertUnit(t.getTilesGenerated() == 3);
+		assertUnit(t.tiles[0].samples.size() == TERRAIN_TILE_SAMPLES + 1);
+	}  // teardown
+};
@@ -43,6 +43,8 @@ public:
 		set_right();
 		set_down();
 		set_all();
+		setBits_all();
+		getBits_some();
 
 		report("Thrust");
 	}
@@ -504,5 +506,43 @@ private:
 		ui.isRightPress = 0;
 	}
 
+	/*********************************************
+	 * name:    SET BITS EVERYTHING
+	 * input:   bits=MAIN|CLOCK|COUNTER
+	 * output:  mainEngine=true clockwise=true counterClockwise=true
+	 *********************************************/
+	void setBits_all()
+	{  // setup
+		Thrust t;
+
+		// exercise
+		t.setBits(THRUST_BIT_MAIN | THRUST_BIT_CLOCK | THRUST_BIT_COUNTER);
+
+		// verify
+		assertUnit(t.mainEngine == true);
+		assertUnit(t.clockwise == true);
+		assertUnit(t.counterClockwise == true);
+	}  // teardown
+
+	/*********************************************
+	 * name:    GET BITS SOME
+	 * input:   mainEngine=true clockwise=false counterClockwise=true
+	 * output:  MAIN|COUNTER
+	 *********************************************/
+	void getBits_some()
+	{  // setup
+		Thrust t;
+		t.mainEngine = true;
+		t.clockwise = false;
+		t.counterClockwise = true;
+		unsigned char bits = 0xff;
+
+		// exercise
+		bits = t.getBits();
+
+		// verify
+		assertUnit(bits == (THRUST_BIT_MAIN | THRUST_BIT_COUNTER));
+	}  // teardown
+
 };
 
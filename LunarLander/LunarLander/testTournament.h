@@ -0,0 +1,264 @@
+/***********************************************************************
+ * Header File:
+ *    TEST TOURNAMENT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for plugin controllers and the tournament
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "tournament.h"
+#include "ground.h"
+#include "lander.h"
+#include <cstdlib>
+#include <unistd.h>
+#include <signal.h>
+
+/*******************************
+ * TEST PLUGINS
+ * Linked in, so the tests need no shared objects
+ ********************************/
+namespace testPlugins
+{
+   static lander_plugin_state seen;
+   static int created = 0;
+   static int destroyed = 0;
+
+   static void* create(uint32_t)   { created++; return &created; }
+   static void destroy(void*)      { destroyed++; }
+   static uint8_t freeFall(void*, const lander_plugin_state*) { return 0; }
+   static uint8_t burner(void*, const lander_plugin_state*)   { return LANDER_THRUST_MAIN; }
+   static uint8_t watch(void* context, const lander_plugin_state* state)
+   {
+      seen = *state;
+      return context == &created ? 0xff : 0;
+   }
+   static uint8_t slow(void*, const lander_plugin_state*)
+   {
+      usleep(3000);
+      return LANDER_THRUST_MAIN;
+   }
+   static uint8_t crash(void*, const lander_plugin_state*)  { abort(); }
+   static uint8_t hang(void*, const lander_plugin_state*)
+   {
+      for (;;)
+         pause();
+   }
+
+   static const lander_plugin_api freeFallApi = { LANDER_PLUGIN_ABI, "free fall", NULL, freeFall, NULL };
+   static const lander_plugin_api burnerApi   = { LANDER_PLUGIN_ABI, "burner", NULL, burner, NULL };
+   static const lander_plugin_api watchApi    = { LANDER_PLUGIN_ABI, "watch", create, watch, destroy };
+   static const lander_plugin_api slowApi     = { LANDER_PLUGIN_ABI, "slow", NULL, slow, NULL };
+   static const lander_plugin_api crashApi    = { LANDER_PLUGIN_ABI, "crash", NULL, crash, NULL };
+   static const lander_plugin_api hangApi     = { LANDER_PLUGIN_ABI, "hang", NULL, hang, NULL };
+   static const lander_plugin_api oldApi      = { LANDER_PLUGIN_ABI + 1, "old", NULL, freeFall, NULL };
+   static const lander_plugin_api emptyApi    = { LANDER_PLUGIN_ABI, "empty", NULL, NULL, NULL };
+}
+
+/*******************************
+ * TEST TOURNAMENT
+ * A friend class for Tournament and PluginController which contains
+ * their unit tests
+ ********************************/
+class TestTournament : public UnitTest
+{
+public:
+	void run()
+	{
+		// plugin controller
+		attach_rejectsBadTable();
+		load_missingFile();
+		decide_seesState();
+		decide_overBudget();
+
+		// tournament
+		run_ranksEntries();
+		run_crashedEntry();
+		run_hungEntry();
+
+		report("Tournament");
+	}
+
+private:
+	/*********************************************
+	 * name:    ATTACH REJECTS BAD TABLE
+	 * input:   a table from another ABI, one without decide(), NULL
+	 * output:  all refused with a reason
+	 *********************************************/
+	void attach_rejectsBadTable()
+	{  // setup
+		PluginController pilot;
+
+		// exercise
+		bool old = pilot.attach(&testPlugins::oldApi);
+		std::string oldError = pilot.getError();
+		bool empty = pilot.attach(&testPlugins::emptyApi);
+		bool none = pilot.attach(nullptr);
+		bool good = pilot.attach(&testPlugins::freeFallApi);
+
+		// verify
+		assertUnit(!old);
+		assertUnit(oldError.find("ABI") != std::string::npos);
+		assertUnit(!empty);
+		assertUnit(!none);
+		assertUnit(good);
+		assertUnit(pilot.getError().empty());
+		assertUnit(pilot.getName() == "free fall");
+		assertUnit(pilot.getId() == CONTROLLER_PLUGIN);
+	}  // teardown
+
+	/*********************************************
+	 * name:    LOAD MISSING FILE
+	 * input:   a path with nothing there
+	 * output:  refused, the controller never thrusts
+	 *********************************************/
+	void load_missingFile()
+	{  // setup
+		PluginController pilot;
+		Lander lander(Position(800.0, 600.0));
+		Ground ground(Position(800.0, 600.0));
+
+		// exercise
+		bool loaded = pilot.load("/nonexistent/plugin.so");
+
+		// verify
+		assertUnit(!loaded);
+		assertUnit(!pilot.getError().empty());
+		assertUnit(pilot.handle == nullptr);
+		assertUnit(pilot.decide(lander, ground) == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    DECIDE SEES STATE
+	 * input:   two decisions on a fresh mission with its own context
+	 * output:  the plugin sees the lander and pad, only thrust bits
+	 *          come back, and its context lives for the mission
+	 *********************************************/
+	void decide_seesState()
+	{  // setup
+		PluginController pilot;
+		pilot.attach(&testPlugins::watchApi);
+		Lander lander(Position(800.0, 600.0));
+		Ground ground(Position(800.0, 600.0));
+		lander.pos = Position(123.0, 456.0);
+		int created = testPlugins::created;
+		int destroyed = testPlugins::destroyed;
+
+		// exercise
+		pilot.start(7);
+		pilot.decide(lander, ground);
+		unsigned char bits = pilot.decide(lander, ground);
+		pilot.finish();
+
+		// verify
+		assertUnit(bits == (LANDER_THRUST_MAIN | LANDER_THRUST_CLOCK | LANDER_THRUST_COUNTER));
+		assertEquals(testPlugins::seen.lander.x, 123.0);
+		assertEquals(testPlugins::seen.lander.y, 456.0);
+		assertEquals(testPlugins::seen.padX, ground.getPlatformPosition().getX());
+		assertEquals(testPlugins::seen.padWidth, ground.getPlatformWidth());
+		assertUnit(testPlugins::seen.frame == 1);
+		assertUnit(pilot.getCounters().calls == 2);
+		assertUnit(pilot.getCounters().overruns == 0);
+		assertUnit(testPlugins::created == created + 1);
+		assertUnit(testPlugins::destroyed == destroyed + 1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    DECIDE OVER BUDGET
+	 * input:   a plugin that takes 3 ms, a 1 ms budget
+	 * output:  no thrust, one overrun, the time still counted
+	 *********************************************/
+	void decide_overBudget()
+	{  // setup
+		PluginController pilot;
+		pilot.attach(&testPlugins::slowApi);
+		pilot.setBudget(1000000);
+		Lander lander(Position(800.0, 600.0));
+		Ground ground(Position(800.0, 600.0));
+
+		// exercise
+		unsigned char bits = pilot.decide(lander, ground);
+
+		// verify
+		assertUnit(bits == 0);
+		assertUnit(pilot.getCounters().calls == 1);
+		assertUnit(pilot.getCounters().overruns == 1);
+		assertUnit(pilot.getCounters().maxNanos >= 3000000);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN RANKS ENTRIES
+	 * input:   a bad table, a burner and a free fall over 3 missions
+	 * output:  neither lands, so the one with fuel left wins, and
+	 *          the entry that never loaded comes last
+	 *********************************************/
+	void run_ranksEntries()
+	{  // setup
+		Tournament t(1, 3);
+		t.addLinked(&testPlugins::oldApi);
+		t.addLinked(&testPlugins::burnerApi);
+		t.addLinked(&testPlugins::freeFallApi);
+
+		// exercise
+		t.run(2);
+
+		// verify
+		assertUnit(t.getResult(0).status == ENTRY_BAD_PLUGIN);
+		assertUnit(t.getResult(1).status == ENTRY_DONE);
+		assertUnit(t.getResult(2).status == ENTRY_DONE);
+		assertUnit(t.getResult(2).stats.missions == 3);
+		assertUnit(t.getResult(2).stats.crashed == 3);
+		assertUnit(std::string(t.getResult(2).name) == "free fall");
+		assertUnit(t.getResult(2).counters.calls > 0);
+		std::vector<int> order = t.ranking();
+		assertUnit(order.size() == 3);
+		assertUnit(order[0] == 2);
+		assertUnit(order[1] == 1);
+		assertUnit(order[2] == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN CRASHED ENTRY
+	 * input:   a plugin that aborts, next to a good one
+	 * output:  its entry is marked crashed with the signal, the
+	 *          other finishes
+	 *********************************************/
+	void run_crashedEntry()
+	{  // setup
+		Tournament t(1, 2);
+		t.addLinked(&testPlugins::crashApi);
+		t.addLinked(&testPlugins::freeFallApi);
+
+		// exercise
+		t.run(2);
+
+		// verify
+		assertUnit(t.getResult(0).status == ENTRY_CRASHED);
+		assertUnit(t.getResult(0).signal == SIGABRT);
+		assertUnit(t.getResult(1).status == ENTRY_DONE);
+		assertUnit(t.ranking()[0] == 1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    RUN HUNG ENTRY
+	 * input:   a plugin that never answers, a 0.2 s deadline
+	 * output:  its worker is killed and the entry timed out
+	 *********************************************/
+	void run_hungEntry()
+	{  // setup
+		Tournament t(1, 1);
+		t.setDeadline(0.2);
+		t.addLinked(&testPlugins::hangApi);
+		t.addLinked(&testPlugins::freeFallApi);
+
+		// exercise
+		t.run(1);
+
+		// verify
+		assertUnit(t.getResult(0).status == ENTRY_TIMED_OUT);
+		assertUnit(t.getResult(1).status == ENTRY_DONE);
+	}  // teardown
+};
@@ -0,0 +1,306 @@
+/***********************************************************************
+ * Header File:
+ *    TEST TRAJECTORY ARCHIVE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for the compressed TRAJECTORY ARCHIVE
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "trajectoryArchive.h"
+#include "batchRunner.h"
+#include "controller.h"
+#include "mission.h"
+#include "thrust.h"
+#include <cmath>
+#include <cstdlib>   // for mkdtemp, system
+#include <unistd.h>  // for truncate
+#include <string>
+
+/*******************************
+ * TEST TRAJECTORY ARCHIVE
+ * A friend class for TrajectoryArchive which contains its unit tests
+ ********************************/
+class TestTrajectoryArchive : public UnitTest
+{
+public:
+	void run()
+	{
+		char pattern[] = "/tmp/trajectoryXXXXXX";
+		if (!mkdtemp(pattern))
+			return;
+		directory = pattern;
+
+		// encoding
+		append_roundTrip();
+		append_compressesMission();
+
+		// reading
+		readAll_matchesRead();
+		open_truncated();
+		decodeBlock_corrupt();
+
+		// batch
+		batch_archivesEveryMission();
+
+		std::string cleanup = "rm -rf " + directory;
+		if (system(cleanup.c_str()) != 0)
+			std::cerr << "could not remove " << directory << "\n";
+
+		report("TrajectoryArchive");
+	}
+
+private:
+	std::string directory;
+
+	/*********************************************
+	 * SAMPLE
+	 * frames of a made-up flight: a burn every
+	 * other frame, spinning through the wrap of
+	 * the angle, and a jump at frame 300
+	 *********************************************/
+	static std::vector<TrajectoryFrame> sample(int frames, double start)
+	{
+		std::vector<TrajectoryFrame> trajectory;
+		for (int i = 0; i < frames; i++)
+		{
+			double t = i * 0.1;
+			TrajectoryFrame frame;
+			frame.x = start + 10.0 * t + (i >= 300 ? 50.0 : 0.0);
+			frame.y = 400.0 - 0.81 * t * t;
+			frame.dx = 10.0 + 0.001 * i;
+			frame.dy = -1.62 * t;
+			frame.angle = remainder(0.05 * i, 2.0 * M_PI);
+			frame.fuel = 2000.0 - 2.2 * (i / 2);
+			frame.thrust = (i % 2 ? THRUST_BIT_MAIN : 0) | (i % 7 == 0 ? THRUST_BIT_CLOCK : 0);
+			trajectory.push_back(frame);
+		}
+		return trajectory;
+	}
+
+	/*********************************************
+	 * NEAR
+	 * Within half a quantization step (and a hair
+	 * for rounding), thrust exact
+	 *********************************************/
+	static bool near(const TrajectoryFrame& a, const TrajectoryFrame& b)
+	{
+		const double half = 0.0005 + 1e-9;
+		return fabs(a.x - b.x) <= half && fabs(a.y - b.y) <= half &&
+		       fabs(a.dx - b.dx) <= half && fabs(a.dy - b.dy) <= half &&
+		       fabs(a.angle - b.angle) <= half / 10.0 && fabs(a.fuel - b.fuel) <= half &&
+		       a.thrust == b.thrust;
+	}
+
+	/*********************************************
+	 * name:    APPEND ROUND TRIP
+	 * input:   600, 1 and 0 frames
+	 * output:  every frame back to within its step
+	 *********************************************/
+	void append_roundTrip()
+	{  // setup
+		std::string path = directory + "/roundTrip";
+		std::vector<TrajectoryFrame> flight = sample(600, 100.0);
+		std::vector<TrajectoryFrame> single = sample(1, -3.0);
+		TrajectoryArchiveWriter writer;
+		TrajectoryArchive archive;
+		std::vector<TrajectoryFrame> frames;
+		std::vector<TrajectoryFrame> one;
+		std::vector<TrajectoryFrame> none;
+
+		// exercise
+		bool opened = writer.open(path);
+		writer.append(7, CONTROLLER_SIMPLE, flight);
+		writer.append(8, CONTROLLER_NONE, single);
+		writer.append(9, CONTROLLER_SIMPLE, std::vector<TrajectoryFrame>());
+		bool closed = writer.close();
+		bool read = archive.open(path) && archive.read(0, frames) &&
+		            archive.read(1, one) && archive.read(2, none);
+
+		// verify
+		assertUnit(opened && closed && read);
+		assertUnit(writer.getCount() == 3);
+		assertUnit(writer.getFrames() == 601);
+		assertUnit(archive.getCount() == 3);
+		assertUnit(archive.getBlocks() == 4);
+		assertUnit(archive.getTrajectory(0).seed == 7);
+		assertUnit(archive.getTrajectory(1).controller == CONTROLLER_NONE);
+		assertUnit(frames.size() == flight.size());
+		bool all = true;
+		for (size_t i = 0; i < frames.size() && i < flight.size(); i++)
+			all = all && near(frames[i], flight[i]);
+		assertUnit(all);
+		assertUnit(one.size() == 1 && near(one[0], single[0]));
+		assertUnit(none.empty());
+	}  // teardown
+
+	/*********************************************
+	 * name:    APPEND COMPRESSES MISSION
+	 * input:   a real flight on the simple autopilot
+	 * output:  more than ten times smaller than raw
+	 *********************************************/
+	void append_compressesMission()
+	{  // setup
+		std::unique_ptr<Controller> pilot = createController(CONTROLLER_SIMPLE);
+		std::vector<TrajectoryFrame> flight;
+		MissionResult result = runMission(21, *pilot, &flight);
+		std::vector<uint8_t> encoded;
+
+		// exercise
+		TrajectoryArchiveWriter::encode(21, CONTROLLER_SIMPLE, flight, encoded);
+
+		// verify
+		assertUnit(flight.size() == static_cast<size_t>(result.frames) + 1);
+		assertUnit(flight.back().thrust == 0);
+		assertUnit(encoded.size() * 10 < flight.size() * TRAJECTORY_RAW_BYTES);
+	}  // teardown
+
+	/*********************************************
+	 * name:    READ ALL MATCHES READ
+	 * input:   three flights decoded on three threads
+	 * output:  end to end, the same as one at a time
+	 *********************************************/
+	void readAll_matchesRead()
+	{  // setup
+		std::string path = directory + "/readAll";
+		TrajectoryArchiveWriter writer;
+		writer.open(path);
+		writer.append(1, CONTROLLER_SIMPLE, sample(700, 0.0));
+		writer.append(2, CONTROLLER_SIMPLE, sample(40, 5.0));
+		writer.append(3, CONTROLLER_SIMPLE, sample(257, 9.0));
+		writer.close();
+		TrajectoryArchive archive;
+		archive.open(path);
+		std::vector<TrajectoryFrame> all;
+
+		// exercise
+		bool ok = archive.readAll(all, 3);
+
+		// verify
+		assertUnit(ok);
+		assertUnit(all.size() == 997);
+		assertUnit(archive.getFrames() == 997);
+		bool same = true;
+		for (size_t t = 0; t < archive.getCount(); t++)
+		{
+			std::vector<TrajectoryFrame> frames;
+			same = same && archive.read(t, frames);
+			for (size_t i = 0; i < frames.size(); i++)
+			{
+				const TrajectoryFrame& a = frames[i];
+				const TrajectoryFrame& b = all[archive.getTrajectory(t).firstFrame + i];
+				same = same && a.x == b.x && a.dy == b.dy && a.fuel == b.fuel &&
+				       a.thrust == b.thrust;
+			}
+		}
+		assertUnit(same);
+	}  // teardown
+
+	/*********************************************
+	 * name:    OPEN TRUNCATED
+	 * input:   an archive cut off inside its second
+	 *          record, and a file that is no archive
+	 * output:  the first record only; refused
+	 *********************************************/
+	void open_truncated()
+	{  // setup
+		std::string path = directory + "/truncated";
+		std::string other = directory + "/other";
+		TrajectoryArchiveWriter writer;
+		writer.open(path);
+		writer.append(1, CONTROLLER_SIMPLE, sample(300, 0.0));
+		uint64_t first = writer.getBytes();
+		writer.append(2, CONTROLLER_SIMPLE, sample(300, 0.0));
+		writer.close();
+		FILE* file = fopen(other.c_str(), "wb");
+		fputs("definitely not trajectories", file);
+		fclose(file);
+		TrajectoryArchive archive;
+		TrajectoryArchive notArchive;
+
+		// exercise
+		bool cut = truncate(path.c_str(), first + 40) == 0;
+		bool opened = archive.open(path);
+		bool openedOther = notArchive.open(other);
+
+		// verify
+		assertUnit(cut && opened);
+		assertUnit(archive.getCount() == 1);
+		assertUnit(archive.getTrajectory(0).seed == 1);
+		assertUnit(!openedOther);
+	}  // teardown
+
+	/*********************************************
+	 * name:    DECODE BLOCK CORRUPT
+	 * input:   a block with a group width past any
+	 *          error, and with its bytes cut short
+	 * output:  refused either way
+	 *********************************************/
+	void decodeBlock_corrupt()
+	{  // setup
+		std::string path = directory + "/corrupt";
+		TrajectoryArchiveWriter writer;
+		writer.open(path);
+		writer.append(1, CONTROLLER_SIMPLE, sample(100, 0.0));
+		writer.close();
+		TrajectoryArchive archive;
+		archive.open(path);
+		std::vector<TrajectoryFrame> frames(100);
+		bool good = archive.decodeBlock(0, frames.data());
+
+		// exercise
+		TrajectoryArchive::Block block = archive.blocks[0];
+		std::vector<uint8_t> copy(archive.data, archive.data + archive.size);
+		const uint8_t* mapped = archive.data;
+		archive.data = copy.data();
+		copy[block.offset + 1] = 60;                 // the thrust's first group
+		bool wide = archive.decodeBlock(0, frames.data());
+		copy[block.offset + 1] = mapped[block.offset + 1];
+		archive.blocks[0].bytes -= 3;
+		bool cutShort = archive.decodeBlock(0, frames.data());
+		archive.blocks[0] = block;
+		archive.data = mapped;
+
+		// verify
+		assertUnit(good);
+		assertUnit(!wide);
+		assertUnit(!cutShort);
+	}  // teardown
+
+	/*********************************************
+	 * name:    BATCH ARCHIVES EVERY MISSION
+	 * input:   120 missions over two workers
+	 * output:  one trajectory per mission, a frame
+	 *          more than the mission flew
+	 *********************************************/
+	void batch_archivesEveryMission()
+	{  // setup
+		std::string path = directory + "/batch";
+		TrajectoryArchiveWriter writer;
+		writer.open(path);
+		BatchRunner runner(800, 120, CONTROLLER_SIMPLE);
+		runner.setChunkSize(32);
+		runner.setPinning(false);
+		runner.setTrajectoryArchive(&writer);
+		MissionStats stats;
+
+		// exercise
+		bool complete = runner.runSharded(2, stats);
+		bool closed = writer.close();
+
+		// verify
+		TrajectoryArchive archive;
+		assertUnit(complete && closed);
+		assertUnit(archive.open(path));
+		assertUnit(archive.getCount() == 120);
+		assertUnit(archive.getFrames() == static_cast<uint64_t>(stats.frames) + 120);
+		assertUnit(archive.getBytes() == writer.getBytes());
+		uint64_t seeds = 0;
+		for (size_t i = 0; i < archive.getCount(); i++)
+			seeds += archive.getTrajectory(i).seed;
+		assertUnit(seeds == 120 * 800 + 119 * 120 / 2);
+	}  // teardown
+};
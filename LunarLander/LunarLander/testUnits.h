@@ -0,0 +1,144 @@
+/***********************************************************************
+ * Header File:
+ *    TEST UNITS
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for UNITS
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "units.h"
+#include "lander.h"
+
+// Mixing units must not compile
+template <class A, class B>
+constexpr bool canAdd = requires(A a, B b) { a + b; };
+static_assert(canAdd<Meters, Meters>, "meters add to meters");
+static_assert(!canAdd<Meters, Seconds>, "meters do not add to seconds");
+static_assert(!canAdd<Kilograms, KilogramsPerSecond>, "a mass is not a flow");
+static_assert(!std::is_convertible<double, Meters>::value, "a double is not meters");
+static_assert(!std::is_convertible<Meters, double>::value, "meters are not a double");
+
+/*******************************
+ * TEST UNITS
+ * Contains the Quantity unit tests
+ ********************************/
+class TestUnits : public UnitTest
+{
+public:
+	void run()
+	{
+		// quantities
+		literal_pounds();
+		multiply_combinesUnits();
+		divide_sameUnitsIsRatio();
+
+		// the lander's fuel
+		lander_fullLoad();
+		lander_burnPerFrame();
+
+		report("Units");
+	}
+
+private:
+	/*********************************************
+	 * name:    LITERAL POUNDS
+	 * input:   5000.0_lb, worked out by the compiler
+	 * output:  2267.96185 kg and back to 5000 lbs
+	 *********************************************/
+	void literal_pounds()
+	{  // setup
+		constexpr Kilograms load = 5000.0_lb;
+		static_assert(load.value() > 2267.96 && load.value() < 2267.97, "at compile time");
+
+		// exercise
+		double lbs = toPounds(load);
+
+		// verify
+		assertEquals(load.value(), 2267.96185);
+		assertEquals(lbs, 5000.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    MULTIPLY COMBINES UNITS
+	 * input:   3 m/s^2 for 2 s, 22.046 kg/s for 0.1 s
+	 * output:  6 m/s, 2.2046 kg
+	 *********************************************/
+	void multiply_combinesUnits()
+	{  // setup
+		MetersPerSecond2 a = 3.0_mps2;
+		KilogramsPerSecond flow = 22.046_kgps;
+
+		// exercise
+		MetersPerSecond v = a * 2.0_s;
+		Kilograms burned = flow * 0.1_s;
+
+		// verify
+		assertEquals(v.value(), 6.0);
+		assertEquals(burned.value(), 2.2046);
+	}  // teardown
+
+	/*********************************************
+	 * name:    DIVIDE SAME UNITS IS RATIO
+	 * input:   45000 N / 15103 kg, 50 kg / 200 kg
+	 * output:  2.98 m/s^2 as Thrust has it, 0.25
+	 *********************************************/
+	void divide_sameUnitsIsRatio()
+	{  // setup
+		Newtons force = 45000.0_N;
+		Kilograms mass = 15103.0_kg;
+
+		// exercise
+		MetersPerSecond2 a = force / mass;
+		Ratio r = 50.0_kg / 200.0_kg;
+
+		// verify
+		assertEquals(a.value(), Thrust::MAIN_ENGINE.value());
+		assertEquals(a.value(), 2.97954);
+		assertEquals(r.value(), 0.25);
+	}  // teardown
+
+	/*********************************************
+	 * name:    LANDER FULL LOAD
+	 * input:   a new lander
+	 * output:  5000 lbs on board, 100% of capacity
+	 *********************************************/
+	void lander_fullLoad()
+	{  // setup
+		Lander l(Position(800.0, 600.0));
+
+		// exercise
+		Kilograms fuel = l.getFuelMass();
+
+		// verify
+		assertUnit(fuel == Lander::FUEL_CAPACITY);
+		assertEquals(toPounds(fuel), 5000.0);
+		assertEquals(l.getFuelPercentage(), 100.0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    LANDER BURN PER FRAME
+	 * input:   one frame of main engine
+	 * output:  fuel down by the rate times the frame time
+	 *********************************************/
+	void lander_burnPerFrame()
+	{  // setup
+		Lander l(Position(800.0, 600.0));
+		Thrust thrust;
+		thrust.setBits(THRUST_BIT_MAIN);
+		Kilograms before = l.getFuelMass();
+
+		// exercise
+		l.input(thrust, -1.625);
+
+		// verify
+		Kilograms burned = before - l.getFuelMass();
+		assertEquals(burned.value(),
+		             (Lander::FUEL_CONSUMPTION_MAIN * Lander::FRAME_TIME).value());
+		assertEquals(l.getFuelPercentage(),
+		             100.0 * (1.0 - burned.value() / Lander::FUEL_CAPACITY.value()));
+	}  // teardown
+};
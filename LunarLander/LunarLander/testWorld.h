@@ -0,0 +1,358 @@
+/***********************************************************************
+ * Header File:
+ *    TEST WORLD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    All the unit tests for WORLD and the C interface on top of it
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "world.h"
+#include "landerApi.h"
+
+/*******************************
+ * TEST WORLD
+ * A friend class for World which contains the World unit tests
+ ********************************/
+class TestWorld : public UnitTest
+{
+public:
+	void run()
+	{
+		// constructor
+		construct_size();
+		construct_sameSeed();
+
+		// step
+		step_noThrust();
+		step_untilDown();
+
+		// swarm
+		swarm_collisionsOffByDefault();
+		swarm_headOnCollision();
+		swarm_spreadOutNeighbors();
+
+		// level of detail
+		lod_closedFormCatchUp();
+		lod_promotedBeforeGround();
+		lod_focusIsFullRate();
+
+		// C interface
+		api_badArguments();
+		api_observe();
+		api_stepFrameMajor();
+
+		report("World");
+	}
+
+private:
+
+	/*********************************************
+	 * name:    CONSTRUCT SIZE
+	 * input:   3 landers
+	 * output:  3 landers all flying
+	 *********************************************/
+	void construct_size()
+	{  // setup
+		Position posUpperRight(800.0, 600.0);
+
+		// exercise
+		World w(posUpperRight, 3, 42);
+
+		// verify
+		assertUnit(w.size() == 3);
+		assertUnit(w.numFlying() == 3);
+		assertUnit(w.getFrame() == 0);
+		assertUnit(w.getLander(2).isFlying());
+	}  // teardown
+
+	/*********************************************
+	 * name:    CONSTRUCT SAME SEED
+	 * input:   two worlds with seed 7
+	 * output:  identical landers and terrain
+	 *********************************************/
+	void construct_sameSeed()
+	{  // setup
+		Position posUpperRight(800.0, 600.0);
+
+		// exercise
+		World w1(posUpperRight, 2, 7);
+		World w2(posUpperRight, 2, 7);
+
+		// verify
+		assertUnit(w1.getLander(1).pos == w2.getLander(1).pos);
+		assertEquals(w1.getLander(1).velocity.dx, w2.getLander(1).velocity.dx);
+		assertEquals(w1.getGround().getPlatformWidth(), w2.getGround().getPlatformWidth());
+		assertEquals(w1.getAltitude(0), w2.getAltitude(0));
+	}  // teardown
+
+	/*********************************************
+	 * name:    STEP WITH NO THRUST
+	 * input:   v=(0,0) at (400,500), one frame
+	 * output:  falls under lunar gravity, no fuel used
+	 *********************************************/
+	void step_noThrust()
+	{  // setup
+		World w(Position(800.0, 600.0), 1, 1);
+		Lander& l = w.landers[0];
+		l.pos.x = 400.0;
+		l.pos.y = 500.0;
+		l.velocity.dx = 0.0;
+		l.velocity.dy = 0.0;
+		Kilograms fuel = l.fuel;
+
+		// exercise
+		w.step(nullptr);
+
+		// verify
+		assertEquals(l.velocity.dy, -0.1625);
+		assertEquals(l.pos.y, 500.0 - 0.5 * 1.625 * 0.01);
+		assertEquals(l.fuel.value(), fuel.value());
+		assertUnit(w.getFrame() == 1);
+		assertUnit(w.numFlying() == 1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    STEP UNTIL DOWN
+	 * input:   free fall from the start position
+	 * output:  eventually nobody is flying
+	 *********************************************/
+	void step_untilDown()
+	{  // setup
+		World w(Position(800.0, 600.0), 4, 3);
+
+		// exercise
+		for (int i = 0; i < 10000 && w.numFlying() > 0; i++)
+			w.step(nullptr);
+
+		// verify
+		assertUnit(w.numFlying() == 0);
+		assertUnit(!w.getLander(0).isFlying());
+	}  // teardown
+
+	/*********************************************
+	 * name:    SWARM COLLISIONS OFF BY DEFAULT
+	 * input:   two landers on top of each other, one frame
+	 * output:  both still flying
+	 *********************************************/
+	void swarm_collisionsOffByDefault()
+	{  // setup
+		World w(Position(800.0, 600.0), 2, 1);
+		w.landers[1].pos = w.landers[0].pos;
+
+		// exercise
+		w.step(nullptr);
+
+		// verify
+		assertUnit(w.numFlying() == 2);
+		assertUnit(w.numCollisions() == 0);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SWARM HEAD ON COLLISION
+	 * input:   two landers 30m apart closing at 20 m/s, a third far away
+	 * output:  the pair crashes into each other, the third flies on
+	 *********************************************/
+	void swarm_headOnCollision()
+	{  // setup
+		World w(Position(800.0, 600.0), 3, 1);
+		w.setLanderCollisions(true);
+		for (int i = 0; i < 3; i++)
+		{
+			w.landers[i].pos.y = 500.0;
+			w.landers[i].velocity.dy = 0.0;
+		}
+		w.landers[0].pos.x = 300.0;
+		w.landers[0].velocity.dx = 10.0;
+		w.landers[1].pos.x = 330.0;
+		w.landers[1].velocity.dx = -10.0;
+		w.landers[2].pos.x = 600.0;
+		w.landers[2].velocity.dx = 0.0;
+
+		// exercise
+		for (int i = 0; i < 10; i++)
+			w.step(nullptr);
+
+		// verify
+		assertUnit(w.getLander(0).isDead() && w.getLander(1).isDead());
+		assertUnit(w.getLander(2).isFlying());
+		assertUnit(w.numFlying() == 1);
+		assertUnit(w.numCollisions() == 1);
+		assertUnit(w.getTouchdown(0).other == 1 && w.getTouchdown(1).other == 0);
+		assertEquals(w.getTouchdown(0).speed, 20.0);
+		assertUnit(w.getTouchdown(2).other == -1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    SWARM SPREAD OUT NEIGHBORS
+	 * input:   40 landers spread out, neighbors of lander 0 within 45m
+	 * output:  right and above neighbors, nobody collides the first frame
+	 *********************************************/
+	void swarm_spreadOutNeighbors()
+	{  // setup
+		World w(Position(800.0, 600.0), 40, 9);
+		w.setLanderCollisions(true);
+		w.spreadOut();
+		std::vector<int> near;
+
+		// exercise
+		int n = w.neighbors(0, 45.0, near);
+		w.step(nullptr);
+
+		// verify
+		assertUnit(n == 2 && near.size() == 2);
+		assertUnit(near[0] != 0 && near[1] != 0);
+		assertUnit(w.numCollisions() == 0);
+		assertUnit(w.numFlying() == 40);
+	}  // teardown
+
+	/*********************************************
+	 * name:    LOD CLOSED FORM CATCH UP
+	 * input:   a lander 5000m up, interval 8, 13 frames, then catch up
+	 * output:  exactly the free fall of 13 frames, from reduced rate
+	 *********************************************/
+	void lod_closedFormCatchUp()
+	{  // setup
+		World w(Position(800.0, 600.0), 1, 1);
+		Lander& l = w.landers[0];
+		l.pos.x = 400.0;
+		l.pos.y = 5000.0;
+		l.velocity.dx = 2.0;
+		l.velocity.dy = 0.0;
+		w.setLevelOfDetail(8, 300.0);
+
+		// exercise
+		for (int i = 0; i < 13; i++)
+			w.step(nullptr);
+		bool reduced = !w.isFullRate(0);
+		w.catchUp();
+
+		// verify
+		double t = 1.3;
+		assertUnit(reduced);
+		assertUnit(w.numFullRate() == 0);
+		assertEquals(l.pos.x, 400.0 + 2.0 * t);
+		assertEquals(l.pos.y, 5000.0 - 0.5 * 1.625 * t * t);
+		assertEquals(l.velocity.dy, -1.625 * t);
+	}  // teardown
+
+	/*********************************************
+	 * name:    LOD PROMOTED BEFORE GROUND
+	 * input:   the same free fall with and without interval 10
+	 * output:  back to full rate above 100m, same touchdown
+	 *********************************************/
+	void lod_promotedBeforeGround()
+	{  // setup
+		World full(Position(800.0, 600.0), 1, 4);
+		World lod(Position(800.0, 600.0), 1, 4);
+		lod.setLevelOfDetail(10, 100.0);
+		double promotedAt = -1.0;
+
+		// exercise
+		while (full.numFlying() > 0)
+			full.step(nullptr);
+		while (lod.numFlying() > 0)
+		{
+			lod.step(nullptr);
+			if (promotedAt < 0.0 && lod.isFullRate(0))
+				promotedAt = lod.getAltitude(0);
+		}
+
+		// verify
+		assertUnit(promotedAt >= 100.0);
+		assertUnit(lod.getFrame() == full.getFrame());
+		assertUnit(fabs(lod.getTouchdown(0).speed - full.getTouchdown(0).speed) < 1e-9);
+	}  // teardown
+
+	/*********************************************
+	 * name:    LOD FOCUS IS FULL RATE
+	 * input:   two landers 5000m up, one inside the focus box
+	 * output:  only the one in the box runs at full rate
+	 *********************************************/
+	void lod_focusIsFullRate()
+	{  // setup
+		World w(Position(800.0, 600.0), 2, 1);
+		w.landers[0].pos = Position(100.0, 5000.0);
+		w.landers[1].pos = Position(700.0, 5000.0);
+		w.setLevelOfDetail(4, 300.0);
+		w.setFocus(Position(0.0, 4000.0), Position(400.0, 6000.0));
+
+		// exercise
+		for (int i = 0; i < 8; i++)
+			w.step(nullptr);
+
+		// verify
+		assertUnit(w.isFullRate(0));
+		assertUnit(!w.isFullRate(1));
+		assertUnit(w.numFullRate() == 1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    API BAD ARGUMENTS
+	 * input:   zero landers, NULL worlds
+	 * output:  NULL and -1
+	 *********************************************/
+	void api_badArguments()
+	{  // setup
+		lander_observation obs;
+
+		// exercise and verify
+		assertUnit(lander_world_create(800.0, 600.0, 0, 1) == nullptr);
+		assertUnit(lander_world_size(nullptr) == -1);
+		assertUnit(lander_batch_step(nullptr, nullptr, 1) == -1);
+		assertUnit(lander_batch_observe(nullptr, 0, 1, &obs) == -1);
+	}  // teardown
+
+	/*********************************************
+	 * name:    API OBSERVE
+	 * input:   5 landers, ask for 10 starting at 3
+	 * output:  2 observations matching the landers
+	 *********************************************/
+	void api_observe()
+	{  // setup
+		lander_world* world = lander_world_create(800.0, 600.0, 5, 11);
+		World w(Position(800.0, 600.0), 5, 11);
+		lander_observation obs[10];
+
+		// exercise
+		int32_t n = lander_batch_observe(world, 3, 10, obs);
+
+		// verify
+		assertUnit(n == 2);
+		assertEquals(obs[0].x, w.getLander(3).pos.x);
+		assertEquals(obs[1].dy, w.getLander(4).velocity.dy);
+		assertUnit(obs[1].status == LANDER_STATUS_PLAYING);
+
+		// teardown
+		lander_world_destroy(world);
+	}
+
+	/*********************************************
+	 * name:    API STEP FRAME MAJOR
+	 * input:   2 landers, 2 frames, only lander 1 fires main
+	 * output:  lander 1 burned fuel, lander 0 did not
+	 *********************************************/
+	void api_stepFrameMajor()
+	{  // setup
+		lander_world* world = lander_world_create(800.0, 600.0, 2, 5);
+		uint8_t thrust[4] = { 0, LANDER_THRUST_MAIN, 0, LANDER_THRUST_MAIN };
+		lander_observation before[2];
+		lander_observation after[2];
+		lander_batch_observe(world, 0, 2, before);
+
+		// exercise
+		int32_t flying = lander_batch_step(world, thrust, 2);
+
+		// verify
+		lander_batch_observe(world, 0, 2, after);
+		assertUnit(flying == 2);
+		assertEquals(after[0].fuel, before[0].fuel);
+		assertUnit(after[1].fuel < before[1].fuel);
+
+		// teardown
+		lander_world_destroy(world);
+	}
+};
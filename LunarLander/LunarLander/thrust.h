@@ -10,10 +10,19 @@
 #pragma once
 
 #include "uiInteract.h"  // for Interface
+#include "units.h"
 
 class TestLander;
 class TestThrust;
 
+// Packed thruster bits used by headless drivers (batch, FFI, scripts)
+enum ThrustBits
+{
+   THRUST_BIT_MAIN    = 0x01,   // main engine
+   THRUST_BIT_CLOCK   = 0x02,   // clockwise attitude thruster
+   THRUST_BIT_COUNTER = 0x04    // counter-clockwise attitude thruster
+};
+
 /*****************************************************
  * THRUST
  * Represents activation of thrusters
@@ -25,6 +34,9 @@ class Thrust
    friend TestThrust;
    
    public:
+   // Lab specification: 45,000 N on 15,103 kg, F = ma -> a = F / m = 2.98 m/s²
+   static constexpr MetersPerSecond2 MAIN_ENGINE = Newtons(45000.0) / Kilograms(15103.0);
+
    // Thrust is initially turned off
    Thrust() : mainEngine(false), clockwise(false), counterClockwise(false) {}
    
@@ -39,11 +51,7 @@ class Thrust
    double mainEngineThrust() const
    {
       if (mainEngine)
-      {
-         const double thrust = 45000.00; // Newtons (lab specification)
-         const double mass = 15103.00;   // Kilograms (lab specification)
-         return thrust / mass;        // F = ma -> a = F / m = 2.98 m/s²
-      }
+         return MAIN_ENGINE.value();
       else
          return 0.0; // No thrust
    }
@@ -61,6 +69,22 @@ class Thrust
       clockwise         = pUI->isRight();       // Right arrow = rotate right (lab spec)
    }
    
+   // set the thrusters from packed bits (see ThrustBits)
+   void setBits(unsigned char bits)
+   {
+      mainEngine        = (bits & THRUST_BIT_MAIN)    != 0;
+      clockwise         = (bits & THRUST_BIT_CLOCK)   != 0;
+      counterClockwise  = (bits & THRUST_BIT_COUNTER) != 0;
+   }
+   
+   // get the thrusters as packed bits (see ThrustBits)
+   unsigned char getBits() const
+   {
+      return (mainEngine       ? THRUST_BIT_MAIN    : 0) |
+             (clockwise        ? THRUST_BIT_CLOCK   : 0) |
+             (counterClockwise ? THRUST_BIT_COUNTER : 0);
+   }
+   
    private:
    bool mainEngine;
    bool clockwise;
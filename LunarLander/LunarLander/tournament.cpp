@@ -0,0 +1,240 @@
+/***********************************************************************
+ * Source File:
+ *    TOURNAMENT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Autopilot plugins flown side by side in forked workers
+ ************************************************************************/
+
+#include "tournament.h"
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <unistd.h>
+#include <signal.h>  // for kill
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+
+/*************************************************************************
+ * READ FULLY
+ * False on end of file or error before everything arrived
+ *************************************************************************/
+static bool readFully(int fd, void* buffer, size_t size)
+{
+   char* p = static_cast<char*>(buffer);
+   while (size > 0)
+   {
+      ssize_t n = read(fd, p, size);
+      if (n <= 0)
+         return false;
+      p += n;
+      size -= n;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * BLANK RESULT
+ *************************************************************************/
+static EntryResult blankResult(EntryStatus status, const std::string& error)
+{
+   EntryResult result{};
+   result.status = status;
+   strncpy(result.error, error.c_str(), sizeof(result.error) - 1);
+   return result;
+}
+
+/*************************************************************************
+ * TOURNAMENT : CONSTRUCTOR
+ *************************************************************************/
+Tournament::Tournament(uint32_t firstSeed, uint32_t count) :
+   firstSeed(firstSeed),
+   count(count),
+   budget(1000000),
+   deadline(600.0)
+{
+}
+
+/*************************************************************************
+ * TOURNAMENT : ADD PLUGIN
+ *************************************************************************/
+int Tournament::addPlugin(const std::string& path)
+{
+   entries.push_back(Entry{ path, nullptr });
+   results.push_back(blankResult(ENTRY_PENDING, ""));
+   return size() - 1;
+}
+
+/*************************************************************************
+ * TOURNAMENT : ADD LINKED
+ *************************************************************************/
+int Tournament::addLinked(const lander_plugin_api* api)
+{
+   entries.push_back(Entry{ std::string(), api });
+   results.push_back(blankResult(ENTRY_PENDING, ""));
+   return size() - 1;
+}
+
+/*************************************************************************
+ * TOURNAMENT : EVALUATE
+ * One entry over every mission, in this process
+ *************************************************************************/
+EntryResult Tournament::evaluate(int i) const
+{
+   const Entry& entry = entries[i];
+   PluginController pilot;
+   bool ready = entry.path.empty() ? pilot.attach(entry.api) : pilot.load(entry.path);
+   if (!ready)
+      return blankResult(ENTRY_BAD_PLUGIN, pilot.getError());
+
+   pilot.setBudget(budget);
+   EntryResult result = blankResult(ENTRY_DONE, "");
+   strncpy(result.name, pilot.getName().c_str(), sizeof(result.name) - 1);
+   for (uint32_t n = 0; n < count; n++)
+      result.stats.add(runMission(firstSeed + n, pilot));
+   result.counters = pilot.getCounters();
+   return result;
+}
+
+/*************************************************************************
+ * TOURNAMENT : WORKER MAIN
+ * Runs in the child. Never returns.
+ *************************************************************************/
+void Tournament::workerMain(int writeFd, int i) const
+{
+   EntryResult result = evaluate(i);
+   const char* p = reinterpret_cast<const char*>(&result);
+   for (size_t sent = 0; sent < sizeof(result); )
+   {
+      ssize_t n = write(writeFd, p + sent, sizeof(result) - sent);
+      if (n <= 0)
+         _exit(2);
+      sent += n;
+   }
+   _exit(0);
+}
+
+/*************************************************************************
+ * TOURNAMENT : RUN
+ * Keep numWorkers entries in flight. A worker reports once, at the
+ * end; one that goes quiet past its deadline is killed.
+ *************************************************************************/
+void Tournament::run(int numWorkers)
+{
+   typedef std::chrono::steady_clock Clock;
+   struct Worker
+   {
+      pid_t pid;
+      int entry;
+      Clock::time_point due;
+   };
+
+   if (numWorkers < 1)
+      numWorkers = 1;
+
+   std::map<int, Worker> live;   // by read end of the worker's pipe
+   int next = 0;
+   while (next < size() || !live.empty())
+   {
+      // Keep every worker slot busy
+      while (next < size() && static_cast<int>(live.size()) < numWorkers)
+      {
+         int entry = next++;
+         int fds[2];
+         if (pipe(fds) != 0)
+         {
+            results[entry] = blankResult(ENTRY_CRASHED, "cannot create a pipe");
+            continue;
+         }
+         pid_t pid = fork();
+         if (pid == 0)
+         {
+            close(fds[0]);
+            workerMain(fds[1], entry);
+         }
+         close(fds[1]);
+         if (pid < 0)
+         {
+            close(fds[0]);
+            results[entry] = blankResult(ENTRY_CRASHED, "cannot fork a worker");
+            continue;
+         }
+         auto due = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(deadline));
+         live[fds[0]] = Worker{ pid, entry, due };
+      }
+      if (live.empty())
+         break;
+
+      // Wait for a report, or until the next deadline
+      Clock::time_point soonest = live.begin()->second.due;
+      std::vector<pollfd> pfds;
+      for (auto& worker : live)
+      {
+         pfds.push_back(pollfd{ worker.first, POLLIN, 0 });
+         soonest = std::min(soonest, worker.second.due);
+      }
+      auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(soonest - Clock::now());
+      int timeout = static_cast<int>(std::max<long long>(0, std::min<long long>(wait.count() + 1, 60000)));
+      if (poll(pfds.data(), pfds.size(), timeout) < 0)
+         continue;
+
+      Clock::time_point now = Clock::now();
+      for (const pollfd& pfd : pfds)
+      {
+         Worker worker = live[pfd.fd];
+         bool overdue = now >= worker.due;
+         if (pfd.revents == 0 && !overdue)
+            continue;
+
+         EntryResult& result = results[worker.entry];
+         int status = 0;
+         if (pfd.revents != 0 && readFully(pfd.fd, &result, sizeof(result)))
+            waitpid(worker.pid, &status, 0);
+         else if (pfd.revents != 0)
+         {
+            // End of file without a report: the plugin took the worker down
+            waitpid(worker.pid, &status, 0);
+            result = blankResult(ENTRY_CRASHED, "worker died");
+            result.signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+         }
+         else
+         {
+            kill(worker.pid, SIGKILL);
+            waitpid(worker.pid, &status, 0);
+            result = blankResult(ENTRY_TIMED_OUT, "past the deadline");
+         }
+         close(pfd.fd);
+         live.erase(pfd.fd);
+      }
+   }
+}
+
+/*************************************************************************
+ * TOURNAMENT : RANKING
+ *************************************************************************/
+std::vector<int> Tournament::ranking() const
+{
+   std::vector<int> order(size());
+   for (int i = 0; i < size(); i++)
+      order[i] = i;
+
+   std::stable_sort(order.begin(), order.end(), [this](int a, int b)
+   {
+      const EntryResult& ra = results[a];
+      const EntryResult& rb = results[b];
+      bool doneA = ra.status == ENTRY_DONE;
+      bool doneB = rb.status == ENTRY_DONE;
+      if (doneA != doneB)
+         return doneA;
+      if (ra.stats.landed != rb.stats.landed)
+         return ra.stats.landed > rb.stats.landed;
+      if (ra.stats.fuelMicro != rb.stats.fuelMicro)
+         return ra.stats.fuelMicro > rb.stats.fuelMicro;
+      return ra.counters.totalNanos < rb.counters.totalNanos;
+   });
+   return order;
+}
@@ -0,0 +1,95 @@
+/***********************************************************************
+ * Header File:
+ *    TOURNAMENT
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Many autopilot plugins flown over the same seeded missions, side
+ *    by side. Each entry runs in its own forked worker, so a plugin
+ *    that crashes or hangs takes down only its own entry, and its
+ *    globals cannot leak into anybody else's. Every decision is timed
+ *    against a budget and counted, and the whole entry has a deadline
+ *    after which its worker is killed.
+ ************************************************************************/
+
+#pragma once
+
+#include "mission.h"
+#include "pluginController.h"
+#include <string>
+#include <vector>
+
+// Forward declaration for unit tests
+class TestTournament;
+
+// How an entry's run ended
+enum EntryStatus
+{
+   ENTRY_PENDING   = 0,
+   ENTRY_DONE      = 1,
+   ENTRY_BAD_PLUGIN = 2,   // would not load
+   ENTRY_CRASHED   = 3,    // the worker died
+   ENTRY_TIMED_OUT = 4     // past the deadline, killed
+};
+
+/*****************************************************
+ * ENTRY RESULT
+ * Plain data so it can come back through a pipe
+ *****************************************************/
+struct EntryResult
+{
+   int32_t status;            // EntryStatus
+   int32_t signal;            // that killed the worker, if it crashed
+   MissionStats stats;
+   DecisionCounters counters;
+   char name[64];
+   char error[160];
+};
+
+/*****************************************************
+ * TOURNAMENT
+ *****************************************************/
+class Tournament
+{
+   friend TestTournament;
+
+public:
+   Tournament(uint32_t firstSeed, uint32_t count);
+
+   // Entries, by path to a shared object or linked in. Returns the index.
+   int addPlugin(const std::string& path);
+   int addLinked(const lander_plugin_api* api);
+
+   // Nanoseconds one decision may take (default 1 ms), 0 for no limit
+   void setBudget(int64_t nanoseconds) { budget = nanoseconds; }
+
+   // Seconds an entry may take over all its missions (default 10 min)
+   void setDeadline(double seconds) { deadline = seconds; }
+
+   // Every entry, numWorkers at a time
+   void run(int numWorkers);
+
+   int size() const { return static_cast<int>(entries.size()); }
+   const EntryResult& getResult(int i) const { return results[i]; }
+
+   // Entry indices, best first: most landings, then most fuel left,
+   // then fastest decisions. Entries that did not finish come last.
+   std::vector<int> ranking() const;
+
+private:
+   struct Entry
+   {
+      std::string path;                // empty when linked in
+      const lander_plugin_api* api;
+   };
+
+   uint32_t firstSeed;
+   uint32_t count;
+   int64_t budget;
+   double deadline;
+   std::vector<Entry> entries;
+   std::vector<EntryResult> results;
+
+   EntryResult evaluate(int i) const;
+   void workerMain(int writeFd, int i) const;
+};
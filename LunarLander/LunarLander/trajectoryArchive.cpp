@@ -0,0 +1,511 @@
+/***********************************************************************
+ * Source File:
+ *    TRAJECTORY ARCHIVE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Predicted, bit-packed trajectories in independent blocks
+ ************************************************************************/
+
+#include "trajectoryArchive.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cmath>      // for llround
+#include <cstring>    // for memcpy
+#include <algorithm>  // for std::min
+#include <atomic>
+#include <thread>
+
+// How each channel is predicted from the frames before it
+enum Predictor
+{
+   PREDICT_PREVIOUS,    // the last value
+   PREDICT_LINEAR,      // the last change again
+   PREDICT_BY_THRUST    // the last change under the same thrust
+};
+
+// By TrajectoryChannel: units per stored step, how it is predicted,
+// and where it sits in a frame
+static const double SCALE[NUM_TRAJECTORY_CHANNELS] =
+{
+   1.0, 1000.0, 1000.0, 1000.0, 1000.0, 10000.0, 1000.0
+};
+static const Predictor PREDICTOR[NUM_TRAJECTORY_CHANNELS] =
+{
+   PREDICT_PREVIOUS, PREDICT_LINEAR, PREDICT_LINEAR, PREDICT_BY_THRUST,
+   PREDICT_BY_THRUST, PREDICT_BY_THRUST, PREDICT_BY_THRUST
+};
+static double TrajectoryFrame::* const FIELDS[NUM_TRAJECTORY_CHANNELS] =
+{
+   nullptr, &TrajectoryFrame::x, &TrajectoryFrame::y, &TrajectoryFrame::dx,
+   &TrajectoryFrame::dy, &TrajectoryFrame::angle, &TrajectoryFrame::fuel
+};
+
+// Thrust values a BY_THRUST prediction tells apart
+#define THRUST_CONTEXTS  8
+
+/*************************************************************************
+ * QUANTIZE
+ * To the nearest step, held to 32 bits so a second difference never
+ * needs more than 35
+ *************************************************************************/
+static int64_t quantize(double value, int channel)
+{
+   double steps = value * SCALE[channel];
+   if (!(steps > -2147483647.0))
+      return -2147483647;
+   if (!(steps < 2147483647.0))
+      return 2147483647;
+   return llround(steps);
+}
+
+/*************************************************************************
+ * ZIGZAG
+ * Small magnitudes of either sign to small unsigned numbers
+ *************************************************************************/
+static uint64_t zigzag(int64_t value)
+{
+   return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static uint64_t unzigzag(uint64_t value)
+{
+   return (value >> 1) ^ (0 - (value & 1));
+}
+
+/*************************************************************************
+ * VARINTS
+ * Seven bits a byte, low first, high bit set on all but the last
+ *************************************************************************/
+static void putVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+   while (value >= 0x80)
+   {
+      out.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+   }
+   out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value)
+{
+   value = 0;
+   for (int shift = 0; shift < 64 && p < end; shift += 7)
+   {
+      uint8_t byte = *p++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+         return true;
+   }
+   return false;
+}
+
+/*************************************************************************
+ * PACK GROUPS
+ * Errors in groups, each at the width of its widest
+ *************************************************************************/
+static void packGroups(const int64_t* errors, int n, std::vector<uint8_t>& out)
+{
+   for (int first = 0; first < n; first += TRAJECTORY_GROUP)
+   {
+      int count = std::min(TRAJECTORY_GROUP, n - first);
+      uint64_t zigzagged[TRAJECTORY_GROUP];
+      uint64_t all = 0;
+      for (int i = 0; i < count; i++)
+         all |= zigzagged[i] = zigzag(errors[first + i]);
+      int width = 0;
+      while (width < 64 && (all >> width))
+         width++;
+      out.push_back(static_cast<uint8_t>(width));
+
+      uint64_t pending = 0;
+      int bits = 0;
+      for (int i = 0; i < count; i++)
+      {
+         pending |= zigzagged[i] << bits;
+         bits += width;
+         for (; bits >= 8; bits -= 8, pending >>= 8)
+            out.push_back(static_cast<uint8_t>(pending));
+      }
+      if (bits > 0)
+         out.push_back(static_cast<uint8_t>(pending));
+   }
+}
+
+/*************************************************************************
+ * UNPACK GROUPS
+ * False if the groups run past end or are wider than an error can be
+ *************************************************************************/
+static bool unpackGroups(const uint8_t*& p, const uint8_t* end, int64_t* errors, int n)
+{
+   for (int first = 0; first < n; first += TRAJECTORY_GROUP)
+   {
+      if (p >= end)
+         return false;
+      int width = *p++;
+      int count = std::min(TRAJECTORY_GROUP, n - first);
+      size_t length = (count * width + 7) / 8;
+      if (width > 40 || length > static_cast<size_t>(end - p))
+         return false;
+
+      if (width == 0)
+         std::fill(errors + first, errors + first + count, 0);
+      else
+      {
+         uint64_t mask = ~0ull >> (64 - width);
+         for (int i = 0, bit = 0; i < count; i++, bit += width)
+         {
+            // the padding makes reading a whole word here safe
+            uint64_t word;
+            memcpy(&word, p + (bit >> 3), sizeof(word));
+            errors[first + i] = static_cast<int64_t>(unzigzag((word >> (bit & 7)) & mask));
+         }
+      }
+      p += length;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * ENCODE BLOCK
+ *************************************************************************/
+static void encodeBlock(const TrajectoryFrame* frames, int n, std::vector<uint8_t>& out)
+{
+   int64_t values[TRAJECTORY_BLOCK_FRAMES];
+   int64_t errors[TRAJECTORY_BLOCK_FRAMES];
+   for (int c = 0; c < NUM_TRAJECTORY_CHANNELS; c++)
+   {
+      for (int i = 0; i < n; i++)
+         values[i] = c == TRAJECTORY_THRUST ? frames[i].thrust :
+                                              quantize(frames[i].*FIELDS[c], c);
+      putVarint(out, zigzag(values[0]));
+
+      int first = 1;
+      if (PREDICTOR[c] == PREDICT_PREVIOUS)
+         for (int i = 1; i < n; i++)
+            errors[i] = values[i] - values[i - 1];
+      else if (PREDICTOR[c] == PREDICT_LINEAR)
+      {
+         if (n > 1)
+            putVarint(out, zigzag(values[1] - values[0]));
+         first = 2;
+         for (int i = 2; i < n; i++)
+            errors[i] = values[i] - 2 * values[i - 1] + values[i - 2];
+      }
+      else
+      {
+         int64_t last[THRUST_CONTEXTS] = {};
+         for (int i = 1; i < n; i++)
+         {
+            int64_t change = values[i] - values[i - 1];
+            int64_t& same = last[frames[i - 1].thrust % THRUST_CONTEXTS];
+            errors[i] = change - same;
+            same = change;
+         }
+      }
+      if (n > first)
+         packGroups(errors + first, n - first, out);
+   }
+   out.insert(out.end(), TRAJECTORY_PADDING, 0);
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE WRITER : ENCODE
+ *************************************************************************/
+void TrajectoryArchiveWriter::encode(uint32_t seed, int controller,
+                                     const std::vector<TrajectoryFrame>& trajectory,
+                                     std::vector<uint8_t>& out)
+{
+   TrajectoryRecordHeader header;
+   header.seed = seed;
+   header.controller = controller;
+   header.frames = static_cast<uint32_t>(trajectory.size());
+   header.numBlocks = (header.frames + TRAJECTORY_BLOCK_FRAMES - 1) / TRAJECTORY_BLOCK_FRAMES;
+
+   size_t start = out.size();
+   out.resize(start + sizeof(header) + header.numBlocks * sizeof(uint32_t));
+   memcpy(&out[start], &header, sizeof(header));
+
+   for (uint32_t b = 0; b < header.numBlocks; b++)
+   {
+      size_t blockStart = out.size();
+      size_t first = static_cast<size_t>(b) * TRAJECTORY_BLOCK_FRAMES;
+      encodeBlock(&trajectory[first],
+                  static_cast<int>(std::min<size_t>(TRAJECTORY_BLOCK_FRAMES,
+                                                    trajectory.size() - first)), out);
+      uint32_t blockBytes = static_cast<uint32_t>(out.size() - blockStart);
+      memcpy(&out[start + sizeof(header) + b * sizeof(uint32_t)], &blockBytes,
+             sizeof(blockBytes));
+   }
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE WRITER : OPEN
+ *************************************************************************/
+bool TrajectoryArchiveWriter::open(const std::string& path)
+{
+   close();
+   count = 0;
+   frames = 0;
+   bytes = 0;
+   failed = false;
+
+   file = fopen(path.c_str(), "wb");
+   if (!file)
+      return false;
+
+   TrajectoryArchiveHeader header = { TRAJECTORY_MAGIC, TRAJECTORY_VERSION,
+                                      TRAJECTORY_BLOCK_FRAMES, 0 };
+   failed = fwrite(&header, sizeof(header), 1, file) != 1;
+   bytes = sizeof(header);
+   return !failed;
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE WRITER : APPEND
+ *************************************************************************/
+void TrajectoryArchiveWriter::append(uint32_t seed, int controller,
+                                     const std::vector<TrajectoryFrame>& trajectory)
+{
+   buffer.clear();
+   encode(seed, controller, trajectory, buffer);
+   appendEncoded(buffer.data(), buffer.size());
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE WRITER : APPEND ENCODED
+ * Written as they are; the headers are read only to keep count
+ *************************************************************************/
+void TrajectoryArchiveWriter::appendEncoded(const uint8_t* data, size_t size)
+{
+   if (!file || size == 0)
+      return;
+   if (fwrite(data, 1, size, file) != size)
+      failed = true;
+   bytes += size;
+
+   for (size_t offset = 0; offset + sizeof(TrajectoryRecordHeader) <= size; )
+   {
+      TrajectoryRecordHeader header;
+      memcpy(&header, data + offset, sizeof(header));
+      size_t table = offset + sizeof(header);
+      offset = table + header.numBlocks * sizeof(uint32_t);
+      for (uint32_t b = 0; b < header.numBlocks && table + (b + 1) * sizeof(uint32_t) <= size; b++)
+      {
+         uint32_t blockBytes;
+         memcpy(&blockBytes, data + table + b * sizeof(uint32_t), sizeof(blockBytes));
+         offset += blockBytes;
+      }
+      count++;
+      frames += header.frames;
+   }
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE WRITER : CLOSE
+ *************************************************************************/
+bool TrajectoryArchiveWriter::close()
+{
+   if (!file)
+      return !failed;
+   if (fclose(file) != 0)
+      failed = true;
+   file = nullptr;
+   return !failed;
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE : OPEN
+ * Map the file and walk its records once to find every block
+ *************************************************************************/
+bool TrajectoryArchive::open(const std::string& path)
+{
+   close();
+
+   int fd = ::open(path.c_str(), O_RDONLY);
+   if (fd < 0)
+      return false;
+   struct stat info;
+   void* p = MAP_FAILED;
+   if (fstat(fd, &info) == 0 &&
+       static_cast<size_t>(info.st_size) >= sizeof(TrajectoryArchiveHeader))
+      p = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   ::close(fd);
+   if (p == MAP_FAILED)
+      return false;
+   data = static_cast<const uint8_t*>(p);
+   size = info.st_size;
+
+   TrajectoryArchiveHeader header;
+   memcpy(&header, data, sizeof(header));
+   if (header.magic != TRAJECTORY_MAGIC || header.version != TRAJECTORY_VERSION ||
+       header.blockFrames != TRAJECTORY_BLOCK_FRAMES)
+   {
+      close();
+      return false;
+   }
+
+   size_t offset = sizeof(header);
+   while (offset + sizeof(TrajectoryRecordHeader) <= size)
+   {
+      TrajectoryRecordHeader record;
+      memcpy(&record, data + offset, sizeof(record));
+      size_t table = offset + sizeof(record);
+      if (record.numBlocks != (record.frames + TRAJECTORY_BLOCK_FRAMES - 1) /
+                                 TRAJECTORY_BLOCK_FRAMES ||
+          record.numBlocks > (size - table) / sizeof(uint32_t))
+         break;
+
+      // Every block must be whole before any of the record counts
+      size_t end = table + record.numBlocks * sizeof(uint32_t);
+      std::vector<Block> found;
+      for (uint32_t b = 0; b < record.numBlocks; b++)
+      {
+         uint32_t bytes;
+         memcpy(&bytes, data + table + b * sizeof(uint32_t), sizeof(bytes));
+         if (bytes < TRAJECTORY_PADDING || bytes > size - end)
+            break;
+         uint32_t frames = std::min<uint32_t>(TRAJECTORY_BLOCK_FRAMES,
+                                              record.frames - b * TRAJECTORY_BLOCK_FRAMES);
+         found.push_back(Block{ end, bytes, frames,
+                                totalFrames + b * TRAJECTORY_BLOCK_FRAMES });
+         end += bytes;
+      }
+      if (found.size() != record.numBlocks)
+         break;
+
+      trajectories.push_back(Trajectory{ record.seed, record.controller, record.frames,
+                                         static_cast<uint32_t>(blocks.size()), totalFrames });
+      blocks.insert(blocks.end(), found.begin(), found.end());
+      totalFrames += record.frames;
+      offset = end;
+   }
+   return true;
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE : CLOSE
+ *************************************************************************/
+void TrajectoryArchive::close()
+{
+   if (data)
+      munmap(const_cast<uint8_t*>(data), size);
+   data = nullptr;
+   size = 0;
+   totalFrames = 0;
+   trajectories.clear();
+   blocks.clear();
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE : DECODE BLOCK
+ * Channel by channel: unpack the errors, undo the prediction, scale
+ *************************************************************************/
+bool TrajectoryArchive::decodeBlock(size_t block, TrajectoryFrame* out) const
+{
+   const Block& info = blocks[block];
+   const uint8_t* p = data + info.offset;
+   const uint8_t* end = p + info.bytes - TRAJECTORY_PADDING;
+   int n = static_cast<int>(info.frames);
+   int64_t values[TRAJECTORY_BLOCK_FRAMES];
+   unsigned char thrust[TRAJECTORY_BLOCK_FRAMES];
+
+   for (int c = 0; c < NUM_TRAJECTORY_CHANNELS; c++)
+   {
+      // unsigned arithmetic, so a corrupt block wraps instead of overflowing
+      uint64_t value;
+      if (!getVarint(p, end, value))
+         return false;
+      values[0] = static_cast<int64_t>(unzigzag(value));
+
+      int first = 1;
+      uint64_t change = 0;
+      if (PREDICTOR[c] == PREDICT_LINEAR && n > 1)
+      {
+         if (!getVarint(p, end, change))
+            return false;
+         change = unzigzag(change);
+         values[1] = static_cast<int64_t>(values[0] + change);
+         first = 2;
+      }
+      if (n > first && !unpackGroups(p, end, values + first, n - first))
+         return false;
+
+      // values[i] holds the error until it is replaced by the value
+      if (PREDICTOR[c] == PREDICT_PREVIOUS)
+         for (int i = 1; i < n; i++)
+            values[i] = static_cast<int64_t>(static_cast<uint64_t>(values[i - 1]) + values[i]);
+      else if (PREDICTOR[c] == PREDICT_LINEAR)
+         for (int i = 2; i < n; i++)
+         {
+            change += values[i];
+            values[i] = static_cast<int64_t>(static_cast<uint64_t>(values[i - 1]) + change);
+         }
+      else
+      {
+         uint64_t last[THRUST_CONTEXTS] = {};
+         for (int i = 1; i < n; i++)
+         {
+            uint64_t& same = last[thrust[i - 1] % THRUST_CONTEXTS];
+            same += values[i];
+            values[i] = static_cast<int64_t>(static_cast<uint64_t>(values[i - 1]) + same);
+         }
+      }
+
+      if (c == TRAJECTORY_THRUST)
+         for (int i = 0; i < n; i++)
+            out[i].thrust = thrust[i] = static_cast<unsigned char>(values[i]);
+      else
+      {
+         double step = 1.0 / SCALE[c];
+         double TrajectoryFrame::* field = FIELDS[c];
+         for (int i = 0; i < n; i++)
+            out[i].*field = static_cast<double>(values[i]) * step;
+      }
+   }
+   return p == end;
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE : READ
+ *************************************************************************/
+bool TrajectoryArchive::read(size_t i, std::vector<TrajectoryFrame>& frames) const
+{
+   const Trajectory& trajectory = trajectories[i];
+   frames.resize(trajectory.frames);
+   size_t numBlocks = (trajectory.frames + TRAJECTORY_BLOCK_FRAMES - 1) / TRAJECTORY_BLOCK_FRAMES;
+   for (size_t b = 0; b < numBlocks; b++)
+      if (!decodeBlock(trajectory.firstBlock + b, &frames[b * TRAJECTORY_BLOCK_FRAMES]))
+         return false;
+   return true;
+}
+
+/*************************************************************************
+ * TRAJECTORY ARCHIVE : READ ALL
+ * Threads take a few blocks at a time from a shared counter
+ *************************************************************************/
+bool TrajectoryArchive::readAll(std::vector<TrajectoryFrame>& frames, int numThreads) const
+{
+   frames.resize(totalFrames);
+   std::atomic<size_t> next(0);
+   std::atomic<bool> ok(true);
+   auto work = [&]()
+   {
+      const size_t batch = 16;
+      for (size_t first = next.fetch_add(batch); first < blocks.size();
+           first = next.fetch_add(batch))
+         for (size_t b = first; b < std::min(first + batch, blocks.size()); b++)
+            if (!decodeBlock(b, &frames[blocks[b].frame]))
+               ok = false;
+   };
+
+   std::vector<std::thread> threads;
+   for (int t = 1; t < numThreads; t++)
+      threads.emplace_back(work);
+   work();
+   for (std::thread& thread : threads)
+      thread.join();
+   return ok;
+}
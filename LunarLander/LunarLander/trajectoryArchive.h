@@ -0,0 +1,199 @@
+/***********************************************************************
+ * Header File:
+ *    TRAJECTORY ARCHIVE
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Every frame of every mission of a batch, compressed. Each channel
+ *    (thrust, position, velocity, angle, fuel) is quantized to a fixed
+ *    step and predicted from the frames before it; only the error is
+ *    stored, which is mostly a few bits:
+ *
+ *       thrust                  the previous frame's
+ *       position                straight on: the last change again
+ *       velocity, angle, fuel   the last change made under the same
+ *                               thrust, since the thrust decides them
+ *
+ *    The errors go out in groups of TRAJECTORY_GROUP, bit-packed at the
+ *    width of the widest in the group, so a touchdown or a wrap of the
+ *    angle costs only its own group.
+ *
+ *    A trajectory is cut into blocks of TRAJECTORY_BLOCK_FRAMES frames,
+ *    each starting afresh, so any block decodes on its own and a reader
+ *    can hand blocks to as many threads as it likes.
+ *
+ *    An archive file:
+ *       TrajectoryArchiveHeader
+ *       records, each:
+ *          TrajectoryRecordHeader
+ *          uint32_t blockBytes[numBlocks]
+ *          the blocks
+ *    A record cut short by a crash is ignored, along with anything after.
+ *
+ *    A block, for each channel in TrajectoryChannel order:
+ *       varint  zigzag of the first value
+ *       varint  zigzag of the first change (position, if there is one)
+ *       for each group of up to TRAJECTORY_GROUP errors that follow:
+ *          uint8   width in bits
+ *          the zigzagged errors, width bits each, low bits first
+ *    then TRAJECTORY_PADDING zero bytes so the decoder may read ahead.
+ ************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Forward declaration for unit tests
+class TestTrajectoryArchive;
+
+#define TRAJECTORY_MAGIC          0x41544c4cu   // "LLTA"
+#define TRAJECTORY_VERSION        1u
+#define TRAJECTORY_BLOCK_FRAMES   256
+#define TRAJECTORY_GROUP          32
+#define TRAJECTORY_PADDING        8
+
+// What is kept of each frame, and the quantization step of each. The
+// thrust comes first since the others are predicted from it.
+enum TrajectoryChannel
+{
+   TRAJECTORY_THRUST,   // ThrustBits, exact
+   TRAJECTORY_X,        // 1 mm
+   TRAJECTORY_Y,
+   TRAJECTORY_DX,       // 1 mm/s
+   TRAJECTORY_DY,
+   TRAJECTORY_ANGLE,    // 0.1 mrad
+   TRAJECTORY_FUEL,     // 1 g
+   NUM_TRAJECTORY_CHANNELS
+};
+
+// Bytes a frame takes uncompressed: six doubles and the thrust
+#define TRAJECTORY_RAW_BYTES  (6 * sizeof(double) + 1)
+
+// One frame: the state the controller saw and what it decided
+struct TrajectoryFrame
+{
+   double x;               // meters
+   double y;
+   double dx;              // meters/second
+   double dy;
+   double angle;           // radians
+   double fuel;            // kg
+   unsigned char thrust;   // ThrustBits
+};
+
+// Start of an archive file
+struct TrajectoryArchiveHeader
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t blockFrames;
+   uint32_t reserved;
+};
+
+// Start of every record
+struct TrajectoryRecordHeader
+{
+   uint32_t seed;
+   int32_t  controller;
+   uint32_t frames;
+   uint32_t numBlocks;
+};
+
+/*****************************************************
+ * TRAJECTORY ARCHIVE WRITER
+ *****************************************************/
+class TrajectoryArchiveWriter
+{
+public:
+   TrajectoryArchiveWriter() : file(nullptr), count(0), frames(0), bytes(0), failed(false) {}
+   ~TrajectoryArchiveWriter() { close(); }
+   TrajectoryArchiveWriter(const TrajectoryArchiveWriter&) = delete;
+   TrajectoryArchiveWriter& operator=(const TrajectoryArchiveWriter&) = delete;
+
+   // Starts a new archive, replacing any file already there
+   bool open(const std::string& path);
+   bool close();
+
+   void append(uint32_t seed, int controller, const std::vector<TrajectoryFrame>& trajectory);
+
+   // Records encode() made, perhaps in another process, one after another
+   void appendEncoded(const uint8_t* data, size_t size);
+
+   // One record onto the end of out
+   static void encode(uint32_t seed, int controller,
+                      const std::vector<TrajectoryFrame>& trajectory,
+                      std::vector<uint8_t>& out);
+
+   uint64_t getCount() const { return count; }
+   uint64_t getFrames() const { return frames; }
+   uint64_t getBytes() const { return bytes; }
+
+private:
+   FILE* file;
+   uint64_t count;
+   uint64_t frames;
+   uint64_t bytes;                // written so far, header included
+   bool failed;
+   std::vector<uint8_t> buffer;   // for append()
+};
+
+/*****************************************************
+ * TRAJECTORY ARCHIVE
+ * Read-only, memory-mapped view of an archive
+ *****************************************************/
+class TrajectoryArchive
+{
+   friend TestTrajectoryArchive;
+
+public:
+   struct Trajectory
+   {
+      uint32_t seed;
+      int32_t  controller;
+      uint32_t frames;
+      uint32_t firstBlock;
+      uint64_t firstFrame;   // in readAll()'s output
+   };
+
+   TrajectoryArchive() : data(nullptr), size(0), totalFrames(0) {}
+   ~TrajectoryArchive() { close(); }
+   TrajectoryArchive(const TrajectoryArchive&) = delete;
+   TrajectoryArchive& operator=(const TrajectoryArchive&) = delete;
+
+   bool open(const std::string& path);
+   void close();
+
+   size_t getCount() const { return trajectories.size(); }
+   const Trajectory& getTrajectory(size_t i) const { return trajectories[i]; }
+   uint64_t getFrames() const { return totalFrames; }
+   size_t getBytes() const { return size; }
+   size_t getBlocks() const { return blocks.size(); }
+
+   // One trajectory. False if the archive is corrupt.
+   bool read(size_t i, std::vector<TrajectoryFrame>& frames) const;
+
+   // Every trajectory end to end, blocks shared among numThreads
+   bool readAll(std::vector<TrajectoryFrame>& frames, int numThreads) const;
+
+   // Any block into its frames (out has room for them). Safe from
+   // several threads at once.
+   bool decodeBlock(size_t block, TrajectoryFrame* out) const;
+
+private:
+   struct Block
+   {
+      uint64_t offset;   // in the file
+      uint32_t bytes;
+      uint32_t frames;
+      uint64_t frame;    // first, in readAll()'s output
+   };
+
+   const uint8_t* data;
+   size_t size;
+   uint64_t totalFrames;
+   std::vector<Trajectory> trajectories;
+   std::vector<Block> blocks;
+};
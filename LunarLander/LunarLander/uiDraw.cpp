@@ -40,6 +40,7 @@
 
 #include "position.h"
 #include "uiDraw.h"
+#include "fastMath.h"
 
 using namespace std;
 
@@ -395,8 +396,8 @@ Position ogstream::rotate(const Position& posOrigin,
 	x -= xOffset;
 
 	// because sine and cosine are expensive, we want to call them only once
-	double cosA = cos(rotation);
-	double sinA = sin(rotation);
+	double cosA, sinA;
+	simSincos(rotation, sinA, cosA);
 
 	// start with our original point
 	Position posReturn(posOrigin);
@@ -41,6 +41,7 @@
 
 #include "uiInteract.h"
 #include "position.h"
+#include "arena.h"     // for frameArena()
 
 using namespace std;
 
@@ -107,6 +108,9 @@ void drawCallback()
 
 	// clear the space at the end
 	ui.keyEvent();
+
+	// everything the frame allocated is gone at once
+	frameArena().reset();
 }
 
 /************************************************************************
@@ -116,7 +120,7 @@ void drawCallback()
  *   INPUT   key:   the key we pressed according to the GLUT_KEY_ prefix
  *           x y:   the position in the window, which we ignore
  *************************************************************************/
-void keyDownCallback(int key, int x, int y)
+void keyDownCallback(int key, int /*x*/, int /*y*/)
 {
 	// Even though this is a local variable, all the members are static
 	// so we are actually getting the same version as in the constructor.
@@ -130,7 +134,7 @@ void keyDownCallback(int key, int x, int y)
  *   INPUT   key:   the key we pressed according to the GLUT_KEY_ prefix
  *           x y:   the position in the window, which we ignore
  *************************************************************************/
-void keyUpCallback(int key, int x, int y)
+void keyUpCallback(int key, int /*x*/, int /*y*/)
 {
 	// Even though this is a local variable, all the members are static
 	// so we are actually getting the same version as in the constructor.
@@ -143,7 +147,7 @@ void keyUpCallback(int key, int x, int y)
  * Generic callback to a regular ascii keyboard event, such as
  * the space bar or the letter 'q'
  ***************************************************************/
-void keyboardCallback(unsigned char key, int x, int y)
+void keyboardCallback(unsigned char key, int /*x*/, int /*y*/)
 {
 	// Even though this is a local variable, all the members are static
 	// so we are actually getting the same version as in the constructor.
@@ -0,0 +1,108 @@
+/***********************************************************************
+ * Header File:
+ *    UNITS
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    Physical quantities that know their units. A Quantity is a double
+ *    tagged at compile time with the powers of length, mass, time and
+ *    angle it carries: adding meters to seconds does not compile,
+ *    meters over seconds is a speed, and a mass divided by a mass is a
+ *    plain ratio. Everything is constexpr and the tag has no storage,
+ *    so the generated code is the same as for raw doubles.
+ *
+ *    Values are always held in SI units (meters, kilograms, seconds,
+ *    radians). Other units exist only as literals and conversions,
+ *    worked out by the compiler: 5000.0_lb is a Kilograms.
+ ************************************************************************/
+
+#pragma once
+
+#include <type_traits>
+
+/*****************************************************
+ * QUANTITY
+ * A double in SI units with dimension
+ * length^L mass^M time^T angle^A
+ *****************************************************/
+template <int L, int M, int T, int A>
+class Quantity
+{
+public:
+   constexpr Quantity() : v(0.0) {}
+   constexpr explicit Quantity(double v) : v(v) {}
+
+   // The number, in SI units
+   constexpr double value() const { return v; }
+
+   // Same units only
+   constexpr Quantity operator + (Quantity rhs) const { return Quantity(v + rhs.v); }
+   constexpr Quantity operator - (Quantity rhs) const { return Quantity(v - rhs.v); }
+   constexpr Quantity operator - () const { return Quantity(-v); }
+   Quantity& operator += (Quantity rhs) { v += rhs.v; return *this; }
+   Quantity& operator -= (Quantity rhs) { v -= rhs.v; return *this; }
+   constexpr bool operator <  (Quantity rhs) const { return v <  rhs.v; }
+   constexpr bool operator <= (Quantity rhs) const { return v <= rhs.v; }
+   constexpr bool operator >  (Quantity rhs) const { return v >  rhs.v; }
+   constexpr bool operator >= (Quantity rhs) const { return v >= rhs.v; }
+   constexpr bool operator == (Quantity rhs) const { return v == rhs.v; }
+   constexpr bool operator != (Quantity rhs) const { return v != rhs.v; }
+
+   // Scaling keeps the units
+   constexpr Quantity operator * (double rhs) const { return Quantity(v * rhs); }
+   constexpr Quantity operator / (double rhs) const { return Quantity(v / rhs); }
+   friend constexpr Quantity operator * (double lhs, Quantity rhs) { return Quantity(lhs * rhs.v); }
+
+   // Products and quotients combine them
+   template <int L2, int M2, int T2, int A2>
+   constexpr Quantity<L + L2, M + M2, T + T2, A + A2> operator * (Quantity<L2, M2, T2, A2> rhs) const
+   {
+      return Quantity<L + L2, M + M2, T + T2, A + A2>(v * rhs.value());
+   }
+   template <int L2, int M2, int T2, int A2>
+   constexpr Quantity<L - L2, M - M2, T - T2, A - A2> operator / (Quantity<L2, M2, T2, A2> rhs) const
+   {
+      return Quantity<L - L2, M - M2, T - T2, A - A2>(v / rhs.value());
+   }
+
+private:
+   double v;
+};
+
+typedef Quantity<0, 0, 0, 0>  Ratio;
+typedef Quantity<1, 0, 0, 0>  Meters;
+typedef Quantity<1, 0, -1, 0> MetersPerSecond;
+typedef Quantity<1, 0, -2, 0> MetersPerSecond2;
+typedef Quantity<0, 1, 0, 0>  Kilograms;
+typedef Quantity<0, 1, -1, 0> KilogramsPerSecond;
+typedef Quantity<1, 1, -2, 0> Newtons;
+typedef Quantity<0, 0, 1, 0>  Seconds;
+typedef Quantity<0, 0, 0, 1>  Radians;
+typedef Quantity<0, 0, -1, 1> RadiansPerSecond;
+
+// The wrapper must cost nothing
+static_assert(sizeof(Meters) == sizeof(double), "a quantity is one double");
+static_assert(std::is_trivially_copyable<Meters>::value, "a quantity copies like a double");
+
+// Exact by definition (NIST)
+constexpr double KG_PER_LB = 0.45359237;
+
+/*****************************************************
+ * LITERALS
+ * 2.0_m, 0.1_s, 5000.0_lb, ...
+ *****************************************************/
+constexpr Meters             operator ""_m   (long double x) { return Meters(static_cast<double>(x)); }
+constexpr MetersPerSecond    operator ""_mps (long double x) { return MetersPerSecond(static_cast<double>(x)); }
+constexpr MetersPerSecond2   operator ""_mps2(long double x) { return MetersPerSecond2(static_cast<double>(x)); }
+constexpr Kilograms          operator ""_kg  (long double x) { return Kilograms(static_cast<double>(x)); }
+constexpr Kilograms          operator ""_lb  (long double x) { return Kilograms(static_cast<double>(x) * KG_PER_LB); }
+constexpr KilogramsPerSecond operator ""_kgps(long double x) { return KilogramsPerSecond(static_cast<double>(x)); }
+constexpr Newtons            operator ""_N   (long double x) { return Newtons(static_cast<double>(x)); }
+constexpr Seconds            operator ""_s   (long double x) { return Seconds(static_cast<double>(x)); }
+constexpr Radians            operator ""_rad (long double x) { return Radians(static_cast<double>(x)); }
+
+/*****************************************************
+ * CONVERSIONS
+ * Out of SI, for display
+ *****************************************************/
+constexpr double toPounds(Kilograms mass) { return mass.value() / KG_PER_LB; }
@@ -1,6 +1,7 @@
 #include "velocity.h"
 #include "acceleration.h"
 #include "angle.h"
+#include "fastMath.h"
 #include <math.h>
 
 void Velocity::add(const Acceleration& acceleration, double time)
@@ -16,8 +17,10 @@ double Velocity::getSpeed() const
 
 void Velocity::set(const Angle& angle, double magnitude)
 {
-   dx = magnitude * sin(angle.radians);
-   dy = magnitude * cos(angle.radians);
+   double s, c;
+   simSincos(angle.radians, s, c);
+   dx = magnitude * s;
+   dy = magnitude * c;
 }
 
 bool Velocity::isSafeLandingSpeedTest() const
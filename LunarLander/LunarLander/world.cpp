@@ -0,0 +1,343 @@
+/***********************************************************************
+ * Source File:
+ *    WORLD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A headless simulation world: one lunar surface shared by a batch
+ *    of landers, stepped one frame at a time without any user interface
+ ************************************************************************/
+
+#include "world.h"
+#include "thrust.h"
+#include <cstdlib>  // for srand()
+#include <cmath>    // for atan2, sin, cos
+#include <mutex>    // for std::mutex
+#include <algorithm> // for std::max
+
+// Lab specification physics (same values the game uses)
+const double World::GRAVITY = -1.625;
+const double World::FRAME_TIME = Lander::FRAME_TIME.value();
+
+// Two landers closer than one lander width apart have collided
+static const double LANDER_COLLISION_RADIUS = 20.0;
+
+// Terrain and lander generation draw from the global rand() sequence,
+// so seeding and generating must happen as one step
+static std::mutex generateMutex;
+
+/*************************************************************************
+ * WORLD : CONSTRUCTOR
+ * The ground starts empty so that nothing touches rand() outside the lock
+ *************************************************************************/
+World::World(const Position& posUpperRight, int numLanders, unsigned int seed,
+             const TerrainChoices* choices) :
+   posUpperRight(posUpperRight),
+   ground(Position()),
+   choices(),
+   hasChoices(choices != nullptr),
+   flying(0),
+   frame(0),
+   landerCollisions(false),
+   collisions(0),
+   hash(posUpperRight, LANDER_COLLISION_RADIUS),
+   lodInterval(1),
+   lodAltitude(0.0),
+   hasFocus(false),
+   fullRateCount(0)
+{
+   std::lock_guard<std::mutex> lock(generateMutex);
+
+   if (choices)
+      this->choices = *choices;
+   landers.reserve(numLanders > 0 ? numLanders : 0);
+   for (int i = 0; i < numLanders; i++)
+      landers.push_back(Lander(posUpperRight));
+   touchdowns.resize(landers.size());
+
+   generate(seed);
+}
+
+/*************************************************************************
+ * WORLD : RESET
+ * Same seed, same terrain, same starting conditions
+ *************************************************************************/
+void World::reset(unsigned int seed)
+{
+   std::lock_guard<std::mutex> lock(generateMutex);
+   generate(seed);
+}
+
+/*************************************************************************
+ * WORLD : GENERATE
+ * Caller must hold generateMutex
+ *************************************************************************/
+void World::generate(unsigned int seed)
+{
+   srand(seed);
+
+   ground.reset(posUpperRight, hasChoices ? &choices : nullptr);
+   for (Lander& lander : landers)
+      lander.reset(posUpperRight);
+   touchdowns.assign(landers.size(), Touchdown{ 0.0, 0.0, 0.0, -1 });
+
+   flying = size();
+   frame = 0;
+   collisions = 0;
+   lastStep.assign(landers.size(), 0);
+   fullRate.assign(landers.size(), 1);
+   fullRateCount = size();
+   if (landerCollisions)
+      rebuildHash();
+}
+
+/*************************************************************************
+ * WORLD : STEP
+ * With nobody watching
+ *************************************************************************/
+void World::step(const unsigned char* thrustBits)
+{
+   NoHooks hooks;
+   step(thrustBits, hooks);
+}
+
+/*************************************************************************
+ * WORLD : SET LANDER COLLISIONS
+ *************************************************************************/
+void World::setLanderCollisions(bool on)
+{
+   landerCollisions = on;
+   if (on)
+      rebuildHash();
+}
+
+/*************************************************************************
+ * WORLD : SPREAD OUT
+ * Replace the random starting spots with a grid, keeping each lander's
+ * velocity and fuel. No rand(), so the seed still says it all.
+ *************************************************************************/
+void World::spreadOut()
+{
+   const double spacing = 2.0 * LANDER_COLLISION_RADIUS;
+   double left = posUpperRight.getX() * 0.05;
+   double bottom = posUpperRight.getY() * 0.6;
+   int perRow = std::max(1, static_cast<int>(posUpperRight.getX() * 0.9 / spacing));
+
+   for (int i = 0; i < size(); i++)
+   {
+      landers[i].pos.setX(left + (i % perRow) * spacing);
+      landers[i].pos.setY(bottom + (i / perRow) * spacing);
+   }
+   if (landerCollisions)
+      rebuildHash();
+}
+
+/*************************************************************************
+ * WORLD : PLACE
+ *************************************************************************/
+void World::place(int i, const Position& pos, const Velocity& velocity)
+{
+   landers[i].pos = pos;
+   landers[i].velocity = velocity;
+   if (landerCollisions)
+      rebuildHash();
+}
+
+/*************************************************************************
+ * WORLD : REBUILD HASH
+ * Every lander still in flight, O(n)
+ *************************************************************************/
+void World::rebuildHash()
+{
+   hashX.clear();
+   hashY.clear();
+   hashIds.clear();
+   for (int i = 0; i < size(); i++)
+      if (landers[i].isFlying())
+      {
+         hashX.push_back(landers[i].pos.getX());
+         hashY.push_back(landers[i].pos.getY());
+         hashIds.push_back(i);
+      }
+   hash.rebuild(hashX.data(), hashY.data(), hashIds.data(), static_cast<int>(hashIds.size()));
+}
+
+/*************************************************************************
+ * WORLD : CHECK LANDER COLLISIONS
+ * Both landers of a pair that got too close are lost. The touchdown
+ * records how fast they met and who the other one was.
+ *************************************************************************/
+void World::checkLanderCollisions()
+{
+   rebuildHash();
+
+   int lost = 0;
+   hash.forEachPair(LANDER_COLLISION_RADIUS, [&](int a, int b)
+   {
+      collisions++;
+      double speed = Velocity(landers[a].velocity.getDX() - landers[b].velocity.getDX(),
+                              landers[a].velocity.getDY() - landers[b].velocity.getDY()).getSpeed();
+      for (int i : { a, b })
+      {
+         if (!landers[i].isFlying())
+            continue;
+         double radians = landers[i].getAngle().getRadians();
+         touchdowns[i].speed = speed;
+         touchdowns[i].angle = fabs(atan2(sin(radians), cos(radians)));
+         touchdowns[i].x = landers[i].pos.getX();
+         touchdowns[i].other = (i == a) ? b : a;
+         landers[i].crash();
+         lost++;
+         if (fullRate[i])
+            fullRateCount--;
+      }
+   });
+
+   // Everyone in the hash was flying a moment ago
+   collided.clear();
+   if (lost > 0)
+   {
+      for (int i : hashIds)
+         if (!landers[i].isFlying())
+            collided.push_back(i);
+      flying -= lost;
+      rebuildHash();
+   }
+}
+
+/*************************************************************************
+ * WORLD : SET LEVEL OF DETAIL
+ *************************************************************************/
+void World::setLevelOfDetail(int interval, double nearAltitude)
+{
+   catchUp();
+   lodInterval = interval > 1 ? interval : 1;
+   lodAltitude = nearAltitude;
+   fullRateCount = 0;
+   for (int i = 0; i < size(); i++)
+   {
+      fullRate[i] = landers[i].isFlying() ? 1 : 0;
+      fullRateCount += fullRate[i];
+   }
+}
+
+/*************************************************************************
+ * WORLD : SET FOCUS
+ * Usually what is on screen
+ *************************************************************************/
+void World::setFocus(const Position& lowerLeft, const Position& upperRight)
+{
+   hasFocus = true;
+   focusLowerLeft = lowerLeft;
+   focusUpperRight = upperRight;
+}
+
+/*************************************************************************
+ * WORLD : WANTS FULL RATE
+ * Reduced rate only while, even falling free for two whole intervals
+ * from where it is now, the lander would stay above nearAltitude
+ *************************************************************************/
+bool World::wantsFullRate(int i) const
+{
+   const Lander& lander = landers[i];
+   Position pos = lander.getPosition();
+   if (hasFocus &&
+       pos.getX() >= focusLowerLeft.getX() && pos.getX() <= focusUpperRight.getX() &&
+       pos.getY() >= focusLowerLeft.getY() && pos.getY() <= focusUpperRight.getY())
+      return true;
+
+   double t = 2 * lodInterval * FRAME_TIME;
+   double dy = lander.getVelocity().getDY();
+   double drop = std::max(0.0, -dy * t - 0.5 * GRAVITY * t * t);
+   return getAltitude(i) - drop < lodAltitude;
+}
+
+/*************************************************************************
+ * WORLD : CATCH UP
+ *************************************************************************/
+void World::catchUp()
+{
+   NoHooks hooks;
+   for (int i = 0; i < size(); i++)
+      if (landers[i].isFlying())
+         coastTo(i, frame, hooks);
+}
+
+/*************************************************************************
+ * WORLD : NEIGHBORS
+ *************************************************************************/
+int World::neighbors(int i, double radius, std::vector<int>& out) const
+{
+   size_t before = out.size();
+   if (landerCollisions)
+      hash.query(landers[i].pos.getX(), landers[i].pos.getY(), radius, out);
+   for (size_t j = before; j < out.size(); j++)
+      if (out[j] == i)
+      {
+         out.erase(out.begin() + j);
+         break;
+      }
+   return static_cast<int>(out.size() - before);
+}
+
+/*************************************************************************
+ * WORLD : GET ALTITUDE
+ * Height of a lander above the terrain directly below it
+ *************************************************************************/
+double World::getAltitude(int i) const
+{
+   Position pos = landers[i].getPosition();
+   return pos.getY() - ground.getElevationMeters(pos);
+}
+
+/*************************************************************************
+ * WORLD : OBSERVE
+ * The wire format every external driver sees
+ *************************************************************************/
+int World::observe(int first, int count, lander_observation* out) const
+{
+   if (first < 0 || count < 0 || first > size())
+      return 0;
+   if (count > size() - first)
+      count = size() - first;
+
+   for (int i = 0; i < count; i++)
+   {
+      const Lander& lander = landers[first + i];
+      lander_observation& obs = out[i];
+      obs.x        = lander.pos.getX();
+      obs.y        = lander.pos.getY();
+      obs.dx       = lander.velocity.getDX();
+      obs.dy       = lander.velocity.getDY();
+      obs.angle    = lander.angle.getRadians();
+      obs.fuel     = lander.getFuelMass().value();
+      obs.altitude = getAltitude(first + i);
+      obs.status   = static_cast<int32_t>(lander.status);
+      obs.reserved = 0;
+   }
+   return count;
+}
+
+/*************************************************************************
+ * WORLD : CHECK COLLISION
+ * Lab spec: crash unless on the platform, slow, and upright. Returns
+ * whether the lander touched down.
+ *************************************************************************/
+bool World::checkCollision(int i)
+{
+   Lander& lander = landers[i];
+   Position pos = lander.getPosition();
+   if (pos.getY() > ground.getElevationMeters(pos))
+      return false;
+
+   double radians = lander.getAngle().getRadians();
+   touchdowns[i].speed = lander.getSpeed();
+   touchdowns[i].angle = fabs(atan2(sin(radians), cos(radians)));
+   touchdowns[i].x = pos.getX();
+
+   if (lander.checkSafetyLanding() && ground.onPlatform(pos, lander.getWidth()))
+      lander.land();
+   else
+      lander.crash();
+   return true;
+}
@@ -0,0 +1,234 @@
+/***********************************************************************
+ * Header File:
+ *    WORLD
+ * Author:
+ *    Gary Sibanda
+ * Summary:
+ *    A headless simulation world: one lunar surface shared by a batch
+ *    of landers, stepped one frame at a time without any user interface
+ ************************************************************************/
+
+#pragma once
+
+#include "position.h"
+#include "ground.h"
+#include "lander.h"
+#include "landerApi.h"   // for lander_observation
+#include "spatialHash.h"
+#include "simHooks.h"
+#include <vector>
+
+// Forward declarations for unit tests
+class TestWorld;
+class TestSimHooks;
+
+/*****************************************************
+ * TOUCHDOWN
+ * What a lander was doing the moment it met the ground
+ *****************************************************/
+struct Touchdown
+{
+   double speed;   // m/s
+   double angle;   // radians from upright, before any crash
+   double x;       // meters from the left edge
+   int other;      // the lander it hit in mid-air, -1 for the ground
+};
+
+/*****************************************************
+ * WORLD
+ * A batch of landers over a single terrain. Every
+ * lander follows the same lab physics as the game.
+ *****************************************************/
+class World
+{
+   friend TestWorld;
+   friend TestSimHooks;
+
+public:
+   // Lab specification physics shared with the game
+   static const double GRAVITY;      // m/s^2 (lunar gravity, pointing down)
+   static const double FRAME_TIME;   // seconds per frame
+
+   // Constructor - a new terrain and numLanders landers from a seed.
+   // Any choices given replace what the seed would draw for the terrain,
+   // here and on every reset.
+   World(const Position& posUpperRight, int numLanders, unsigned int seed,
+         const TerrainChoices* choices = nullptr);
+
+   // Generate a new terrain and restart every lander from a seed
+   void reset(unsigned int seed);
+   template <class Hooks>
+   void reset(unsigned int seed, Hooks& hooks);
+
+   // Advance every lander one frame. thrustBits holds one ThrustBits
+   // value per lander, or is NULL for no thrust at all
+   void step(const unsigned char* thrustBits);
+
+   // The same, reporting to a hooks policy (see simHooks.h)
+   template <class Hooks>
+   void step(const unsigned char* thrustBits, Hooks& hooks);
+
+   // Number of landers still in flight
+   int numFlying() const { return flying; }
+
+   // Swarms: landers closer than a lander width crash into each other.
+   // Off by default, so a batch of landers never notices its neighbors.
+   void setLanderCollisions(bool on);
+   int numCollisions() const { return collisions; }
+
+   // Swarms: rows of landers two widths apart, from 60% of the sky upward
+   void spreadOut();
+
+   // Start lander i from here instead of where the seed put it
+   void place(int i, const Position& pos, const Velocity& velocity);
+
+   // Other landers in flight within radius of lander i, as of the last
+   // frame. Only with lander collisions on. Returns how many.
+   int neighbors(int i, double radius, std::vector<int>& out) const;
+
+   // Level of detail: a lander more than nearAltitude above the ground
+   // and outside the focus box only coasts, and is moved every interval
+   // frames in one closed-form jump. Its thrust bits are ignored and its
+   // state lags up to interval - 1 frames. It goes back to full rate
+   // before it could reach nearAltitude, and within an interval of
+   // entering the focus box.
+   // An interval of 1 (the default) steps everyone every frame.
+   void setLevelOfDetail(int interval, double nearAltitude);
+   void setFocus(const Position& lowerLeft, const Position& upperRight);
+   bool isFullRate(int i) const { return fullRate[i] != 0; }
+   int numFullRate() const { return fullRateCount; }
+
+   // Bring every lagging lander up to the current frame
+   void catchUp();
+
+   // Getters
+   int size() const { return static_cast<int>(landers.size()); }
+   const Lander& getLander(int i) const { return landers[i]; }
+   const Ground& getGround() const { return ground; }
+   const Position& getUpperRight() const { return posUpperRight; }
+   double getAltitude(int i) const;
+   long getFrame() const { return frame; }
+   const Touchdown& getTouchdown(int i) const { return touchdowns[i]; }
+
+   // Copy up to count landers starting at first into out. Returns how many.
+   int observe(int first, int count, lander_observation* out) const;
+
+private:
+   Position posUpperRight;        // size of the world
+   Ground ground;                 // the shared lunar surface
+   TerrainChoices choices;        // for every terrain, if hasChoices
+   bool hasChoices;
+   std::vector<Lander> landers;   // every lander in the batch
+   std::vector<Touchdown> touchdowns; // how each lander met the ground
+   int flying;                    // landers still PLAYING
+   long frame;                    // frames since the last reset
+   bool landerCollisions;         // do landers run into each other?
+   int collisions;                // mid-air collisions since the last reset
+   SpatialHash hash;              // landers in flight, by where they are
+   std::vector<double> hashX;     // scratch for rebuilding the hash
+   std::vector<double> hashY;
+   std::vector<int> hashIds;
+   int lodInterval;               // frames between reduced-rate updates
+   double lodAltitude;            // full rate below this altitude
+   bool hasFocus;                 // is there a focus box?
+   Position focusLowerLeft;
+   Position focusUpperRight;
+   std::vector<long> lastStep;    // frame each lander's state is as of
+   std::vector<unsigned char> fullRate;
+   int fullRateCount;
+   std::vector<int> collided;     // lost to lander collisions this frame
+
+   void generate(unsigned int seed);
+   bool checkCollision(int i);
+   void rebuildHash();
+   void checkLanderCollisions();
+   bool wantsFullRate(int i) const;
+   template <class Hooks>
+   void coastTo(int i, long toFrame, Hooks& hooks);
+};
+
+/*************************************************************************
+ * WORLD : RESET
+ *************************************************************************/
+template <class Hooks>
+void World::reset(unsigned int seed, Hooks& hooks)
+{
+   reset(seed);
+   hooks.terrainGenerated(ground);
+}
+
+/*************************************************************************
+ * WORLD : STEP
+ * One frame for every lander still in flight
+ *************************************************************************/
+template <class Hooks>
+void World::step(const unsigned char* thrustBits, Hooks& hooks)
+{
+   Thrust thrust;
+   int stillFlying = 0;
+   int stillFullRate = 0;
+
+   for (int i = 0; i < size(); i++)
+   {
+      Lander& lander = landers[i];
+      if (!lander.isFlying())
+         continue;
+
+      // Reduced rate: nothing at all until its turn comes, one jump every
+      // lodInterval frames, staggered so the work is spread over the frames
+      if (!fullRate[i])
+      {
+         if ((frame + i) % lodInterval == 0)
+         {
+            coastTo(i, frame + 1, hooks);
+            if (checkCollision(i))
+               hooks.contact(lander, touchdowns[i]);
+            fullRate[i] = lander.isFlying() && wantsFullRate(i);
+         }
+         stillFlying += lander.isFlying() ? 1 : 0;
+         stillFullRate += fullRate[i];
+         continue;
+      }
+
+      thrust.setBits(thrustBits ? thrustBits[i] : 0);
+      Acceleration acceleration = lander.input(thrust, GRAVITY, hooks);
+      lander.coast(acceleration, FRAME_TIME, hooks);
+      lastStep[i] = frame + 1;
+      if (checkCollision(i))
+         hooks.contact(lander, touchdowns[i]);
+
+      if (lander.isFlying())
+      {
+         stillFlying++;
+         if (lodInterval > 1 && !wantsFullRate(i))
+            fullRate[i] = 0;
+         else
+            stillFullRate++;
+      }
+   }
+
+   flying = stillFlying;
+   fullRateCount = stillFullRate;
+   if (landerCollisions)
+   {
+      checkLanderCollisions();
+      for (int i : collided)
+         hooks.contact(landers[i], touchdowns[i]);
+   }
+   frame++;
+}
+
+/*************************************************************************
+ * WORLD : COAST TO
+ * Free fall from where the lander was left to toFrame, in one step:
+ * under constant acceleration the closed form is exact
+ *************************************************************************/
+template <class Hooks>
+void World::coastTo(int i, long toFrame, Hooks& hooks)
+{
+   long frames = toFrame - lastStep[i];
+   if (frames <= 0)
+      return;
+   landers[i].coast(Acceleration(0.0, GRAVITY), frames * FRAME_TIME, hooks);
+   lastStep[i] = toFrame;
+}